@@ -17,6 +17,7 @@ using namespace flowsql;
 struct Args {
     std::string config;       // Gateway 模式：配置文件路径
     std::string role;         // Service 模式：角色名
+    std::string instance;     // Service 模式：实例名（多实例时由 Gateway 传入，默认与角色名相同）
     std::string gateway_addr; // Service 模式：Gateway 地址
     int port = 0;             // Service 模式：监听端口
     std::string plugins;      // Service 模式：插件列表（逗号分隔）
@@ -30,6 +31,8 @@ static Args ParseArgs(int argc, char* argv[]) {
             args.config = argv[++i];
         } else if (strcmp(argv[i], "--role") == 0 && i + 1 < argc) {
             args.role = argv[++i];
+        } else if (strcmp(argv[i], "--instance") == 0 && i + 1 < argc) {
+            args.instance = argv[++i];
         } else if (strcmp(argv[i], "--gateway") == 0 && i + 1 < argc) {
             args.gateway_addr = argv[++i];
         } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
@@ -151,11 +154,14 @@ static int RunService(const Args& args) {
         }
         client.SetGateway(gw_host, gw_port);
 
+        // 同一角色的多个实例注册同一前缀，以实例名区分心跳
+        std::string instance = args.instance.empty() ? args.role : args.instance;
         std::string local_addr = "127.0.0.1:" + std::to_string(args.port);
         std::string prefix = "/" + args.role;
+        client.SetServiceName(instance);
         client.RegisterRoute(prefix, local_addr);
 
-        client.StartHeartbeat(args.role, 5);
+        client.StartHeartbeat(instance, 5);
     }
 
     printf("Service %s running on port %d. Press Ctrl+C to stop.\n", args.role.c_str(), args.port);
@@ -4,7 +4,14 @@
 #include <arrow/compute/api.h>
 #include <arrow/io/api.h>
 #include <arrow/ipc/api.h>
+#include <arrow/util/byte_size.h>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <common/log.h>
 
 #include "dataframe.h"
@@ -23,23 +30,67 @@ static std::vector<Field> SchemaToFields(const std::shared_ptr<arrow::Schema>& s
     return fields;
 }
 
+// 一次性合并所有 batch 后写入 DataFrame 通道，避免逐行追加
+static int WriteBatchesToDataFrame(const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
+                                   IDataFrameChannel* df_out, std::string* error) {
+    DataFrame result;
+    if (!batches.empty()) {
+        auto concat_result = arrow::ConcatenateRecordBatches(batches);
+        if (!concat_result.ok()) {
+            if (error) *error = "ConcatenateRecordBatches failed: " + concat_result.status().ToString();
+            return -1;
+        }
+        result.SetSchema(SchemaToFields(batches.front()->schema()));
+        result.FromArrow(*concat_result);
+    }
+    return df_out->Write(&result);
+}
+
 int ChannelAdapter::ReadToDataFrame(IDatabaseChannel* db, const char* query,
                                      IDataFrameChannel* df_out, std::string* error) {
     if (!db || !df_out) return -1;
 
+    // 收集所有 RecordBatch，最后一次性合并，避免逐行追加的 O(n²) 问题
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+
+    // 读端支持 IArrowReadable（ClickHouse、SQLite 原生读取器）时直接取 RecordBatch 列表
+    IArrowReader* arrow_reader = nullptr;
+    if (db->CreateArrowReader(query, &arrow_reader) == 0 && arrow_reader) {
+        std::string err;
+        int rc = arrow_reader->ExecuteQueryArrow(query, &batches, &err);
+        arrow_reader->Release();
+        if (rc != 0) {
+            if (error) *error = err;
+            return -1;
+        }
+        return WriteBatchesToDataFrame(batches, df_out, error);
+    }
+
     IBatchReader* reader = nullptr;
     if (db->CreateReader(query, &reader) != 0 || !reader) {
         if (error) *error = "CreateReader failed for query: " + std::string(query ? query : "");
         return -1;
     }
 
-    // 收集所有 RecordBatch，最后一次性合并，避免逐行追加的 O(n²) 问题
-    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
-    std::shared_ptr<arrow::Schema> schema;
     const uint8_t* buf = nullptr;
     size_t len = 0;
 
-    while (true) {
+    // 同进程读端直接取 RecordBatch，跳过 IPC 编解码
+    auto* batch_source = dynamic_cast<IRecordBatchReader*>(reader);
+    while (batch_source) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        int rc = batch_source->NextBatch(&batch);
+        if (rc == 1) break;  // 已读完
+        if (rc < 0) {
+            if (error) *error = std::string(reader->GetLastError());
+            reader->Close();
+            reader->Release();
+            return -1;
+        }
+        batches.push_back(std::move(batch));
+    }
+
+    while (!batch_source) {
         int rc = reader->Next(&buf, &len);
         if (rc == 1) break;  // 已读完
         if (rc < 0) {
@@ -59,7 +110,6 @@ int ChannelAdapter::ReadToDataFrame(IDatabaseChannel* db, const char* query,
             return -1;
         }
         auto stream_reader = *stream_result;
-        if (!schema) schema = stream_reader->schema();
 
         std::shared_ptr<arrow::RecordBatch> batch;
         while (stream_reader->ReadNext(&batch).ok() && batch) {
@@ -70,19 +120,7 @@ int ChannelAdapter::ReadToDataFrame(IDatabaseChannel* db, const char* query,
     reader->Close();
     reader->Release();
 
-    DataFrame result;
-    if (!batches.empty()) {
-        // 一次性合并所有 batch，避免逐行追加
-        auto concat_result = arrow::ConcatenateRecordBatches(batches);
-        if (!concat_result.ok()) {
-            if (error) *error = "ConcatenateRecordBatches failed: " + concat_result.status().ToString();
-            return -1;
-        }
-        result.SetSchema(SchemaToFields(schema));
-        result.FromArrow(*concat_result);
-    }
-
-    return df_out->Write(&result);
+    return WriteBatchesToDataFrame(batches, df_out, error);
 }
 
 int64_t ChannelAdapter::WriteFromDataFrame(IDataFrameChannel* df_in,
@@ -104,7 +142,7 @@ int64_t ChannelAdapter::WriteFromDataFrame(IDataFrameChannel* df_in,
         return -1;
     }
 
-    // DataFrame → Arrow RecordBatch → IPC 序列化 → Writer
+    // DataFrame → Arrow RecordBatch →（IPC 序列化）→ Writer
     auto batch = data.ToArrow();
     if (!batch) {
         if (error) *error = "ToArrow conversion failed";
@@ -113,24 +151,34 @@ int64_t ChannelAdapter::WriteFromDataFrame(IDataFrameChannel* df_in,
         return -1;
     }
 
-    // 序列化为 IPC stream 格式
-    auto sink_stream = arrow::io::BufferOutputStream::Create().ValueOrDie();
-    auto ipc_writer = arrow::ipc::MakeStreamWriter(sink_stream, batch->schema()).ValueOrDie();
-    auto status = ipc_writer->WriteRecordBatch(*batch);
-    if (!status.ok()) {
-        if (error) *error = "IPC serialize failed: " + status.ToString();
-        writer->Close(nullptr);
-        writer->Release();
-        return -1;
-    }
-    ipc_writer->Close();
+    if (auto* batch_sink = dynamic_cast<IRecordBatchWriter*>(writer)) {
+        // 同进程写端直接写入 RecordBatch，跳过 IPC 编解码
+        if (batch_sink->WriteBatch(batch) != 0) {
+            if (error) *error = std::string(writer->GetLastError());
+            writer->Close(nullptr);
+            writer->Release();
+            return -1;
+        }
+    } else {
+        // 序列化为 IPC stream 格式
+        auto sink_stream = arrow::io::BufferOutputStream::Create().ValueOrDie();
+        auto ipc_writer = arrow::ipc::MakeStreamWriter(sink_stream, batch->schema()).ValueOrDie();
+        auto status = ipc_writer->WriteRecordBatch(*batch);
+        if (status.ok()) status = ipc_writer->Close();
+        if (!status.ok()) {
+            if (error) *error = "IPC serialize failed: " + status.ToString();
+            writer->Close(nullptr);
+            writer->Release();
+            return -1;
+        }
 
-    auto buffer = sink_stream->Finish().ValueOrDie();
-    if (writer->Write(buffer->data(), static_cast<size_t>(buffer->size())) != 0) {
-        if (error) *error = std::string(writer->GetLastError());
-        writer->Close(nullptr);
-        writer->Release();
-        return -1;
+        auto buffer = sink_stream->Finish().ValueOrDie();
+        if (writer->Write(buffer->data(), static_cast<size_t>(buffer->size())) != 0) {
+            if (error) *error = std::string(writer->GetLastError());
+            writer->Close(nullptr);
+            writer->Release();
+            return -1;
+        }
     }
 
     writer->Flush();
@@ -145,6 +193,556 @@ int64_t ChannelAdapter::WriteFromDataFrame(IDataFrameChannel* df_in,
     return stats.rows_written;
 }
 
+namespace {
+
+// 搬运单元：读端取出的一批数据
+// 读端走 IPC 时 ipc 为 IPC stream buffer（行式写端原样透传），列式写端时 batches 为解码结果；
+// 读端支持 IRecordBatchReader 时只有 batches，ipc 为空
+struct TransferChunk {
+    std::shared_ptr<arrow::Buffer> ipc;
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+};
+
+// 有界 SPSC 队列：读线程 Push、写线程 Pop
+// 队列满时阻塞读线程（背压），队列空时阻塞写线程；任一端失败调用 Abort 唤醒另一端
+class TransferQueue {
+ public:
+    explicit TransferQueue(size_t capacity) : slots_(capacity > 0 ? capacity : 1) {}
+
+    // 返回 false 表示写端已放弃，读端应停止
+    bool Push(TransferChunk&& chunk) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return count_ < slots_.size() || aborted_; });
+        if (aborted_) return false;
+        slots_[(head_ + count_) % slots_.size()] = std::move(chunk);
+        ++count_;
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // 返回 false 表示队列已关闭且取空，或读端已放弃
+    bool Pop(TransferChunk* chunk) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return count_ > 0 || closed_ || aborted_; });
+        if (aborted_ || count_ == 0) return false;
+        *chunk = std::move(slots_[head_]);
+        head_ = (head_ + 1) % slots_.size();
+        --count_;
+        not_full_.notify_one();
+        return true;
+    }
+
+    // 读端正常结束
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+    // 任一端出错，丢弃队列中剩余数据
+    void Abort() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborted_ = true;
+        for (auto& slot : slots_) slot = TransferChunk();
+        count_ = 0;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+ private:
+    std::vector<TransferChunk> slots_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    bool closed_ = false;
+    bool aborted_ = false;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+static int64_t ElapsedUs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - since).count();
+}
+
+// 解码 IPC stream buffer，得到的 RecordBatch 引用 buffer 本身
+static int DecodeIpc(const std::shared_ptr<arrow::Buffer>& buffer,
+                     std::vector<std::shared_ptr<arrow::RecordBatch>>* out,
+                     std::string* error) {
+    auto input = std::make_shared<arrow::io::BufferReader>(buffer);
+    auto stream_result = arrow::ipc::RecordBatchStreamReader::Open(input);
+    if (!stream_result.ok()) {
+        if (error) *error = "IPC deserialize failed: " + stream_result.status().ToString();
+        return -1;
+    }
+    std::shared_ptr<arrow::RecordBatch> batch;
+    while (true) {
+        auto status = (*stream_result)->ReadNext(&batch);
+        if (!status.ok()) {
+            if (error) *error = "IPC deserialize failed: " + status.ToString();
+            return -1;
+        }
+        if (!batch) break;
+        out->push_back(batch);
+    }
+    return 0;
+}
+
+// 从读端取一批数据
+// owned=true 时复制一份 IPC buffer（IBatchReader::Next 返回的 buffer 在下一次 Next 调用后失效），
+// 跨线程传递或需要延迟写入时必须复制；decode=true 时同时解码为 RecordBatch
+// 返回：0=有数据, 1=已读完, <0=错误
+static int ReadChunk(IBatchReader* reader, bool owned, bool decode,
+                     TransferChunk* chunk, std::string* error) {
+    // 同进程读端：RecordBatch 由调用方持有，无需复制也无需解码
+    if (auto* batch_source = dynamic_cast<IRecordBatchReader*>(reader)) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        int rc = batch_source->NextBatch(&batch);
+        if (rc < 0 && error) *error = reader->GetLastError();
+        if (rc == 0) chunk->batches.push_back(std::move(batch));
+        return rc;
+    }
+
+    const uint8_t* buf = nullptr;
+    size_t len = 0;
+    int rc = reader->Next(&buf, &len);
+    if (rc == 1) return 1;
+    if (rc < 0) {
+        if (error) *error = reader->GetLastError();
+        return -1;
+    }
+
+    if (owned) {
+        auto alloc = arrow::AllocateBuffer(static_cast<int64_t>(len));
+        if (!alloc.ok()) {
+            if (error) *error = "AllocateBuffer failed: " + alloc.status().ToString();
+            return -1;
+        }
+        std::shared_ptr<arrow::Buffer> copy = std::move(*alloc);
+        if (len > 0) memcpy(copy->mutable_data(), buf, len);
+        chunk->ipc = std::move(copy);
+    } else {
+        chunk->ipc = arrow::Buffer::Wrap(buf, static_cast<int64_t>(len));
+    }
+
+    if (decode && DecodeIpc(chunk->ipc, &chunk->batches, error) != 0) return -1;
+    return 0;
+}
+
+// 写端封装：列式写入端（IArrowWriter）按窗口合并提交，行式写入端（IBatchWriter）逐批直写
+class TransferSink {
+ public:
+    TransferSink(IArrowWriter* arrow_writer, IBatchWriter* batch_writer,
+                 const char* table, const TransferOptions& options)
+        : arrow_writer_(arrow_writer), batch_writer_(batch_writer), table_(table), options_(options),
+          batch_sink_(dynamic_cast<IRecordBatchWriter*>(batch_writer)) {}
+
+    bool columnar() const { return arrow_writer_ != nullptr; }
+
+    int Write(TransferChunk&& chunk, std::string* error) {
+        if (batch_writer_) return WriteRows(chunk, error);
+
+        window_bytes_ += ChunkBytes(chunk);
+        for (auto& b : chunk.batches) window_.push_back(std::move(b));
+        if (window_bytes_ >= options_.window_bytes ||
+            static_cast<int32_t>(window_.size()) >= options_.window_batches) {
+            return FlushWindow(error);
+        }
+        return 0;
+    }
+
+    // 成功结束：提交剩余窗口 / 提交行式写入器事务
+    int Finish(std::string* error) {
+        if (arrow_writer_) return FlushWindow(error);
+
+        batch_writer_->Flush();
+        BatchWriteStats stats;
+        batch_writer_->Close(&stats);
+        const char* close_error = batch_writer_->GetLastError();
+        if (close_error && *close_error) {
+            if (error) *error = close_error;
+            return -1;
+        }
+        rows_ = stats.rows_written;
+        return 0;
+    }
+
+    // 失败时不调用 Close（Close 会提交事务），直接释放由写入器回滚：
+    // 行式写端回滚整个事务；列式写端只丢弃当前未提交的窗口，已经 FlushWindow 的窗口不会撤销
+    void Release() {
+        if (arrow_writer_) arrow_writer_->Release();
+        if (batch_writer_) batch_writer_->Release();
+        arrow_writer_ = nullptr;
+        batch_writer_ = nullptr;
+    }
+
+    int64_t rows() const { return rows_; }
+
+    static int64_t ChunkBytes(const TransferChunk& chunk) {
+        if (chunk.ipc) return chunk.ipc->size();
+        int64_t bytes = 0;
+        for (const auto& b : chunk.batches) bytes += arrow::util::TotalBufferSize(*b);
+        return bytes;
+    }
+
+ private:
+    // 行式写端：IPC buffer 原样透传；只有 RecordBatch 时优先走 IRecordBatchWriter，否则编码为 IPC
+    int WriteRows(const TransferChunk& chunk, std::string* error) {
+        if (chunk.ipc) {
+            if (batch_writer_->Write(chunk.ipc->data(), static_cast<size_t>(chunk.ipc->size())) != 0) {
+                if (error) *error = batch_writer_->GetLastError();
+                return -1;
+            }
+            return 0;
+        }
+        for (const auto& b : chunk.batches) {
+            if (batch_sink_) {
+                if (batch_sink_->WriteBatch(b) != 0) {
+                    if (error) *error = batch_writer_->GetLastError();
+                    return -1;
+                }
+                continue;
+            }
+            auto sink_stream = arrow::io::BufferOutputStream::Create().ValueOrDie();
+            auto ipc_writer = arrow::ipc::MakeStreamWriter(sink_stream, b->schema()).ValueOrDie();
+            auto status = ipc_writer->WriteRecordBatch(*b);
+            if (status.ok()) status = ipc_writer->Close();
+            if (!status.ok()) {
+                if (error) *error = "IPC serialize failed: " + status.ToString();
+                return -1;
+            }
+            auto buffer = sink_stream->Finish().ValueOrDie();
+            if (batch_writer_->Write(buffer->data(), static_cast<size_t>(buffer->size())) != 0) {
+                if (error) *error = batch_writer_->GetLastError();
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+
+    int FlushWindow(std::string* error) {
+        if (window_.empty()) return 0;
+        std::string err;
+        if (arrow_writer_->WriteBatches(table_, window_, &err) != 0) {
+            if (err.empty()) err = arrow_writer_->GetLastError();
+            if (error) *error = err;
+            return -1;
+        }
+        for (const auto& b : window_) rows_ += b->num_rows();
+        window_.clear();
+        window_bytes_ = 0;
+        return 0;
+    }
+
+    IArrowWriter* arrow_writer_;
+    IBatchWriter* batch_writer_;
+    const char* table_;
+    const TransferOptions& options_;
+    IRecordBatchWriter* batch_sink_;
+    std::vector<std::shared_ptr<arrow::RecordBatch>> window_;
+    int64_t window_bytes_ = 0;
+    int64_t rows_ = 0;
+};
+
+// 写端：列式数据库走 IArrowWriter（按窗口合并提交），行式数据库走 IBatchWriter（逐批直写）
+static int CreateSinkWriter(IDatabaseChannel* dst, const char* table, IArrowWriter** arrow_writer,
+                            IBatchWriter** batch_writer) {
+    *arrow_writer = nullptr;
+    *batch_writer = nullptr;
+    if (dst->CreateArrowWriter(table, arrow_writer) == 0 && *arrow_writer) return 0;
+    *arrow_writer = nullptr;
+    if (dst->CreateWriter(table, batch_writer) == 0 && *batch_writer) return 0;
+    *batch_writer = nullptr;
+    return -1;
+}
+
+// 协作式取消检查：调用方置位 options.cancel 后，在下一批边界终止
+static bool Cancelled(const TransferOptions& options, std::string* error) {
+    if (!options.cancel || !options.cancel->load(std::memory_order_relaxed)) return false;
+    if (error) *error = "cancelled";
+    return true;
+}
+
+static void ReportProgress(const TransferOptions& options, int64_t bytes, int64_t rows) {
+    if (!options.progress) return;
+    options.progress->batches.fetch_add(1, std::memory_order_relaxed);
+    options.progress->bytes.fetch_add(bytes, std::memory_order_relaxed);
+    options.progress->rows.store(rows, std::memory_order_relaxed);
+}
+
+// 串行模式：在调用线程上读一批写一批
+// 行式写端在下一次 Next 之前写完，可直接透传读端 buffer，无需复制
+static int RunSerialTransfer(IBatchReader* reader, TransferSink* sink, const TransferOptions& options,
+                             TransferStats* stats, std::string* error) {
+    while (true) {
+        if (Cancelled(options, error)) return -1;
+        TransferChunk chunk;
+        auto t0 = std::chrono::steady_clock::now();
+        int rc = ReadChunk(reader, sink->columnar(), sink->columnar(), &chunk, error);
+        stats->read_us += ElapsedUs(t0);
+        if (rc == 1) break;
+        if (rc < 0) return -1;
+        stats->batches++;
+        int64_t bytes = TransferSink::ChunkBytes(chunk);
+        stats->bytes += bytes;
+
+        auto t1 = std::chrono::steady_clock::now();
+        rc = sink->Write(std::move(chunk), error);
+        stats->write_us += ElapsedUs(t1);
+        if (rc != 0) return -1;
+        ReportProgress(options, bytes, sink->rows());
+    }
+    auto t = std::chrono::steady_clock::now();
+    int rc = sink->Finish(error);
+    stats->write_us += ElapsedUs(t);
+    if (rc == 0 && options.progress) options.progress->rows = sink->rows();
+    return rc;
+}
+
+// 流水线模式：读线程调用 IBatchReader::Next 放入有界队列，调用线程从队列取出写入
+// 两端各自计时：*_us 为实际读/写耗时，*_wait_us 为在队列上阻塞的时间
+// read_wait_us 高说明写端是瓶颈，write_wait_us 高说明读端是瓶颈
+static int RunPipelinedTransfer(IBatchReader* reader, TransferSink* sink, const TransferOptions& options,
+                                TransferStats* stats, std::string* error) {
+    TransferQueue queue(static_cast<size_t>(options.queue_depth));
+    std::string read_error;
+    int read_rc = 0;
+    const bool decode = sink->columnar();
+
+    std::thread producer([&]() {
+        while (true) {
+            TransferChunk chunk;
+            auto t0 = std::chrono::steady_clock::now();
+            int rc = ReadChunk(reader, true, decode, &chunk, &read_error);
+            stats->read_us += ElapsedUs(t0);
+            if (rc == 1) break;
+            if (rc < 0) {
+                read_rc = -1;
+                queue.Abort();
+                return;
+            }
+            stats->batches++;
+            stats->bytes += TransferSink::ChunkBytes(chunk);
+
+            auto t1 = std::chrono::steady_clock::now();
+            bool pushed = queue.Push(std::move(chunk));
+            stats->read_wait_us += ElapsedUs(t1);
+            if (!pushed) return;  // 写端已放弃
+        }
+        queue.Close();
+    });
+
+    int write_rc = 0;
+    while (true) {
+        TransferChunk chunk;
+        auto t0 = std::chrono::steady_clock::now();
+        bool popped = queue.Pop(&chunk);
+        stats->write_wait_us += ElapsedUs(t0);
+        if (!popped) break;
+
+        int64_t bytes = TransferSink::ChunkBytes(chunk);
+        auto t1 = std::chrono::steady_clock::now();
+        write_rc = Cancelled(options, error) ? -1 : sink->Write(std::move(chunk), error);
+        stats->write_us += ElapsedUs(t1);
+        if (write_rc == 0) ReportProgress(options, bytes, sink->rows());
+        if (write_rc != 0) {
+            // 先取消读端，让阻塞在 Next 中的读线程尽快返回
+            reader->Cancel();
+            queue.Abort();
+            break;
+        }
+    }
+    producer.join();
+
+    if (write_rc != 0) return -1;
+    if (read_rc != 0) {
+        if (error) *error = read_error;
+        return -1;
+    }
+
+    auto t = std::chrono::steady_clock::now();
+    int rc = sink->Finish(error);
+    stats->write_us += ElapsedUs(t);
+    if (rc == 0 && options.progress) options.progress->rows = sink->rows();
+    return rc;
+}
+
+}  // namespace
+
+int64_t ChannelAdapter::TransferDatabase(IDatabaseChannel* src, const char* query,
+                                         IDatabaseChannel* dst, const char* table,
+                                         const TransferOptions& options, std::string* error,
+                                         TransferStats* stats) {
+    if (!src || !dst || !table) return -1;
+    auto start = std::chrono::steady_clock::now();
+
+    IBatchReader* reader = nullptr;
+    if (src->CreateReader(query, &reader) != 0 || !reader) {
+        if (error) *error = "CreateReader failed for query: " + std::string(query ? query : "");
+        return -1;
+    }
+
+    IArrowWriter* arrow_writer = nullptr;
+    IBatchWriter* batch_writer = nullptr;
+    if (CreateSinkWriter(dst, table, &arrow_writer, &batch_writer) != 0) {
+        if (error) *error = "CreateWriter failed for table: " + std::string(table);
+        reader->Close();
+        reader->Release();
+        return -1;
+    }
+
+    TransferSink sink(arrow_writer, batch_writer, table, options);
+    TransferStats local_stats;
+    std::string err;
+    int rc = options.pipelined
+                 ? RunPipelinedTransfer(reader, &sink, options, &local_stats, &err)
+                 : RunSerialTransfer(reader, &sink, options, &local_stats, &err);
+
+    if (rc != 0) reader->Cancel();
+    reader->Close();
+    reader->Release();
+    sink.Release();
+
+    local_stats.rows = sink.rows();
+    local_stats.elapsed_us = ElapsedUs(start);
+    if (stats) *stats = local_stats;
+
+    if (rc != 0) {
+        if (error) *error = err;
+        return -1;
+    }
+
+    LOG_INFO("ChannelAdapter::TransferDatabase(%s): %ld batches, %ld rows, %ld bytes in %ld ms "
+             "(read %ld ms, write %ld ms, read wait %ld ms, write wait %ld ms)",
+             options.pipelined ? "pipelined" : "serial",
+             static_cast<long>(local_stats.batches), static_cast<long>(local_stats.rows),
+             static_cast<long>(local_stats.bytes), static_cast<long>(local_stats.elapsed_us / 1000),
+             static_cast<long>(local_stats.read_us / 1000), static_cast<long>(local_stats.write_us / 1000),
+             static_cast<long>(local_stats.read_wait_us / 1000),
+             static_cast<long>(local_stats.write_wait_us / 1000));
+    return local_stats.rows;
+}
+
+int64_t ChannelAdapter::TransferThroughOperator(IChannel* src, const char* query, IBatchOperator* op,
+                                                IChannel* dst, const char* table,
+                                                const TransferOptions& options, std::string* error) {
+    if (!src || !op || !dst) return -1;
+    auto* db_src = dynamic_cast<IDatabaseChannel*>(src);
+    auto* df_src = db_src ? nullptr : dynamic_cast<IDataFrameChannel*>(src);
+    auto* db_dst = dynamic_cast<IDatabaseChannel*>(dst);
+    auto* df_dst = db_dst ? nullptr : dynamic_cast<IDataFrameChannel*>(dst);
+    if ((!db_src && !df_src) || (!db_dst && !df_dst) || (db_dst && !table)) {
+        if (error) *error = "unsupported channel type for batch operator";
+        return -1;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    // 读端：数据库逐批读取；DataFrame 通道本身已在内存中，整帧作为唯一一批
+    IBatchReader* reader = nullptr;
+    std::shared_ptr<arrow::RecordBatch> frame_batch;
+    if (db_src) {
+        if (db_src->CreateReader(query, &reader) != 0 || !reader) {
+            if (error) *error = "CreateReader failed for query: " + std::string(query ? query : "");
+            return -1;
+        }
+    } else {
+        DataFrame data;
+        if (df_src->Read(&data) != 0 || !(frame_batch = data.ToArrow())) {
+            if (error) *error = "Read from input channel failed";
+            return -1;
+        }
+    }
+
+    IArrowWriter* arrow_writer = nullptr;
+    IBatchWriter* batch_writer = nullptr;
+    if (db_dst && CreateSinkWriter(db_dst, table, &arrow_writer, &batch_writer) != 0) {
+        if (error) *error = "CreateWriter failed for table: " + std::string(table);
+        if (reader) {
+            reader->Close();
+            reader->Release();
+        }
+        return -1;
+    }
+    TransferSink sink(arrow_writer, batch_writer, table, options);
+    // DataFrame 写端是替换语义，只能在结束时整体写入
+    std::vector<std::shared_ptr<arrow::RecordBatch>> frames;
+
+    std::string err;
+    TransferStats stats;
+    int64_t out_rows = 0;
+    std::deque<std::shared_ptr<arrow::RecordBatch>> pending;  // 一个 IPC buffer 可能解码出多批
+
+    // 读端 buffer 在下一次 Next 后失效，而算子可能跨批保留输入，故复制后再解码
+    BatchSource next = [&](std::shared_ptr<arrow::RecordBatch>* batch) -> int {
+        if (Cancelled(options, &err)) return -1;
+        if (!reader) {
+            if (!frame_batch) return 1;
+            *batch = std::move(frame_batch);
+            frame_batch.reset();
+            return 0;
+        }
+        while (pending.empty()) {
+            TransferChunk chunk;
+            auto t0 = std::chrono::steady_clock::now();
+            int rc = ReadChunk(reader, true, true, &chunk, &err);
+            stats.read_us += ElapsedUs(t0);
+            if (rc != 0) return rc;
+            stats.batches++;
+            stats.bytes += TransferSink::ChunkBytes(chunk);
+            for (auto& b : chunk.batches) pending.push_back(std::move(b));
+        }
+        *batch = std::move(pending.front());
+        pending.pop_front();
+        return 0;
+    };
+
+    BatchSink emit = [&](const std::shared_ptr<arrow::RecordBatch>& batch) -> int {
+        if (Cancelled(options, &err)) return -1;
+        int64_t bytes = arrow::util::TotalBufferSize(*batch);
+        out_rows += batch->num_rows();
+        if (df_dst) {
+            frames.push_back(batch);
+        } else {
+            TransferChunk chunk;
+            chunk.batches.push_back(batch);
+            auto t0 = std::chrono::steady_clock::now();
+            int rc = sink.Write(std::move(chunk), &err);
+            stats.write_us += ElapsedUs(t0);
+            if (rc != 0) return -1;
+        }
+        ReportProgress(options, bytes, db_dst ? sink.rows() : out_rows);
+        return 0;
+    };
+
+    int rc = op->WorkBatches(next, emit);
+    if (reader) {
+        if (rc != 0) reader->Cancel();
+        reader->Close();
+        reader->Release();
+    }
+    if (rc == 0) {
+        auto t = std::chrono::steady_clock::now();
+        rc = db_dst ? sink.Finish(&err) : WriteBatchesToDataFrame(frames, df_dst, &err);
+        stats.write_us += ElapsedUs(t);
+        if (rc == 0 && db_dst) out_rows = sink.rows();
+    }
+    sink.Release();
+
+    if (rc != 0) {
+        if (error) *error = err;
+        return -1;
+    }
+    if (options.progress) options.progress->rows = out_rows;
+
+    LOG_INFO("ChannelAdapter::TransferThroughOperator: %ld input batches, %ld bytes -> %ld rows in %ld ms "
+             "(read %ld ms, write %ld ms)",
+             static_cast<long>(stats.batches), static_cast<long>(stats.bytes), static_cast<long>(out_rows),
+             static_cast<long>(ElapsedUs(start) / 1000), static_cast<long>(stats.read_us / 1000),
+             static_cast<long>(stats.write_us / 1000));
+    return out_rows;
+}
+
 int ChannelAdapter::CopyDataFrame(IDataFrameChannel* src, IDataFrameChannel* dst) {
     if (!src || !dst) return -1;
 
@@ -1,11 +1,54 @@
 #ifndef _FLOWSQL_FRAMEWORK_CORE_CHANNEL_ADAPTER_H_
 #define _FLOWSQL_FRAMEWORK_CORE_CHANNEL_ADAPTER_H_
 
+#include <atomic>
+#include <cstdint>
+#include <string>
+
 #include "framework/interfaces/idatabase_channel.h"
 #include "framework/interfaces/idataframe_channel.h"
+#include "framework/interfaces/ioperator.h"
 
 namespace flowsql {
 
+// 搬运进度（异步作业轮询用），由搬运线程写入，其他线程随时读取
+struct TransferProgress {
+    std::atomic<int64_t> batches{0};
+    std::atomic<int64_t> bytes{0};
+    std::atomic<int64_t> rows{0};  // 已提交到写端的行数（行式写端在结束时才更新）
+};
+
+// 流式搬运参数
+// 读端每取一批立即交给写端，内存占用只与窗口大小有关，与总行数无关
+struct TransferOptions {
+    // 列式写入端（IArrowWriter）累积到以下任一上限即提交一次；行式写入端（IBatchWriter）逐批直写
+    int64_t window_bytes = 16 * 1024 * 1024;
+    int32_t window_batches = 16;
+    // 流水线模式：独立读线程预取，经有界队列交给写端，读写重叠执行
+    bool pipelined = false;
+    // 流水线模式下读写之间最多缓冲的批次数（队列满时读线程阻塞）
+    int32_t queue_depth = 4;
+    // 协作式取消：每批之间检查，置位后终止搬运；为空表示不可取消
+    // 列式写端每个窗口单独提交，取消或失败时只回滚未提交的窗口，此前已提交的窗口保留在目标表中；
+    // 行式写端在 Close 时才提交，取消或失败时整体回滚
+    const std::atomic<bool>* cancel = nullptr;
+    // 可选的进度输出
+    TransferProgress* progress = nullptr;
+};
+
+// 流式搬运统计，各阶段耗时单位为微秒
+// read_wait_us 高说明写端是瓶颈，write_wait_us 高说明读端是瓶颈（仅流水线模式有等待时间）
+struct TransferStats {
+    int64_t batches = 0;
+    int64_t rows = 0;
+    int64_t bytes = 0;
+    int64_t elapsed_us = 0;
+    int64_t read_us = 0;        // 读端 Next + 复制/解码
+    int64_t write_us = 0;       // 写端 Write/WriteBatches + 提交
+    int64_t read_wait_us = 0;   // 读线程等待队列空位
+    int64_t write_wait_us = 0;  // 写端等待队列数据
+};
+
 // ChannelAdapter — 通道间格式转换工具类
 // 封装 Database ↔ DataFrame 的数据搬运逻辑，供 Scheduler 自动适配使用
 class ChannelAdapter {
@@ -21,6 +64,24 @@ class ChannelAdapter {
                                       IDatabaseChannel* db, const char* table,
                                       std::string* error = nullptr);
 
+    // Database → Database：流式搬运，不经过 DataFrame 中转
+    // 读端 IBatchReader 逐批读取；写端优先 IArrowWriter（按窗口分批提交），否则 IBatchWriter（IPC buffer 原样透传）
+    // 串行模式下写端未消费完当前窗口前不会继续读取；流水线模式下队列满时读线程阻塞（背压）
+    // 返回：成功返回写入的行数（>= 0），失败返回 -1（列式写端可能已写入部分窗口，见 TransferOptions::cancel）
+    static int64_t TransferDatabase(IDatabaseChannel* src, const char* query,
+                                    IDatabaseChannel* dst, const char* table,
+                                    const TransferOptions& options = TransferOptions(),
+                                    std::string* error = nullptr, TransferStats* stats = nullptr);
+
+    // 经逐批算子搬运：读端每取一批交给算子，算子每产出一批立即交给写端
+    // src 为数据库通道时流式执行 query，为 DataFrame 通道时整帧作为一批；
+    // dst 为数据库通道时写入 table（提交方式同 TransferDatabase），为 DataFrame 通道时输出在结束时整体写入（替换语义）
+    // 取消与进度按批检查 / 上报；返回：成功返回输出行数（>= 0），失败返回 -1（error 为空时取算子的 LastError）
+    static int64_t TransferThroughOperator(IChannel* src, const char* query, IBatchOperator* op,
+                                           IChannel* dst, const char* table,
+                                           const TransferOptions& options = TransferOptions(),
+                                           std::string* error = nullptr);
+
     // DataFrame → DataFrame：纯数据搬运（无算子场景）
     static int CopyDataFrame(IDataFrameChannel* src, IDataFrameChannel* dst);
 };
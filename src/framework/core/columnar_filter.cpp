@@ -0,0 +1,1211 @@
+#include "columnar_filter.h"
+
+#include <arrow/util/bit_util.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+
+#include "sql_parser.h"
+
+namespace flowsql {
+
+namespace {
+
+// ==================== 字面量解析 ====================
+
+bool ParseInt64(const std::string& s, int64_t* out) {
+    if (s.empty()) return false;
+    errno = 0;
+    char* end = nullptr;
+    long long v = std::strtoll(s.c_str(), &end, 10);
+    if (errno == ERANGE || *end != '\0') return false;
+    *out = static_cast<int64_t>(v);
+    return true;
+}
+
+bool ParseUint64(const std::string& s, uint64_t* out) {
+    if (s.empty() || s[0] == '-') return false;
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long v = std::strtoull(s.c_str(), &end, 10);
+    if (errno == ERANGE || *end != '\0') return false;
+    *out = static_cast<uint64_t>(v);
+    return true;
+}
+
+bool ParseDouble(const std::string& s, double* out) {
+    if (s.empty()) return false;
+    errno = 0;
+    char* end = nullptr;
+    double v = std::strtod(s.c_str(), &end);
+    if (errno == ERANGE || *end != '\0') return false;
+    *out = v;
+    return true;
+}
+
+bool ParseBool(const std::string& s, uint8_t* out) {
+    if (s == "true" || s == "TRUE" || s == "1") { *out = 1; return true; }
+    if (s == "false" || s == "FALSE" || s == "0") { *out = 0; return true; }
+    return false;
+}
+
+// 整数列的字面量：CmpType 为 int64_t（有符号列）或 uint64_t（无符号列）
+template <typename CmpType>
+bool ParseInteger(const std::string& s, CmpType* out) {
+    if constexpr (std::is_signed_v<CmpType>) {
+        return ParseInt64(s, out);
+    } else {
+        return ParseUint64(s, out);
+    }
+}
+
+// ==================== 掩码辅助 ====================
+
+// 估算的单行代价，仅用于 AND/OR 子项排序
+constexpr int kCostConstant = 0;
+constexpr int kCostNullTest = 1;
+constexpr int kCostFixedWidth = 2;
+constexpr int kCostRange = 3;
+constexpr int kCostBinary = 8;
+constexpr int kCostBinaryIn = 12;
+
+bool AnySelected(const uint8_t* sel, int64_t length) {
+    return length > 0 && std::memchr(sel, 1, static_cast<size_t>(length)) != nullptr;
+}
+
+bool AllSelected(const uint8_t* sel, int64_t length) {
+    return length == 0 || std::memchr(sel, 0, static_cast<size_t>(length)) == nullptr;
+}
+
+// null 行清零（SQL 语义：与 null 比较结果为未知，不命中）
+void ApplyValidity(const arrow::ArrayData& data, uint8_t* sel) {
+    if (data.buffers.empty() || !data.buffers[0] || data.GetNullCount() == 0) return;
+    const uint8_t* bitmap = data.buffers[0]->data();
+    for (int64_t i = 0; i < data.length; ++i) {
+        sel[i] &= static_cast<uint8_t>(arrow::bit_util::GetBit(bitmap, data.offset + i) ? 1 : 0);
+    }
+}
+
+// ==================== 求值内核 ====================
+
+// 操作符在编译期确定，行循环内没有分支，便于编译器向量化
+template <CompareOp Op, typename T>
+inline bool Compare(const T& lhs, const T& rhs) {
+    if constexpr (Op == CompareOp::EQ) return lhs == rhs;
+    else if constexpr (Op == CompareOp::NE) return lhs != rhs;
+    else if constexpr (Op == CompareOp::LT) return lhs < rhs;
+    else if constexpr (Op == CompareOp::LE) return lhs <= rhs;
+    else if constexpr (Op == CompareOp::GT) return lhs > rhs;
+    else return lhs >= rhs;
+}
+
+CompareOp NegateOp(CompareOp op) {
+    switch (op) {
+        case CompareOp::EQ: return CompareOp::NE;
+        case CompareOp::NE: return CompareOp::EQ;
+        case CompareOp::LT: return CompareOp::GE;
+        case CompareOp::LE: return CompareOp::GT;
+        case CompareOp::GT: return CompareOp::LE;
+        case CompareOp::GE: return CompareOp::LT;
+    }
+    return op;
+}
+
+// 定长列内核：refine 时与原掩码按位与，仍是无分支循环
+template <CompareOp Op, typename CType, typename CmpType>
+void NumericKernel(const CType* values, int64_t length, CmpType literal, uint8_t* sel, bool refine) {
+    if (refine) {
+        for (int64_t i = 0; i < length; ++i) {
+            sel[i] &= static_cast<uint8_t>(Compare<Op>(static_cast<CmpType>(values[i]), literal));
+        }
+    } else {
+        for (int64_t i = 0; i < length; ++i) {
+            sel[i] = static_cast<uint8_t>(Compare<Op>(static_cast<CmpType>(values[i]), literal));
+        }
+    }
+}
+
+template <CompareOp Op>
+void BooleanKernel(const uint8_t* bits, int64_t offset, int64_t length, uint8_t literal, uint8_t* sel,
+                   bool refine) {
+    for (int64_t i = 0; i < length; ++i) {
+        uint8_t v = arrow::bit_util::GetBit(bits, offset + i) ? 1 : 0;
+        uint8_t hit = static_cast<uint8_t>(Compare<Op>(v, literal));
+        sel[i] = refine ? static_cast<uint8_t>(sel[i] & hit) : hit;
+    }
+}
+
+// 变长列（string/binary）逐行访问：refine 时跳过已淘汰的行
+template <typename OffsetType, typename Fn>
+void ForEachView(const arrow::ArrayData& data, uint8_t* sel, bool refine, Fn&& fn) {
+    const OffsetType* offsets = data.GetValues<OffsetType>(1);
+    const char* values = data.buffers[2] ? reinterpret_cast<const char*>(data.buffers[2]->data()) : nullptr;
+    for (int64_t i = 0; i < data.length; ++i) {
+        if (refine && !sel[i]) continue;
+        std::string_view v(values + offsets[i], static_cast<size_t>(offsets[i + 1] - offsets[i]));
+        sel[i] = static_cast<uint8_t>(fn(v));
+    }
+}
+
+template <CompareOp Op, typename OffsetType>
+void BinaryKernel(const arrow::ArrayData& data, std::string_view literal, uint8_t* sel, bool refine) {
+    ForEachView<OffsetType>(data, sel, refine, [literal](std::string_view v) { return Compare<Op>(v, literal); });
+}
+
+// 按操作符选出内核实例：编译期展开 6 个版本，运行期只在编译谓词时选择一次
+template <typename CType, typename CmpType>
+using NumericKernelFn = void (*)(const CType*, int64_t, CmpType, uint8_t*, bool);
+
+template <typename CType, typename CmpType>
+NumericKernelFn<CType, CmpType> SelectNumericKernel(CompareOp op) {
+    switch (op) {
+        case CompareOp::EQ: return &NumericKernel<CompareOp::EQ, CType, CmpType>;
+        case CompareOp::NE: return &NumericKernel<CompareOp::NE, CType, CmpType>;
+        case CompareOp::LT: return &NumericKernel<CompareOp::LT, CType, CmpType>;
+        case CompareOp::LE: return &NumericKernel<CompareOp::LE, CType, CmpType>;
+        case CompareOp::GT: return &NumericKernel<CompareOp::GT, CType, CmpType>;
+        case CompareOp::GE: return &NumericKernel<CompareOp::GE, CType, CmpType>;
+    }
+    return nullptr;
+}
+
+template <typename OffsetType>
+using BinaryKernelFn = void (*)(const arrow::ArrayData&, std::string_view, uint8_t*, bool);
+
+template <typename OffsetType>
+BinaryKernelFn<OffsetType> SelectBinaryKernel(CompareOp op) {
+    switch (op) {
+        case CompareOp::EQ: return &BinaryKernel<CompareOp::EQ, OffsetType>;
+        case CompareOp::NE: return &BinaryKernel<CompareOp::NE, OffsetType>;
+        case CompareOp::LT: return &BinaryKernel<CompareOp::LT, OffsetType>;
+        case CompareOp::LE: return &BinaryKernel<CompareOp::LE, OffsetType>;
+        case CompareOp::GT: return &BinaryKernel<CompareOp::GT, OffsetType>;
+        case CompareOp::GE: return &BinaryKernel<CompareOp::GE, OffsetType>;
+    }
+    return nullptr;
+}
+
+using BooleanKernelFn = void (*)(const uint8_t*, int64_t, int64_t, uint8_t, uint8_t*, bool);
+
+BooleanKernelFn SelectBooleanKernel(CompareOp op) {
+    switch (op) {
+        case CompareOp::EQ: return &BooleanKernel<CompareOp::EQ>;
+        case CompareOp::NE: return &BooleanKernel<CompareOp::NE>;
+        case CompareOp::LT: return &BooleanKernel<CompareOp::LT>;
+        case CompareOp::LE: return &BooleanKernel<CompareOp::LE>;
+        case CompareOp::GT: return &BooleanKernel<CompareOp::GT>;
+        case CompareOp::GE: return &BooleanKernel<CompareOp::GE>;
+    }
+    return nullptr;
+}
+
+// ==================== LIKE 模式 ====================
+
+// 编译后的 LIKE 模式：% 任意串，_ 单个字符（按 UTF-8 码点），\ 转义
+// 常见形态（精确、前缀、后缀、包含）退化为 string_view 操作，其余走通配匹配
+class LikeMatcher {
+ public:
+    explicit LikeMatcher(const std::string& pattern) {
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            char c = pattern[i];
+            if (c == '\\' && i + 1 < pattern.size()) {
+                tokens_.push_back({Token::LITERAL, pattern[++i]});
+            } else if (c == '%') {
+                if (tokens_.empty() || tokens_.back().type != Token::ANY) tokens_.push_back({Token::ANY, 0});
+            } else if (c == '_') {
+                tokens_.push_back({Token::ONE, 0});
+            } else {
+                tokens_.push_back({Token::LITERAL, c});
+            }
+        }
+
+        // 仅首尾出现 % 且没有 _ 时可以退化
+        size_t begin = 0, end = tokens_.size();
+        bool leading = begin < end && tokens_[begin].type == Token::ANY;
+        if (leading) ++begin;
+        bool trailing = end > begin && tokens_[end - 1].type == Token::ANY;
+        if (trailing) --end;
+        bool simple = true;
+        for (size_t i = begin; i < end; ++i) {
+            if (tokens_[i].type != Token::LITERAL) {
+                simple = false;
+                break;
+            }
+            needle_.push_back(tokens_[i].c);
+        }
+        if (!simple) {
+            mode_ = Mode::GENERAL;
+        } else if (leading && trailing) {
+            mode_ = Mode::CONTAINS;
+        } else if (leading) {
+            mode_ = Mode::SUFFIX;
+        } else if (trailing) {
+            mode_ = Mode::PREFIX;
+        } else {
+            mode_ = Mode::EXACT;
+        }
+    }
+
+    bool Match(std::string_view s) const {
+        switch (mode_) {
+            case Mode::EXACT:    return s == needle_;
+            case Mode::PREFIX:   return s.size() >= needle_.size() && s.compare(0, needle_.size(), needle_) == 0;
+            case Mode::SUFFIX:
+                return s.size() >= needle_.size() &&
+                       s.compare(s.size() - needle_.size(), needle_.size(), needle_) == 0;
+            case Mode::CONTAINS: return s.find(needle_) != std::string_view::npos;
+            case Mode::GENERAL:  return MatchGeneral(s);
+        }
+        return false;
+    }
+
+    int Cost() const {
+        switch (mode_) {
+            case Mode::EXACT:    return kCostBinary;
+            case Mode::PREFIX:
+            case Mode::SUFFIX:   return kCostBinary + 2;
+            case Mode::CONTAINS: return kCostBinary * 2;
+            case Mode::GENERAL:  return kCostBinary * 4;
+        }
+        return kCostBinary * 4;
+    }
+
+ private:
+    struct Token {
+        enum Type { LITERAL, ONE, ANY } type;
+        char c;
+    };
+    enum class Mode { EXACT, PREFIX, SUFFIX, CONTAINS, GENERAL };
+
+    static size_t Utf8Length(unsigned char lead) {
+        if ((lead & 0x80) == 0) return 1;
+        if ((lead & 0xE0) == 0xC0) return 2;
+        if ((lead & 0xF0) == 0xE0) return 3;
+        if ((lead & 0xF8) == 0xF0) return 4;
+        return 1;
+    }
+
+    // 贪心匹配 + 回溯到最近的 %，最坏 O(n*m)
+    bool MatchGeneral(std::string_view s) const {
+        const size_t n = tokens_.size();
+        size_t si = 0, ti = 0;
+        size_t star_ti = std::string::npos, star_si = 0;
+        while (si < s.size()) {
+            if (ti < n && tokens_[ti].type == Token::LITERAL && tokens_[ti].c == s[si]) {
+                ++ti;
+                ++si;
+            } else if (ti < n && tokens_[ti].type == Token::ONE) {
+                ++ti;
+                si = std::min(s.size(), si + Utf8Length(static_cast<unsigned char>(s[si])));
+            } else if (ti < n && tokens_[ti].type == Token::ANY) {
+                star_ti = ti++;
+                star_si = si;
+            } else if (star_ti != std::string::npos) {
+                star_si = std::min(s.size(), star_si + Utf8Length(static_cast<unsigned char>(s[star_si])));
+                ti = star_ti + 1;
+                si = star_si;
+            } else {
+                return false;
+            }
+        }
+        while (ti < n && tokens_[ti].type == Token::ANY) ++ti;
+        return ti == n;
+    }
+
+    std::vector<Token> tokens_;
+    std::string needle_;
+    Mode mode_ = Mode::GENERAL;
+};
+
+// ==================== 谓词实现 ====================
+
+// 叶子谓词：子类只负责值比较，null 处理统一在这里
+class LeafPredicate : public ColumnPredicate {
+ public:
+    explicit LeafPredicate(int column) : column_(column) {}
+
+    void Evaluate(const arrow::RecordBatch& batch, uint8_t* sel) const override {
+        auto data = batch.column_data(column_);
+        Run(*data, sel, false);
+        ApplyValidity(*data, sel);
+    }
+
+    void Refine(const arrow::RecordBatch& batch, uint8_t* sel) const override {
+        auto data = batch.column_data(column_);
+        Run(*data, sel, true);
+        ApplyValidity(*data, sel);
+    }
+
+ protected:
+    // refine=false：sel[i] = 谓词(i)；refine=true：sel[i] &= 谓词(i)
+    virtual void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const = 0;
+
+    int column_;
+};
+
+template <typename CType, typename CmpType>
+class NumericPredicate : public LeafPredicate {
+ public:
+    NumericPredicate(int column, NumericKernelFn<CType, CmpType> kernel, CmpType literal)
+        : LeafPredicate(column), kernel_(kernel), literal_(literal) {}
+
+    int Cost() const override { return kCostFixedWidth; }
+
+ protected:
+    void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const override {
+        kernel_(data.GetValues<CType>(1), data.length, literal_, sel, refine);
+    }
+
+ private:
+    NumericKernelFn<CType, CmpType> kernel_;
+    CmpType literal_;
+};
+
+// [NOT] BETWEEN：单次扫描完成上下界判断
+template <typename CType, typename CmpType>
+class NumericRangePredicate : public LeafPredicate {
+ public:
+    NumericRangePredicate(int column, CmpType lo, CmpType hi, bool negated)
+        : LeafPredicate(column), lo_(lo), hi_(hi), negated_(negated ? 1 : 0) {}
+
+    int Cost() const override { return kCostRange; }
+
+ protected:
+    void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const override {
+        const CType* values = data.GetValues<CType>(1);
+        const CmpType lo = lo_, hi = hi_;
+        const uint8_t neg = negated_;
+        if (refine) {
+            for (int64_t i = 0; i < data.length; ++i) {
+                CmpType v = static_cast<CmpType>(values[i]);
+                sel[i] &= static_cast<uint8_t>(((v >= lo) & (v <= hi)) ^ neg);
+            }
+        } else {
+            for (int64_t i = 0; i < data.length; ++i) {
+                CmpType v = static_cast<CmpType>(values[i]);
+                sel[i] = static_cast<uint8_t>(((v >= lo) & (v <= hi)) ^ neg);
+            }
+        }
+    }
+
+ private:
+    CmpType lo_;
+    CmpType hi_;
+    uint8_t negated_;
+};
+
+// [NOT] IN：列表通常很短，逐项比较比哈希更快且可向量化
+template <typename CType, typename CmpType>
+class NumericInPredicate : public LeafPredicate {
+ public:
+    NumericInPredicate(int column, std::vector<CmpType> list, bool negated)
+        : LeafPredicate(column), list_(std::move(list)), negated_(negated ? 1 : 0) {}
+
+    int Cost() const override { return kCostFixedWidth + static_cast<int>(list_.size()); }
+
+ protected:
+    void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const override {
+        const CType* values = data.GetValues<CType>(1);
+        const CmpType* list = list_.data();
+        const size_t count = list_.size();
+        for (int64_t i = 0; i < data.length; ++i) {
+            CmpType v = static_cast<CmpType>(values[i]);
+            uint8_t hit = 0;
+            for (size_t k = 0; k < count; ++k) hit |= static_cast<uint8_t>(v == list[k]);
+            hit ^= negated_;
+            sel[i] = refine ? static_cast<uint8_t>(sel[i] & hit) : hit;
+        }
+    }
+
+ private:
+    std::vector<CmpType> list_;
+    uint8_t negated_;
+};
+
+template <typename OffsetType>
+class BinaryPredicate : public LeafPredicate {
+ public:
+    BinaryPredicate(int column, BinaryKernelFn<OffsetType> kernel, std::string literal)
+        : LeafPredicate(column), kernel_(kernel), literal_(std::move(literal)) {}
+
+    int Cost() const override { return kCostBinary; }
+
+ protected:
+    void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const override {
+        kernel_(data, literal_, sel, refine);
+    }
+
+ private:
+    BinaryKernelFn<OffsetType> kernel_;
+    std::string literal_;
+};
+
+template <typename OffsetType>
+class BinaryInPredicate : public LeafPredicate {
+ public:
+    BinaryInPredicate(int column, std::vector<std::string> list, bool negated)
+        : LeafPredicate(column), list_(std::move(list)), negated_(negated) {
+        // list_ 构造完成后再建索引，避免 string 移动导致 view 失效
+        for (const auto& s : list_) set_.insert(s);
+    }
+
+    int Cost() const override { return kCostBinaryIn; }
+
+ protected:
+    void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const override {
+        ForEachView<OffsetType>(data, sel, refine,
+                                [this](std::string_view v) { return (set_.count(v) > 0) != negated_; });
+    }
+
+ private:
+    std::vector<std::string> list_;
+    std::unordered_set<std::string_view> set_;
+    bool negated_;
+};
+
+template <typename OffsetType>
+class LikePredicate : public LeafPredicate {
+ public:
+    LikePredicate(int column, const std::string& pattern, bool negated)
+        : LeafPredicate(column), matcher_(pattern), negated_(negated) {}
+
+    int Cost() const override { return matcher_.Cost(); }
+
+ protected:
+    void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const override {
+        ForEachView<OffsetType>(data, sel, refine,
+                                [this](std::string_view v) { return matcher_.Match(v) != negated_; });
+    }
+
+ private:
+    LikeMatcher matcher_;
+    bool negated_;
+};
+
+class BooleanPredicate : public LeafPredicate {
+ public:
+    BooleanPredicate(int column, BooleanKernelFn kernel, uint8_t literal)
+        : LeafPredicate(column), kernel_(kernel), literal_(literal) {}
+
+    int Cost() const override { return kCostFixedWidth; }
+
+ protected:
+    void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const override {
+        kernel_(data.buffers[1]->data(), data.offset, data.length, literal_, sel, refine);
+    }
+
+ private:
+    BooleanKernelFn kernel_;
+    uint8_t literal_;
+};
+
+// 结果与值无关的谓词（如无符号列与负数比较），只需处理 null
+class ConstantPredicate : public LeafPredicate {
+ public:
+    ConstantPredicate(int column, bool value) : LeafPredicate(column), value_(value) {}
+
+    int Cost() const override { return kCostConstant; }
+
+ protected:
+    void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const override {
+        if (!refine) {
+            std::memset(sel, value_ ? 1 : 0, static_cast<size_t>(data.length));
+        } else if (!value_) {
+            std::memset(sel, 0, static_cast<size_t>(data.length));
+        }
+    }
+
+ private:
+    bool value_;
+};
+
+// IS [NOT] NULL：只读有效位图
+class NullTestPredicate : public ColumnPredicate {
+ public:
+    NullTestPredicate(int column, bool want_null) : column_(column), want_null_(want_null) {}
+
+    void Evaluate(const arrow::RecordBatch& batch, uint8_t* sel) const override {
+        auto data = batch.column_data(column_);
+        Run(*data, sel, false);
+    }
+
+    void Refine(const arrow::RecordBatch& batch, uint8_t* sel) const override {
+        auto data = batch.column_data(column_);
+        Run(*data, sel, true);
+    }
+
+    int Cost() const override { return kCostNullTest; }
+
+ private:
+    void Run(const arrow::ArrayData& data, uint8_t* sel, bool refine) const {
+        const int64_t n = data.length;
+        if (data.type->id() == arrow::Type::NA || data.GetNullCount() == n) {
+            // 全为 null
+            if (!want_null_) std::memset(sel, 0, static_cast<size_t>(n));
+            else if (!refine) std::memset(sel, 1, static_cast<size_t>(n));
+            return;
+        }
+        if (data.buffers.empty() || !data.buffers[0] || data.GetNullCount() == 0) {
+            // 没有 null
+            if (want_null_) std::memset(sel, 0, static_cast<size_t>(n));
+            else if (!refine) std::memset(sel, 1, static_cast<size_t>(n));
+            return;
+        }
+        const uint8_t* bitmap = data.buffers[0]->data();
+        const uint8_t flip = want_null_ ? 1 : 0;
+        for (int64_t i = 0; i < n; ++i) {
+            uint8_t hit = static_cast<uint8_t>((arrow::bit_util::GetBit(bitmap, data.offset + i) ? 1 : 0) ^ flip);
+            sel[i] = refine ? static_cast<uint8_t>(sel[i] & hit) : hit;
+        }
+    }
+
+    int column_;
+    bool want_null_;
+};
+
+// AND：子项按代价升序，只在仍存活的行上继续收窄，掩码清空即停止
+class ConjunctionPredicate : public ColumnPredicate {
+ public:
+    explicit ConjunctionPredicate(std::vector<std::unique_ptr<ColumnPredicate>> children)
+        : children_(std::move(children)) {}
+
+    void Evaluate(const arrow::RecordBatch& batch, uint8_t* sel) const override {
+        const int64_t n = batch.num_rows();
+        children_[0]->Evaluate(batch, sel);
+        for (size_t k = 1; k < children_.size(); ++k) {
+            if (!AnySelected(sel, n)) return;
+            children_[k]->Refine(batch, sel);
+        }
+    }
+
+    void Refine(const arrow::RecordBatch& batch, uint8_t* sel) const override {
+        const int64_t n = batch.num_rows();
+        for (const auto& child : children_) {
+            if (!AnySelected(sel, n)) return;
+            child->Refine(batch, sel);
+        }
+    }
+
+    int Cost() const override {
+        int cost = 0;
+        for (const auto& child : children_) cost += child->Cost();
+        return cost;
+    }
+
+    std::vector<std::unique_ptr<ColumnPredicate>> TakeChildren() { return std::move(children_); }
+
+ private:
+    std::vector<std::unique_ptr<ColumnPredicate>> children_;
+};
+
+// OR：子项按代价升序，只在尚未命中的行上继续求值，全部命中即停止
+class DisjunctionPredicate : public ColumnPredicate {
+ public:
+    explicit DisjunctionPredicate(std::vector<std::unique_ptr<ColumnPredicate>> children)
+        : children_(std::move(children)) {}
+
+    void Evaluate(const arrow::RecordBatch& batch, uint8_t* sel) const override {
+        const int64_t n = batch.num_rows();
+        children_[0]->Evaluate(batch, sel);
+        SelectionMask pending;
+        for (size_t k = 1; k < children_.size(); ++k) {
+            if (AllSelected(sel, n)) return;
+            pending.resize(static_cast<size_t>(n));
+            for (int64_t i = 0; i < n; ++i) pending[i] = sel[i] ^ 1;
+            children_[k]->Refine(batch, pending.data());
+            for (int64_t i = 0; i < n; ++i) sel[i] |= pending[i];
+        }
+    }
+
+    int Cost() const override {
+        int cost = 0;
+        for (const auto& child : children_) cost += child->Cost();
+        return cost;
+    }
+
+    std::vector<std::unique_ptr<ColumnPredicate>> TakeChildren() { return std::move(children_); }
+
+ private:
+    std::vector<std::unique_ptr<ColumnPredicate>> children_;
+};
+
+// ==================== 编译 ====================
+
+int FindColumn(const arrow::Schema& schema, const std::string& column, std::string* error) {
+    for (int i = 0; i < schema.num_fields(); ++i) {
+        if (schema.field(i)->name() == column) return i;
+    }
+    if (error) *error = "column not found: " + column;
+    return -1;
+}
+
+bool IsIntegerBacked(arrow::Type::type id) {
+    switch (id) {
+        case arrow::Type::INT8:
+        case arrow::Type::INT16:
+        case arrow::Type::INT32:
+        case arrow::Type::INT64:
+        case arrow::Type::UINT8:
+        case arrow::Type::UINT16:
+        case arrow::Type::UINT32:
+        case arrow::Type::UINT64:
+        case arrow::Type::DATE32:
+        case arrow::Type::DATE64:
+        case arrow::Type::TIME32:
+        case arrow::Type::TIME64:
+        case arrow::Type::TIMESTAMP:
+        case arrow::Type::DURATION:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 按列的物理类型分发：fn 以 CType 的零值为参数被调用一次
+template <typename Fn>
+auto DispatchNumeric(arrow::Type::type id, Fn&& fn) -> decltype(fn(int64_t{})) {
+    switch (id) {
+        case arrow::Type::INT8:    return fn(int8_t{});
+        case arrow::Type::INT16:   return fn(int16_t{});
+        case arrow::Type::INT32:
+        case arrow::Type::DATE32:
+        case arrow::Type::TIME32:  return fn(int32_t{});
+        case arrow::Type::INT64:
+        case arrow::Type::DATE64:
+        case arrow::Type::TIME64:
+        case arrow::Type::TIMESTAMP:
+        case arrow::Type::DURATION: return fn(int64_t{});
+        case arrow::Type::UINT8:   return fn(uint8_t{});
+        case arrow::Type::UINT16:  return fn(uint16_t{});
+        case arrow::Type::UINT32:  return fn(uint32_t{});
+        case arrow::Type::UINT64:  return fn(uint64_t{});
+        case arrow::Type::FLOAT:   return fn(float{});
+        case arrow::Type::DOUBLE:  return fn(double{});
+        default:                   return nullptr;
+    }
+}
+
+// 整数列比较：字面量优先按整数比较，带小数时退化为 double 比较
+template <typename CType>
+std::unique_ptr<ColumnPredicate> MakeNumericComparison(int column, CompareOp op, const std::string& literal) {
+    if constexpr (std::is_integral_v<CType>) {
+        using IntType = std::conditional_t<std::is_signed_v<CType>, int64_t, uint64_t>;
+        IntType v = 0;
+        if (ParseInteger(literal, &v)) {
+            return std::make_unique<NumericPredicate<CType, IntType>>(
+                column, SelectNumericKernel<CType, IntType>(op), v);
+        }
+        if constexpr (std::is_unsigned_v<CType>) {
+            int64_t neg = 0;
+            if (ParseInt64(literal, &neg) && neg < 0) {
+                // 无符号值恒大于负数
+                return std::make_unique<ConstantPredicate>(
+                    column, op == CompareOp::NE || op == CompareOp::GT || op == CompareOp::GE);
+            }
+        }
+    }
+    double d = 0;
+    if (!ParseDouble(literal, &d)) return nullptr;
+    return std::make_unique<NumericPredicate<CType, double>>(column, SelectNumericKernel<CType, double>(op), d);
+}
+
+template <typename CType>
+std::unique_ptr<ColumnPredicate> MakeNumericRange(int column, const std::string& lo, const std::string& hi,
+                                                  bool negated) {
+    if constexpr (std::is_integral_v<CType>) {
+        using IntType = std::conditional_t<std::is_signed_v<CType>, int64_t, uint64_t>;
+        IntType lo_v = 0, hi_v = 0;
+        if (ParseInteger(lo, &lo_v) && ParseInteger(hi, &hi_v)) {
+            return std::make_unique<NumericRangePredicate<CType, IntType>>(column, lo_v, hi_v, negated);
+        }
+    }
+    double lo_d = 0, hi_d = 0;
+    if (!ParseDouble(lo, &lo_d) || !ParseDouble(hi, &hi_d)) return nullptr;
+    return std::make_unique<NumericRangePredicate<CType, double>>(column, lo_d, hi_d, negated);
+}
+
+template <typename CType>
+std::unique_ptr<ColumnPredicate> MakeNumericIn(int column, const std::vector<std::string>& values, bool negated) {
+    using CmpType = std::conditional_t<std::is_integral_v<CType>,
+                                       std::conditional_t<std::is_signed_v<CType>, int64_t, uint64_t>, double>;
+    std::vector<CmpType> list;
+    list.reserve(values.size());
+    for (const auto& s : values) {
+        CmpType v{};
+        if constexpr (std::is_integral_v<CType>) {
+            if (ParseInteger(s, &v)) {
+                list.push_back(v);
+                continue;
+            }
+        }
+        double d = 0;
+        if (!ParseDouble(s, &d)) return nullptr;
+        if constexpr (std::is_integral_v<CType>) {
+            // 整数列：非整数值或超出范围的值不可能相等，直接丢弃
+            if (std::trunc(d) != d || d < static_cast<double>(std::numeric_limits<CmpType>::lowest()) ||
+                d > static_cast<double>(std::numeric_limits<CmpType>::max())) {
+                continue;
+            }
+        }
+        list.push_back(static_cast<CmpType>(d));
+    }
+    if (list.empty()) return std::make_unique<ConstantPredicate>(column, negated);
+    return std::make_unique<NumericInPredicate<CType, CmpType>>(column, std::move(list), negated);
+}
+
+std::unique_ptr<ColumnPredicate> MakeJunction(bool conjunction,
+                                              std::vector<std::unique_ptr<ColumnPredicate>> children) {
+    // 展平同类子项（NOT 下推后可能出现 AND 套 AND），便于整体按代价排序
+    std::vector<std::unique_ptr<ColumnPredicate>> flat;
+    for (auto& child : children) {
+        std::vector<std::unique_ptr<ColumnPredicate>> grand;
+        if (conjunction) {
+            if (auto* c = dynamic_cast<ConjunctionPredicate*>(child.get())) grand = c->TakeChildren();
+        } else {
+            if (auto* d = dynamic_cast<DisjunctionPredicate*>(child.get())) grand = d->TakeChildren();
+        }
+        if (grand.empty()) {
+            flat.push_back(std::move(child));
+        } else {
+            for (auto& g : grand) flat.push_back(std::move(g));
+        }
+    }
+    std::stable_sort(flat.begin(), flat.end(),
+                     [](const std::unique_ptr<ColumnPredicate>& a, const std::unique_ptr<ColumnPredicate>& b) {
+                         return a->Cost() < b->Cost();
+                     });
+    if (flat.size() == 1) return std::move(flat[0]);
+    if (conjunction) return std::make_unique<ConjunctionPredicate>(std::move(flat));
+    return std::make_unique<DisjunctionPredicate>(std::move(flat));
+}
+
+// 无专用内核的类型（如 boolean、string 的 BETWEEN）展开为比较的组合
+std::unique_ptr<ColumnPredicate> ExpandToComparisons(const arrow::Schema& schema, const std::string& column,
+                                                     const std::vector<std::pair<CompareOp, std::string>>& terms,
+                                                     bool conjunction, std::string* error) {
+    std::vector<std::unique_ptr<ColumnPredicate>> children;
+    for (const auto& term : terms) {
+        auto p = ColumnarFilter::CompileComparison(schema, column, term.first, term.second, error);
+        if (!p) return nullptr;
+        children.push_back(std::move(p));
+    }
+    return MakeJunction(conjunction, std::move(children));
+}
+
+std::unique_ptr<ColumnPredicate> CompileIn(const arrow::Schema& schema, const std::string& column,
+                                           const std::vector<std::string>& values, bool negated,
+                                           std::string* error) {
+    int col = FindColumn(schema, column, error);
+    if (col < 0) return nullptr;
+    if (values.empty()) {
+        if (error) *error = "empty IN list for column " + column;
+        return nullptr;
+    }
+
+    const auto& type = schema.field(col)->type();
+    std::unique_ptr<ColumnPredicate> predicate;
+    if (IsIntegerBacked(type->id()) || type->id() == arrow::Type::FLOAT || type->id() == arrow::Type::DOUBLE) {
+        predicate = DispatchNumeric(type->id(), [&](auto zero) -> std::unique_ptr<ColumnPredicate> {
+            return MakeNumericIn<decltype(zero)>(col, values, negated);
+        });
+    } else if (type->id() == arrow::Type::STRING || type->id() == arrow::Type::BINARY) {
+        return std::make_unique<BinaryInPredicate<int32_t>>(col, values, negated);
+    } else if (type->id() == arrow::Type::LARGE_STRING || type->id() == arrow::Type::LARGE_BINARY) {
+        return std::make_unique<BinaryInPredicate<int64_t>>(col, values, negated);
+    } else {
+        // IN → OR(=)，NOT IN → AND(!=)
+        std::vector<std::pair<CompareOp, std::string>> terms;
+        for (const auto& v : values) terms.emplace_back(negated ? CompareOp::NE : CompareOp::EQ, v);
+        return ExpandToComparisons(schema, column, terms, negated, error);
+    }
+    if (!predicate && error) *error = "invalid IN list for column " + column + " (" + type->ToString() + ")";
+    return predicate;
+}
+
+std::unique_ptr<ColumnPredicate> CompileBetween(const arrow::Schema& schema, const std::string& column,
+                                                const std::vector<std::string>& values, bool negated,
+                                                std::string* error) {
+    int col = FindColumn(schema, column, error);
+    if (col < 0) return nullptr;
+    if (values.size() != 2) {
+        if (error) *error = "BETWEEN requires two bounds for column " + column;
+        return nullptr;
+    }
+
+    const auto& type = schema.field(col)->type();
+    if (IsIntegerBacked(type->id()) || type->id() == arrow::Type::FLOAT || type->id() == arrow::Type::DOUBLE) {
+        auto predicate = DispatchNumeric(type->id(), [&](auto zero) -> std::unique_ptr<ColumnPredicate> {
+            return MakeNumericRange<decltype(zero)>(col, values[0], values[1], negated);
+        });
+        if (!predicate && error) {
+            *error = "invalid BETWEEN bounds for column " + column + " (" + type->ToString() + ")";
+        }
+        return predicate;
+    }
+    // BETWEEN → AND(>=, <=)，NOT BETWEEN → OR(<, >)
+    if (negated) {
+        return ExpandToComparisons(schema, column, {{CompareOp::LT, values[0]}, {CompareOp::GT, values[1]}},
+                                   false, error);
+    }
+    return ExpandToComparisons(schema, column, {{CompareOp::GE, values[0]}, {CompareOp::LE, values[1]}},
+                               true, error);
+}
+
+std::unique_ptr<ColumnPredicate> CompileLike(const arrow::Schema& schema, const std::string& column,
+                                             const std::vector<std::string>& values, bool negated,
+                                             std::string* error) {
+    int col = FindColumn(schema, column, error);
+    if (col < 0) return nullptr;
+    if (values.size() != 1) {
+        if (error) *error = "LIKE requires one pattern for column " + column;
+        return nullptr;
+    }
+
+    const auto& type = schema.field(col)->type();
+    switch (type->id()) {
+        case arrow::Type::STRING:
+        case arrow::Type::BINARY:
+            return std::make_unique<LikePredicate<int32_t>>(col, values[0], negated);
+        case arrow::Type::LARGE_STRING:
+        case arrow::Type::LARGE_BINARY:
+            return std::make_unique<LikePredicate<int64_t>>(col, values[0], negated);
+        default:
+            if (error) *error = "LIKE requires a string column: " + column + " (" + type->ToString() + ")";
+            return nullptr;
+    }
+}
+
+// negate 表示外层有奇数个 NOT：连接词按德摩根律互换，叶子取反
+std::unique_ptr<ColumnPredicate> CompileNode(const WhereExpr& expr, const arrow::Schema& schema, bool negate,
+                                             std::string* error) {
+    switch (expr.kind) {
+        case WhereExprKind::AND:
+        case WhereExprKind::OR: {
+            if (expr.children.empty()) break;
+            std::vector<std::unique_ptr<ColumnPredicate>> children;
+            children.reserve(expr.children.size());
+            for (const auto& child : expr.children) {
+                if (!child) break;
+                auto p = CompileNode(*child, schema, negate, error);
+                if (!p) return nullptr;
+                children.push_back(std::move(p));
+            }
+            if (children.size() != expr.children.size()) break;
+            bool conjunction = (expr.kind == WhereExprKind::AND) != negate;
+            return MakeJunction(conjunction, std::move(children));
+        }
+        case WhereExprKind::NOT:
+            if (expr.children.size() != 1 || !expr.children[0]) break;
+            return CompileNode(*expr.children[0], schema, !negate, error);
+        case WhereExprKind::COMPARE:
+            if (expr.values.size() != 1) break;
+            return ColumnarFilter::CompileComparison(schema, expr.column, negate ? NegateOp(expr.op) : expr.op,
+                                                     expr.values[0], error);
+        case WhereExprKind::IN:
+            return CompileIn(schema, expr.column, expr.values, expr.negated != negate, error);
+        case WhereExprKind::BETWEEN:
+            return CompileBetween(schema, expr.column, expr.values, expr.negated != negate, error);
+        case WhereExprKind::LIKE:
+            return CompileLike(schema, expr.column, expr.values, expr.negated != negate, error);
+        case WhereExprKind::IS_NULL: {
+            int col = FindColumn(schema, expr.column, error);
+            if (col < 0) return nullptr;
+            return std::make_unique<NullTestPredicate>(col, expr.negated == negate);
+        }
+    }
+    if (error) *error = "malformed WHERE expression";
+    return nullptr;
+}
+
+// ==================== Gather ====================
+
+arrow::Status GatherValidity(const arrow::ArrayData& in, const std::vector<int64_t>& indices,
+                             std::shared_ptr<arrow::Buffer>* out, int64_t* null_count) {
+    *out = nullptr;
+    *null_count = 0;
+    if (in.buffers.empty() || !in.buffers[0] || in.GetNullCount() == 0) return arrow::Status::OK();
+
+    int64_t n = static_cast<int64_t>(indices.size());
+    auto result = arrow::AllocateEmptyBitmap(n);
+    if (!result.ok()) return result.status();
+    std::shared_ptr<arrow::Buffer> bitmap = std::move(*result);
+
+    const uint8_t* src = in.buffers[0]->data();
+    uint8_t* dst = bitmap->mutable_data();
+    int64_t nulls = 0;
+    for (int64_t k = 0; k < n; ++k) {
+        bool valid = arrow::bit_util::GetBit(src, in.offset + indices[k]);
+        arrow::bit_util::SetBitTo(dst, k, valid);
+        nulls += valid ? 0 : 1;
+    }
+    *out = std::move(bitmap);
+    *null_count = nulls;
+    return arrow::Status::OK();
+}
+
+template <typename T>
+void GatherValues(const T* src, const std::vector<int64_t>& indices, T* dst) {
+    const int64_t n = static_cast<int64_t>(indices.size());
+    for (int64_t k = 0; k < n; ++k) dst[k] = src[indices[k]];
+}
+
+arrow::Status GatherFixedWidth(const arrow::ArrayData& in, int byte_width, const std::vector<int64_t>& indices,
+                               std::shared_ptr<arrow::ArrayData>* out) {
+    int64_t n = static_cast<int64_t>(indices.size());
+    auto result = arrow::AllocateBuffer(n * byte_width);
+    if (!result.ok()) return result.status();
+    std::shared_ptr<arrow::Buffer> values = std::move(*result);
+
+    const uint8_t* src = in.buffers[1]->data() + in.offset * byte_width;
+    uint8_t* dst = values->mutable_data();
+    switch (byte_width) {
+        case 1: GatherValues(src, indices, dst); break;
+        case 2:
+            GatherValues(reinterpret_cast<const uint16_t*>(src), indices, reinterpret_cast<uint16_t*>(dst));
+            break;
+        case 4:
+            GatherValues(reinterpret_cast<const uint32_t*>(src), indices, reinterpret_cast<uint32_t*>(dst));
+            break;
+        case 8:
+            GatherValues(reinterpret_cast<const uint64_t*>(src), indices, reinterpret_cast<uint64_t*>(dst));
+            break;
+        default:
+            for (int64_t k = 0; k < n; ++k) {
+                std::memcpy(dst + k * byte_width, src + indices[k] * byte_width, static_cast<size_t>(byte_width));
+            }
+            break;
+    }
+
+    std::shared_ptr<arrow::Buffer> bitmap;
+    int64_t null_count = 0;
+    auto status = GatherValidity(in, indices, &bitmap, &null_count);
+    if (!status.ok()) return status;
+
+    *out = arrow::ArrayData::Make(in.type, n, {std::move(bitmap), std::move(values)}, null_count);
+    return arrow::Status::OK();
+}
+
+arrow::Status GatherBoolean(const arrow::ArrayData& in, const std::vector<int64_t>& indices,
+                            std::shared_ptr<arrow::ArrayData>* out) {
+    int64_t n = static_cast<int64_t>(indices.size());
+    auto result = arrow::AllocateEmptyBitmap(n);
+    if (!result.ok()) return result.status();
+    std::shared_ptr<arrow::Buffer> values = std::move(*result);
+
+    const uint8_t* src = in.buffers[1]->data();
+    uint8_t* dst = values->mutable_data();
+    for (int64_t k = 0; k < n; ++k) {
+        arrow::bit_util::SetBitTo(dst, k, arrow::bit_util::GetBit(src, in.offset + indices[k]));
+    }
+
+    std::shared_ptr<arrow::Buffer> bitmap;
+    int64_t null_count = 0;
+    auto status = GatherValidity(in, indices, &bitmap, &null_count);
+    if (!status.ok()) return status;
+
+    *out = arrow::ArrayData::Make(in.type, n, {std::move(bitmap), std::move(values)}, null_count);
+    return arrow::Status::OK();
+}
+
+template <typename OffsetType>
+arrow::Status GatherBinary(const arrow::ArrayData& in, const std::vector<int64_t>& indices,
+                           std::shared_ptr<arrow::ArrayData>* out) {
+    int64_t n = static_cast<int64_t>(indices.size());
+    const OffsetType* src_offsets = in.GetValues<OffsetType>(1);
+    const uint8_t* src_data = in.buffers[2] ? in.buffers[2]->data() : nullptr;
+
+    // 先算总字节数，一次分配数据缓冲区
+    int64_t total = 0;
+    for (int64_t k = 0; k < n; ++k) {
+        int64_t i = indices[k];
+        total += static_cast<int64_t>(src_offsets[i + 1] - src_offsets[i]);
+    }
+
+    auto offsets_result = arrow::AllocateBuffer((n + 1) * static_cast<int64_t>(sizeof(OffsetType)));
+    if (!offsets_result.ok()) return offsets_result.status();
+    std::shared_ptr<arrow::Buffer> offsets = std::move(*offsets_result);
+    auto data_result = arrow::AllocateBuffer(total);
+    if (!data_result.ok()) return data_result.status();
+    std::shared_ptr<arrow::Buffer> data = std::move(*data_result);
+
+    auto* dst_offsets = reinterpret_cast<OffsetType*>(offsets->mutable_data());
+    uint8_t* dst_data = data->mutable_data();
+    OffsetType pos = 0;
+    dst_offsets[0] = 0;
+    for (int64_t k = 0; k < n; ++k) {
+        int64_t i = indices[k];
+        OffsetType len = src_offsets[i + 1] - src_offsets[i];
+        if (len > 0) std::memcpy(dst_data + pos, src_data + src_offsets[i], static_cast<size_t>(len));
+        pos += len;
+        dst_offsets[k + 1] = pos;
+    }
+
+    std::shared_ptr<arrow::Buffer> bitmap;
+    int64_t null_count = 0;
+    auto status = GatherValidity(in, indices, &bitmap, &null_count);
+    if (!status.ok()) return status;
+
+    *out = arrow::ArrayData::Make(in.type, n, {std::move(bitmap), std::move(offsets), std::move(data)},
+                                  null_count);
+    return arrow::Status::OK();
+}
+
+arrow::Status GatherArray(const arrow::ArrayData& in, const std::vector<int64_t>& indices,
+                          std::shared_ptr<arrow::ArrayData>* out) {
+    int64_t n = static_cast<int64_t>(indices.size());
+    switch (in.type->id()) {
+        case arrow::Type::NA:
+            *out = arrow::ArrayData::Make(in.type, n, {nullptr}, n);
+            return arrow::Status::OK();
+        case arrow::Type::BOOL:
+            return GatherBoolean(in, indices, out);
+        case arrow::Type::STRING:
+        case arrow::Type::BINARY:
+            return GatherBinary<int32_t>(in, indices, out);
+        case arrow::Type::LARGE_STRING:
+        case arrow::Type::LARGE_BINARY:
+            return GatherBinary<int64_t>(in, indices, out);
+        case arrow::Type::DICTIONARY:
+            break;
+        default: {
+            auto* fixed = dynamic_cast<const arrow::FixedWidthType*>(in.type.get());
+            if (fixed && fixed->bit_width() > 0 && fixed->bit_width() % 8 == 0) {
+                return GatherFixedWidth(in, fixed->bit_width() / 8, indices, out);
+            }
+            break;
+        }
+    }
+    return arrow::Status::NotImplemented("filter gather not supported for type ", in.type->ToString());
+}
+
+}  // namespace
+
+// ==================== ColumnarFilter ====================
+
+void ColumnPredicate::Refine(const arrow::RecordBatch& batch, uint8_t* sel) const {
+    const int64_t n = batch.num_rows();
+    SelectionMask tmp(static_cast<size_t>(n));
+    Evaluate(batch, tmp.data());
+    for (int64_t i = 0; i < n; ++i) sel[i] &= tmp[i];
+}
+
+std::unique_ptr<ColumnPredicate> ColumnarFilter::CompileComparison(const arrow::Schema& schema,
+                                                                   const std::string& column, CompareOp op,
+                                                                   const std::string& literal,
+                                                                   std::string* error) {
+    int col = FindColumn(schema, column, error);
+    if (col < 0) return nullptr;
+
+    const auto& type = schema.field(col)->type();
+    std::unique_ptr<ColumnPredicate> predicate;
+    switch (type->id()) {
+        case arrow::Type::STRING:
+        case arrow::Type::BINARY:
+            return std::make_unique<BinaryPredicate<int32_t>>(col, SelectBinaryKernel<int32_t>(op), literal);
+        case arrow::Type::LARGE_STRING:
+        case arrow::Type::LARGE_BINARY:
+            return std::make_unique<BinaryPredicate<int64_t>>(col, SelectBinaryKernel<int64_t>(op), literal);
+        case arrow::Type::BOOL: {
+            uint8_t v = 0;
+            if (ParseBool(literal, &v)) {
+                predicate = std::make_unique<BooleanPredicate>(col, SelectBooleanKernel(op), v);
+            }
+            break;
+        }
+        default:
+            if (!IsIntegerBacked(type->id()) && type->id() != arrow::Type::FLOAT &&
+                type->id() != arrow::Type::DOUBLE) {
+                if (error) *error = "unsupported column type for filter: " + column + " (" + type->ToString() + ")";
+                return nullptr;
+            }
+            predicate = DispatchNumeric(type->id(), [&](auto zero) -> std::unique_ptr<ColumnPredicate> {
+                return MakeNumericComparison<decltype(zero)>(col, op, literal);
+            });
+            break;
+    }
+
+    if (!predicate && error) {
+        *error = "invalid literal '" + literal + "' for column " + column + " (" + type->ToString() + ")";
+    }
+    return predicate;
+}
+
+std::unique_ptr<ColumnPredicate> ColumnarFilter::Compile(const WhereExpr& expr, const arrow::Schema& schema,
+                                                         std::string* error) {
+    return CompileNode(expr, schema, false, error);
+}
+
+std::unique_ptr<ColumnPredicate> ColumnarFilter::Compile(const char* condition, const arrow::Schema& schema,
+                                                         std::string* error) {
+    if (!condition || !*condition) {
+        if (error) *error = "empty filter condition";
+        return nullptr;
+    }
+    std::string parse_error;
+    auto expr = SqlParser::ParseWhere(condition, &parse_error);
+    if (!expr) {
+        if (error) *error = "invalid filter condition: " + parse_error;
+        return nullptr;
+    }
+    return Compile(*expr, schema, error);
+}
+
+int64_t ColumnarFilter::CountSelected(const uint8_t* sel, int64_t length) {
+    int64_t count = 0;
+    for (int64_t i = 0; i < length; ++i) count += sel[i];
+    return count;
+}
+
+std::shared_ptr<arrow::RecordBatch> ColumnarFilter::Gather(const std::shared_ptr<arrow::RecordBatch>& batch,
+                                                           const uint8_t* sel, std::string* error) {
+    if (!batch || !sel) {
+        if (error) *error = "Gather: null batch or selection";
+        return nullptr;
+    }
+
+    const int64_t rows = batch->num_rows();
+    const int64_t selected = CountSelected(sel, rows);
+    if (selected == rows) return batch;
+
+    // 掩码 → 行号列表，各列共用；无分支写入，末尾多留一个槽位
+    std::vector<int64_t> indices(static_cast<size_t>(selected) + 1);
+    int64_t j = 0;
+    for (int64_t i = 0; i < rows; ++i) {
+        indices[j] = i;
+        j += sel[i];
+    }
+    indices.resize(static_cast<size_t>(selected));
+
+    std::vector<std::shared_ptr<arrow::ArrayData>> columns;
+    columns.reserve(batch->num_columns());
+    for (int c = 0; c < batch->num_columns(); ++c) {
+        std::shared_ptr<arrow::ArrayData> out;
+        auto status = GatherArray(*batch->column_data(c), indices, &out);
+        if (!status.ok()) {
+            if (error) *error = "Gather column '" + batch->schema()->field(c)->name() + "' failed: " + status.ToString();
+            return nullptr;
+        }
+        columns.push_back(std::move(out));
+    }
+    return arrow::RecordBatch::Make(batch->schema(), selected, std::move(columns));
+}
+
+std::shared_ptr<arrow::RecordBatch> ColumnarFilter::Apply(const std::shared_ptr<arrow::RecordBatch>& batch,
+                                                          const ColumnPredicate& predicate, std::string* error) {
+    if (!batch) {
+        if (error) *error = "Apply: null batch";
+        return nullptr;
+    }
+    SelectionMask sel(static_cast<size_t>(batch->num_rows()));
+    predicate.Evaluate(*batch, sel.data());
+    return Gather(batch, sel.data(), error);
+}
+
+}  // namespace flowsql
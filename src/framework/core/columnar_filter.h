@@ -0,0 +1,74 @@
+#ifndef _FLOWSQL_FRAMEWORK_CORE_COLUMNAR_FILTER_H_
+#define _FLOWSQL_FRAMEWORK_CORE_COLUMNAR_FILTER_H_
+
+#include <arrow/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "where_expr.h"
+
+namespace flowsql {
+
+// 选择掩码：每行 1 字节，1 表示命中，0 表示丢弃
+// 用字节而非位图：内核是无分支的逐元素写，编译器可直接自动向量化
+using SelectionMask = std::vector<uint8_t>;
+
+// ColumnPredicate — 编译后的列谓词
+// 条件只解析一次，字面量预先转换为列的原生类型，求值时直接扫描 Arrow 值缓冲区，
+// 不经过 FieldValue，也不在行循环内判断操作符
+class ColumnPredicate {
+ public:
+    virtual ~ColumnPredicate() = default;
+
+    // 对 batch 求值，结果写入 sel[0, num_rows)
+    // null 按 SQL 语义视为不满足（IS NULL 除外）
+    virtual void Evaluate(const arrow::RecordBatch& batch, uint8_t* sel) const = 0;
+
+    // 在已有掩码上收窄：sel[i] &= 谓词(i)
+    // 代价高的谓词（字符串、LIKE 等）跳过已为 0 的行；默认实现求值到临时掩码再合并
+    virtual void Refine(const arrow::RecordBatch& batch, uint8_t* sel) const;
+
+    // 估算的单行求值代价，AND/OR 按代价升序求值
+    virtual int Cost() const = 0;
+};
+
+// ColumnarFilter — 列式过滤引擎
+// 流程：Compile（一次）→ Evaluate（类型化内核，产出选择掩码）→ Gather（按掩码收集各列）
+// 注：Arrow 以 ARROW_COMPUTE=OFF 构建，没有 compute::Filter/Take，Gather 为自实现的类型化收集
+class ColumnarFilter {
+ public:
+    // 编译单列比较谓词；列不存在、类型不支持或字面量无法转换时返回 nullptr
+    static std::unique_ptr<ColumnPredicate> CompileComparison(const arrow::Schema& schema,
+                                                              const std::string& column, CompareOp op,
+                                                              const std::string& literal,
+                                                              std::string* error = nullptr);
+
+    // 编译表达式树
+    // NOT 在编译期下推到叶子（null 参与的比较取反后仍不命中，保持 SQL 三值逻辑），
+    // AND/OR 展平后按代价升序排列，求值时短路：AND 只在存活行上继续，OR 只在未命中行上继续
+    static std::unique_ptr<ColumnPredicate> Compile(const WhereExpr& expr, const arrow::Schema& schema,
+                                                    std::string* error = nullptr);
+
+    // 编译条件文本（SqlParser::ParseWhere + Compile）
+    static std::unique_ptr<ColumnPredicate> Compile(const char* condition, const arrow::Schema& schema,
+                                                    std::string* error = nullptr);
+
+    // 统计掩码中命中的行数
+    static int64_t CountSelected(const uint8_t* sel, int64_t length);
+
+    // 按选择掩码收集行，生成新的 RecordBatch；全部命中时直接返回原 batch（零拷贝）
+    static std::shared_ptr<arrow::RecordBatch> Gather(const std::shared_ptr<arrow::RecordBatch>& batch,
+                                                      const uint8_t* sel, std::string* error = nullptr);
+
+    // 求值 + 收集
+    static std::shared_ptr<arrow::RecordBatch> Apply(const std::shared_ptr<arrow::RecordBatch>& batch,
+                                                     const ColumnPredicate& predicate,
+                                                     std::string* error = nullptr);
+};
+
+}  // namespace flowsql
+
+#endif  // _FLOWSQL_FRAMEWORK_CORE_COLUMNAR_FILTER_H_
@@ -3,11 +3,16 @@
 #include <arrow/builder.h>
 #include <arrow/type.h>
 #include <rapidjson/document.h>
-#include <rapidjson/stringbuffer.h>
-#include <rapidjson/writer.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <stdexcept>
 
+#include "columnar_filter.h"
+#include "json_writer.h"
+#include "sql_parser.h"
+
 namespace flowsql {
 
 std::shared_ptr<arrow::DataType> ToArrowType(DataType type) {
@@ -184,52 +189,75 @@ static DataType StringToDataType(const std::string& s) {
     return DataType::STRING;
 }
 
+// 将 [offset, offset + limit) 裁剪到实际行范围内，limit < 0 表示到末尾
+static void ClampRange(int64_t rows, int64_t offset, int64_t limit, int64_t* begin, int64_t* end) {
+    *begin = std::min(std::max<int64_t>(offset, 0), rows);
+    *end = (limit < 0) ? rows : std::min(rows, *begin + limit);
+}
+
 std::string DataFrame::ToJson() const {
+    return ToJson(0, -1);
+}
+
+// 列类型化序列化：JsonWriter 直接读取 Arrow 缓冲区写入预分配的输出，不经过 FieldValue
+std::string DataFrame::ToJson(int64_t offset, int64_t limit, JsonLayout layout) const {
     if (pending_rows_ > 0) {
         Finalize();
     }
-    rapidjson::StringBuffer sb;
-    rapidjson::Writer<rapidjson::StringBuffer> w(sb);
-    w.StartObject();
-
-    // columns
-    w.Key("columns");
-    w.StartArray();
-    for (auto& f : schema_) w.String(f.name.c_str());
-    w.EndArray();
-
-    // types
-    w.Key("types");
-    w.StartArray();
-    for (auto& f : schema_) w.String(DataTypeToString(f.type));
-    w.EndArray();
-
-    // data
-    w.Key("data");
-    w.StartArray();
-    int32_t rows = batch_ ? static_cast<int32_t>(batch_->num_rows()) : 0;
-    for (int32_t r = 0; r < rows; ++r) {
-        w.StartArray();
-        for (size_t c = 0; c < schema_.size(); ++c) {
-            auto val = ExtractValue(batch_->column(static_cast<int>(c)), r);
-            std::visit([&w](auto&& v) {
-                using T = std::decay_t<decltype(v)>;
-                if constexpr (std::is_same_v<T, int32_t>) w.Int(v);
-                else if constexpr (std::is_same_v<T, int64_t>) w.Int64(v);
-                else if constexpr (std::is_same_v<T, uint32_t>) w.Uint(v);
-                else if constexpr (std::is_same_v<T, uint64_t>) w.Uint64(v);
-                else if constexpr (std::is_same_v<T, float>) w.Double(v);
-                else if constexpr (std::is_same_v<T, double>) w.Double(v);
-                else if constexpr (std::is_same_v<T, std::string>) w.String(v.c_str());
-                else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) w.String(reinterpret_cast<const char*>(v.data()), v.size());
-                else if constexpr (std::is_same_v<T, bool>) w.Bool(v);
-            }, val);
+    int64_t begin = 0, end = 0;
+    ClampRange(batch_ ? batch_->num_rows() : 0, offset, limit, &begin, &end);
+
+    std::unique_ptr<JsonWriter> writer;
+    size_t estimate = 64;
+    for (auto& f : schema_) estimate += f.name.size() + 16;
+    if (batch_) {
+        writer = std::make_unique<JsonWriter>(*batch_);
+        estimate += writer->EstimateSize(begin, end);
+    }
+
+    std::string out;
+    {
+        JsonBuffer buf(&out, estimate);
+        buf.Append("{\"columns\":[", 12);
+        for (size_t i = 0; i < schema_.size(); ++i) {
+            if (i) buf.Put(',');
+            buf.String(schema_[i].name.data(), schema_[i].name.size());
+        }
+        buf.Append("],\"types\":[", 11);
+        for (size_t i = 0; i < schema_.size(); ++i) {
+            if (i) buf.Put(',');
+            const char* type = DataTypeToString(schema_[i].type);
+            buf.String(type, std::strlen(type));
+        }
+        buf.Append("],\"data\":", 9);
+        if (!writer) {
+            if (layout == JsonLayout::COLUMNS) buf.Append("{}", 2);
+            else buf.Append("[]", 2);
+        } else if (layout == JsonLayout::COLUMNS) {
+            writer->WriteColumns(begin, end, &buf);
+        } else {
+            writer->WriteRows(begin, end, &buf);
         }
-        w.EndArray();
+        buf.Put('}');
     }
-    w.EndArray();
-    w.EndObject();
-    return sb.GetString();
+    return out;
+}
+
+std::string DataFrame::ToNdjson(int64_t offset, int64_t limit) const {
+    if (pending_rows_ > 0) {
+        Finalize();
+    }
+    int64_t begin = 0, end = 0;
+    ClampRange(batch_ ? batch_->num_rows() : 0, offset, limit, &begin, &end);
+    std::string out;
+    if (!batch_ || begin >= end) return out;
+
+    JsonWriter writer(*batch_);
+    {
+        JsonBuffer buf(&out, writer.EstimateSize(begin, end));
+        writer.WriteLines(begin, end, &buf);
+    }
+    return out;
 }
 
 bool DataFrame::FromJson(const std::string& json) {
@@ -241,7 +269,7 @@ bool DataFrame::FromJson(const std::string& json) {
     auto& cols = doc["columns"];
     auto& types = doc["types"];
     auto& data = doc["data"];
-    if (!cols.IsArray() || !types.IsArray() || !data.IsArray()) return false;
+    if (!cols.IsArray() || !types.IsArray() || !(data.IsArray() || data.IsObject())) return false;
     if (cols.Size() != types.Size()) return false;
 
     std::vector<Field> schema;
@@ -254,32 +282,52 @@ bool DataFrame::FromJson(const std::string& json) {
     }
     SetSchema(schema);
 
+    auto convert = [this](size_t c, const rapidjson::Value& v) -> FieldValue {
+        switch (schema_[c].type) {
+            case DataType::INT32:     return v.GetInt();
+            case DataType::INT64:
+            case DataType::TIMESTAMP: return v.GetInt64();
+            case DataType::UINT32:    return v.GetUint();
+            case DataType::UINT64:    return v.GetUint64();
+            // 非有限浮点数序列化为 null
+            case DataType::FLOAT:     return v.IsNumber() ? static_cast<float>(v.GetDouble()) : NAN;
+            case DataType::DOUBLE:    return v.IsNumber() ? v.GetDouble() : static_cast<double>(NAN);
+            case DataType::STRING:    return std::string(v.GetString(), v.GetStringLength());
+            case DataType::BYTES: {
+                auto s = v.GetString();
+                auto len = v.GetStringLength();
+                return std::vector<uint8_t>(s, s + len);
+            }
+            case DataType::BOOLEAN:   return v.GetBool();
+            default:                  return std::string(v.GetString(), v.GetStringLength());
+        }
+    };
+
+    // 列式布局：{"col": [...], ...}，行数取各列长度的最小值
+    if (data.IsObject()) {
+        std::vector<const rapidjson::Value*> columns;
+        rapidjson::SizeType rows = 0;
+        for (auto& f : schema_) {
+            auto it = data.FindMember(f.name.c_str());
+            if (it == data.MemberEnd() || !it->value.IsArray()) return false;
+            rows = columns.empty() ? it->value.Size() : std::min(rows, it->value.Size());
+            columns.push_back(&it->value);
+        }
+        for (rapidjson::SizeType r = 0; r < rows; ++r) {
+            std::vector<FieldValue> row;
+            row.reserve(schema_.size());
+            for (size_t c = 0; c < columns.size(); ++c) row.push_back(convert(c, (*columns[c])[r]));
+            AppendRow(row);
+        }
+        return true;
+    }
+
     for (rapidjson::SizeType r = 0; r < data.Size(); ++r) {
         auto& row_arr = data[r];
         if (!row_arr.IsArray() || row_arr.Size() != cols.Size()) continue;
         std::vector<FieldValue> row;
         row.reserve(schema_.size());
-        for (rapidjson::SizeType c = 0; c < row_arr.Size(); ++c) {
-            auto& v = row_arr[c];
-            switch (schema_[c].type) {
-                case DataType::INT32:     row.emplace_back(v.GetInt()); break;
-                case DataType::INT64:
-                case DataType::TIMESTAMP: row.emplace_back(v.GetInt64()); break;
-                case DataType::UINT32:    row.emplace_back(v.GetUint()); break;
-                case DataType::UINT64:    row.emplace_back(v.GetUint64()); break;
-                case DataType::FLOAT:     row.emplace_back(static_cast<float>(v.GetDouble())); break;
-                case DataType::DOUBLE:    row.emplace_back(v.GetDouble()); break;
-                case DataType::STRING:    row.emplace_back(std::string(v.GetString())); break;
-                case DataType::BYTES: {
-                    auto s = v.GetString();
-                    auto len = v.GetStringLength();
-                    row.emplace_back(std::vector<uint8_t>(s, s + len));
-                    break;
-                }
-                case DataType::BOOLEAN:   row.emplace_back(v.GetBool()); break;
-                default:                  row.emplace_back(std::string(v.GetString())); break;
-            }
-        }
+        for (rapidjson::SizeType c = 0; c < row_arr.Size(); ++c) row.push_back(convert(c, row_arr[c]));
         AppendRow(row);
     }
     return true;
@@ -404,117 +452,27 @@ FieldValue DataFrame::ExtractValue(const std::shared_ptr<arrow::Array>& array, i
 }
 
 // --- Filter 实现 ---
-// 解析简单条件表达式并过滤行
-// 支持: column=value, column>value, column<value, column>=value, column<=value, column!=value
+// 条件编译为类型化列谓词，直接在 Arrow 缓冲区上求值得到选择掩码，再按掩码收集各列
+// 支持: 比较(= != <> > < >= <=)、IN、BETWEEN、LIKE、IS [NOT] NULL，以 AND / OR / NOT 和括号组合
 int DataFrame::Filter(const char* condition) {
     if (!condition || !*condition) return -1;
 
+    auto expr = SqlParser::ParseWhere(condition);
+    if (!expr) return -1;
+    return Filter(*expr);
+}
+
+int DataFrame::Filter(const WhereExpr& expr, std::string* error) {
     Finalize();
     if (!batch_ || batch_->num_rows() == 0) return 0;
 
-    // 解析条件：找到操作符
-    std::string cond(condition);
-    std::string col_name, op, value;
-
-    // 支持的操作符（按长度降序匹配）
-    static const char* ops[] = {">=", "<=", "!=", "=", ">", "<"};
-    size_t op_pos = std::string::npos;
-    for (const char* o : ops) {
-        op_pos = cond.find(o);
-        if (op_pos != std::string::npos) {
-            op = o;
-            col_name = cond.substr(0, op_pos);
-            value = cond.substr(op_pos + op.size());
-            break;
-        }
-    }
-
-    if (op_pos == std::string::npos) return -1;
-
-    // 去除空白
-    while (!col_name.empty() && std::isspace(col_name.back())) col_name.pop_back();
-    while (!value.empty() && std::isspace(value.front())) value.erase(value.begin());
-
-    // 去除值的引号（前后引号必须匹配）
-    if (value.size() >= 2 && (value.front() == '\'' || value.front() == '"') &&
-        value.back() == value.front()) {
-        value = value.substr(1, value.size() - 2);
-    }
-
-    // 查找列索引
-    int col_idx = -1;
-    for (size_t i = 0; i < schema_.size(); ++i) {
-        if (schema_[i].name == col_name) {
-            col_idx = static_cast<int>(i);
-            break;
-        }
-    }
-    if (col_idx < 0) return -1;  // 列不存在
-
-    // 逐行过滤，保留匹配的行
-    std::vector<std::vector<FieldValue>> kept_rows;
-    int32_t nrows = batch_->num_rows();
-
-    for (int32_t r = 0; r < nrows; ++r) {
-        auto row_val = ExtractValue(batch_->column(col_idx), r);
-        bool match = false;
-
-        // 根据类型比较
-        std::visit([&](auto&& v) {
-            using T = std::decay_t<decltype(v)>;
-            if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
-                          std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>) {
-                int64_t lhs = static_cast<int64_t>(v);
-                int64_t rhs = 0;
-                try { rhs = std::stoll(value); } catch (...) { return; }
-                if (op == "=") match = (lhs == rhs);
-                else if (op == ">") match = (lhs > rhs);
-                else if (op == "<") match = (lhs < rhs);
-                else if (op == ">=") match = (lhs >= rhs);
-                else if (op == "<=") match = (lhs <= rhs);
-                else if (op == "!=") match = (lhs != rhs);
-            } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
-                double lhs = static_cast<double>(v);
-                double rhs = 0;
-                try { rhs = std::stod(value); } catch (...) { return; }
-                if (op == "=") match = (lhs == rhs);
-                else if (op == ">") match = (lhs > rhs);
-                else if (op == "<") match = (lhs < rhs);
-                else if (op == ">=") match = (lhs >= rhs);
-                else if (op == "<=") match = (lhs <= rhs);
-                else if (op == "!=") match = (lhs != rhs);
-            } else if constexpr (std::is_same_v<T, std::string>) {
-                if (op == "=") match = (v == value);
-                else if (op == "!=") match = (v != value);
-                else if (op == ">") match = (v > value);
-                else if (op == "<") match = (v < value);
-                else if (op == ">=") match = (v >= value);
-                else if (op == "<=") match = (v <= value);
-            } else if constexpr (std::is_same_v<T, bool>) {
-                bool rhs = (value == "true" || value == "1");
-                if (op == "=") match = (v == rhs);
-                else if (op == "!=") match = (v != rhs);
-            }
-        }, row_val);
+    auto predicate = ColumnarFilter::Compile(expr, *batch_->schema(), error);
+    if (!predicate) return -1;  // 列不存在、类型不支持或字面量与列类型不匹配
 
-        if (match) {
-            // 收集整行
-            std::vector<FieldValue> row;
-            for (int c = 0; c < batch_->num_columns(); ++c) {
-                row.push_back(ExtractValue(batch_->column(c), r));
-            }
-            kept_rows.push_back(std::move(row));
-        }
-    }
-
-    // 重建 DataFrame
-    auto saved_schema = schema_;
-    Clear();
-    SetSchema(saved_schema);
-    for (auto& row : kept_rows) {
-        AppendRow(row);
-    }
+    auto filtered = ColumnarFilter::Apply(batch_, *predicate, error);
+    if (!filtered) return -1;
 
+    batch_ = std::move(filtered);
     return 0;
 }
 
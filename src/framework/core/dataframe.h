@@ -8,6 +8,8 @@
 #include <vector>
 
 #include "framework/interfaces/idataframe.h"
+#include "json_writer.h"
+#include "where_expr.h"
 
 namespace flowsql {
 
@@ -41,12 +43,21 @@ class DataFrame : public IDataFrame {
     std::string ToJson() const override;
     bool FromJson(const std::string& json) override;
 
+    // 分页序列化：只输出 [offset, offset + limit) 行，limit < 0 表示到末尾
+    // layout 为 COLUMNS 时 data 为 {"col": [...], ...}，FromJson 两种布局都能解析
+    std::string ToJson(int64_t offset, int64_t limit, JsonLayout layout = JsonLayout::ROWS) const;
+    // NDJSON：每行输出一个 JSON 数组并以换行结尾，不含列名（由调用方另行输出表头）
+    std::string ToNdjson(int64_t offset, int64_t limit) const;
+
     // 清空
     void Clear() override;
 
     // 按条件过滤
     int Filter(const char* condition) override;
 
+    // 按已解析的表达式树过滤（调度器复用 SqlParser 的解析结果，避免重复解析）
+    int Filter(const WhereExpr& expr, std::string* error = nullptr);
+
  private:
     void Finalize() const;
     void InitBuilders() const;
@@ -0,0 +1,161 @@
+#include "json_writer.h"
+
+namespace flowsql {
+
+template <typename T>
+static const uint8_t* FixedValues(const arrow::Array& array) {
+    return reinterpret_cast<const uint8_t*>(array.data()->GetValues<T>(1));
+}
+
+JsonWriter::JsonWriter(const arrow::RecordBatch& batch) {
+    columns_.resize(batch.num_columns());
+    for (int i = 0; i < batch.num_columns(); ++i) {
+        Column& col = columns_[i];
+        col.array = batch.column(i);
+        col.name = batch.schema()->field(i)->name();
+        const arrow::Array& array = *col.array;
+        switch (array.type_id()) {
+            case arrow::Type::INT8:   col.kind = Kind::INT8;   col.values = FixedValues<int8_t>(array); break;
+            case arrow::Type::INT16:  col.kind = Kind::INT16;  col.values = FixedValues<int16_t>(array); break;
+            case arrow::Type::INT32:  col.kind = Kind::INT32;  col.values = FixedValues<int32_t>(array); break;
+            case arrow::Type::INT64:  col.kind = Kind::INT64;  col.values = FixedValues<int64_t>(array); break;
+            case arrow::Type::UINT8:  col.kind = Kind::UINT8;  col.values = FixedValues<uint8_t>(array); break;
+            case arrow::Type::UINT16: col.kind = Kind::UINT16; col.values = FixedValues<uint16_t>(array); break;
+            case arrow::Type::UINT32: col.kind = Kind::UINT32; col.values = FixedValues<uint32_t>(array); break;
+            case arrow::Type::UINT64: col.kind = Kind::UINT64; col.values = FixedValues<uint64_t>(array); break;
+            case arrow::Type::FLOAT:  col.kind = Kind::FLOAT;  col.values = FixedValues<float>(array); break;
+            case arrow::Type::DOUBLE: col.kind = Kind::DOUBLE; col.values = FixedValues<double>(array); break;
+            case arrow::Type::BOOL:   col.kind = Kind::BOOL; break;
+            case arrow::Type::STRING:
+            case arrow::Type::BINARY: {
+                // raw_value_offsets / GetValues 已按数组 offset 偏移，切片后可直接按行号索引
+                auto& bin = static_cast<const arrow::BinaryArray&>(array);
+                col.kind = Kind::STRING;
+                col.offsets32 = bin.raw_value_offsets();
+                col.data = reinterpret_cast<const char*>(bin.raw_data());
+                break;
+            }
+            case arrow::Type::LARGE_STRING:
+            case arrow::Type::LARGE_BINARY: {
+                auto& bin = static_cast<const arrow::LargeBinaryArray&>(array);
+                col.kind = Kind::LARGE_STRING;
+                col.offsets64 = bin.raw_value_offsets();
+                col.data = reinterpret_cast<const char*>(bin.raw_data());
+                break;
+            }
+            default:
+                col.kind = Kind::UNSUPPORTED;
+                break;
+        }
+    }
+}
+
+template <typename T>
+static inline T LoadValue(const uint8_t* values, int64_t row) {
+    T v;
+    std::memcpy(&v, values + row * static_cast<int64_t>(sizeof(T)), sizeof(T));
+    return v;
+}
+
+void JsonWriter::WriteCell(const Column& col, int64_t row, JsonBuffer* out) const {
+    bool null = col.array->IsNull(row);
+    switch (col.kind) {
+        case Kind::INT8:   out->Integer(null ? 0 : LoadValue<int8_t>(col.values, row)); break;
+        case Kind::INT16:  out->Integer(null ? 0 : LoadValue<int16_t>(col.values, row)); break;
+        case Kind::INT32:  out->Integer(null ? 0 : LoadValue<int32_t>(col.values, row)); break;
+        case Kind::INT64:  out->Integer(null ? 0 : LoadValue<int64_t>(col.values, row)); break;
+        case Kind::UINT8:  out->Integer(null ? 0u : LoadValue<uint8_t>(col.values, row)); break;
+        case Kind::UINT16: out->Integer(null ? 0u : LoadValue<uint16_t>(col.values, row)); break;
+        case Kind::UINT32: out->Integer(null ? 0u : LoadValue<uint32_t>(col.values, row)); break;
+        case Kind::UINT64: out->Integer(null ? uint64_t(0) : LoadValue<uint64_t>(col.values, row)); break;
+        case Kind::FLOAT:  out->Float(null ? 0.0f : LoadValue<float>(col.values, row)); break;
+        case Kind::DOUBLE: out->Float(null ? 0.0 : LoadValue<double>(col.values, row)); break;
+        case Kind::BOOL:
+            out->Bool(!null && static_cast<const arrow::BooleanArray&>(*col.array).Value(row));
+            break;
+        case Kind::STRING: {
+            if (null) {
+                out->Append("\"\"", 2);
+                break;
+            }
+            out->String(col.data + col.offsets32[row],
+                        static_cast<size_t>(col.offsets32[row + 1] - col.offsets32[row]));
+            break;
+        }
+        case Kind::LARGE_STRING: {
+            if (null) {
+                out->Append("\"\"", 2);
+                break;
+            }
+            out->String(col.data + col.offsets64[row],
+                        static_cast<size_t>(col.offsets64[row + 1] - col.offsets64[row]));
+            break;
+        }
+        case Kind::UNSUPPORTED:
+            out->Append("\"\"", 2);
+            break;
+    }
+}
+
+void JsonWriter::WriteRows(int64_t begin, int64_t end, JsonBuffer* out) const {
+    out->Put('[');
+    for (int64_t r = begin; r < end; ++r) {
+        if (r != begin) out->Put(',');
+        out->Put('[');
+        for (size_t c = 0; c < columns_.size(); ++c) {
+            if (c) out->Put(',');
+            WriteCell(columns_[c], r, out);
+        }
+        out->Put(']');
+    }
+    out->Put(']');
+}
+
+// 列式布局按列连续扫描，同一列的类型分派对分支预测友好
+void JsonWriter::WriteColumns(int64_t begin, int64_t end, JsonBuffer* out) const {
+    out->Put('{');
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        if (c) out->Put(',');
+        out->String(columns_[c].name.data(), columns_[c].name.size());
+        out->Append(":[", 2);
+        for (int64_t r = begin; r < end; ++r) {
+            if (r != begin) out->Put(',');
+            WriteCell(columns_[c], r, out);
+        }
+        out->Put(']');
+    }
+    out->Put('}');
+}
+
+void JsonWriter::WriteLines(int64_t begin, int64_t end, JsonBuffer* out) const {
+    for (int64_t r = begin; r < end; ++r) {
+        out->Put('[');
+        for (size_t c = 0; c < columns_.size(); ++c) {
+            if (c) out->Put(',');
+            WriteCell(columns_[c], r, out);
+        }
+        out->Append("]\n", 2);
+    }
+}
+
+size_t JsonWriter::EstimateSize(int64_t begin, int64_t end) const {
+    int64_t rows = std::max<int64_t>(end - begin, 0);
+    if (rows == 0) return 64;
+    size_t total = 2;
+    for (const auto& col : columns_) {
+        switch (col.kind) {
+            case Kind::INT8: case Kind::UINT8:   total += rows * 4; break;
+            case Kind::INT16: case Kind::UINT16: total += rows * 6; break;
+            case Kind::INT32: case Kind::UINT32: total += rows * 8; break;
+            case Kind::BOOL:                     total += rows * 6; break;
+            case Kind::INT64: case Kind::UINT64:
+            case Kind::FLOAT: case Kind::DOUBLE: total += rows * 16; break;
+            case Kind::STRING:       total += col.offsets32[end] - col.offsets32[begin] + rows * 3; break;
+            case Kind::LARGE_STRING: total += col.offsets64[end] - col.offsets64[begin] + rows * 3; break;
+            case Kind::UNSUPPORTED: total += rows * 3; break;
+        }
+    }
+    return total + rows * 3;
+}
+
+}  // namespace flowsql
@@ -0,0 +1,169 @@
+#ifndef _FLOWSQL_FRAMEWORK_CORE_JSON_WRITER_H_
+#define _FLOWSQL_FRAMEWORK_CORE_JSON_WRITER_H_
+
+#include <arrow/api.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace flowsql {
+
+// JSON 字符串转义表：0 表示原样输出；否则为转义后的字符（'u' 表示 \u00XX）
+struct JsonEscapeTable {
+    char table[256];
+    constexpr JsonEscapeTable() : table() {
+        for (int c = 0; c < 0x20; ++c) table[c] = 'u';
+        table['\b'] = 'b';
+        table['\f'] = 'f';
+        table['\n'] = 'n';
+        table['\r'] = 'r';
+        table['\t'] = 't';
+        table['"'] = '"';
+        table['\\'] = '\\';
+    }
+    constexpr char operator[](uint8_t c) const { return table[c]; }
+};
+inline constexpr JsonEscapeTable kJsonEscape{};
+
+// JsonBuffer — 追加式 JSON 输出缓冲区
+// 直接在 std::string 的存储上按指针写入，每次写入前 Reserve 确保余量，容量不足时按倍数扩展
+class JsonBuffer {
+ public:
+    // reserve: 预分配的字节数（通常取 JsonWriter::EstimateSize），写入从 out 现有内容之后开始
+    explicit JsonBuffer(std::string* out, size_t reserve = 0) : out_(out), len_(out->size()) {
+        out_->resize(len_ + reserve);
+    }
+    ~JsonBuffer() { Finish(); }
+
+    // 结束写入：截掉未使用的预留空间
+    void Finish() { out_->resize(len_); }
+
+    void Reserve(size_t n) {
+        if (len_ + n <= out_->size()) return;
+        out_->resize(std::max(out_->size() * 2, len_ + n));
+    }
+
+    void Put(char c) {
+        Reserve(1);
+        (*out_)[len_++] = c;
+    }
+
+    void Append(const char* data, size_t n) {
+        Reserve(n);
+        std::memcpy(&(*out_)[len_], data, n);
+        len_ += n;
+    }
+
+    template <typename T>
+    void Integer(T v) {
+        Reserve(24);
+        char* p = &(*out_)[len_];
+        len_ += static_cast<size_t>(std::to_chars(p, p + 24, v).ptr - p);
+    }
+
+    // 最短往返表示（std::to_chars 无精度参数）；NaN / Inf 不是合法 JSON，输出 null
+    template <typename T>
+    void Float(T v) {
+        if (!std::isfinite(v)) {
+            Append("null", 4);
+            return;
+        }
+        Reserve(32);
+        char* p = &(*out_)[len_];
+        len_ += static_cast<size_t>(std::to_chars(p, p + 32, v).ptr - p);
+    }
+
+    void Bool(bool v) {
+        if (v) Append("true", 4);
+        else Append("false", 5);
+    }
+
+    // 带引号的转义字符串：查表判断需转义的字节，未转义的连续片段整段拷贝
+    void String(const char* data, size_t n) {
+        static const char kHex[] = "0123456789abcdef";
+        Reserve(n + 2);
+        (*out_)[len_++] = '"';
+        size_t run = 0;
+        for (size_t i = 0; i < n; ++i) {
+            char esc = kJsonEscape[static_cast<uint8_t>(data[i])];
+            if (!esc) continue;
+            Append(data + run, i - run);
+            run = i + 1;
+            Reserve(6 + (n - i));
+            char* p = &(*out_)[len_];
+            p[0] = '\\';
+            if (esc == 'u') {
+                uint8_t c = static_cast<uint8_t>(data[i]);
+                p[1] = 'u';
+                p[2] = '0';
+                p[3] = '0';
+                p[4] = kHex[c >> 4];
+                p[5] = kHex[c & 0xF];
+                len_ += 6;
+            } else {
+                p[1] = esc;
+                len_ += 2;
+            }
+        }
+        Append(data + run, n - run);
+        Put('"');
+    }
+
+    size_t size() const { return len_; }
+
+ private:
+    std::string* out_;
+    size_t len_;
+};
+
+// JSON 输出布局
+//   ROWS    — 行式 [[v, ...], ...]
+//   COLUMNS — 列式 {"col": [...], ...}，宽表数值结果体积明显更小
+enum class JsonLayout { ROWS, COLUMNS };
+
+// JsonWriter — 列类型化的 JSON 序列化器
+// 构造时按列解析一次 Arrow 缓冲区（值、偏移、validity），逐格按列类型直接写入 JsonBuffer，
+// 不经过 FieldValue 中转，字符串单元格不分配内存
+// null 与 ExtractValue 保持一致，写为类型默认值（0 / "" / false）；不支持的类型写为 ""
+class JsonWriter {
+ public:
+    explicit JsonWriter(const arrow::RecordBatch& batch);
+
+    // [[v, ...], ...]
+    void WriteRows(int64_t begin, int64_t end, JsonBuffer* out) const;
+    // {"col": [...], ...}
+    void WriteColumns(int64_t begin, int64_t end, JsonBuffer* out) const;
+    // NDJSON：每行一个数组并以换行结尾
+    void WriteLines(int64_t begin, int64_t end, JsonBuffer* out) const;
+
+    // 预估 [begin, end) 行序列化后的字节数（不含转义膨胀），用于一次性预分配
+    size_t EstimateSize(int64_t begin, int64_t end) const;
+
+ private:
+    enum class Kind { INT8, INT16, INT32, INT64, UINT8, UINT16, UINT32, UINT64,
+                      FLOAT, DOUBLE, BOOL, STRING, LARGE_STRING, UNSUPPORTED };
+
+    struct Column {
+        Kind kind = Kind::UNSUPPORTED;
+        std::string name;
+        std::shared_ptr<arrow::Array> array;
+        const uint8_t* values = nullptr;    // 定长类型的值缓冲区（已按 offset 偏移）
+        const int32_t* offsets32 = nullptr;  // STRING / BINARY
+        const int64_t* offsets64 = nullptr;  // LARGE_STRING / LARGE_BINARY
+        const char* data = nullptr;
+    };
+
+    void WriteCell(const Column& col, int64_t row, JsonBuffer* out) const;
+
+    std::vector<Column> columns_;
+};
+
+}  // namespace flowsql
+
+#endif  // _FLOWSQL_FRAMEWORK_CORE_JSON_WRITER_H_
@@ -237,6 +237,8 @@ SqlStatement SqlParser::Parse(const std::string& sql) {
                 stmt.error = "WHERE clause contains forbidden keywords";
                 return stmt;
             }
+            // 能解析则生成表达式树（DataFrame 通道据此过滤）；含 GROUP BY 等数据库方言时保持为空
+            stmt.where_expr = ParseWhere(stmt.where_clause);
         } else {
             // WHERE 子句为空，清除并回退 pos_
             stmt.where_clause.clear();
@@ -364,4 +366,287 @@ bool SqlParser::ValidateWhereClause(const std::string& clause) {
     return true;
 }
 
+// ==================== WHERE 表达式解析 ====================
+
+namespace {
+
+// 递归下降解析 WHERE 条件，产出 WhereExpr 树
+class WhereExprParser {
+ public:
+    explicit WhereExprParser(const std::string& text)
+        : pos_(text.c_str()), end_(text.c_str() + text.size()) {}
+
+    std::shared_ptr<WhereExpr> Parse(std::string* error) {
+        auto expr = ParseOr(0);
+        if (expr) {
+            SkipWhitespace();
+            if (pos_ < end_) {
+                Fail("unexpected token near: " + std::string(pos_, end_));
+                expr = nullptr;
+            }
+        }
+        if (!expr && error) *error = error_;
+        return expr;
+    }
+
+ private:
+    // 括号/NOT 嵌套上限，防止恶意输入打爆栈
+    static constexpr int kMaxDepth = 64;
+
+    void SkipWhitespace() {
+        while (pos_ < end_ && std::isspace(static_cast<unsigned char>(*pos_))) ++pos_;
+    }
+
+    void Fail(const std::string& msg) {
+        if (error_.empty()) error_ = msg;
+    }
+
+    // 大小写不敏感匹配关键字，要求词边界
+    bool MatchKeyword(const char* keyword) {
+        SkipWhitespace();
+        size_t len = strlen(keyword);
+        if (pos_ + len > end_) return false;
+        for (size_t i = 0; i < len; ++i) {
+            if (std::toupper(static_cast<unsigned char>(pos_[i])) != keyword[i]) return false;
+        }
+        const char* after = pos_ + len;
+        if (after < end_ && (std::isalnum(static_cast<unsigned char>(*after)) || *after == '_')) return false;
+        pos_ += len;
+        return true;
+    }
+
+    bool MatchChar(char c) {
+        SkipWhitespace();
+        if (pos_ < end_ && *pos_ == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    std::shared_ptr<WhereExpr> MakeNode(WhereExprKind kind, std::shared_ptr<WhereExpr> lhs,
+                                        std::shared_ptr<WhereExpr> rhs) {
+        // 同类连接词展平：a AND b AND c → AND(a, b, c)
+        if (lhs->kind == kind) {
+            lhs->children.push_back(std::move(rhs));
+            return lhs;
+        }
+        auto node = std::make_shared<WhereExpr>();
+        node->kind = kind;
+        node->children.push_back(std::move(lhs));
+        node->children.push_back(std::move(rhs));
+        return node;
+    }
+
+    std::shared_ptr<WhereExpr> ParseOr(int depth) {
+        auto lhs = ParseAnd(depth);
+        if (!lhs) return nullptr;
+        while (MatchKeyword("OR")) {
+            auto rhs = ParseAnd(depth);
+            if (!rhs) return nullptr;
+            lhs = MakeNode(WhereExprKind::OR, std::move(lhs), std::move(rhs));
+        }
+        return lhs;
+    }
+
+    std::shared_ptr<WhereExpr> ParseAnd(int depth) {
+        auto lhs = ParseNot(depth);
+        if (!lhs) return nullptr;
+        while (MatchKeyword("AND")) {
+            auto rhs = ParseNot(depth);
+            if (!rhs) return nullptr;
+            lhs = MakeNode(WhereExprKind::AND, std::move(lhs), std::move(rhs));
+        }
+        return lhs;
+    }
+
+    std::shared_ptr<WhereExpr> ParseNot(int depth) {
+        if (depth > kMaxDepth) {
+            Fail("WHERE expression nested too deeply");
+            return nullptr;
+        }
+        if (MatchKeyword("NOT")) {
+            auto child = ParseNot(depth + 1);
+            if (!child) return nullptr;
+            auto node = std::make_shared<WhereExpr>();
+            node->kind = WhereExprKind::NOT;
+            node->children.push_back(std::move(child));
+            return node;
+        }
+        if (MatchChar('(')) {
+            auto inner = ParseOr(depth + 1);
+            if (!inner) return nullptr;
+            if (!MatchChar(')')) {
+                Fail("expected ')'");
+                return nullptr;
+            }
+            return inner;
+        }
+        return ParsePredicate();
+    }
+
+    std::shared_ptr<WhereExpr> ParsePredicate() {
+        auto node = std::make_shared<WhereExpr>();
+        if (!ReadColumn(&node->column)) return nullptr;
+
+        // IS [NOT] NULL
+        if (MatchKeyword("IS")) {
+            node->kind = WhereExprKind::IS_NULL;
+            node->negated = MatchKeyword("NOT");
+            if (!MatchKeyword("NULL")) {
+                Fail("expected NULL after IS");
+                return nullptr;
+            }
+            return node;
+        }
+
+        const char* saved = pos_;
+        bool negated = MatchKeyword("NOT");
+        if (MatchKeyword("IN")) {
+            node->kind = WhereExprKind::IN;
+            node->negated = negated;
+            if (!MatchChar('(')) {
+                Fail("expected '(' after IN");
+                return nullptr;
+            }
+            do {
+                std::string v;
+                if (!ReadLiteral(&v)) return nullptr;
+                node->values.push_back(std::move(v));
+            } while (MatchChar(','));
+            if (!MatchChar(')')) {
+                Fail("expected ')' to close IN list");
+                return nullptr;
+            }
+            return node;
+        }
+        if (MatchKeyword("BETWEEN")) {
+            node->kind = WhereExprKind::BETWEEN;
+            node->negated = negated;
+            std::string lo, hi;
+            if (!ReadLiteral(&lo)) return nullptr;
+            if (!MatchKeyword("AND")) {
+                Fail("expected AND in BETWEEN");
+                return nullptr;
+            }
+            if (!ReadLiteral(&hi)) return nullptr;
+            node->values = {std::move(lo), std::move(hi)};
+            return node;
+        }
+        if (MatchKeyword("LIKE")) {
+            node->kind = WhereExprKind::LIKE;
+            node->negated = negated;
+            std::string pattern;
+            if (!ReadLiteral(&pattern)) return nullptr;
+            node->values.push_back(std::move(pattern));
+            return node;
+        }
+        if (negated) {
+            Fail("expected IN, BETWEEN or LIKE after NOT");
+            return nullptr;
+        }
+        pos_ = saved;
+
+        node->kind = WhereExprKind::COMPARE;
+        if (!ReadCompareOp(&node->op)) return nullptr;
+        std::string v;
+        if (!ReadLiteral(&v)) return nullptr;
+        node->values.push_back(std::move(v));
+        return node;
+    }
+
+    // 列名：标识符，或用反引号/双引号括起的任意名称
+    bool ReadColumn(std::string* out) {
+        SkipWhitespace();
+        if (pos_ < end_ && (*pos_ == '`' || *pos_ == '"')) {
+            char quote = *pos_++;
+            const char* start = pos_;
+            while (pos_ < end_ && *pos_ != quote) ++pos_;
+            if (pos_ >= end_) {
+                Fail("unterminated quoted column name");
+                return false;
+            }
+            out->assign(start, pos_);
+            ++pos_;
+        } else {
+            const char* start = pos_;
+            while (pos_ < end_ && (std::isalnum(static_cast<unsigned char>(*pos_)) || *pos_ == '_' || *pos_ == '.')) {
+                ++pos_;
+            }
+            out->assign(start, pos_);
+        }
+        if (out->empty()) {
+            Fail(pos_ < end_ ? "expected column name near: " + std::string(pos_, end_) : "expected column name");
+            return false;
+        }
+        return true;
+    }
+
+    bool ReadCompareOp(CompareOp* op) {
+        SkipWhitespace();
+        static const struct {
+            const char* text;
+            CompareOp op;
+        } kOps[] = {
+            {"==", CompareOp::EQ}, {"!=", CompareOp::NE}, {"<>", CompareOp::NE}, {">=", CompareOp::GE},
+            {"<=", CompareOp::LE}, {"=", CompareOp::EQ},  {">", CompareOp::GT},  {"<", CompareOp::LT},
+        };
+        for (const auto& o : kOps) {
+            size_t len = strlen(o.text);
+            if (pos_ + len <= end_ && strncmp(pos_, o.text, len) == 0) {
+                pos_ += len;
+                *op = o.op;
+                return true;
+            }
+        }
+        Fail(pos_ < end_ ? "expected comparison operator near: " + std::string(pos_, end_)
+                         : "expected comparison operator");
+        return false;
+    }
+
+    // 字面量：'...'（'' 转义单引号）、"..."，或无引号的数字/单词
+    bool ReadLiteral(std::string* out) {
+        SkipWhitespace();
+        if (pos_ < end_ && (*pos_ == '\'' || *pos_ == '"')) {
+            char quote = *pos_++;
+            out->clear();
+            while (pos_ < end_) {
+                if (*pos_ == quote) {
+                    if (pos_ + 1 < end_ && pos_[1] == quote) {
+                        out->push_back(quote);
+                        pos_ += 2;
+                        continue;
+                    }
+                    ++pos_;
+                    return true;
+                }
+                out->push_back(*pos_++);
+            }
+            Fail("unterminated string literal");
+            return false;
+        }
+        const char* start = pos_;
+        while (pos_ < end_ && !std::isspace(static_cast<unsigned char>(*pos_)) && !strchr("(),=<>!'\"", *pos_)) {
+            ++pos_;
+        }
+        out->assign(start, pos_);
+        if (out->empty()) {
+            Fail(pos_ < end_ ? "expected literal near: " + std::string(pos_, end_) : "expected literal");
+            return false;
+        }
+        return true;
+    }
+
+    const char* pos_;
+    const char* end_;
+    std::string error_;
+};
+
+}  // namespace
+
+std::shared_ptr<WhereExpr> SqlParser::ParseWhere(const std::string& clause, std::string* error) {
+    WhereExprParser parser(clause);
+    return parser.Parse(error);
+}
+
 }  // namespace flowsql
@@ -1,10 +1,13 @@
 #ifndef _FLOWSQL_FRAMEWORK_CORE_SQL_PARSER_H_
 #define _FLOWSQL_FRAMEWORK_CORE_SQL_PARSER_H_
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "where_expr.h"
+
 namespace flowsql {
 
 // SQL 解析结果
@@ -16,6 +19,8 @@ struct SqlStatement {
     std::string dest;         // INTO 后的目标通道名（可选，空表示直接返回结果）
     std::vector<std::string> columns;  // SELECT 后的列名（空表示 *）
     std::string where_clause; // WHERE 后的过滤条件（可选，空表示无过滤）
+    std::shared_ptr<WhereExpr> where_expr;  // WHERE 条件的表达式树（无 WHERE 或超出支持的语法时为空，
+                                            // 数据库通道仍直接使用 where_clause 原文）
     std::string sql_part;     // 完整 SQL 部分（不含 USING/WITH/INTO），数据库通道直接使用
     std::string error;        // 解析错误信息（空表示成功）
 
@@ -33,6 +38,15 @@ class SqlParser {
     // 验证 WHERE 子句安全性（拒绝 SQL 注入关键字）
     static bool ValidateWhereClause(const std::string& clause);
 
+    // 解析 WHERE 条件为表达式树，必须完整消费输入；失败返回 nullptr
+    // 语法：expr := or_expr
+    //       or_expr  := and_expr (OR and_expr)*
+    //       and_expr := not_expr (AND not_expr)*
+    //       not_expr := NOT not_expr | '(' expr ')' | predicate
+    //       predicate := column (op value | [NOT] IN (v, ...) | [NOT] BETWEEN v AND v
+    //                           | [NOT] LIKE pattern | IS [NOT] NULL)
+    static std::shared_ptr<WhereExpr> ParseWhere(const std::string& clause, std::string* error = nullptr);
+
  private:
     // 词法辅助
     void SkipWhitespace();
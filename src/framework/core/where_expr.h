@@ -0,0 +1,38 @@
+#ifndef _FLOWSQL_FRAMEWORK_CORE_WHERE_EXPR_H_
+#define _FLOWSQL_FRAMEWORK_CORE_WHERE_EXPR_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace flowsql {
+
+// 比较操作符
+enum class CompareOp { EQ, NE, LT, LE, GT, GE };
+
+// WHERE 表达式节点类型
+enum class WhereExprKind {
+    AND,      // children ≥ 2
+    OR,       // children ≥ 2
+    NOT,      // children == 1
+    COMPARE,  // column op values[0]
+    IN,       // column [NOT] IN (values...)
+    BETWEEN,  // column [NOT] BETWEEN values[0] AND values[1]
+    LIKE,     // column [NOT] LIKE values[0]（% 任意串，_ 单字符，\ 转义）
+    IS_NULL,  // column IS [NOT] NULL
+};
+
+// WHERE 表达式树节点
+// 字面量一律保存原文（已去引号），求值前再按列类型转换
+struct WhereExpr {
+    WhereExprKind kind = WhereExprKind::COMPARE;
+    std::string column;                                // 叶子节点的列名
+    CompareOp op = CompareOp::EQ;                      // COMPARE 的操作符
+    std::vector<std::string> values;                   // 叶子节点的字面量
+    bool negated = false;                              // NOT IN / NOT BETWEEN / NOT LIKE / IS NOT NULL
+    std::vector<std::shared_ptr<WhereExpr>> children;  // AND / OR / NOT 的子节点
+};
+
+}  // namespace flowsql
+
+#endif  // _FLOWSQL_FRAMEWORK_CORE_WHERE_EXPR_H_
@@ -73,6 +73,26 @@ interface IBatchWriter {
     virtual void Release() = 0;
 };
 
+// IRecordBatchReader — IBatchReader 的进程内快速路径（可选能力，dynamic_cast 检测）
+// 读端与调用方在同一进程时直接交出 RecordBatch 引用，省去 IPC 序列化/反序列化；
+// 跨进程场景仍使用 IBatchReader::Next 的 IPC buffer。同一读取器只能使用 Next 与 NextBatch 之一
+interface IRecordBatchReader {
+    virtual ~IRecordBatchReader() = default;
+
+    // 读取下一批数据，返回的 RecordBatch 由调用方持有，不随下一次调用失效
+    // 返回：0=有数据, 1=已读完, <0=错误
+    virtual int NextBatch(std::shared_ptr<arrow::RecordBatch>* batch) = 0;
+};
+
+// IRecordBatchWriter — IBatchWriter 的进程内快速路径（可选能力，dynamic_cast 检测）
+// 与 IBatchWriter::Write 共享同一事务，可混合调用
+interface IRecordBatchWriter {
+    virtual ~IRecordBatchWriter() = default;
+
+    // 直接写入一批数据
+    virtual int WriteBatch(const std::shared_ptr<arrow::RecordBatch>& batch) = 0;
+};
+
 // IArrowReader — 列式读取器（Arrow 原生）
 // 生命周期：ExecuteQueryArrow() → 直接获取 RecordBatch 列表
 interface IArrowReader {
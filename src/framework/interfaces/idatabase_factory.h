@@ -36,6 +36,11 @@ interface IDatabaseFactory {
     virtual void List(std::function<void(const char* type, const char* name,
                                          const char* config_json)> callback) = 0;
 
+    // 列出已连接通道的连接池运行指标
+    // stats_json：{"type","name","pool":{...}}，驱动不支持连接池指标时不回调
+    virtual void Stats(std::function<void(const char* type, const char* name,
+                                          const char* stats_json)> callback) {}
+
     // 释放指定通道（关闭连接，从池中移除）
     virtual int Release(const char* type, const char* name) = 0;
 
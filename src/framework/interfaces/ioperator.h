@@ -5,8 +5,15 @@
 #include <common/typedef.h>
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 
+// Arrow 前向声明
+namespace arrow {
+class RecordBatch;
+}
+
 namespace flowsql {
 
 // 前向声明
@@ -40,6 +47,21 @@ interface IOperator {
     virtual std::string LastError() { return ""; }
 };
 
+// 逐批输入：返回 0=有数据, 1=已读完, <0=错误
+using BatchSource = std::function<int(std::shared_ptr<arrow::RecordBatch>* batch)>;
+// 逐批输出：返回非 0 表示写端失败，算子应尽快结束并返回 -1
+using BatchSink = std::function<int(const std::shared_ptr<arrow::RecordBatch>& batch)>;
+
+// IBatchOperator — IOperator 的逐批处理能力（可选能力，dynamic_cast 检测）
+// 调用方边读边喂输入、算子每产出一批立即交给写端，输入和输出都不在内存中整体拼接；
+// 不支持时调用方退回 Work(IChannel*, IChannel*)
+interface IBatchOperator {
+    virtual ~IBatchOperator() = default;
+
+    // 成功返回 0；失败返回 -1，错误信息经 IOperator::LastError 获取
+    virtual int WorkBatches(const BatchSource& next, const BatchSink& emit) = 0;
+};
+
 }  // namespace flowsql
 
 #endif  // _FLOWSQL_FRAMEWORK_INTERFACES_IOPERATOR_H_
@@ -36,7 +36,9 @@ export default {
   // 任务
   getTasks: () => api.get('/tasks'),
   createTask: (sql) => api.post('/tasks', { sql }),
-  getTaskResult: (id) => api.get(`/tasks/${id}/result`),
+  getTask: (id) => api.get(`/tasks/${id}`),
+  getTaskResult: (id, params) => api.get(`/tasks/${id}/result`, { params }),
+  cancelTask: (id) => api.post(`/tasks/${id}/cancel`),
 
   // 数据库通道动态管理（Epic 6）
   listDbChannels: () => api.get('/db-channels'),
@@ -8,6 +8,8 @@ class WorkerConfig:
         self.host = "127.0.0.1"
         self.port = 18900
         self.operators_dir = "operators"
+        self.data_socket = ""  # 共享内存数据通道的 Unix socket，空表示不启用
+        self.instance = "pyworker"  # 向 Gateway 注册路由、上报心跳使用的实例名
 
     @classmethod
     def from_args(cls):
@@ -15,10 +17,19 @@ class WorkerConfig:
         parser.add_argument("--host", default="127.0.0.1")
         parser.add_argument("--port", type=int, default=18900)
         parser.add_argument("--operators-dir", default="operators")
+        parser.add_argument("--data-socket", default=None,
+                            help="共享内存数据通道的 Unix socket 路径，默认 /tmp/flowsql_pyworker_<port>.sock，'off' 禁用")
+        parser.add_argument("--instance", default="pyworker",
+                            help="实例名，多实例 Worker 池中由 Gateway 传入 pyworker#<i>")
         args = parser.parse_args()
 
         config = cls()
         config.host = args.host
         config.port = args.port
         config.operators_dir = args.operators_dir
+        config.instance = args.instance
+        if args.data_socket is None:
+            config.data_socket = f"/tmp/flowsql_pyworker_{args.port}.sock"
+        elif args.data_socket != "off":
+            config.data_socket = args.data_socket
         return config
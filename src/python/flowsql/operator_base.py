@@ -1,8 +1,9 @@
 """算子基类 — 所有 Python 算子继承此类"""
 
-from abc import ABC, abstractmethod
+import copy
+from abc import ABC
 from dataclasses import dataclass
-from typing import Dict
+from typing import Dict, Optional
 
 import polars as pl
 
@@ -30,12 +31,39 @@ class OperatorBase(ABC):
         # 如果没有使用装饰器，子类必须覆盖此方法
         raise NotImplementedError("Must use @register_operator decorator or override attribute() method")
 
-    @abstractmethod
     def work(self, df_in: pl.DataFrame) -> pl.DataFrame:
         """核心处理方法：接收输入 Polars DataFrame，返回输出 Polars DataFrame
 
-        如需使用 pandas，可在算子内部调用 df_in.to_pandas() 转换"""
-        ...
+        如需使用 pandas，可在算子内部调用 df_in.to_pandas() 转换。
+        只实现了流式接口的算子，默认用 begin / work_batch / finish 处理整帧"""
+        if not self.supports_streaming():
+            raise NotImplementedError("Must override work() or work_batch()")
+        stream = self.stream_instance()
+        stream.begin()
+        outputs = [out for out in (stream.work_batch(df_in), stream.finish()) if out is not None]
+        return pl.concat(outputs, how="vertical_relaxed") if outputs else df_in.clear()
+
+    # ---- 流式接口（可选）----
+    # C++ 端按批次（默认 65536 行）经共享内存环逐批送入，每批的输出随即回传，不必等全部输入到齐；
+    # 未实现 work_batch 的算子由 Worker 缓存所有批次，结束时合并后调用 work()
+
+    def supports_streaming(self) -> bool:
+        return type(self).work_batch is not OperatorBase.work_batch
+
+    def stream_instance(self) -> "OperatorBase":
+        """每个流在独立的浅拷贝上执行，配置共享，流式状态互不干扰"""
+        return copy.copy(self)
+
+    def begin(self):
+        """流开始时调用，用于初始化跨批次状态（如累加器）"""
+
+    def work_batch(self, df_in: pl.DataFrame) -> Optional[pl.DataFrame]:
+        """处理一批输入，返回这一批的输出；返回 None 表示暂无输出（如聚合算子在 finish 中统一输出）"""
+        raise NotImplementedError
+
+    def finish(self) -> Optional[pl.DataFrame]:
+        """输入结束时调用，返回剩余输出，没有时返回 None"""
+        return None
 
     def configure(self, key: str, value: str):
         """接收配置参数"""
@@ -0,0 +1,127 @@
+"""共享内存环 — 与 C++ 端 services/bridge/shm_ring.h 的文件布局一致
+
+文件布局（小端）：
+    [0, 4096)                 头部：magic u64 | version u32 | 保留 u32 | capacity u64
+                              环 i 的控制块位于 64 + i * 128：head u64（+0），tail u64（+64）
+    [4096 + i * capacity, …)  环 i 的数据区
+记录：kind u32 | 保留 u32 | length u64 | payload，整体按 64 字节对齐
+环 0（REQUEST）由 C++ 写、Worker 读；环 1（RESPONSE）由 Worker 写、C++ 读。
+head / tail 在发门铃之前写入，socket 收发保证对端读取时已可见。
+"""
+
+import mmap
+import os
+import struct
+
+MAGIC = 0x474E495251534C46  # "FLSQRING"
+VERSION = 1
+HEADER_SIZE = 4096
+RECORD_HEADER_SIZE = 16
+ALIGN = 64
+CONTROL_OFFSET = 64
+CONTROL_SIZE = 128
+
+REQUEST = 0
+RESPONSE = 1
+
+_RECORD_DATA = 1
+_RECORD_PAD = 2
+
+
+def _align_up(n: int) -> int:
+    return (n + ALIGN - 1) // ALIGN * ALIGN
+
+
+class ShmRing:
+    """映射 C++ 端创建的环文件，Worker 作为 REQUEST 环的消费者、RESPONSE 环的生产者"""
+
+    def __init__(self, path: str):
+        fd = os.open(path, os.O_RDWR)
+        try:
+            size = os.fstat(fd).st_size
+            self.mm = mmap.mmap(fd, size, mmap.MAP_SHARED, mmap.PROT_READ | mmap.PROT_WRITE)
+        finally:
+            os.close(fd)
+        magic, version, _, capacity = struct.unpack_from("<QIIQ", self.mm, 0)
+        if magic != MAGIC or version != VERSION or HEADER_SIZE + 2 * capacity != size:
+            self.mm.close()
+            raise ValueError(f"bad ring header in {path} (version={version}, capacity={capacity})")
+        self.capacity = capacity
+        self.view = memoryview(self.mm)
+        self._pending = {}
+
+    def close(self):
+        self._pending.clear()
+        self.view.release()
+        self.mm.close()
+
+    def _head_offset(self, ring: int) -> int:
+        return CONTROL_OFFSET + ring * CONTROL_SIZE
+
+    def _tail_offset(self, ring: int) -> int:
+        return CONTROL_OFFSET + ring * CONTROL_SIZE + 64
+
+    def _data_offset(self, ring: int) -> int:
+        return HEADER_SIZE + ring * self.capacity
+
+    def _load(self, offset: int) -> int:
+        return struct.unpack_from("<Q", self.mm, offset)[0]
+
+    def _store(self, offset: int, value: int):
+        struct.pack_into("<Q", self.mm, offset, value)
+
+    def max_payload(self) -> int:
+        return self.capacity - RECORD_HEADER_SIZE
+
+    def peek(self, ring: int):
+        """取最早一条记录的 payload（memoryview，release 之前有效），没有记录时返回 None"""
+        data = self._data_offset(ring)
+        tail = self._load(self._tail_offset(ring))
+        while True:
+            head = self._load(self._head_offset(ring))
+            if tail == head:
+                return None
+            pos = tail % self.capacity
+            kind, _, length = struct.unpack_from("<IIQ", self.mm, data + pos)
+            if kind == _RECORD_PAD:
+                tail += self.capacity - pos
+                self._store(self._tail_offset(ring), tail)
+                continue
+            if kind != _RECORD_DATA or pos + RECORD_HEADER_SIZE + length > self.capacity:
+                raise ValueError(f"corrupted ring record at {tail}")
+            start = data + pos + RECORD_HEADER_SIZE
+            return self.view[start:start + length]
+
+    def release(self, ring: int):
+        """归还 peek 得到的记录"""
+        data = self._data_offset(ring)
+        tail = self._load(self._tail_offset(ring))
+        pos = tail % self.capacity
+        _, _, length = struct.unpack_from("<IIQ", self.mm, data + pos)
+        self._store(self._tail_offset(ring), tail + _align_up(RECORD_HEADER_SIZE + length))
+
+    def reserve(self, ring: int, length: int):
+        """预留 length 字节的连续空间，返回可写 memoryview；放不下时返回 None"""
+        total = _align_up(RECORD_HEADER_SIZE + length)
+        if total > self.capacity:
+            return None
+        data = self._data_offset(ring)
+        head = self._load(self._head_offset(ring))
+        tail = self._load(self._tail_offset(ring))
+        pos = head % self.capacity
+        pad = self.capacity - pos if pos + total > self.capacity else 0
+        if self.capacity - (head - tail) < pad + total:
+            return None
+        if pad:
+            struct.pack_into("<IIQ", self.mm, data + pos, _RECORD_PAD, 0, pad - RECORD_HEADER_SIZE)
+            head += pad
+            pos = 0
+        self._pending[ring] = (pos, length, head + total)
+        start = data + pos + RECORD_HEADER_SIZE
+        return self.view[start:start + length]
+
+    def commit(self, ring: int):
+        """提交 reserve 的记录，对端随后可读"""
+        pos, length, new_head = self._pending.pop(ring)
+        struct.pack_into("<IIQ", self.mm, self._data_offset(ring) + pos, _RECORD_DATA, 0, length)
+        self._store(self._head_offset(ring), new_head)
@@ -0,0 +1,240 @@
+"""共享内存数据通道 — Worker 端
+
+C++ 端（services/bridge/shm_transport.cpp）连接本 socket 后先发 attach_ring 交换环文件，
+之后每次算子调用是一个流：stream_begin → 若干 batch → stream_end。
+每个 batch 门铃对应 REQUEST 环中的一条 Arrow IPC 记录，Worker 处理后把这一批的输出写入
+RESPONSE 环并回复 batch_done；stream_end 时调用 finish() 并回复 stream_done。
+C++ 端最多有 window 个 batch 未收到回复，输出在后续输入仍在发送时即逐批流回。
+消息格式与 Control Protocol 相同：每行一个 JSON {"version", "type", "timestamp", "payload"}。
+"""
+
+import json
+import os
+import socket
+import threading
+import time
+import uuid
+
+import pyarrow as pa
+import polars as pl
+
+from .arrow_codec import _ensure_arrow_table, encode_arrow_ipc_file
+from .shm_ring import REQUEST, RESPONSE, ShmRing
+
+PROTOCOL_VERSION = "1.0"
+
+
+def _message(msg_type: str, payload: dict) -> bytes:
+    return (json.dumps({
+        "version": PROTOCOL_VERSION,
+        "type": msg_type,
+        "timestamp": int(time.time()),
+        "payload": payload,
+    }) + "\n").encode("utf-8")
+
+
+def _ipc_batches(table: pa.Table):
+    batches = table.to_batches()
+    # 零行时也写一个空批次，对端据此拿到 schema
+    if batches:
+        return batches
+    return [pa.RecordBatch.from_arrays([pa.array([], type=f.type) for f in table.schema], schema=table.schema)]
+
+
+def _write_ipc(sink, table: pa.Table, batches):
+    writer = pa.ipc.new_stream(sink, table.schema)
+    try:
+        for batch in batches:
+            writer.write_batch(batch)
+    finally:
+        writer.close()
+
+
+class _Stream:
+    """一次算子调用的流状态：op 为流式算子的独立副本；tables 非 None 时表示非流式算子，缓存全部输入"""
+
+    def __init__(self):
+        self.op = None
+        self.tables = None
+        self.error = ""
+
+
+class ShmDataServer:
+    """监听 Unix socket，每个 C++ 连接一个线程、一个环"""
+
+    def __init__(self, socket_path: str, registry):
+        self.socket_path = socket_path
+        self.registry = registry
+        self.sock = None
+        self.running = False
+
+    def start(self) -> bool:
+        try:
+            if os.path.exists(self.socket_path):
+                os.unlink(self.socket_path)
+            self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            self.sock.bind(self.socket_path)
+            self.sock.listen(16)
+        except OSError as e:
+            print(f"ShmDataServer: listen on {self.socket_path} failed: {e}")
+            if self.sock:
+                self.sock.close()
+                self.sock = None
+            return False
+        self.running = True
+        threading.Thread(target=self._accept_loop, daemon=True).start()
+        print(f"ShmDataServer: listening on {self.socket_path}")
+        return True
+
+    def stop(self):
+        self.running = False
+        if self.sock:
+            self.sock.close()
+            self.sock = None
+        try:
+            os.unlink(self.socket_path)
+        except OSError:
+            pass
+
+    def _accept_loop(self):
+        while self.running:
+            try:
+                conn, _ = self.sock.accept()
+            except OSError:
+                break
+            threading.Thread(target=self._serve, args=(conn,), daemon=True).start()
+
+    def _serve(self, conn: socket.socket):
+        ring = None
+        stream = None
+        buffer = b""
+        try:
+            while True:
+                data = conn.recv(4096)
+                if not data:
+                    break
+                buffer += data
+                while b"\n" in buffer:
+                    line, buffer = buffer.split(b"\n", 1)
+                    if not line.strip():
+                        continue
+                    msg = json.loads(line)
+                    msg_type = msg.get("type")
+                    payload = msg.get("payload", {})
+                    if msg_type == "attach_ring":
+                        if ring:
+                            ring.close()
+                        try:
+                            ring = ShmRing(payload["path"])
+                            conn.sendall(_message("ack", {}))
+                        except (OSError, KeyError, ValueError) as e:
+                            ring = None
+                            conn.sendall(_message("error", {"code": 1, "message": f"attach_ring failed: {e}"}))
+                    elif msg_type == "stream_begin" and ring:
+                        stream = self._begin(payload)
+                    elif msg_type == "batch" and ring and stream:
+                        conn.sendall(_message("batch_done", self._batch(ring, stream)))
+                    elif msg_type == "stream_end" and ring and stream:
+                        conn.sendall(_message("stream_done", self._finish(ring, stream)))
+                        stream = None
+                    elif msg_type == "ping":
+                        conn.sendall(_message("pong", {}))
+                    else:
+                        conn.sendall(_message("error", {"code": 2, "message": f"unexpected message: {msg_type}"}))
+        except Exception as e:
+            print(f"ShmDataServer: connection error: {e}")
+        finally:
+            conn.close()
+            if ring:
+                try:
+                    ring.close()
+                except BufferError:
+                    pass  # 仍有 Arrow 对象引用环内存，交给 GC 回收
+
+    def _begin(self, payload: dict) -> "_Stream":
+        """stream_begin 不回复，出错时记在流上，由后续的 batch_done / stream_done 带回"""
+        stream = _Stream()
+        stream.op = self.registry.get(payload.get("catelog", ""), payload.get("name", ""))
+        if not stream.op:
+            stream.error = f"Operator {payload.get('catelog')}.{payload.get('name')} not found"
+        elif stream.op.supports_streaming():
+            stream.op = stream.op.stream_instance()
+            try:
+                stream.op.begin()
+            except Exception as e:
+                stream.error = f"Operator error: {e}"
+        else:
+            stream.tables = []
+        return stream
+
+    def _batch(self, ring: ShmRing, stream: "_Stream") -> dict:
+        """处理一批输入；无论成败都归还 REQUEST 环中的记录"""
+        request = ring.peek(REQUEST)
+        if request is None:
+            return {"ok": False, "error": "no input in request ring"}
+        try:
+            if stream.error:
+                return {"ok": False, "error": stream.error}
+            try:
+                # 先复制出环再解码：记录立即归还，C++ 端可以继续写后续批次，算子也可以安全地保留输入
+                table = pa.ipc.open_stream(pa.py_buffer(bytes(request))).read_all()
+            except Exception as e:
+                stream.error = f"Failed to decode Arrow IPC: {e}"
+                return {"ok": False, "error": stream.error}
+        finally:
+            try:
+                request.release()
+            except BufferError:
+                pass
+            ring.release(REQUEST)
+
+        # 非流式算子先缓存，stream_end 时整帧调用 work()
+        if stream.tables is not None:
+            stream.tables.append(table)
+            return {"ok": True, "empty": True}
+        try:
+            df_out = stream.op.work_batch(pl.from_arrow(table))
+        except Exception as e:
+            stream.error = f"Operator error: {e}"
+            return {"ok": False, "error": stream.error}
+        return self._write_output(ring, df_out)
+
+    def _finish(self, ring: ShmRing, stream: "_Stream") -> dict:
+        if stream.error:
+            return {"ok": False, "error": stream.error}
+        try:
+            if stream.tables is not None:
+                table = pa.concat_tables(stream.tables) if stream.tables else pa.table({})
+                stream.tables = None
+                df_out = stream.op.work(pl.from_arrow(table))
+            else:
+                df_out = stream.op.finish()
+        except Exception as e:
+            return {"ok": False, "error": f"Operator error: {e}"}
+        return self._write_output(ring, df_out)
+
+    def _write_output(self, ring: ShmRing, df_out) -> dict:
+        """输出原地写入 RESPONSE 环；环中放不下时写到共享内存文件，由 C++ 端读取后删除。
+        df_out 为 None 表示这一批没有输出"""
+        if df_out is None:
+            return {"ok": True, "empty": True}
+        try:
+            table = _ensure_arrow_table(df_out)
+            batches = _ipc_batches(table)
+            mock = pa.MockOutputStream()
+            _write_ipc(mock, table, batches)
+            size = mock.size()
+            slot = ring.reserve(RESPONSE, size) if size <= ring.max_payload() else None
+            if slot is None:
+                shm_dir = "/dev/shm" if os.path.isdir("/dev/shm") else "/tmp"
+                path = f"{shm_dir}/flowsql_{uuid.uuid4()}_out"
+                encode_arrow_ipc_file(df_out, path)
+                return {"ok": True, "output": path}
+            try:
+                _write_ipc(pa.FixedSizeBufferWriter(pa.py_buffer(slot)), table, batches)
+            finally:
+                slot.release()
+            ring.commit(RESPONSE)
+            return {"ok": True}
+        except Exception as e:
+            return {"ok": False, "error": f"Failed to encode Arrow IPC: {e}"}
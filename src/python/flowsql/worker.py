@@ -13,9 +13,11 @@ import uvicorn
 from .arrow_codec import decode_arrow_ipc, encode_arrow_ipc, decode_arrow_ipc_file, encode_arrow_ipc_file
 from .config import WorkerConfig
 from .operator_registry import OperatorRegistry
+from .shm_transport import ShmDataServer
 
 app = FastAPI(title="FlowSQL Python Worker")
 registry = OperatorRegistry()
+data_server = None  # 共享内存数据通道，main() 中启动
 
 
 def _do_reload():
@@ -40,6 +42,14 @@ async def list_operators():
     return registry.list_operators()
 
 
+@app.get("/transport")
+async def transport():
+    """共享内存数据通道的 socket 路径，C++ 端据此决定是否绕过 HTTP 调用算子"""
+    if not data_server:
+        raise HTTPException(status_code=404, detail="shared memory transport disabled")
+    return {"socket": data_server.socket_path}
+
+
 @app.post("/reload")
 async def reload_operators():
     """重新扫描算子目录"""
@@ -139,17 +149,27 @@ def main():
         local_addr = f"{config.host}:{config.port}"
         prefixes = ["/pyworker/health", "/pyworker/operators", "/pyworker/work",
                     "/pyworker/reload", "/pyworker/configure"]
-        _register_with_gateway(gateway_addr, "pyworker", local_addr, prefixes)
+        _register_with_gateway(gateway_addr, config.instance, local_addr, prefixes)
 
         # 启动心跳线程
-        t = threading.Thread(target=_heartbeat_loop, args=(gateway_addr, "pyworker", 5), daemon=True)
+        t = threading.Thread(target=_heartbeat_loop, args=(gateway_addr, config.instance, 5), daemon=True)
         t.start()
 
-    # 3. 启动 HTTP 服务
+    # 3. 启动共享内存数据通道（失败时算子调用只走 HTTP）
+    global data_server
+    if config.data_socket:
+        server = ShmDataServer(config.data_socket, registry)
+        if server.start():
+            data_server = server
+
+    # 4. 启动 HTTP 服务
     try:
         uvicorn.run(app, host=config.host, port=config.port, log_level="warning")
     except KeyboardInterrupt:
         pass
+    finally:
+        if data_server:
+            data_server.stop()
 
 
 if __name__ == "__main__":
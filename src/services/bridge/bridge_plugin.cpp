@@ -7,6 +7,7 @@
 #include <cstring>
 #include <dirent.h>
 #include <thread>
+#include <unistd.h>
 
 #include <httplib.h>
 #include <rapidjson/document.h>
@@ -52,6 +53,10 @@ int BridgePlugin::Option(const char* arg) {
 
         if (key == "worker_host") host_ = val;
         else if (key == "worker_port") port_ = std::stoi(val);
+        else if (key == "shm_ring") shm_ring_ = (val != "off" && val != "false" && val != "0");
+        else if (key == "ring_capacity_mb") ring_capacity_mb_ = std::stoul(val);
+        else if (key == "stream_window") stream_window_ = std::stoi(val);
+        else if (key == "stream_chunk_rows") stream_chunk_rows_ = std::stoll(val);
 
         pos = (end < opts.size()) ? end + 1 : opts.size();
     }
@@ -60,54 +65,67 @@ int BridgePlugin::Option(const char* arg) {
 
 int BridgePlugin::Load(IQuerier* querier) {
     querier_ = querier;
+    workers_ = {{host_, port_}};
 
     // 从环境变量获取 Gateway 地址，通过 Gateway 路由发现 PyWorker
     const char* gw = std::getenv("FLOWSQL_GATEWAY_ADDR");
     if (gw) {
         gateway_addr_ = gw;
-        std::string gw_host = "127.0.0.1";
-        int gw_port = 18800;
-        size_t colon = gateway_addr_.find(':');
-        if (colon != std::string::npos) {
-            gw_host = gateway_addr_.substr(0, colon);
-            gw_port = std::stoi(gateway_addr_.substr(colon + 1));
-        }
-
         // 重试查询路由表（PyWorker 可能还没注册）
-        for (int retry = 0; retry < 10; ++retry) {
-            httplib::Client client(gw_host, gw_port);
-            client.set_connection_timeout(2);
-            client.set_read_timeout(2);
-            auto res = client.Get("/gateway/routes");
-            if (res && res->status == 200) {
-                rapidjson::Document doc;
-                doc.Parse(res->body.c_str());
-                if (!doc.HasParseError() && doc.IsArray()) {
-                    for (auto& item : doc.GetArray()) {
-                        std::string prefix = item["prefix"].GetString();
-                        if (prefix.find("/pyworker") == 0) {
-                            std::string addr = item["address"].GetString();
-                            size_t c = addr.find(':');
-                            if (c != std::string::npos) {
-                                host_ = addr.substr(0, c);
-                                port_ = std::stoi(addr.substr(c + 1));
-                            }
-                            printf("BridgePlugin::Load: discovered PyWorker at %s:%d via Gateway\n",
-                                   host_.c_str(), port_);
-                            goto found;
-                        }
-                    }
-                }
-            }
+        for (int retry = 0; retry < 10 && DiscoverWorkers() != 0; ++retry) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
         }
     }
-found:
-    printf("BridgePlugin::Load: worker=%s:%d, gateway=%s\n", host_.c_str(), port_,
-           gateway_addr_.empty() ? "(none)" : gateway_addr_.c_str());
+    printf("BridgePlugin::Load: %zu worker(s), first=%s:%d, gateway=%s\n", workers_.size(),
+           workers_[0].first.c_str(), workers_[0].second, gateway_addr_.empty() ? "(none)" : gateway_addr_.c_str());
     return 0;
 }
 
+int BridgePlugin::DiscoverWorkers() {
+    std::string gw_host = "127.0.0.1";
+    int gw_port = 18800;
+    size_t colon = gateway_addr_.find(':');
+    if (colon != std::string::npos) {
+        gw_host = gateway_addr_.substr(0, colon);
+        gw_port = std::stoi(gateway_addr_.substr(colon + 1));
+    }
+
+    httplib::Client client(gw_host, gw_port);
+    client.set_connection_timeout(2);
+    client.set_read_timeout(2);
+    auto res = client.Get("/gateway/routes");
+    if (!res || res->status != 200) return -1;
+    rapidjson::Document doc;
+    doc.Parse(res->body.c_str());
+    if (doc.HasParseError() || !doc.IsArray()) return -1;
+
+    // pyworker 各实例注册相同的前缀，取任一 /pyworker 路由的全部实例
+    for (auto& item : doc.GetArray()) {
+        std::string prefix = item["prefix"].GetString();
+        if (prefix.find("/pyworker") != 0) continue;
+
+        std::vector<std::string> addresses;
+        if (item.HasMember("upstreams") && item["upstreams"].IsArray()) {
+            for (auto& upstream : item["upstreams"].GetArray()) addresses.push_back(upstream["address"].GetString());
+        } else {
+            addresses.push_back(item["address"].GetString());
+        }
+        std::vector<std::pair<std::string, int>> workers;
+        for (const auto& addr : addresses) {
+            size_t c = addr.find(':');
+            if (c != std::string::npos) workers.emplace_back(addr.substr(0, c), std::stoi(addr.substr(c + 1)));
+        }
+        if (workers.empty()) continue;
+        std::sort(workers.begin(), workers.end());
+        if (workers != workers_) {
+            printf("BridgePlugin: discovered %zu PyWorker instance(s) via Gateway\n", workers.size());
+        }
+        workers_ = std::move(workers);
+        return 0;
+    }
+    return -1;
+}
+
 int BridgePlugin::Unload() {
     return 0;
 }
@@ -131,15 +149,66 @@ int BridgePlugin::Start() {
 
 int BridgePlugin::Stop() {
     registered_operators_.clear();
+    pool_->Reset({});
     return 0;
 }
 
-int BridgePlugin::DiscoverOperators() {
-    httplib::Client client(host_, port_);
+std::string BridgePlugin::DiscoverTransport(const std::string& host, int port) {
+    if (!shm_ring_) return "";
+
+    httplib::Client client(host, port);
     client.set_connection_timeout(2);
     client.set_read_timeout(5);
+    auto res = client.Get("/transport");
+    std::string socket_path;
+    if (res && res->status == 200) {
+        rapidjson::Document doc;
+        doc.Parse(res->body.c_str());
+        if (!doc.HasParseError() && doc.IsObject() && doc.HasMember("socket") && doc["socket"].IsString()) {
+            socket_path = doc["socket"].GetString();
+        }
+    }
+    // Unix socket 只在同一主机上可达
+    if (socket_path.empty() || access(socket_path.c_str(), F_OK) != 0) return "";
+    return socket_path;
+}
 
-    auto res = client.Get("/operators");
+void BridgePlugin::UpdatePool() {
+    std::vector<std::shared_ptr<PythonWorker>> workers;
+    for (const auto& [host, port] : workers_) {
+        std::string socket_path = DiscoverTransport(host, port);
+        auto existing = pool_->Find(host, port);
+        std::string existing_socket = existing && existing->transport ? existing->transport->SocketPath() : "";
+        if (existing && existing_socket == socket_path) {
+            workers.push_back(existing);
+            continue;
+        }
+        // 共享内存连接在首次调用时建立
+        std::shared_ptr<ShmTransport> transport;
+        if (!socket_path.empty()) {
+            transport = std::make_shared<ShmTransport>(socket_path, ring_capacity_mb_ << 20, stream_window_,
+                                                       stream_chunk_rows_);
+        }
+        printf("BridgePlugin: worker %s:%d via %s\n", host.c_str(), port,
+               socket_path.empty() ? "HTTP" : socket_path.c_str());
+        workers.push_back(std::make_shared<PythonWorker>(host, port, transport));
+    }
+    pool_->Reset(std::move(workers));
+}
+
+int BridgePlugin::DiscoverOperators() {
+    // 刷新 Worker 成员（实例数变化、重启换了地址）；查询失败时沿用已知地址
+    if (!gateway_addr_.empty()) DiscoverWorkers();
+
+    // 各 Worker 加载同一个算子目录，从第一个可达的 Worker 获取算子列表
+    httplib::Result res;
+    for (const auto& [host, port] : workers_) {
+        httplib::Client client(host, port);
+        client.set_connection_timeout(2);
+        client.set_read_timeout(5);
+        res = client.Get("/operators");
+        if (res && res->status == 200) break;
+    }
     if (!res || res->status != 200) {
         return -1;
     }
@@ -151,6 +220,8 @@ int BridgePlugin::DiscoverOperators() {
         return -1;
     }
 
+    UpdatePool();
+
     for (auto& item : doc.GetArray()) {
         OperatorMeta meta;
         meta.catelog = item.HasMember("catelog") ? item["catelog"].GetString() : "";
@@ -159,7 +230,7 @@ int BridgePlugin::DiscoverOperators() {
 
         if (meta.catelog.empty() || meta.name.empty()) continue;
 
-        auto bridge = std::make_shared<PythonOperatorBridge>(meta, host_, port_);
+        auto bridge = std::make_shared<PythonOperatorBridge>(meta, pool_);
         std::string key = meta.catelog + "." + meta.name;
 
         // 只存内部，不注册到 PluginLoader
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <common/iplugin.h>
@@ -37,14 +38,31 @@ class BridgePlugin : public IPlugin, public IBridge {
     // 从 Python Worker 获取算子列表（只存内部，不注册到 PluginLoader）
     int DiscoverOperators();
 
+    // 从 Gateway 路由表获取 pyworker 各实例地址，成功返回 0
+    int DiscoverWorkers();
+
+    // 按 workers_ 重建 Worker 池，地址和数据 socket 未变的 Worker 保留原有共享内存连接
+    void UpdatePool();
+
+    // 查询 Worker 的数据 socket，返回空表示该 Worker 只走文件 + HTTP
+    std::string DiscoverTransport(const std::string& host, int port);
+
     IQuerier* querier_ = nullptr;
 
     // 已发现的 Python 算子（持有 shared_ptr 保证生命周期安全）
     std::vector<std::shared_ptr<PythonOperatorBridge>> registered_operators_;
 
+    // 所有 Python 算子共享的 Worker 池
+    std::shared_ptr<WorkerPool> pool_ = std::make_shared<WorkerPool>();
+
     // 配置参数
     std::string host_ = "127.0.0.1";
     int port_ = 18900;
+    std::vector<std::pair<std::string, int>> workers_;  // Worker 地址，无 Gateway 时只有 host_:port_
+    bool shm_ring_ = true;              // shm_ring=off 时禁用共享内存传输
+    size_t ring_capacity_mb_ = 64;      // 每个方向的环容量
+    int stream_window_ = 4;             // 流式调用中未收到回复的批次上限
+    int64_t stream_chunk_rows_ = 65536; // 流式调用每批行数上限
     std::string gateway_addr_;  // Gateway 地址（从环境变量获取）
 };
 
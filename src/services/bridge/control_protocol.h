@@ -22,6 +22,15 @@ namespace MessageType {
     constexpr const char* UPDATE_CONFIG = "update_config";
     constexpr const char* SHUTDOWN = "shutdown";
 
+    // C++ → Worker（共享内存数据通道，走 Worker 的数据 socket）
+    constexpr const char* ATTACH_RING = "attach_ring";    // payload: {"path": 环文件路径}
+    constexpr const char* STREAM_BEGIN = "stream_begin";  // payload: {"catelog", "name"}，不回复
+    constexpr const char* BATCH = "batch";                // payload: {}，一批输入在 REQUEST 环中
+    constexpr const char* STREAM_END = "stream_end";      // payload: {}，输入结束
+    // Worker → C++（payload: {"ok", "error", "output", "empty"}，输出在 RESPONSE 环中）
+    constexpr const char* BATCH_DONE = "batch_done";      // 每个 batch 一条，按顺序
+    constexpr const char* STREAM_DONE = "stream_done";    // finish() 的输出
+
     // 双向
     constexpr const char* PING = "ping";
     constexpr const char* PONG = "pong";
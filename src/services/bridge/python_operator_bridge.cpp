@@ -39,57 +39,183 @@ std::string ChooseShmDir() {
     return "/tmp";
 }
 
+// 本线程最近一次调用的错误及其所属实例：同一实例被并发调用，不能共用一个成员
+thread_local const void* t_error_owner = nullptr;
+thread_local std::string t_last_error;
+
+// 多批拼成一批：文件通道与 DataFrame 通道都只能整体传递
+std::shared_ptr<arrow::RecordBatch> CombineBatches(const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
+                                                   std::string* error) {
+    if (batches.size() == 1) return batches.front();
+    auto combined = arrow::ConcatenateRecordBatches(batches);
+    if (!combined.ok()) {
+        *error = "combine batches failed: " + combined.status().ToString();
+        return nullptr;
+    }
+    return *combined;
+}
+
 }  // namespace
 
 namespace flowsql {
 namespace bridge {
 
-PythonOperatorBridge::PythonOperatorBridge(const OperatorMeta& meta, const std::string& host, int port)
-    : meta_(meta), host_(host), port_(port) {
-    client_ = std::make_unique<httplib::Client>(host, port);
-    client_->set_connection_timeout(5);
-    client_->set_read_timeout(30);
-    client_->set_write_timeout(10);
-    client_->set_keep_alive(true);
-}
+PythonOperatorBridge::PythonOperatorBridge(const OperatorMeta& meta, std::shared_ptr<WorkerPool> pool)
+    : meta_(meta), pool_(std::move(pool)) {}
 
 int PythonOperatorBridge::Work(IChannel* in, IChannel* out) {
-    last_error_.clear();
-
     // 1. dynamic_cast 到 IDataFrameChannel
     auto* df_in = dynamic_cast<IDataFrameChannel*>(in);
     auto* df_out = dynamic_cast<IDataFrameChannel*>(out);
-    if (!df_in || !df_out) {
-        last_error_ = "channel type mismatch (expected IDataFrameChannel)";
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
-        return -1;
-    }
+    if (!df_in || !df_out) return Fail("channel type mismatch (expected IDataFrameChannel)");
 
     // 2. 从输入通道读取 DataFrame
     DataFrame in_frame;
-    if (df_in->Read(&in_frame) != 0) {
-        last_error_ = "Read from input channel failed";
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
+    if (df_in->Read(&in_frame) != 0) return Fail("Read from input channel failed");
+
+    // 3. 转为 Arrow RecordBatch
+    auto batch = in_frame.ToArrow();
+    if (!batch) return Fail("ToArrow() returned null");
+
+    // 4. 整帧作为唯一一批输入；DataFrame 通道是替换语义，输出收齐后整体写入
+    std::vector<std::shared_ptr<arrow::RecordBatch>> results;
+    BatchSource next = [&batch](std::shared_ptr<arrow::RecordBatch>* out_batch) {
+        if (!batch) return 1;
+        *out_batch = std::move(batch);
+        batch.reset();
+        return 0;
+    };
+    BatchSink emit = [&results](const std::shared_ptr<arrow::RecordBatch>& out_batch) {
+        results.push_back(out_batch);
+        return 0;
+    };
+    std::string error;
+    if (Run(next, emit, &error) != 0) return Fail(error);
+
+    auto result_batch = results.empty() ? nullptr : CombineBatches(results, &error);
+    if (!result_batch) return Fail(error.empty() ? "Python Worker returned no output" : error);
+
+    DataFrame out_frame;
+    out_frame.FromArrow(result_batch);
+
+    if (df_out->Write(&out_frame) != 0) return Fail("Write to output channel failed");
+
+    PublishError("");
+    return 0;
+}
+
+int PythonOperatorBridge::WorkBatches(const BatchSource& next, const BatchSink& emit) {
+    std::string error;
+    if (Run(next, emit, &error) != 0) return Fail(error);
+    PublishError("");
+    return 0;
+}
+
+int PythonOperatorBridge::Run(const BatchSource& next, const BatchSink& emit, std::string* error) {
+    InputCursor input(next);
+    int64_t emitted = 0;
+    BatchSink output = [&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+        ++emitted;
+        return emit(batch);
+    };
+
+    // 分派到在途调用最少的 Worker；Worker 不可达（崩溃、重启中）时换一个重试一次，算子本身出错不重试
+    // 重试要重放输入：读端至多取走了第一批、写端还没有收到输出时才可以
+    auto worker = pool_->Acquire();
+    if (!worker) {
+        *error = "no Python Worker available";
         return -1;
     }
+    bool unreachable = false;
+    int ret = Call(worker.get(), &input, output, &unreachable, error);
+    pool_->Release(worker, unreachable);
+    if (ret != 0 && unreachable && emitted == 0 && pool_->Size() > 1 && input.Rewind() &&
+        (worker = pool_->Acquire(worker.get()))) {
+        printf("PythonOperatorBridge[%s.%s]: %s, retrying on %s:%d\n", meta_.catelog.c_str(),
+               meta_.name.c_str(), error->c_str(), worker->host.c_str(), worker->port);
+        error->clear();
+        unreachable = false;
+        ret = Call(worker.get(), &input, output, &unreachable, error);
+        pool_->Release(worker, unreachable);
+    }
+    if (ret != 0 && error->empty()) *error = "Python operator call failed";
+    return ret;
+}
 
-    // 3. 序列化 Arrow IPC 到共享内存文件
-    auto batch = in_frame.ToArrow();
-    if (!batch) {
-        last_error_ = "ToArrow() returned null";
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
+int PythonOperatorBridge::Fail(const std::string& error) {
+    printf("PythonOperatorBridge[%s.%s]: %s\n", meta_.catelog.c_str(), meta_.name.c_str(), error.c_str());
+    PublishError(error);
+    return -1;
+}
+
+void PythonOperatorBridge::PublishError(const std::string& error) {
+    t_error_owner = this;
+    t_last_error = error;
+}
+
+std::string PythonOperatorBridge::LastError() {
+    return t_error_owner == this ? t_last_error : std::string();
+}
+
+int PythonOperatorBridge::InputCursor::Next(std::shared_ptr<arrow::RecordBatch>* batch) {
+    if (replay) {
+        replay = false;
+        *batch = first;
+        return 0;
+    }
+    if (exhausted) return 1;
+    int rc = next(batch);
+    if (rc == 1) {
+        exhausted = true;
+    } else if (rc == 0) {
+        ++pulled;
+        if (pulled == 1) first = *batch;
+        if (pulled == 2) first.reset();  // 已不可重放，不再持有
+    }
+    return rc;
+}
+
+bool PythonOperatorBridge::InputCursor::Rewind() {
+    if (pulled > 1) return false;
+    replay = pulled == 1;
+    return true;
+}
+
+int PythonOperatorBridge::Call(PythonWorker* worker, InputCursor* input, const BatchSink& emit,
+                               bool* unreachable, std::string* error) {
+    // 优先共享内存环，未经环发送时（至多取走了第一批）从头回退到文件 + HTTP
+    if (worker->transport) {
+        BatchSource next = [input](std::shared_ptr<arrow::RecordBatch>* batch) { return input->Next(batch); };
+        int ret = worker->transport->Call(meta_.catelog, meta_.name, next, emit, error);
+        if (ret != ShmTransport::kNotHandled) {
+            *unreachable = ret != 0 && !worker->transport->Connected();
+            return ret;
+        }
+        input->Rewind();
+    }
+    return WorkViaFile(worker, input, emit, unreachable, error);
+}
+
+int PythonOperatorBridge::WorkViaFile(PythonWorker* worker, InputCursor* input, const BatchSink& emit,
+                                      bool* unreachable, std::string* error) {
+    // 文件通道只能整体传递：收齐输入拼成一批；读端没有任何输入时发送无列的空批
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    std::shared_ptr<arrow::RecordBatch> in_batch;
+    int rc;
+    while ((rc = input->Next(&in_batch)) == 0) batches.push_back(std::move(in_batch));
+    if (rc < 0) {
+        *error = "read operator input failed";
         return -1;
     }
+    auto batch = batches.empty() ? arrow::RecordBatch::Make(arrow::schema({}), 0, arrow::ArrayVector{})
+                                 : CombineBatches(batches, error);
+    if (!batch) return -1;
+    batches.clear();
 
     std::string shm_dir = ChooseShmDir();
     std::string uuid = GenerateUUID();
     if (uuid.empty()) {
-        last_error_ = "Failed to generate UUID";
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
+        *error = "Failed to generate UUID";
         return -1;
     }
 
@@ -98,13 +224,11 @@ int PythonOperatorBridge::Work(IChannel* in, IChannel* out) {
     SharedMemoryGuard guard(in_path, out_path);
 
     if (ArrowIpcSerializer::SerializeToFile(batch, in_path) != 0) {
-        last_error_ = "Arrow IPC serialize to file failed";
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
+        *error = "Arrow IPC serialize to file failed";
         return -1;
     }
 
-    // 4. HTTP POST JSON 路径到 Python Worker
+    // HTTP POST JSON 路径到 Python Worker
     std::string path = "/work/" + meta_.catelog + "/" + meta_.name;
 
     rapidjson::StringBuffer sb;
@@ -114,77 +238,71 @@ int PythonOperatorBridge::Work(IChannel* in, IChannel* out) {
     json_writer.String(in_path.c_str());
     json_writer.EndObject();
 
-    auto res = client_->Post(path, sb.GetString(), "application/json");
+    httplib::Result res;
+    {
+        std::lock_guard<std::mutex> lock(worker->http_mutex);
+        res = worker->client->Post(path, sb.GetString(), "application/json");
+    }
 
     if (!res) {
-        last_error_ = "HTTP POST to Python Worker failed (connection error)";
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
+        *error = "HTTP POST to Python Worker failed (connection error)";
+        *unreachable = true;
         return -1;
     }
 
     if (res->status != 200) {
-        last_error_ = "Python Worker returned HTTP " + std::to_string(res->status);
+        *error = "Python Worker returned HTTP " + std::to_string(res->status);
         if (!res->body.empty()) {
             rapidjson::Document doc;
             doc.Parse(res->body.c_str());
             if (!doc.HasParseError() && doc.IsObject() && doc.HasMember("detail") && doc["detail"].IsString()) {
-                last_error_ += ": " + std::string(doc["detail"].GetString());
+                *error += ": " + std::string(doc["detail"].GetString());
             } else {
-                last_error_ += ": " + res->body;
+                *error += ": " + res->body;
             }
         }
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
         return -1;
     }
 
-    // 5. 解析响应 JSON，从共享内存文件反序列化结果
+    // 解析响应 JSON，从共享内存文件反序列化结果
     rapidjson::Document res_doc;
     res_doc.Parse(res->body.c_str());
     if (res_doc.HasParseError() || !res_doc.IsObject() || !res_doc.HasMember("output") ||
         !res_doc["output"].IsString()) {
-        last_error_ = "Invalid JSON response from Python Worker: " + res->body;
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
+        *error = "Invalid JSON response from Python Worker: " + res->body;
         return -1;
     }
 
     std::string output_path = res_doc["output"].GetString();
-    std::shared_ptr<arrow::RecordBatch> result_batch;
-    if (ArrowIpcSerializer::DeserializeFromFile(output_path, &result_batch) != 0) {
-        last_error_ = "Deserialize Arrow IPC from file failed: " + output_path;
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
+    std::shared_ptr<arrow::RecordBatch> result;
+    if (ArrowIpcSerializer::DeserializeFromFile(output_path, &result) != 0) {
+        *error = "Deserialize Arrow IPC from file failed: " + output_path;
         return -1;
     }
-
-    DataFrame out_frame;
-    out_frame.FromArrow(result_batch);
-
-    if (df_out->Write(&out_frame) != 0) {
-        last_error_ = "Write to output channel failed";
-        printf("PythonOperatorBridge[%s.%s]: %s\n",
-               meta_.catelog.c_str(), meta_.name.c_str(), last_error_.c_str());
+    if (emit(result) != 0) {
+        *error = "write operator output failed";
         return -1;
     }
-
     return 0;
 }
 
 int PythonOperatorBridge::Configure(const char* key, const char* value) {
     if (!key || !value) return -1;
 
+    // 每个 Worker 进程各有一份算子实例，配置需要逐个下发
     std::string path = "/configure/" + meta_.catelog + "/" + meta_.name;
     std::string body = std::string("{\"key\":\"") + key + "\",\"value\":\"" + value + "\"}";
-    auto res = client_->Post(path, body, "application/json");
-
-    if (!res || res->status != 200) {
-        printf("PythonOperatorBridge[%s.%s]: Configure failed\n",
-               meta_.catelog.c_str(), meta_.name.c_str());
-        return -1;
+    int ret = 0;
+    for (auto& worker : pool_->Workers()) {
+        std::lock_guard<std::mutex> lock(worker->http_mutex);
+        auto res = worker->client->Post(path, body, "application/json");
+        if (!res || res->status != 200) {
+            printf("PythonOperatorBridge[%s.%s]: Configure failed on %s:%d\n",
+                   meta_.catelog.c_str(), meta_.name.c_str(), worker->host.c_str(), worker->port);
+            ret = -1;
+        }
     }
-    return 0;
+    return ret;
 }
 
 }  // namespace bridge
@@ -1,12 +1,12 @@
 #ifndef _FLOWSQL_BRIDGE_PYTHON_OPERATOR_BRIDGE_H_
 #define _FLOWSQL_BRIDGE_PYTHON_OPERATOR_BRIDGE_H_
 
-#include <httplib.h>
-
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "framework/interfaces/ioperator.h"
+#include "worker_pool.h"
 
 namespace flowsql {
 namespace bridge {
@@ -19,11 +19,13 @@ struct OperatorMeta {
     OperatorPosition position = OperatorPosition::DATA;
 };
 
-// PythonOperatorBridge — 实现 IOperator，将 Work() 转发给 Python Worker
-// Work() 内部 dynamic_cast 到 IDataFrameChannel，完成 Read/Write + Arrow IPC 序列化
-class PythonOperatorBridge : public IOperator {
+// PythonOperatorBridge — 实现 IOperator / IBatchOperator，将调用转发给 Worker 池中在途调用最少的 Python Worker
+// WorkBatches() 边从读端取输入边经共享内存环发送，输出逐批交给写端；Work() 是其 DataFrame 通道包装
+// 连不上 Worker 的数据 socket 或单行超过环容量时回退到文件 + HTTP（输入与输出整体拼接）；
+// 所选 Worker 不可达且输入尚可重放（至多取走第一批、还没有输出）时换一个 Worker 重试一次
+class PythonOperatorBridge : public IOperator, public IBatchOperator {
  public:
-    PythonOperatorBridge(const OperatorMeta& meta, const std::string& host, int port);
+    PythonOperatorBridge(const OperatorMeta& meta, std::shared_ptr<WorkerPool> pool);
     ~PythonOperatorBridge() override = default;
 
     // IOperator 元数据
@@ -32,21 +34,52 @@ class PythonOperatorBridge : public IOperator {
     std::string Description() override { return meta_.description; }
     OperatorPosition Position() override { return meta_.position; }
 
-    // 核心：从 in 通道读取 DataFrame → Arrow IPC → Python Worker → 写入 out 通道
+    // 从 in 通道读取 DataFrame → Python Worker → 写入 out 通道
     int Work(IChannel* in, IChannel* out) override;
 
-    // 配置转发
+    // 核心：逐批输入 → Arrow IPC → Python Worker → 逐批输出
+    int WorkBatches(const BatchSource& next, const BatchSink& emit) override;
+
+    // 配置转发（广播到池中所有 Worker）
     int Configure(const char* key, const char* value) override;
 
-    // 错误信息
-    std::string LastError() override { return last_error_; }
+    // 错误信息：同一实例被多个查询并发调用，错误按调用线程隔离，返回本线程最近一次调用的结果
+    std::string LastError() override;
 
  private:
+    // 读端包装：记住取到的第一批，换 Worker 重试或回退文件通道时重放
+    struct InputCursor {
+        explicit InputCursor(const BatchSource& next) : next(next) {}
+        int Next(std::shared_ptr<arrow::RecordBatch>* batch);
+        // 从头重新读取；已取走第二批时无法重放，返回 false
+        bool Rewind();
+
+        const BatchSource& next;
+        std::shared_ptr<arrow::RecordBatch> first;
+        int pulled = 0;  // 已从读端取走的批次数
+        bool exhausted = false;
+        bool replay = false;
+    };
+
+    // 以下均把错误写入调用方的 error，不触及实例状态，可并发调用
+    // 分派、重试并执行一次逐批调用
+    int Run(const BatchSource& next, const BatchSink& emit, std::string* error);
+
+    // 在一个 Worker 上调用算子；unreachable 表示连不上该 Worker
+    int Call(PythonWorker* worker, InputCursor* input, const BatchSink& emit, bool* unreachable,
+             std::string* error);
+
+    // 原通道：输入拼接后写到共享内存文件，HTTP POST 路径，Worker 写 _out 文件后读回
+    int WorkViaFile(PythonWorker* worker, InputCursor* input, const BatchSink& emit, bool* unreachable,
+                    std::string* error);
+
+    // 记录日志并发布错误，返回 -1
+    int Fail(const std::string& error);
+    // 调用结束时发布本次结果，供同一线程随后的 LastError 读取
+    void PublishError(const std::string& error);
+
     OperatorMeta meta_;
-    std::unique_ptr<httplib::Client> client_;
-    std::string host_;
-    int port_;
-    std::string last_error_;
+    std::shared_ptr<WorkerPool> pool_;
 };
 
 }  // namespace bridge
@@ -0,0 +1,233 @@
+#include "shm_ring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace flowsql {
+namespace bridge {
+
+namespace {
+
+constexpr uint32_t kRecordData = 1;
+constexpr uint32_t kRecordPad = 2;
+
+// 头部字段偏移
+constexpr size_t kMagicOffset = 0;
+constexpr size_t kVersionOffset = 8;
+constexpr size_t kCapacityOffset = 16;
+constexpr size_t kControlOffset = 64;
+constexpr size_t kControlSize = 128;
+
+size_t AlignUp(size_t n, size_t align) { return (n + align - 1) / align * align; }
+
+void WriteRecordHeader(uint8_t* at, uint32_t kind, uint64_t len) {
+    uint32_t reserved = 0;
+    memcpy(at, &kind, sizeof(kind));
+    memcpy(at + 4, &reserved, sizeof(reserved));
+    memcpy(at + 8, &len, sizeof(len));
+}
+
+}  // namespace
+
+// 环控制块：head 由生产者推进，tail 由消费者推进，分处两条缓存行避免伪共享
+struct ShmRing::Control {
+    std::atomic<uint64_t> head;
+    char pad[56];
+    std::atomic<uint64_t> tail;
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == 8 && std::atomic<uint64_t>::is_always_lock_free,
+              "ring control words must be lock-free 64-bit atomics");
+
+ShmRing::~ShmRing() {
+    Close();
+}
+
+int ShmRing::Create(const std::string& path, size_t capacity) {
+    Close();
+    capacity = AlignUp(capacity, kAlign);
+    if (capacity < kAlign * 2) {
+        printf("ShmRing::Create: capacity too small: %zu\n", capacity);
+        return -1;
+    }
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        printf("ShmRing::Create: open %s failed: %s\n", path.c_str(), strerror(errno));
+        return -1;
+    }
+    size_t size = kHeaderSize + 2 * capacity;
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        printf("ShmRing::Create: ftruncate failed: %s\n", strerror(errno));
+        close(fd);
+        unlink(path.c_str());
+        return -1;
+    }
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        printf("ShmRing::Create: mmap failed: %s\n", strerror(errno));
+        unlink(path.c_str());
+        return -1;
+    }
+
+    path_ = path;
+    base_ = static_cast<uint8_t*>(addr);
+    mapped_size_ = size;
+    capacity_ = capacity;
+
+    // 新文件内容全为 0，head / tail 已经是 0；magic 最后写，对端据此判断头部已初始化
+    uint32_t version = kVersion;
+    uint64_t cap = capacity;
+    memcpy(base_ + kVersionOffset, &version, sizeof(version));
+    memcpy(base_ + kCapacityOffset, &cap, sizeof(cap));
+    uint64_t magic = kMagic;
+    memcpy(base_ + kMagicOffset, &magic, sizeof(magic));
+    return 0;
+}
+
+int ShmRing::Open(const std::string& path) {
+    Close();
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        printf("ShmRing::Open: open %s failed: %s\n", path.c_str(), strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kHeaderSize) {
+        printf("ShmRing::Open: %s is not a ring file\n", path.c_str());
+        close(fd);
+        return -1;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        printf("ShmRing::Open: mmap failed: %s\n", strerror(errno));
+        return -1;
+    }
+
+    auto* base = static_cast<uint8_t*>(addr);
+    uint64_t magic = 0, capacity = 0;
+    uint32_t version = 0;
+    memcpy(&magic, base + kMagicOffset, sizeof(magic));
+    memcpy(&version, base + kVersionOffset, sizeof(version));
+    memcpy(&capacity, base + kCapacityOffset, sizeof(capacity));
+    if (magic != kMagic || version != kVersion || kHeaderSize + 2 * capacity != size) {
+        printf("ShmRing::Open: %s has bad header (version=%u, capacity=%llu)\n", path.c_str(), version,
+               (unsigned long long)capacity);
+        munmap(addr, size);
+        return -1;
+    }
+
+    path_ = path;
+    base_ = base;
+    mapped_size_ = size;
+    capacity_ = static_cast<size_t>(capacity);
+    return 0;
+}
+
+void ShmRing::Unlink() {
+    if (!path_.empty()) {
+        unlink(path_.c_str());
+        path_.clear();
+    }
+}
+
+void ShmRing::Close() {
+    if (base_) {
+        munmap(base_, mapped_size_);
+        base_ = nullptr;
+    }
+    mapped_size_ = 0;
+    capacity_ = 0;
+    path_.clear();
+    for (int i = 0; i < 2; ++i) pending_pos_[i] = pending_head_[i] = pending_len_[i] = 0;
+}
+
+ShmRing::Control* ShmRing::ControlOf(RingDirection dir) const {
+    return reinterpret_cast<Control*>(base_ + kControlOffset + static_cast<size_t>(dir) * kControlSize);
+}
+
+uint8_t* ShmRing::DataOf(RingDirection dir) const {
+    return base_ + kHeaderSize + static_cast<size_t>(dir) * capacity_;
+}
+
+uint8_t* ShmRing::Reserve(RingDirection dir, size_t len) {
+    if (!base_) return nullptr;
+    size_t total = AlignUp(kRecordHeaderSize + len, kAlign);
+    if (total > capacity_) return nullptr;
+
+    Control* ctl = ControlOf(dir);
+    uint64_t head = ctl->head.load(std::memory_order_relaxed);  // 只有本端写 head
+    uint64_t tail = ctl->tail.load(std::memory_order_acquire);
+    uint64_t pos = head % capacity_;
+
+    // 尾部放不下时先用 PAD 占满到末尾，payload 从数据区起点开始
+    uint64_t pad = (pos + total > capacity_) ? capacity_ - pos : 0;
+    if (capacity_ - (head - tail) < pad + total) return nullptr;
+
+    uint8_t* data = DataOf(dir);
+    if (pad > 0) {
+        WriteRecordHeader(data + pos, kRecordPad, pad - kRecordHeaderSize);
+        head += pad;
+        pos = 0;
+    }
+    pending_pos_[static_cast<int>(dir)] = pos;
+    pending_len_[static_cast<int>(dir)] = len;
+    pending_head_[static_cast<int>(dir)] = head + total;
+    return data + pos + kRecordHeaderSize;
+}
+
+void ShmRing::Commit(RingDirection dir) {
+    int i = static_cast<int>(dir);
+    WriteRecordHeader(DataOf(dir) + pending_pos_[i], kRecordData, pending_len_[i]);
+    ControlOf(dir)->head.store(pending_head_[i], std::memory_order_release);
+}
+
+int ShmRing::Peek(RingDirection dir, const uint8_t** data, size_t* len) {
+    if (!base_) return -1;
+    Control* ctl = ControlOf(dir);
+    uint8_t* ring = DataOf(dir);
+    uint64_t tail = ctl->tail.load(std::memory_order_relaxed);  // 只有本端写 tail
+    while (true) {
+        uint64_t head = ctl->head.load(std::memory_order_acquire);
+        if (tail == head) return -1;
+        uint64_t pos = tail % capacity_;
+        uint32_t kind = 0;
+        uint64_t length = 0;
+        memcpy(&kind, ring + pos, sizeof(kind));
+        memcpy(&length, ring + pos + 8, sizeof(length));
+        if (kind == kRecordPad) {
+            tail += capacity_ - pos;
+            ctl->tail.store(tail, std::memory_order_release);
+            continue;
+        }
+        if (kind != kRecordData || pos + kRecordHeaderSize + length > capacity_) {
+            printf("ShmRing::Peek: corrupted record at %llu\n", (unsigned long long)tail);
+            return -1;
+        }
+        *data = ring + pos + kRecordHeaderSize;
+        *len = static_cast<size_t>(length);
+        return 0;
+    }
+}
+
+void ShmRing::Release(RingDirection dir) {
+    Control* ctl = ControlOf(dir);
+    uint64_t tail = ctl->tail.load(std::memory_order_relaxed);
+    uint64_t pos = tail % capacity_;
+    uint64_t length = 0;
+    memcpy(&length, DataOf(dir) + pos + 8, sizeof(length));
+    ctl->tail.store(tail + AlignUp(kRecordHeaderSize + length, kAlign), std::memory_order_release);
+}
+
+}  // namespace bridge
+}  // namespace flowsql
@@ -0,0 +1,84 @@
+#ifndef _FLOWSQL_BRIDGE_SHM_RING_H_
+#define _FLOWSQL_BRIDGE_SHM_RING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace flowsql {
+namespace bridge {
+
+// 环方向：REQUEST 由 C++ 写、Worker 读；RESPONSE 由 Worker 写、C++ 读
+enum class RingDirection { REQUEST = 0, RESPONSE = 1 };
+
+// ShmRing — C++ 进程与 Python Worker 之间常驻的 mmap 共享内存，内含两个单生产者单消费者环
+// Arrow IPC 消息直接写在环内，对端原地读取；何时有新消息由 Unix socket 上的门铃通知，
+// 门铃收发本身是系统调用，保证 head / tail 的写入先于对端读取可见
+//
+// 文件布局（与 python/flowsql/shm_ring.py 保持一致，整数均为小端）：
+//   [0, 4096)                 头部：magic u64 | version u32 | 保留 u32 | capacity u64
+//                             环 i 的控制块位于 64 + i * 128：head u64（+0），tail u64（+64），各占一条缓存行
+//   [4096 + i * capacity, …)  环 i 的数据区
+// 记录：kind u32 | 保留 u32 | length u64 | payload，整体按 64 字节对齐；
+// 剩余空间放不下整条记录时写一条 PAD 记录占满到数据区末尾，从 0 重新开始，保证 payload 连续
+class ShmRing {
+ public:
+    static constexpr uint64_t kMagic = 0x474E495251534C46ULL;  // "FLSQRING"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 4096;
+    static constexpr size_t kRecordHeaderSize = 16;
+    static constexpr size_t kAlign = 64;
+
+    ShmRing() = default;
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // 创建并映射共享内存文件，capacity 为每个环的数据区大小（向上取整到 kAlign）
+    int Create(const std::string& path, size_t capacity);
+
+    // 映射已存在的共享内存文件（对端 / 测试使用）
+    int Open(const std::string& path);
+
+    // 删除文件名；双方都已映射后调用，进程退出时内核回收内存，不留残留文件
+    void Unlink();
+
+    void Close();
+
+    bool IsOpen() const { return base_ != nullptr; }
+    size_t Capacity() const { return capacity_; }
+    const std::string& Path() const { return path_; }
+
+    // 生产者：预留 len 字节的连续空间，返回 payload 起始地址；len 超过容量或剩余空间不足返回 nullptr
+    // 预留后必须 Commit 才对消费者可见，同一方向同时只能有一个未提交的预留
+    uint8_t* Reserve(RingDirection dir, size_t len);
+    void Commit(RingDirection dir);
+
+    // 消费者：取最早一条记录（跳过 PAD），没有时返回 -1；Release 之前 data 一直有效
+    int Peek(RingDirection dir, const uint8_t** data, size_t* len);
+    void Release(RingDirection dir);
+
+    // 单条记录 payload 的上限
+    size_t MaxPayload() const { return capacity_ - kRecordHeaderSize; }
+
+ private:
+    struct Control;
+    Control* ControlOf(RingDirection dir) const;
+    uint8_t* DataOf(RingDirection dir) const;
+
+    std::string path_;
+    uint8_t* base_ = nullptr;
+    size_t mapped_size_ = 0;
+    size_t capacity_ = 0;
+
+    // 生产者未提交的预留：记录所在的位置与提交后的新 head
+    uint64_t pending_pos_[2] = {0, 0};
+    uint64_t pending_head_[2] = {0, 0};
+    uint64_t pending_len_[2] = {0, 0};
+};
+
+}  // namespace bridge
+}  // namespace flowsql
+
+#endif  // _FLOWSQL_BRIDGE_SHM_RING_H_
@@ -0,0 +1,403 @@
+#include "shm_transport.h"
+
+#include <sys/socket.h>
+#include <sys/statvfs.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
+#include <arrow/util/byte_size.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "arrow_ipc_serializer.h"
+#include "control_message.h"
+#include "control_protocol.h"
+
+namespace flowsql {
+namespace bridge {
+
+namespace {
+
+constexpr int kRecvTimeoutS = 30;  // 与 HTTP 通道的读超时一致
+constexpr int kSendTimeoutS = 10;
+constexpr int64_t kRetryBackoffMs = 5000;
+
+int64_t NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// 环文件目录：/dev/shm 放得下两个环时优先，否则回退 /tmp
+std::string RingDir(size_t capacity) {
+    struct statvfs stat;
+    if (statvfs("/dev/shm", &stat) == 0) {
+        uint64_t free_bytes = static_cast<uint64_t>(stat.f_bavail) * stat.f_frsize;
+        if (free_bytes > 4ULL * capacity) return "/dev/shm";
+    }
+    return "/tmp";
+}
+
+std::string MakePayload(std::initializer_list<std::pair<const char*, std::string>> fields) {
+    rapidjson::StringBuffer sb;
+    rapidjson::Writer<rapidjson::StringBuffer> w(sb);
+    w.StartObject();
+    for (auto& [key, value] : fields) {
+        w.Key(key);
+        w.String(value.c_str(), static_cast<rapidjson::SizeType>(value.size()));
+    }
+    w.EndObject();
+    return sb.GetString();
+}
+
+// 从 RESPONSE 环读出一批结果：先复制到自有 buffer 再解码（DataFrame 会零拷贝引用 buffer，环空间随后要归还）
+int ReadResult(const uint8_t* data, size_t len, std::vector<std::shared_ptr<arrow::RecordBatch>>* results) {
+    auto alloc = arrow::AllocateBuffer(static_cast<int64_t>(len));
+    if (!alloc.ok()) return -1;
+    std::shared_ptr<arrow::Buffer> buffer = std::move(*alloc);
+    memcpy(buffer->mutable_data(), data, len);
+
+    auto reader = arrow::ipc::RecordBatchStreamReader::Open(std::make_shared<arrow::io::BufferReader>(buffer));
+    if (!reader.ok()) return -1;
+    // Worker 按 Table 输出，一条记录里可能有多个 RecordBatch
+    auto batches = (*reader)->ToRecordBatches();
+    if (!batches.ok()) return -1;
+    results->insert(results->end(), batches->begin(), batches->end());
+    return 0;
+}
+
+}  // namespace
+
+ShmTransport::ShmTransport(const std::string& socket_path, size_t ring_capacity, int window, int64_t chunk_rows)
+    : socket_path_(socket_path),
+      ring_capacity_(ring_capacity),
+      window_(window > 0 ? window : 1),
+      chunk_rows_(chunk_rows > 0 ? chunk_rows : 1) {}
+
+ShmTransport::~ShmTransport() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disconnect();
+}
+
+int ShmTransport::Connect() {
+    if (NowMs() < retry_after_ms_) return -1;
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        printf("ShmTransport: socket() failed: %s\n", strerror(errno));
+        retry_after_ms_ = NowMs() + kRetryBackoffMs;
+        return -1;
+    }
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+    struct timeval recv_tv = {kRecvTimeoutS, 0};
+    struct timeval send_tv = {kSendTimeoutS, 0};
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &recv_tv, sizeof(recv_tv));
+    setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &send_tv, sizeof(send_tv));
+    if (connect(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        printf("ShmTransport: connect %s failed: %s, using HTTP\n", socket_path_.c_str(), strerror(errno));
+        Disconnect();
+        retry_after_ms_ = NowMs() + kRetryBackoffMs;
+        return -1;
+    }
+
+    // 环文件只在握手期间存在：Worker 映射后即删除文件名，进程退出后内核自动回收
+    static std::atomic<int> seq{0};
+    std::string path = RingDir(ring_capacity_) + "/flowsql_ring_" + std::to_string(getpid()) + "_" +
+                       std::to_string(seq++);
+    std::string reply;
+    if (ring_.Create(path, ring_capacity_) != 0 ||
+        SendLine(ControlMessage::BuildCommand(MessageType::ATTACH_RING, MakePayload({{"path", path}}))) != 0 ||
+        ReceiveReply(MessageType::ACK, &reply) != 0) {
+        printf("ShmTransport: attach ring %s failed, using HTTP\n", path.c_str());
+        Disconnect();
+        retry_after_ms_ = NowMs() + kRetryBackoffMs;
+        return -1;
+    }
+    ring_.Unlink();
+    printf("ShmTransport: attached %zuMB ring to worker at %s\n", ring_.Capacity() >> 20, socket_path_.c_str());
+    return 0;
+}
+
+bool ShmTransport::Connected() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fd_ >= 0;
+}
+
+void ShmTransport::Disconnect() {
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    ring_.Unlink();
+    ring_.Close();
+    recv_buffer_.clear();
+}
+
+int ShmTransport::SendLine(const std::string& line) {
+    size_t sent = 0;
+    while (sent < line.size()) {
+        ssize_t n = send(fd_, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            printf("ShmTransport: send() failed: %s\n", strerror(errno));
+            return -1;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return 0;
+}
+
+int ShmTransport::ReceiveLine(std::string* line) {
+    char buffer[4096];
+    while (true) {
+        size_t pos = recv_buffer_.find('\n');
+        if (pos != std::string::npos) {
+            *line = recv_buffer_.substr(0, pos);
+            recv_buffer_.erase(0, pos + 1);
+            return 0;
+        }
+        ssize_t n = recv(fd_, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            printf("ShmTransport: recv() failed: %s\n", n == 0 ? "connection closed" : strerror(errno));
+            return -1;
+        }
+        recv_buffer_.append(buffer, static_cast<size_t>(n));
+    }
+}
+
+int ShmTransport::ReceiveReply(const char* expected_type, std::string* payload) {
+    std::string line, type;
+    if (ReceiveLine(&line) != 0) return -1;
+    if (ControlMessage::ParseMessage(line, &type, payload) != 0) return -1;
+    if (type != expected_type) {
+        printf("ShmTransport: expected %s, got %s: %s\n", expected_type, type.c_str(), payload->c_str());
+        return -1;
+    }
+    return 0;
+}
+
+int ShmTransport::ReceiveResult(const char* expected_type, const BatchSink& emit, std::string* error) {
+    std::string payload;
+    if (ReceiveReply(expected_type, &payload) != 0) {
+        // 连接状态未知，环内残留的记录无法回收，断开后下次调用重新建环
+        *error = "shared memory call to Python Worker failed";
+        Disconnect();
+        return -1;
+    }
+
+    rapidjson::Document doc;
+    doc.Parse(payload.c_str());
+    if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("ok") || !doc["ok"].IsBool()) {
+        *error = std::string("invalid ") + expected_type + " payload: " + payload;
+        Disconnect();
+        return -1;
+    }
+    if (!doc["ok"].GetBool()) {
+        if (error->empty()) {
+            *error = doc.HasMember("error") && doc["error"].IsString() ? doc["error"].GetString() : "operator failed";
+        }
+        return 0;
+    }
+
+    // 结果在 RESPONSE 环中放不下时 Worker 写到文件，按原文件通道读取
+    if (doc.HasMember("output") && doc["output"].IsString()) {
+        std::string output_path = doc["output"].GetString();
+        std::shared_ptr<arrow::RecordBatch> batch;
+        int ret = ArrowIpcSerializer::DeserializeFromFile(output_path, &batch);
+        std::remove(output_path.c_str());
+        if (ret != 0 && error->empty()) *error = "Deserialize Arrow IPC from file failed: " + output_path;
+        if (error->empty() && emit(batch) != 0) *error = "write operator output failed";
+        return 0;
+    }
+    if (doc.HasMember("empty") && doc["empty"].IsBool() && doc["empty"].GetBool()) return 0;
+
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+    if (ring_.Peek(RingDirection::RESPONSE, &data, &len) != 0) {
+        *error = "no result in response ring";
+        Disconnect();
+        return -1;
+    }
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    int ret = ReadResult(data, len, &batches);
+    ring_.Release(RingDirection::RESPONSE);
+    if (ret != 0 && error->empty()) *error = "Deserialize Arrow IPC from ring failed";
+    for (auto& batch : batches) {
+        if (!error->empty()) break;
+        if (emit(batch) != 0) *error = "write operator output failed";
+    }
+    return 0;
+}
+
+int ShmTransport::SendBatch(const std::shared_ptr<arrow::RecordBatch>& batch, size_t max_bytes,
+                            const std::string& doorbell, int* outstanding, const BatchSink& emit,
+                            std::string* error) {
+    // 先用 MockOutputStream 算出 IPC 流长度，再在环内预留空间原地写入
+    auto mock = std::make_shared<arrow::io::MockOutputStream>();
+    auto sizer = arrow::ipc::MakeStreamWriter(mock, batch->schema());
+    if (!sizer.ok() || !(*sizer)->WriteRecordBatch(*batch).ok() || !(*sizer)->Close().ok()) {
+        *error = "Arrow IPC serialize failed";
+        return -1;
+    }
+    size_t size = static_cast<size_t>(mock->GetExtentBytesWritten());
+    if (size > max_bytes) return kNotHandled;
+
+    // 窗口已满或环中暂无空间时，先收取最早批次的回复（Worker 回复前已归还其输入记录）
+    uint8_t* slot = nullptr;
+    while (*outstanding >= window_ || !(slot = ring_.Reserve(RingDirection::REQUEST, size))) {
+        if (*outstanding == 0) {
+            *error = "request ring has no space";
+            Disconnect();
+            return -1;
+        }
+        if (ReceiveResult(MessageType::BATCH_DONE, emit, error) != 0) return -1;
+        --*outstanding;
+    }
+
+    auto sink = std::make_shared<arrow::io::FixedSizeBufferWriter>(
+        std::make_shared<arrow::MutableBuffer>(slot, static_cast<int64_t>(size)));
+    auto writer = arrow::ipc::MakeStreamWriter(sink, batch->schema());
+    if (!writer.ok() || !(*writer)->WriteRecordBatch(*batch).ok() || !(*writer)->Close().ok()) {
+        *error = "Arrow IPC serialize to ring failed";
+        return -1;  // 未提交，预留的空间下次 Reserve 时覆盖
+    }
+    ring_.Commit(RingDirection::REQUEST);
+
+    if (SendLine(doorbell) != 0) {
+        *error = "shared memory call to Python Worker failed";
+        Disconnect();
+        return -1;
+    }
+    ++*outstanding;
+    return 0;
+}
+
+int ShmTransport::Call(const std::string& catelog, const std::string& name, const BatchSource& next,
+                       const BatchSink& emit, std::string* error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0 && Connect() != 0) return kNotHandled;
+
+    // 单批 IPC 不超过环容量的一半：对端消费完后无论写位置在哪都放得下，不会卡住
+    size_t max_bytes = ring_.Capacity() / 2 - ShmRing::kAlign - ShmRing::kRecordHeaderSize;
+
+    std::string batch_line = ControlMessage::BuildCommand(MessageType::BATCH, "{}");
+    std::string begin_line =
+        ControlMessage::BuildCommand(MessageType::STREAM_BEGIN, MakePayload({{"catelog", catelog}, {"name", name}}));
+    std::shared_ptr<arrow::Schema> in_schema;
+    int64_t emitted = 0;
+    BatchSink deliver = [&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+        ++emitted;
+        return emit(batch);
+    };
+    std::string op_error;
+    int outstanding = 0;
+    bool begun = false;
+
+    while (op_error.empty()) {
+        std::shared_ptr<arrow::RecordBatch> in;
+        int rc = next(&in);
+        if (rc == 1) break;
+        if (rc != 0 || !in) {
+            op_error = "read operator input failed";
+            break;
+        }
+        if (!in_schema) in_schema = in->schema();
+
+        // 按本批平均行宽估算每片行数，目标为环容量的 1/4，使窗口内能有多批同时在途
+        int64_t num_rows = in->num_rows();
+        int64_t chunk_rows = chunk_rows_;
+        if (num_rows > 0) {
+            int64_t row_bytes = std::max<int64_t>(1, arrow::util::TotalBufferSize(*in) / num_rows);
+            chunk_rows = std::min<int64_t>(chunk_rows, std::max<int64_t>(1, max_bytes / 2 / row_bytes));
+        }
+
+        // 空批也发送，算子据此拿到 schema；切片零拷贝，序列化时只写切片范围内的数据
+        int64_t offset = 0;
+        do {
+            auto chunk = in->Slice(offset, std::min(chunk_rows, num_rows - offset));
+            // stream_begin 与第一个 batch 门铃合并发送，第一片放不下时还没有发出任何消息
+            int ret = SendBatch(chunk, max_bytes, begun ? batch_line : begin_line + batch_line, &outstanding,
+                                deliver, &op_error);
+            if (ret == kNotHandled) {
+                if (chunk->num_rows() > 1) {
+                    chunk_rows = (chunk->num_rows() + 1) / 2;
+                    continue;
+                }
+                if (!begun) return kNotHandled;
+                op_error = "row exceeds shared memory ring capacity";
+                break;
+            }
+            if (ret != 0) {
+                if (fd_ < 0) {
+                    *error = op_error;
+                    return -1;
+                }
+                break;  // 本地序列化失败：连接仍然可用，照常结束流
+            }
+            begun = true;
+            offset += chunk->num_rows();
+        } while (offset < num_rows && op_error.empty());
+    }
+
+    if (!begun) {
+        if (!op_error.empty()) {
+            *error = op_error;
+            return -1;
+        }
+        // 读端没有任何输入：只开流不发批次，Worker 按空输入执行算子
+        if (SendLine(begin_line) != 0) {
+            *error = "shared memory call to Python Worker failed";
+            Disconnect();
+            return -1;
+        }
+    }
+    // Worker 出错后仍会逐批回复并归还记录，收完所有回复再结束流，保持连接可复用
+    for (; outstanding > 0; --outstanding) {
+        if (ReceiveResult(MessageType::BATCH_DONE, deliver, &op_error) != 0) {
+            *error = op_error;
+            return -1;
+        }
+    }
+    if (SendLine(ControlMessage::BuildCommand(MessageType::STREAM_END, "{}")) != 0) {
+        *error = "shared memory call to Python Worker failed";
+        Disconnect();
+        return -1;
+    }
+    if (ReceiveResult(MessageType::STREAM_DONE, deliver, &op_error) != 0 || !op_error.empty()) {
+        *error = op_error;
+        return -1;
+    }
+
+    // 没有任何输出时交出一个与输入同 schema 的空批，写端据此建表
+    if (emitted == 0 && in_schema) {
+        auto empty = arrow::RecordBatch::MakeEmpty(in_schema);
+        if (!empty.ok()) {
+            *error = "create empty result failed";
+            return -1;
+        }
+        if (emit(*empty) != 0) {
+            *error = "write operator output failed";
+            return -1;
+        }
+    }
+    return 0;
+}
+
+}  // namespace bridge
+}  // namespace flowsql
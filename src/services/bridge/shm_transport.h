@@ -0,0 +1,78 @@
+#ifndef _FLOWSQL_BRIDGE_SHM_TRANSPORT_H_
+#define _FLOWSQL_BRIDGE_SHM_TRANSPORT_H_
+
+#include <arrow/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "framework/interfaces/ioperator.h"
+#include "shm_ring.h"
+
+namespace flowsql {
+namespace bridge {
+
+// ShmTransport — 经共享内存环调用 Python 算子，替代每次调用的文件读写 + HTTP 往返
+// 首次调用时连接 Worker 的数据 socket，创建环文件并发送 attach_ring，对端映射后即删除文件名；
+// 之后每次调用是一个流：stream_begin → 从读端逐批取输入，按 chunk_rows 切片原地写入 REQUEST 环并发 batch 门铃 →
+// stream_end。最多 window 个批次未收到 batch_done，输出在后续批次发送的同时逐批从 RESPONSE 环取回并立即交给写端，
+// 共享内存与本地内存占用都与数据总量无关
+// 同一 Worker 上的所有 Python 算子共享一个实例，调用串行（Worker 本身也是逐个执行算子）
+class ShmTransport {
+ public:
+    // 本次调用没有经过共享内存（未连上 Worker、首批输入的单行超过环容量），调用方应改走文件 + HTTP
+    // 此时什么都没有发送，读端最多已取走第一批、写端没有收到任何输出
+    static constexpr int kNotHandled = 1;
+
+    ShmTransport(const std::string& socket_path, size_t ring_capacity, int window = 4,
+                 int64_t chunk_rows = 65536);
+    ~ShmTransport();
+
+    ShmTransport(const ShmTransport&) = delete;
+    ShmTransport& operator=(const ShmTransport&) = delete;
+
+    // 调用 Python 算子：next 逐批提供输入，每个输出批次经 emit 交出
+    // 成功返回 0；失败返回 -1 并设置 error；返回 kNotHandled 时什么都没有发送
+    // Worker 没有任何输出时按输入 schema 交出一个空批
+    int Call(const std::string& catelog, const std::string& name, const BatchSource& next, const BatchSink& emit,
+             std::string* error);
+
+    const std::string& SocketPath() const { return socket_path_; }
+
+    // 连接是否仍然建立：Call 返回 -1 后为 false 表示 Worker 不可达（进程退出等），而不是算子出错
+    bool Connected();
+
+ private:
+    // 以下均在 mutex_ 内调用
+    int Connect();
+    void Disconnect();
+    int SendLine(const std::string& line);
+    int ReceiveLine(std::string* line);
+    int ReceiveReply(const char* expected_type, std::string* payload);
+    // 写入一批输入并发门铃：成功返回 0；序列化后超过 max_bytes 返回 kNotHandled（什么都没写）；
+    // 失败返回 -1，连接异常时已断开。窗口已满或环中暂无空间时先收取未完成批次的回复
+    int SendBatch(const std::shared_ptr<arrow::RecordBatch>& batch, size_t max_bytes, const std::string& doorbell,
+                  int* outstanding, const BatchSink& emit, std::string* error);
+    // 收取一条 batch_done / stream_done 并将其输出交给 emit：连接异常返回 -1（已断开）；
+    // 算子或写端失败时只记录第一条错误，之后的输出丢弃
+    int ReceiveResult(const char* expected_type, const BatchSink& emit, std::string* error);
+
+    std::string socket_path_;
+    size_t ring_capacity_;
+    int window_;          // 未收到回复的批次上限
+    int64_t chunk_rows_;  // 每批行数上限，实际还受环容量约束
+
+    std::mutex mutex_;
+    int fd_ = -1;
+    ShmRing ring_;
+    std::string recv_buffer_;
+    int64_t retry_after_ms_ = 0;  // 连接失败后的退避，期间直接回退到 HTTP
+};
+
+}  // namespace bridge
+}  // namespace flowsql
+
+#endif  // _FLOWSQL_BRIDGE_SHM_TRANSPORT_H_
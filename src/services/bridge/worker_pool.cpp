@@ -0,0 +1,87 @@
+#include "worker_pool.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace flowsql {
+namespace bridge {
+
+namespace {
+
+int64_t NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+PythonWorker::PythonWorker(const std::string& host, int port, std::shared_ptr<ShmTransport> transport)
+    : host(host), port(port), transport(std::move(transport)) {
+    client = std::make_unique<httplib::Client>(host, port);
+    client->set_connection_timeout(5);
+    client->set_read_timeout(30);
+    client->set_write_timeout(10);
+    client->set_keep_alive(true);
+}
+
+void WorkerPool::Reset(std::vector<std::shared_ptr<PythonWorker>> workers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    workers_ = std::move(workers);
+}
+
+std::shared_ptr<PythonWorker> WorkerPool::Find(const std::string& host, int port) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& worker : workers_) {
+        if (worker->host == host && worker->port == port) return worker;
+    }
+    return nullptr;
+}
+
+std::vector<std::shared_ptr<PythonWorker>> WorkerPool::Workers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return workers_;
+}
+
+size_t WorkerPool::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return workers_.size();
+}
+
+std::shared_ptr<PythonWorker> WorkerPool::Acquire(const PythonWorker* exclude) {
+    std::vector<std::shared_ptr<PythonWorker>> workers = Workers();
+    if (workers.empty()) return nullptr;
+
+    int64_t now = NowMs();
+    size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+    std::shared_ptr<PythonWorker> best;
+    bool best_up = false;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        auto& worker = workers[(start + i) % workers.size()];
+        if (worker.get() == exclude && workers.size() > 1) continue;
+        bool up = worker->down_until_ms.load(std::memory_order_relaxed) <= now;
+        if (!best || (up && !best_up) ||
+            (up == best_up && worker->inflight.load(std::memory_order_relaxed) <
+                                  best->inflight.load(std::memory_order_relaxed))) {
+            best = worker;
+            best_up = up;
+        }
+    }
+    best->inflight.fetch_add(1, std::memory_order_relaxed);
+    return best;
+}
+
+void WorkerPool::Release(const std::shared_ptr<PythonWorker>& worker, bool unreachable) {
+    worker->inflight.fetch_sub(1, std::memory_order_relaxed);
+    if (unreachable) {
+        if (worker->down_until_ms.exchange(NowMs() + kDownMs) == 0) {
+            printf("WorkerPool: Python Worker %s:%d unreachable, skipping for %llds\n", worker->host.c_str(),
+                   worker->port, (long long)kDownMs / 1000);
+        }
+    } else {
+        worker->down_until_ms.store(0, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace bridge
+}  // namespace flowsql
@@ -0,0 +1,63 @@
+#ifndef _FLOWSQL_BRIDGE_WORKER_POOL_H_
+#define _FLOWSQL_BRIDGE_WORKER_POOL_H_
+
+#include <httplib.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "shm_transport.h"
+
+namespace flowsql {
+namespace bridge {
+
+// PythonWorker — 一个 Python Worker 进程的调用端
+// 创建后 host / port / transport 不再变化；Worker 的数据 socket 变了就换一个新对象，进行中的调用继续用旧的
+struct PythonWorker {
+    PythonWorker(const std::string& host, int port, std::shared_ptr<ShmTransport> transport);
+
+    std::string host;
+    int port;
+    std::shared_ptr<ShmTransport> transport;  // 为空表示只走文件 + HTTP
+
+    std::mutex http_mutex;                    // httplib::Client 不支持并发请求
+    std::unique_ptr<httplib::Client> client;
+
+    std::atomic<int> inflight{0};             // 已分派未返回的调用数
+    std::atomic<int64_t> down_until_ms{0};    // 连接失败后暂停分派，Gateway 负责重启进程
+};
+
+// WorkerPool — 同一组 Python Worker（Gateway 中 pyworker 的各实例），按在途调用数分派
+// 每个 Worker 是独立进程、各有一个 GIL，调用在 Worker 之间并行，在同一 Worker 内串行
+class WorkerPool {
+ public:
+    static constexpr int64_t kDownMs = 3000;
+
+    // 替换成员；调用方传入的对象可以是 Find 返回的旧对象，以保留其共享内存连接
+    void Reset(std::vector<std::shared_ptr<PythonWorker>> workers);
+
+    std::shared_ptr<PythonWorker> Find(const std::string& host, int port) const;
+    std::vector<std::shared_ptr<PythonWorker>> Workers() const;
+    size_t Size() const;
+
+    // 选在途调用最少的可用 Worker（负载相同时轮转），计入在途；没有成员时返回 nullptr
+    // 全部处于暂停期时仍从中挑选，宁可重试也不直接失败
+    std::shared_ptr<PythonWorker> Acquire(const PythonWorker* exclude = nullptr);
+
+    // 调用结束；unreachable 表示连不上 Worker（进程崩溃或正在重启）
+    void Release(const std::shared_ptr<PythonWorker>& worker, bool unreachable);
+
+ private:
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<PythonWorker>> workers_;
+    std::atomic<size_t> next_{0};
+};
+
+}  // namespace bridge
+}  // namespace flowsql
+
+#endif  // _FLOWSQL_BRIDGE_WORKER_POOL_H_
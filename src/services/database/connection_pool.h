@@ -1,11 +1,20 @@
 #ifndef _FLOWSQL_SERVICES_DATABASE_CONNECTION_POOL_H_
 #define _FLOWSQL_SERVICES_DATABASE_CONNECTION_POOL_H_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace flowsql {
 namespace database {
@@ -16,10 +25,69 @@ struct ConnectionPoolConfig {
     int min_connections = 0;                     // 最小连接数
     std::chrono::seconds idle_timeout = std::chrono::seconds(300);  // 空闲超时（5 分钟）
     std::chrono::seconds health_check_interval = std::chrono::seconds(60);  // 健康检查间隔
+    std::chrono::milliseconds acquire_timeout = std::chrono::milliseconds(0);  // 池满时等待归还的最长时间，0 表示立即失败
+    int min_idle = 0;                            // reaper 维持的最少空闲连接数（空闲回收后自动补齐）
+    bool warmup_on_open = false;                 // 通道 Open 时并行预建 max(min_connections, min_idle) 条连接
+};
+
+// 从驱动连接参数中读取连接池配置（未出现的参数保留 config 中的驱动默认值）
+// max_connections / min_idle / idle_timeout（秒）/ acquire_timeout_ms / warmup_on_open
+inline void ApplyPoolParams(const std::unordered_map<std::string, std::string>& params,
+                            ConnectionPoolConfig* config) {
+    auto it = params.find("max_connections");
+    if (it != params.end()) config->max_connections = std::max(1, std::stoi(it->second));
+
+    it = params.find("min_idle");
+    if (it != params.end()) config->min_idle = std::max(0, std::stoi(it->second));
+
+    it = params.find("idle_timeout");
+    if (it != params.end()) config->idle_timeout = std::chrono::seconds(std::stoi(it->second));
+
+    it = params.find("acquire_timeout_ms");
+    if (it != params.end()) config->acquire_timeout = std::chrono::milliseconds(std::stoll(it->second));
+
+    it = params.find("warmup_on_open");
+    if (it != params.end()) config->warmup_on_open = (it->second == "true");
+
+    config->min_idle = std::min(config->min_idle, config->max_connections);
+}
+
+// 连接池运行指标（GetMetrics 快照）
+struct ConnectionPoolMetrics {
+    // Acquire 等待时间直方图上界（毫秒），最后一个桶为 >= 最大上界
+    static constexpr int kWaitBuckets = 6;
+    static constexpr int64_t kWaitBucketBoundsMs[kWaitBuckets - 1] = {1, 10, 100, 1000, 5000};
+
+    int total_connections = 0;
+    int idle_connections = 0;
+    int in_use_connections = 0;
+    int max_connections = 0;
+    int waiters = 0;
+
+    uint64_t acquires = 0;            // 成功的 Acquire 次数
+    uint64_t acquire_timeouts = 0;    // 池满等待超时（或不等待直接失败）次数
+    uint64_t wait_histogram[kWaitBuckets] = {};
+
+    uint64_t connects = 0;            // 工厂函数成功建立的连接数
+    uint64_t connect_failures = 0;
+    double connect_avg_ms = 0;
+    double connect_max_ms = 0;
+
+    uint64_t health_checks = 0;
+    uint64_t health_check_failures = 0;
+    uint64_t idle_evictions = 0;
 };
 
 // 连接池实现
 // 线程安全的连接池，支持连接复用、超时回收、健康检查
+//
+// 并发设计：
+//   - 空闲连接按线程亲和分散到 kStripes 个分片，每个分片独立加锁；线程优先从自己的分片取（LIFO，
+//     取到最近归还的热连接），为空时再依次窃取其他分片，Acquire/Return 的常见路径不争用同一把锁
+//   - 连接总数为原子计数，创建连接先 CAS 预占名额，工厂函数在任何锁之外调用
+//   - 健康检查（Ping）和空闲回收由后台 reaper 线程完成，Acquire 不再同步 Ping；
+//     Acquire 只对取出的连接做一次时间戳比较，避免交出已超过 idle_timeout 的连接
+//   - 池满时按 acquire_timeout 在条件变量上等待 Return/Discard 唤醒，超时才返回错误
 template<typename ConnectionType>
 class ConnectionPool {
 public:
@@ -41,120 +109,132 @@ public:
           total_connections_(0) {
         // 预创建最小连接数
         PrecreateConnections(config_.min_connections);
+        reaper_ = std::thread([this] { ReaperLoop(); });
     }
 
     ~ConnectionPool() {
-        // 关闭所有连接
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (auto conn : pool_) {
-            closer_(conn);
+        {
+            std::lock_guard<std::mutex> lock(reaper_mutex_);
+            stopping_ = true;
+        }
+        reaper_cv_.notify_all();
+        reaper_.join();
+
+        // 关闭所有空闲连接
+        for (auto& stripe : stripes_) {
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            for (auto& entry : stripe.idle) {
+                closer_(entry.conn);
+            }
+            stripe.idle.clear();
         }
-        pool_.clear();
+        std::unique_lock<std::shared_mutex> lock(meta_mutex_);
+        conn_info_.clear();
         total_connections_ = 0;
     }
 
-    // 获取连接（带健康检查）
+    // 获取连接
     // 返回 true 表示成功，false 表示失败（error 会包含错误信息）
+    // 池满时最多等待 acquire_timeout，期间有连接归还或名额释放即被唤醒
     bool Acquire(ConnectionType* conn, std::string* error) {
-        while (true) {
-            ConnectionType candidate{};
-            bool need_ping = false;
-            bool need_close = false;
-
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                if (pool_.empty()) {
-                    // 池中没有可用连接，尝试创建新连接
-                    if (total_connections_ < config_.max_connections) {
-                        ConnectionType new_conn = factory_(error);
-                        if (new_conn) {
-                            auto now = std::chrono::steady_clock::now();
-                            total_connections_++;
-                            conn_info_[new_conn] = {now, now, true};
-                            *conn = new_conn;
-                            return true;
-                        }
-                        return false;
-                    }
-                    if (error) {
-                        *error = "Connection pool exhausted (max_connections=" +
-                                 std::to_string(config_.max_connections) + ")";
-                    }
-                    return false;
-                }
+        AcquireResult result = TryAcquire(conn, error);
+        if (result == AcquireResult::kOk) {
+            RecordWait(std::chrono::nanoseconds(0));
+            return true;
+        }
+        if (result == AcquireResult::kFailed) return false;
 
-                candidate = pool_.front();
-                pool_.pop_front();
+        auto wait_start = std::chrono::steady_clock::now();
 
-                auto now = std::chrono::steady_clock::now();
-                auto& info = conn_info_[candidate];
-                auto idle_time = std::chrono::duration_cast<std::chrono::seconds>(
-                    now - info.last_used).count();
-
-                if (idle_time > config_.idle_timeout.count()) {
-                    // 超时，锁外关闭
-                    conn_info_.erase(candidate);
-                    total_connections_--;
-                    need_close = true;
-                } else {
-                    auto since_check = std::chrono::duration_cast<std::chrono::seconds>(
-                        now - info.last_check).count();
-                    if (since_check >= config_.health_check_interval.count()) {
-                        // 需要健康检查，锁外 ping
-                        need_ping = true;
-                    } else {
-                        // 连接可用，直接返回
-                        info.last_used = now;
-                        info.in_use = true;
-                        *conn = candidate;
-                        return true;
-                    }
-                }
-            }  // 释放锁
-
-            if (need_close) {
-                closer_(candidate);
-                continue;  // 重新尝试获取
+        if (config_.acquire_timeout.count() > 0) {
+            auto deadline = std::chrono::steady_clock::now() + config_.acquire_timeout;
+            std::unique_lock<std::mutex> lock(wait_mutex_);
+            waiters_.fetch_add(1);
+            while (true) {
+                // 尝试期间不持有 wait_mutex_（工厂函数可能很慢），用唤醒计数防止错过这期间的通知
+                uint64_t seen = wakeups_;
+                lock.unlock();
+                result = TryAcquire(conn, error);
+                lock.lock();
+                if (result != AcquireResult::kExhausted) break;
+                if (!wait_cv_.wait_until(lock, deadline, [&] { return wakeups_ != seen; })) break;
             }
-
-            if (need_ping) {
-                bool alive = pinger_(candidate);
-                std::lock_guard<std::mutex> lock(mutex_);
-                if (!alive) {
-                    conn_info_.erase(candidate);
-                    total_connections_--;
-                    closer_(candidate);
-                    continue;  // 重新尝试获取
-                }
-                auto now = std::chrono::steady_clock::now();
-                auto it = conn_info_.find(candidate);
-                if (it == conn_info_.end()) {
-                    // 极端情况：ping 期间连接被其他路径清理
-                    closer_(candidate);
-                    continue;
-                }
-                it->second.last_check = now;
-                it->second.last_used = now;
-                it->second.in_use = true;
-                *conn = candidate;
+            waiters_.fetch_sub(1);
+            if (result == AcquireResult::kOk) {
+                RecordWait(std::chrono::steady_clock::now() - wait_start);
                 return true;
             }
+            if (result == AcquireResult::kFailed) return false;
         }
+
+        acquire_timeouts_.fetch_add(1, std::memory_order_relaxed);
+
+        if (error) {
+            *error = "Connection pool exhausted (max_connections=" +
+                     std::to_string(config_.max_connections) + ")";
+            if (config_.acquire_timeout.count() > 0) {
+                *error += ", waited " + std::to_string(config_.acquire_timeout.count()) + "ms";
+            }
+        }
+        return false;
     }
 
-    // 归还连接（直接放回池中，超时清理在 Acquire 时进行）
+    // 归还连接（放回当前线程的分片，超时清理和健康检查由 reaper 进行）
     void Return(ConnectionType conn) {
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        auto it = conn_info_.find(conn);
-        if (it == conn_info_.end()) {
-            // 连接不在 map 中（可能已被清理），直接关闭避免泄漏
+        bool owned;
+        {
+            std::shared_lock<std::shared_mutex> lock(meta_mutex_);
+            owned = conn_info_.count(conn) > 0;
+        }
+        if (!owned) {
+            // 连接不在 map 中（可能已被清理，或是池外的临时连接），直接关闭避免泄漏
             closer_(conn);
             return;
         }
-        it->second.in_use = false;
-        it->second.last_used = std::chrono::steady_clock::now();
-        pool_.push_back(conn);
+        {
+            Stripe& stripe = LocalStripe();
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            stripe.idle.push_back({conn, std::chrono::steady_clock::now()});
+        }
+        NotifyWaiter();
+    }
+
+    // 丢弃连接（调用方发现连接已损坏时使用，不再放回池中）
+    void Discard(ConnectionType conn) {
+        if (Forget(conn)) NotifyWaiter();
+        closer_(conn);
+    }
+
+    // 并行预建连接，使空闲连接数达到 max(min_connections, min_idle)（受 max_connections 限制）
+    // 返回实际新建的连接数；失败的连接不影响其余连接，error 记录最后一个错误
+    int Warmup(std::string* error) {
+        int target = std::max(config_.min_connections, config_.min_idle);
+        int missing = target - GetStats().available_connections;
+        if (missing <= 0) return 0;
+
+        std::atomic<int> created{0};
+        std::mutex error_mutex;
+        std::vector<std::thread> workers;
+        workers.reserve(missing);
+        for (int i = 0; i < missing; ++i) {
+            workers.emplace_back([&, i]() {
+                std::string err;
+                ConnectionType conn{};
+                if (CreateConnection(&conn, &err) != AcquireResult::kOk) {
+                    if (!err.empty()) {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (error) *error = err;
+                    }
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(stripes_[i % kStripes].mutex);
+                stripes_[i % kStripes].idle.push_back({conn, std::chrono::steady_clock::now()});
+                created.fetch_add(1);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        if (created > 0) NotifyWaiter();
+        return created.load();
     }
 
     // 获取当前池状态
@@ -165,25 +245,253 @@ public:
     };
 
     PoolStats GetStats() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        int available = static_cast<int>(pool_.size());
+        // 依次锁住全部分片得到一致快照；in_use 由 total - available 推出，三者始终自洽
+        std::array<std::unique_lock<std::mutex>, kStripes> locks;
+        int available = 0;
+        for (size_t i = 0; i < kStripes; ++i) {
+            locks[i] = std::unique_lock<std::mutex>(stripes_[i].mutex);
+            available += static_cast<int>(stripes_[i].idle.size());
+        }
+        int total = total_connections_.load();
         return {
-            total_connections_,
+            total,
             available,
-            total_connections_ - available
+            total - available
         };
     }
 
+    // 获取运行指标快照（状态 + 累计计数器）
+    ConnectionPoolMetrics GetMetrics() {
+        ConnectionPoolMetrics m;
+        auto stats = GetStats();
+        m.total_connections = stats.total_connections;
+        m.idle_connections = stats.available_connections;
+        m.in_use_connections = stats.in_use_connections;
+        m.max_connections = config_.max_connections;
+        m.waiters = waiters_.load();
+
+        m.acquire_timeouts = acquire_timeouts_.load(std::memory_order_relaxed);
+        for (int i = 0; i < ConnectionPoolMetrics::kWaitBuckets; ++i) {
+            m.wait_histogram[i] = wait_histogram_[i].load(std::memory_order_relaxed);
+            m.acquires += m.wait_histogram[i];
+        }
+
+        m.connects = connects_.load(std::memory_order_relaxed);
+        m.connect_failures = connect_failures_.load(std::memory_order_relaxed);
+        if (m.connects > 0) {
+            m.connect_avg_ms = connect_total_us_.load(std::memory_order_relaxed) / 1000.0 / m.connects;
+        }
+        m.connect_max_ms = connect_max_us_.load(std::memory_order_relaxed) / 1000.0;
+
+        m.health_checks = health_checks_.load(std::memory_order_relaxed);
+        m.health_check_failures = health_check_failures_.load(std::memory_order_relaxed);
+        m.idle_evictions = idle_evictions_.load(std::memory_order_relaxed);
+        return m;
+    }
+
 private:
+    static constexpr size_t kStripes = 8;
+
+    enum class AcquireResult { kOk, kExhausted, kFailed };
+
+    struct IdleEntry {
+        ConnectionType conn;
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    // alignas 避免相邻分片的锁落在同一 cache line 上
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+        std::deque<IdleEntry> idle;
+    };
+
+    // 连接信息（仅记录池内连接的元数据，空闲/使用状态由分片中是否存在决定）
+    struct ConnectionInfo {
+        std::chrono::steady_clock::time_point last_check;
+    };
+
+    Stripe& LocalStripe() {
+        size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % kStripes;
+        return stripes_[index];
+    }
+
+    // 不等待的一次尝试：先取空闲连接，没有则在名额内新建
+    AcquireResult TryAcquire(ConnectionType* conn, std::string* error) {
+        size_t home = std::hash<std::thread::id>{}(std::this_thread::get_id()) % kStripes;
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kStripes; ++i) {
+            Stripe& stripe = stripes_[(home + i) % kStripes];
+            while (true) {
+                IdleEntry entry;
+                {
+                    std::lock_guard<std::mutex> lock(stripe.mutex);
+                    if (stripe.idle.empty()) break;
+                    entry = stripe.idle.back();
+                    stripe.idle.pop_back();
+                }
+                if (now - entry.last_used > config_.idle_timeout) {
+                    // reaper 尚未回收的超时连接，锁外关闭后继续取
+                    Forget(entry.conn);
+                    closer_(entry.conn);
+                    continue;
+                }
+                *conn = entry.conn;
+                return AcquireResult::kOk;
+            }
+        }
+
+        // 池中没有可用连接，在名额内创建新连接
+        return CreateConnection(conn, error);
+    }
+
+    // 在名额内新建一条连接（CAS 预占名额，工厂函数在锁外调用），记录建连耗时
+    AcquireResult CreateConnection(ConnectionType* conn, std::string* error) {
+        int total = total_connections_.load();
+        do {
+            if (total >= config_.max_connections) return AcquireResult::kExhausted;
+        } while (!total_connections_.compare_exchange_weak(total, total + 1));
+
+        auto start = std::chrono::steady_clock::now();
+        ConnectionType new_conn = factory_(error);
+        if (!new_conn) {
+            connect_failures_.fetch_add(1, std::memory_order_relaxed);
+            total_connections_.fetch_sub(1);
+            NotifyWaiter();
+            return AcquireResult::kFailed;
+        }
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - start).count();
+        connects_.fetch_add(1, std::memory_order_relaxed);
+        connect_total_us_.fetch_add(us, std::memory_order_relaxed);
+        int64_t prev = connect_max_us_.load(std::memory_order_relaxed);
+        while (us > prev && !connect_max_us_.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {}
+
+        {
+            std::unique_lock<std::shared_mutex> lock(meta_mutex_);
+            conn_info_[new_conn] = {std::chrono::steady_clock::now()};
+        }
+        *conn = new_conn;
+        return AcquireResult::kOk;
+    }
+
+    void RecordWait(std::chrono::steady_clock::duration waited) {
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(waited).count();
+        int bucket = 0;
+        while (bucket < ConnectionPoolMetrics::kWaitBuckets - 1 &&
+               ms >= ConnectionPoolMetrics::kWaitBucketBoundsMs[bucket]) {
+            ++bucket;
+        }
+        wait_histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 从池中注销连接并释放名额，返回连接原本是否属于本池
+    bool Forget(ConnectionType conn) {
+        std::unique_lock<std::shared_mutex> lock(meta_mutex_);
+        if (conn_info_.erase(conn) == 0) return false;
+        total_connections_.fetch_sub(1);
+        return true;
+    }
+
+    // 有等待者时才加锁通知，常见路径只多一次原子读
+    void NotifyWaiter() {
+        if (waiters_.load() == 0) return;
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        ++wakeups_;
+        wait_cv_.notify_one();
+    }
+
+    // reaper：周期性回收超时空闲连接、对到期的空闲连接做健康检查
+    // 检查期间连接已从分片取出，不会被 Acquire 拿到；Ping 在任何锁之外进行
+    void ReaperLoop() {
+        auto period = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::min(config_.idle_timeout, config_.health_check_interval)) / 4;
+        period = std::clamp(period, std::chrono::milliseconds(100), std::chrono::milliseconds(5000));
+
+        std::unique_lock<std::mutex> lock(reaper_mutex_);
+        while (!reaper_cv_.wait_for(lock, period, [this] { return stopping_; })) {
+            lock.unlock();
+            ReapOnce();
+            lock.lock();
+        }
+    }
+
+    void ReapOnce() {
+        auto now = std::chrono::steady_clock::now();
+        std::vector<ConnectionType> expired;
+        std::vector<IdleEntry> due;
+
+        for (auto& stripe : stripes_) {
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            std::shared_lock<std::shared_mutex> meta(meta_mutex_);
+            for (auto it = stripe.idle.begin(); it != stripe.idle.end();) {
+                if (now - it->last_used > config_.idle_timeout) {
+                    expired.push_back(it->conn);
+                    it = stripe.idle.erase(it);
+                    continue;
+                }
+                auto info = conn_info_.find(it->conn);
+                if (info != conn_info_.end() &&
+                    now - info->second.last_check >= config_.health_check_interval) {
+                    due.push_back(*it);
+                    it = stripe.idle.erase(it);
+                    continue;
+                }
+                ++it;
+            }
+        }
+
+        idle_evictions_.fetch_add(expired.size(), std::memory_order_relaxed);
+        for (auto conn : expired) {
+            if (Forget(conn)) NotifyWaiter();
+            closer_(conn);
+        }
+
+        for (auto& entry : due) {
+            health_checks_.fetch_add(1, std::memory_order_relaxed);
+            if (!pinger_(entry.conn)) {
+                health_check_failures_.fetch_add(1, std::memory_order_relaxed);
+                if (Forget(entry.conn)) NotifyWaiter();
+                closer_(entry.conn);
+                continue;
+            }
+            {
+                std::unique_lock<std::shared_mutex> lock(meta_mutex_);
+                auto it = conn_info_.find(entry.conn);
+                if (it != conn_info_.end()) it->second.last_check = std::chrono::steady_clock::now();
+            }
+            // 保留原 last_used：健康检查不算作使用，不延长空闲期
+            {
+                std::lock_guard<std::mutex> lock(stripes_[0].mutex);
+                stripes_[0].idle.push_front(entry);
+            }
+            NotifyWaiter();
+        }
+
+        // 补齐 min_idle：超时回收的连接由新连接替换（顺带避开服务端的空闲断连），
+        // 回收之后的第一批查询不必再同步建连
+        int missing = config_.min_idle - GetStats().available_connections;
+        for (int i = 0; i < missing; ++i) {
+            ConnectionType conn{};
+            std::string error;
+            if (CreateConnection(&conn, &error) != AcquireResult::kOk) break;
+            {
+                std::lock_guard<std::mutex> lock(stripes_[i % kStripes].mutex);
+                stripes_[i % kStripes].idle.push_back({conn, std::chrono::steady_clock::now()});
+            }
+            NotifyWaiter();
+        }
+    }
+
     // 预创建连接
     void PrecreateConnections(int count) {
         for (int i = 0; i < count; ++i) {
             std::string error;
             ConnectionType conn = factory_(&error);
             if (conn) {
+                connects_++;
                 auto now = std::chrono::steady_clock::now();
-                pool_.push_back(conn);
-                conn_info_[conn] = {now, now, false};
+                stripes_[i % kStripes].idle.push_back({conn, now});
+                conn_info_[conn] = {now};
                 total_connections_++;
             } else {
                 // 预创建失败，记录日志但继续
@@ -197,18 +505,36 @@ private:
     CloseFunc closer_;
     PingFunc pinger_;
 
-    std::deque<ConnectionType> pool_;
-    std::mutex mutex_;
+    std::array<Stripe, kStripes> stripes_;
 
-    // 连接信息
-    struct ConnectionInfo {
-        std::chrono::steady_clock::time_point last_used;
-        std::chrono::steady_clock::time_point last_check;
-        bool in_use;
-    };
+    // 池内连接的元数据：Return 时只需共享锁判断归属，写锁只在创建/关闭/健康检查后出现
+    std::shared_mutex meta_mutex_;
     std::unordered_map<ConnectionType, ConnectionInfo> conn_info_;
 
-    int total_connections_;
+    std::atomic<int> total_connections_;
+
+    // 池满等待
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    std::atomic<int> waiters_{0};
+    uint64_t wakeups_ = 0;  // wait_mutex_ 保护
+
+    // 指标计数器（relaxed 原子，GetMetrics 读取快照）
+    std::atomic<uint64_t> wait_histogram_[ConnectionPoolMetrics::kWaitBuckets] = {};
+    std::atomic<uint64_t> acquire_timeouts_{0};
+    std::atomic<uint64_t> connects_{0};
+    std::atomic<uint64_t> connect_failures_{0};
+    std::atomic<int64_t> connect_total_us_{0};
+    std::atomic<int64_t> connect_max_us_{0};
+    std::atomic<uint64_t> health_checks_{0};
+    std::atomic<uint64_t> health_check_failures_{0};
+    std::atomic<uint64_t> idle_evictions_{0};
+
+    // 后台 reaper
+    std::thread reaper_;
+    std::mutex reaper_mutex_;
+    std::condition_variable reaper_cv_;
+    bool stopping_ = false;
 };
 
 }  // namespace database
@@ -22,6 +22,19 @@ int DatabaseChannel::Open() {
     if (opened_) return 0;
     // 驱动已由 DatabasePlugin 负责连接，这里只验证连接状态
     if (!driver_ || !driver_->IsConnected()) return -1;
+
+    // 连接池预热（warmup_on_open）：并行预建连接，首批查询不必同步建连；预热失败不影响通道打开
+    if (auto* pooled = dynamic_cast<IPooledDriver*>(driver_)) {
+        std::string error;
+        int created = pooled->WarmupPool(&error);
+        if (created < 0) {
+            LOG_WARN("DatabaseChannel::Open: pool warmup failed (%s.%s): %s",
+                     type_.c_str(), name_.c_str(), error.c_str());
+        } else if (created > 0) {
+            LOG_INFO("DatabaseChannel::Open: warmed up %d connections (%s.%s)",
+                     created, type_.c_str(), name_.c_str());
+        }
+    }
     opened_ = true;
     return 0;
 }
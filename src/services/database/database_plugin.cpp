@@ -233,6 +233,53 @@ void DatabasePlugin::List(std::function<void(const char* type, const char* name,
     }
 }
 
+// 连接池指标 JSON（wait_ms_histogram 的键为桶上界，"inf" 为最后一个桶）
+static std::string PoolMetricsJson(const std::string& type, const std::string& name,
+                                   const ConnectionPoolMetrics& m) {
+    char buf[1024];
+    std::string histogram;
+    for (int i = 0; i < ConnectionPoolMetrics::kWaitBuckets; ++i) {
+        std::string le = (i < ConnectionPoolMetrics::kWaitBuckets - 1)
+                             ? std::to_string(ConnectionPoolMetrics::kWaitBucketBoundsMs[i])
+                             : "inf";
+        if (i > 0) histogram += ",";
+        histogram += "\"" + le + "\":" + std::to_string(m.wait_histogram[i]);
+    }
+    snprintf(buf, sizeof(buf),
+             "{\"type\":\"%s\",\"name\":\"%s\",\"pool\":{"
+             "\"total\":%d,\"idle\":%d,\"in_use\":%d,\"max\":%d,\"waiters\":%d,"
+             "\"acquires\":%llu,\"acquire_timeouts\":%llu,\"wait_ms_histogram\":{%s},"
+             "\"connects\":%llu,\"connect_failures\":%llu,\"connect_avg_ms\":%.3f,\"connect_max_ms\":%.3f,"
+             "\"health_checks\":%llu,\"health_check_failures\":%llu,\"idle_evictions\":%llu}}",
+             type.c_str(), name.c_str(),
+             m.total_connections, m.idle_connections, m.in_use_connections, m.max_connections, m.waiters,
+             static_cast<unsigned long long>(m.acquires), static_cast<unsigned long long>(m.acquire_timeouts),
+             histogram.c_str(),
+             static_cast<unsigned long long>(m.connects), static_cast<unsigned long long>(m.connect_failures),
+             m.connect_avg_ms, m.connect_max_ms,
+             static_cast<unsigned long long>(m.health_checks),
+             static_cast<unsigned long long>(m.health_check_failures),
+             static_cast<unsigned long long>(m.idle_evictions));
+    return buf;
+}
+
+void DatabasePlugin::Stats(std::function<void(const char* type, const char* name,
+                                               const char* stats_json)> callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [key, channel] : channels_) {
+        auto drv_it = driver_storage_.find(key);
+        if (drv_it == driver_storage_.end()) continue;
+        auto* pooled = dynamic_cast<IPooledDriver*>(drv_it->second.get());
+        ConnectionPoolMetrics metrics;
+        if (!pooled || !pooled->GetPoolMetrics(&metrics)) continue;
+
+        std::string type = channel->Catelog();
+        std::string name = channel->Name();
+        std::string json = PoolMetricsJson(type, name, metrics);
+        callback(type.c_str(), name.c_str(), json.c_str());
+    }
+}
+
 int DatabasePlugin::Release(const char* type, const char* name) {
     if (!type || !name) return -1;
 
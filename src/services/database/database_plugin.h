@@ -32,6 +32,8 @@ class __attribute__((visibility("default"))) DatabasePlugin : public IPlugin, pu
     IDatabaseChannel* Get(const char* type, const char* name) override;
     void List(std::function<void(const char* type, const char* name,
                                   const char* config_json)> callback) override;
+    void Stats(std::function<void(const char* type, const char* name,
+                                   const char* stats_json)> callback) override;
     int Release(const char* type, const char* name) override;
     const char* LastError() override;
 
@@ -4,10 +4,16 @@
 #include <arrow/io/memory.h>
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
+#include <arrow/util/compression.h>
 #include <httplib.h>
 
 #include <common/log.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
 namespace flowsql {
 namespace database {
 
@@ -22,6 +28,74 @@ static std::string QuoteIdentifier(const std::string& name) {
     return result;
 }
 
+// ==================== ClickHouseClientPool 实现 ====================
+
+// ClickHouseClientPool — keep-alive httplib::Client 连接池
+// 每个 Client 维持一条 HTTP/1.1 keep-alive 连接，同一时刻只被一个请求使用（httplib::Client 非线程安全）
+// 健康检查：空闲超过 health_check_interval 的连接由连接池后台 reaper GET /ping；传输失败的连接由调用方 Discard
+// 池满时不报错，返回一条临时连接（归还时 ConnectionPool::Return 发现不在池中会直接关闭），并发突增时退化为短连接
+class ClickHouseClientPool {
+public:
+    ClickHouseClientPool(const std::string& host, int port, const std::string& user,
+                         const std::string& password, const std::string& database,
+                         const ConnectionPoolConfig& config)
+        : host_(host), port_(port), database_(database),
+          headers_({{"X-ClickHouse-User", user}, {"X-ClickHouse-Key", password}}) {
+        pool_ = std::make_unique<ConnectionPool<httplib::Client*>>(
+            config,
+            [this](std::string* error) -> httplib::Client* { return ConnectClient(error); },
+            [](httplib::Client* client) { delete client; },
+            [this](httplib::Client* client) -> bool {
+                auto res = client->Get("/ping", headers_);
+                return res && res->status == 200;
+            });
+    }
+
+    httplib::Client* Acquire() {
+        httplib::Client* client = nullptr;
+        std::string error;
+        if (pool_->Acquire(&client, &error)) return client;
+        return NewClient();
+    }
+
+    void Return(httplib::Client* client) { pool_->Return(client); }
+    void Discard(httplib::Client* client) { pool_->Discard(client); }
+    int Warmup(std::string* error) { return pool_->Warmup(error); }
+    ConnectionPoolMetrics GetMetrics() { return pool_->GetMetrics(); }
+
+    const httplib::Headers& headers() const { return headers_; }
+    const std::string& database() const { return database_; }
+    std::string endpoint() const { return host_ + ":" + std::to_string(port_); }
+
+private:
+    // 池内连接：httplib 在首个请求时才建立 TCP 连接，这里 GET /ping 一次，
+    // 让预热/补齐的连接真正完成握手，连接耗时也计入连接池指标
+    httplib::Client* ConnectClient(std::string* error) {
+        auto* client = NewClient();
+        auto res = client->Get("/ping", headers_);
+        if (!res || res->status != 200) {
+            if (error) *error = "ClickHouse unreachable at " + endpoint();
+            delete client;
+            return nullptr;
+        }
+        return client;
+    }
+
+    httplib::Client* NewClient() {
+        auto* client = new httplib::Client(host_, port_);
+        client->set_keep_alive(true);
+        client->set_connection_timeout(10);
+        client->set_read_timeout(60);
+        return client;
+    }
+
+    std::string host_;
+    int port_;
+    std::string database_;
+    httplib::Headers headers_;
+    std::unique_ptr<ConnectionPool<httplib::Client*>> pool_;
+};
+
 // ==================== ClickHouseDriver 实现 ====================
 
 int ClickHouseDriver::Connect(const std::unordered_map<std::string, std::string>& params) {
@@ -29,34 +103,89 @@ int ClickHouseDriver::Connect(const std::unordered_map<std::string, std::string>
         auto it = params.find(k);
         return it != params.end() ? it->second : def;
     };
-    host_     = get("host", "127.0.0.1");
-    port_     = std::stoi(get("port", "8123"));
-    user_     = get("user", "default");
-    password_ = get("password", "");
-    database_ = get("database", "default");
+
+    // ClickHouse 服务端 keep_alive_timeout 默认 10 秒，空闲连接超过该时间会被服务端关闭，池内保留时间与之对齐
+    ConnectionPoolConfig config;
+    config.max_connections = 16;
+    config.min_connections = 0;
+    config.idle_timeout = std::chrono::seconds(10);
+    config.health_check_interval = std::chrono::seconds(60);
+    ApplyPoolParams(params, &config);
+    warmup_on_open_ = config.warmup_on_open;
+
+    // 批量写入参数
+    insert_config_.compression = get("insert_compression", "lz4");
+    if (insert_config_.compression != "none" && insert_config_.compression != "lz4" &&
+        insert_config_.compression != "zstd") {
+        last_error_ = "invalid insert_compression: " + insert_config_.compression + " (none/lz4/zstd)";
+        return -1;
+    }
+    // 预编译的 Arrow 可能未带对应压缩库，此时退回不压缩而不是让每次写入失败
+    if (insert_config_.compression != "none") {
+        auto type = insert_config_.compression == "zstd" ? arrow::Compression::ZSTD : arrow::Compression::LZ4_FRAME;
+        if (!arrow::util::Codec::IsAvailable(type)) {
+            LOG_WARN("ClickHouseDriver: Arrow built without %s codec, insert_compression falls back to none",
+                     insert_config_.compression.c_str());
+            insert_config_.compression = "none";
+        }
+    }
+    insert_config_.max_parallel_parts = std::max(1, std::stoi(get("insert_parallel_parts", "4")));
+    insert_config_.part_rows = std::max<int64_t>(1, std::stoll(get("insert_part_rows", "1048576")));
+
+    clients_ = std::make_shared<ClickHouseClientPool>(
+        get("host", "127.0.0.1"), std::stoi(get("port", "8123")), get("user", "default"),
+        get("password", ""), get("database", "default"), config);
 
     // Ping 返回具体错误（区分网络不可达 vs 认证失败）
     if (!Ping()) {
         // last_error_ 已在 Ping() 内部根据 HTTP 状态码设置
+        clients_.reset();
         return -1;
     }
     connected_ = true;
-    LOG_INFO("ClickHouseDriver: connected to %s:%d/%s", host_.c_str(), port_, database_.c_str());
+    LOG_INFO("ClickHouseDriver: connected to %s/%s", clients_->endpoint().c_str(),
+             clients_->database().c_str());
     return 0;
 }
 
+int ClickHouseDriver::Disconnect() {
+    connected_ = false;
+    clients_.reset();
+    return 0;
+}
+
+int ClickHouseDriver::WarmupPool(std::string* error) {
+    auto clients = clients_;
+    if (!clients || !warmup_on_open_) return 0;
+    std::string err;
+    int created = clients->Warmup(&err);
+    if (created == 0 && !err.empty()) {
+        if (error) *error = err;
+        return -1;
+    }
+    return created;
+}
+
+bool ClickHouseDriver::GetPoolMetrics(ConnectionPoolMetrics* metrics) {
+    auto clients = clients_;
+    if (!clients) return false;
+    *metrics = clients->GetMetrics();
+    return true;
+}
+
 bool ClickHouseDriver::Ping() {
-    httplib::Client client(host_, port_);
-    client.set_connection_timeout(5);
-    httplib::Headers headers = {
-        {"X-ClickHouse-User", user_},
-        {"X-ClickHouse-Key", password_}
-    };
-    auto res = client.Get("/?query=SELECT+1", headers);
+    if (!clients_) {
+        last_error_ = "Driver not connected";
+        return false;
+    }
+    httplib::Client* client = clients_->Acquire();
+    auto res = client->Get("/?query=SELECT+1", clients_->headers());
     if (!res) {
-        last_error_ = "ClickHouse unreachable at " + host_ + ":" + std::to_string(port_);
+        clients_->Discard(client);
+        last_error_ = "ClickHouse unreachable at " + clients_->endpoint();
         return false;
     }
+    clients_->Return(client);
     if (res->status == 401 || res->status == 403) {
         last_error_ = "ClickHouse authentication failed (HTTP " + std::to_string(res->status) + "): " + res->body;
         return false;
@@ -73,173 +202,514 @@ std::shared_ptr<IDbSession> ClickHouseDriver::CreateSession() {
         last_error_ = "Driver not connected";
         return nullptr;
     }
-    return std::make_shared<ClickHouseSession>(host_, port_, user_, password_, database_);
+    return std::make_shared<ClickHouseSession>(clients_, insert_config_);
 }
 
-// ==================== ClickHouseSession 实现 ====================
-
-ClickHouseSession::ClickHouseSession(const std::string& host, int port,
-                                     const std::string& user, const std::string& password,
-                                     const std::string& database)
-    : host_(host), port_(port), user_(user), password_(password), database_(database) {}
-
-bool ClickHouseSession::Ping() {
-    httplib::Client client(host_, port_);
-    client.set_connection_timeout(5);
-    httplib::Headers headers = {
-        {"X-ClickHouse-User", user_},
-        {"X-ClickHouse-Key", password_}
+// ==================== 增量解码 ====================
+
+// 发送 POST：receiver 非空时 200 响应体逐块交给 receiver（返回 false 中止请求），否则累积到 response
+// 返回 HTTP 状态码；传输失败或被中止返回 -1，response 为错误描述
+static int SendPost(httplib::Client* client, const httplib::Headers& headers, const std::string& path,
+                    std::string body, const char* content_type, std::string* response,
+                    const ClickHouseSession::ChunkReceiver& receiver) {
+    httplib::Request req;
+    req.method = "POST";
+    req.path = path;
+    req.headers = headers;
+    req.set_header("Content-Type", content_type);
+    req.body = std::move(body);
+
+    int status = 0;
+    req.response_handler = [&status](const httplib::Response& r) {
+        status = r.status;
+        return true;
     };
-    auto res = client.Get("/?query=SELECT+1", headers);
-    return res && res->status == 200;
+    req.content_receiver = [&](const char* data, size_t len, uint64_t, uint64_t) -> bool {
+        if (status == 200 && receiver) return receiver(data, len);
+        response->append(data, len);
+        return true;
+    };
+
+    auto res = client->send(req);
+    if (!res) {
+        *response = "Connection failed: " + httplib::to_string(res.error());
+        return -1;
+    }
+    return status;
 }
 
-int ClickHouseSession::ExecuteSql(const char* sql, std::string* error) {
-    httplib::Client client(host_, port_);
-    client.set_connection_timeout(10);
-    client.set_read_timeout(60);
+// ArrowStreamSink — 将分块到达的 ArrowStream 响应体喂给 arrow::ipc::StreamDecoder
+// 每个 RecordBatch 解码完成立即回调 on_batch，不保留完整响应体，也不再整体复制一次
+class ArrowStreamSink {
+public:
+    using SchemaCallback = std::function<void(std::shared_ptr<arrow::Schema>)>;
+    using BatchCallback = std::function<bool(std::shared_ptr<arrow::RecordBatch>)>;
 
-    httplib::Headers headers = {
-        {"X-ClickHouse-User", user_},
-        {"X-ClickHouse-Key", password_}
-    };
+    ArrowStreamSink(SchemaCallback on_schema, BatchCallback on_batch)
+        : listener_(std::make_shared<Listener>(std::move(on_schema), std::move(on_batch))),
+          decoder_(listener_) {}
 
-    std::string path = "/?database=" + database_;
-    auto res = client.Post(path, headers, std::string(sql), "text/plain");
+    bool Consume(const char* data, size_t len) {
+        bytes_ += static_cast<int64_t>(len);
+        auto status = decoder_.Consume(reinterpret_cast<const uint8_t*>(data), static_cast<int64_t>(len));
+        if (!status.ok()) {
+            if (error_.empty()) {
+                error_ = listener_->stopped ? "consumer stopped" : "ArrowStream decode failed: " + status.ToString();
+            }
+            return false;
+        }
+        return true;
+    }
 
-    if (!res || res->status != 200) {
-        if (error) *error = res ? res->body : "Connection failed";
-        return -1;
+    // 响应结束后检查：解码器停在消息中途说明响应被截断（或服务端在 200 之后追加了异常文本）
+    bool Finish() {
+        if (!listener_->eos && bytes_ > 0 && decoder_.next_required_size() > kMaxHeaderSize) {
+            error_ = "ArrowStream response truncated";
+            return false;
+        }
+        return true;
     }
-    return 0;
-}
 
-int ClickHouseSession::ExecuteQueryArrow(const char* sql,
-                                         std::vector<std::shared_ptr<arrow::RecordBatch>>* batches,
-                                         std::string* error) {
-    std::string full_sql = std::string(sql) + " FORMAT ArrowStream";
+    const std::string& error() const { return error_; }
 
-    httplib::Client client(host_, port_);
-    client.set_connection_timeout(10);
-    client.set_read_timeout(60);
+private:
+    // 续行标记（0xFFFFFFFF）+ 元数据长度，完整消息之后解码器等待的最大字节数
+    static constexpr int64_t kMaxHeaderSize = 8;
 
-    httplib::Headers headers = {
-        {"X-ClickHouse-User", user_},
-        {"X-ClickHouse-Key", password_}
+    struct Listener : public arrow::ipc::Listener {
+        Listener(SchemaCallback s, BatchCallback b) : on_schema(std::move(s)), on_batch(std::move(b)) {}
+
+        arrow::Status OnSchemaDecoded(std::shared_ptr<arrow::Schema> schema) override {
+            if (on_schema) on_schema(std::move(schema));
+            return arrow::Status::OK();
+        }
+        arrow::Status OnRecordBatchDecoded(std::shared_ptr<arrow::RecordBatch> batch) override {
+            if (!on_batch(std::move(batch))) {
+                stopped = true;
+                return arrow::Status::Cancelled("consumer stopped");
+            }
+            return arrow::Status::OK();
+        }
+        arrow::Status OnEOS() override {
+            eos = true;
+            return arrow::Status::OK();
+        }
+
+        SchemaCallback on_schema;
+        BatchCallback on_batch;
+        bool stopped = false;
+        bool eos = false;
     };
 
-    std::string path = "/?database=" + database_;
-    auto res = client.Post(path, headers, full_sql, "text/plain");
+    std::shared_ptr<Listener> listener_;
+    arrow::ipc::StreamDecoder decoder_;
+    int64_t bytes_ = 0;
+    std::string error_;
+};
+
+// ==================== ClickHouseBatchReader 实现 ====================
+
+// ClickHouseBatchReader — ClickHouse 流式批量读取器
+// 后台线程独占一条池化连接发送查询，响应体经 ArrowStreamSink 增量解码后放入有界队列；
+// NextBatch/Next 从队列取出，首个 batch 在响应体第一条消息到达后即可取得。
+// 队列满时阻塞接收回调，由 TCP 流控把背压传回服务端
+// Cancel 置位并 stop() 当前连接，阻塞中的读取立即返回；被中止的连接不再放回连接池
+class ClickHouseBatchReader : public IBatchReader, public IRecordBatchReader {
+public:
+    static constexpr size_t kQueueDepth = 8;
+
+    ClickHouseBatchReader(std::shared_ptr<ClickHouseClientPool> clients, std::string sql)
+        : clients_(std::move(clients)), sql_(std::move(sql)) {}
+
+    ~ClickHouseBatchReader() override { Close(); }
+
+    void Start() { worker_ = std::thread([this] { Run(); }); }
+
+    int GetSchema(const uint8_t** data, size_t* size) override {
+        if (!schema_buffer_) {
+            std::shared_ptr<arrow::Schema> schema;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_empty_.wait(lock, [this] { return schema_ || finished_; });
+                if (!schema_) {
+                    last_error_ = error_.empty() ? "no schema in ArrowStream response" : error_;
+                    return -1;
+                }
+                schema = schema_;
+            }
+            auto out = arrow::io::BufferOutputStream::Create().ValueOrDie();
+            auto writer = arrow::ipc::MakeStreamWriter(out, schema).ValueOrDie();
+            if (!writer->Close().ok()) return -1;
+            auto buf = out->Finish();
+            if (!buf.ok()) return -1;
+            schema_buffer_ = *buf;
+        }
+        *data = schema_buffer_->data();
+        *size = schema_buffer_->size();
+        return 0;
+    }
 
-    if (!res || res->status != 200) {
-        if (error) *error = res ? res->body : "Connection failed";
-        return -1;
+    // 跨进程路径：每批编码为独立的 IPC stream（含 Schema），与行式读取器一致
+    int Next(const uint8_t** data, size_t* size) override {
+        *data = nullptr;
+        *size = 0;
+        std::shared_ptr<arrow::RecordBatch> batch;
+        int rc = NextBatch(&batch);
+        if (rc != 0) return rc;
+
+        auto out = arrow::io::BufferOutputStream::Create().ValueOrDie();
+        auto writer = arrow::ipc::MakeStreamWriter(out, batch->schema()).ValueOrDie();
+        if (!writer->WriteRecordBatch(*batch).ok()) return -1;
+        if (!writer->Close().ok()) return -1;
+        auto buf = out->Finish();
+        if (!buf.ok()) return -1;
+        batch_buffer_ = *buf;
+        *data = batch_buffer_->data();
+        *size = batch_buffer_->size();
+        return 0;
     }
 
-    return ParseArrowStream(res->body, batches, error);
-}
+    int NextBatch(std::shared_ptr<arrow::RecordBatch>* batch) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return !queue_.empty() || finished_; });
+        if (!queue_.empty()) {
+            *batch = std::move(queue_.front());
+            queue_.pop_front();
+            not_full_.notify_one();
+            return 0;
+        }
+        if (!error_.empty()) {
+            last_error_ = error_;
+            return -1;
+        }
+        return 1;
+    }
 
-int ClickHouseSession::WriteArrowBatches(const char* table,
-                                         const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
-                                         std::string* error) {
-    // 空 batches 提前返回，不发 HTTP 请求
-    // （ClickHouse 收到只有 Schema 的 IPC Stream 行为未定义）
-    if (batches.empty()) return 0;
+    void Cancel() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finished_ || cancelled_) return;
+            cancelled_ = true;
+            not_full_.notify_all();
+        }
+        std::lock_guard<std::mutex> lock(client_mutex_);
+        if (client_) client_->stop();
+    }
 
-    std::string body;
-    if (SerializeArrowStream(batches, &body, error) != 0) return -1;
+    // 未读完就关闭时中止请求，避免把剩余响应体读完
+    void Close() override {
+        if (!worker_.joinable()) return;
+        Cancel();
+        worker_.join();
+    }
 
-    std::string query = "INSERT INTO " + QuoteIdentifier(table) + " FORMAT ArrowStream";
-    std::string path = "/?database=" + database_ + "&query=" + httplib::detail::encode_url(query);
+    const char* GetLastError() override { return last_error_.c_str(); }
+    void Release() override { delete this; }
 
-    httplib::Client client(host_, port_);
-    client.set_connection_timeout(10);
-    client.set_read_timeout(60);
+private:
+    void Run() {
+        httplib::Client* client = clients_->Acquire();
+        {
+            std::lock_guard<std::mutex> lock(client_mutex_);
+            client_ = client;
+        }
 
-    httplib::Headers headers = {
-        {"X-ClickHouse-User", user_},
-        {"X-ClickHouse-Key", password_}
-    };
+        ArrowStreamSink sink(
+            [this](std::shared_ptr<arrow::Schema> schema) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                schema_ = std::move(schema);
+                not_empty_.notify_all();
+            },
+            [this](std::shared_ptr<arrow::RecordBatch> batch) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_full_.wait(lock, [this] { return queue_.size() < kQueueDepth || cancelled_; });
+                if (cancelled_) return false;
+                queue_.push_back(std::move(batch));
+                not_empty_.notify_one();
+                return true;
+            });
+
+        std::string response;
+        std::string path = "/?database=" + clients_->database();
+        int status = SendPost(client, clients_->headers(), path, sql_ + " FORMAT ArrowStream",
+                              "text/plain", &response,
+                              [this, &sink](const char* data, size_t len) {
+                                  {
+                                      // Cancel 可能发生在 stop() 可见之前，逐块检查一次
+                                      std::lock_guard<std::mutex> lock(mutex_);
+                                      if (cancelled_) return false;
+                                  }
+                                  return sink.Consume(data, len);
+                              });
+        std::string error;
+        if (status == 200) {
+            if (!sink.Finish()) error = sink.error();
+        } else {
+            error = sink.error().empty() ? response : sink.error();
+            if (error.empty()) error = "ClickHouse error (HTTP " + std::to_string(status) + ")";
+        }
 
-    auto res = client.Post(path, headers, body, "application/octet-stream");
-    if (!res || res->status != 200) {
-        if (error) *error = res ? res->body : "Connection failed";
-        return -1;
+        {
+            std::lock_guard<std::mutex> lock(client_mutex_);
+            client_ = nullptr;
+        }
+        if (status == 200 && error.empty()) clients_->Return(client);
+        else clients_->Discard(client);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cancelled_) error = "read cancelled";
+        error_ = std::move(error);
+        finished_ = true;
+        not_empty_.notify_all();
     }
-    return 0;
-}
 
-int ClickHouseSession::ParseArrowStream(const std::string& body,
-                                        std::vector<std::shared_ptr<arrow::RecordBatch>>* batches,
-                                        std::string* error) {
-    auto buffer = arrow::Buffer::FromString(body);
-    auto buf_reader = std::make_shared<arrow::io::BufferReader>(buffer);
+    std::shared_ptr<ClickHouseClientPool> clients_;
+    std::string sql_;
+    std::thread worker_;
 
-    auto reader_result = arrow::ipc::RecordBatchStreamReader::Open(buf_reader);
-    if (!reader_result.ok()) {
-        if (error) *error = reader_result.status().ToString();
-        return -1;
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<std::shared_ptr<arrow::RecordBatch>> queue_;
+    std::shared_ptr<arrow::Schema> schema_;
+    std::string error_;
+    bool finished_ = false;
+    bool cancelled_ = false;
+
+    std::mutex client_mutex_;
+    httplib::Client* client_ = nullptr;
+
+    std::shared_ptr<arrow::Buffer> schema_buffer_;
+    std::shared_ptr<arrow::Buffer> batch_buffer_;
+    std::string last_error_;
+};
+
+// ==================== ClickHouseSession 实现 ====================
+
+ClickHouseSession::ClickHouseSession(std::shared_ptr<ClickHouseClientPool> clients,
+                                     const ClickHouseInsertConfig& insert_config)
+    : clients_(std::move(clients)), insert_config_(insert_config) {}
+
+ClickHouseSession::~ClickHouseSession() {
+    if (client_) clients_->Return(client_);
+}
+
+int ClickHouseSession::Post(const std::string& path, std::string body, const char* content_type,
+                            std::string* response, const ChunkReceiver& receiver) {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    if (!client_) client_ = clients_->Acquire();
+    int status = SendPost(client_, clients_->headers(), path, std::move(body), content_type,
+                          response, receiver);
+    if (status < 0) {
+        // 传输层失败或被中止：连接状态未知，丢弃，下一次请求重新获取
+        clients_->Discard(client_);
+        client_ = nullptr;
     }
-    auto reader = *reader_result;
+    return status;
+}
 
-    while (true) {
-        std::shared_ptr<arrow::RecordBatch> batch;
-        auto status = reader->ReadNext(&batch);
-        if (!status.ok()) {
-            if (error) *error = status.ToString();
-            return -1;
-        }
-        if (!batch) break;  // EOS
-        batches->push_back(batch);
+bool ClickHouseSession::Ping() {
+    std::string response;
+    return Post("/", "SELECT 1", "text/plain", &response) == 200;
+}
+
+int ClickHouseSession::ExecuteSql(const char* sql, std::string* error) {
+    std::string response;
+    std::string path = "/?database=" + clients_->database();
+    if (Post(path, sql, "text/plain", &response) != 200) {
+        if (error) *error = response;
+        return -1;
     }
     return 0;
 }
 
-int ClickHouseSession::SerializeArrowStream(
-    const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
-    std::string* body, std::string* error) {
-    if (batches.empty()) {
-        *body = "";
-        return 0;
+int ClickHouseSession::ExecuteQueryArrow(const char* sql,
+                                         std::vector<std::shared_ptr<arrow::RecordBatch>>* batches,
+                                         std::string* error) {
+    ArrowStreamSink sink(nullptr, [batches](std::shared_ptr<arrow::RecordBatch> batch) {
+        batches->push_back(std::move(batch));
+        return true;
+    });
+
+    std::string response;
+    std::string path = "/?database=" + clients_->database();
+    int status = Post(path, std::string(sql) + " FORMAT ArrowStream", "text/plain", &response,
+                      [&sink](const char* data, size_t len) { return sink.Consume(data, len); });
+    if (status != 200) {
+        if (error) *error = sink.error().empty() ? response : sink.error();
+        return -1;
     }
-
-    auto schema = batches[0]->schema();
-    auto buffer_output_result = arrow::io::BufferOutputStream::Create();
-    if (!buffer_output_result.ok()) {
-        if (error) *error = buffer_output_result.status().ToString();
+    if (!sink.Finish()) {
+        if (error) *error = sink.error();
         return -1;
     }
-    auto buffer_output = *buffer_output_result;
+    return 0;
+}
 
-    auto writer_result = arrow::ipc::MakeStreamWriter(buffer_output, schema);
-    if (!writer_result.ok()) {
-        if (error) *error = writer_result.status().ToString();
-        return -1;
+int ClickHouseSession::CreateReader(const char* query, IBatchReader** reader) {
+    if (!query || !reader) return -1;
+    auto* r = new ClickHouseBatchReader(clients_, query);
+    r->Start();
+    *reader = r;
+    return 0;
+}
+
+// ==================== 流式写入 ====================
+
+// ChunkOutputStream — IPC writer 的输出目标，序列化结果暂存在外部 chunk 中，
+// 由 content provider 每写完一个 batch 取走并写入 chunked 请求体
+class ChunkOutputStream : public arrow::io::OutputStream {
+public:
+    explicit ChunkOutputStream(std::string* chunk) : chunk_(chunk) {}
+
+    arrow::Status Close() override {
+        closed_ = true;
+        return arrow::Status::OK();
+    }
+    bool closed() const override { return closed_; }
+    arrow::Result<int64_t> Tell() const override { return position_; }
+    arrow::Status Write(const void* data, int64_t nbytes) override {
+        chunk_->append(static_cast<const char*>(data), static_cast<size_t>(nbytes));
+        position_ += nbytes;
+        return arrow::Status::OK();
     }
-    auto writer = *writer_result;
 
+private:
+    std::string* chunk_;
+    int64_t position_ = 0;
+    bool closed_ = false;
+};
+
+// 按行数把 batches 切成 parts 个连续分片，跨分片的 batch 用零拷贝 Slice 拆开
+static std::vector<std::vector<std::shared_ptr<arrow::RecordBatch>>> SplitParts(
+    const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches, int64_t total_rows, int parts) {
+    std::vector<std::vector<std::shared_ptr<arrow::RecordBatch>>> result(parts);
+    int64_t per_part = (total_rows + parts - 1) / parts;
+    int part = 0;
+    int64_t filled = 0;
     for (const auto& batch : batches) {
-        auto status = writer->WriteRecordBatch(*batch);
-        if (!status.ok()) {
-            if (error) *error = status.ToString();
+        int64_t offset = 0;
+        while (offset < batch->num_rows()) {
+            int64_t take = std::min(batch->num_rows() - offset, per_part - filled);
+            result[part].push_back(offset == 0 && take == batch->num_rows() ? batch : batch->Slice(offset, take));
+            offset += take;
+            filled += take;
+            if (filled == per_part && part + 1 < parts) {
+                ++part;
+                filled = 0;
+            }
+        }
+    }
+    // 行数除不尽时尾部分片可能为空
+    while (result.size() > 1 && result.back().empty()) result.pop_back();
+    return result;
+}
+
+int ClickHouseSession::InsertPart(httplib::Client* client, const std::string& path,
+                                  const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
+                                  std::string* error) {
+    auto options = arrow::ipc::IpcWriteOptions::Defaults();
+    if (insert_config_.compression != "none") {
+        auto type = insert_config_.compression == "zstd" ? arrow::Compression::ZSTD : arrow::Compression::LZ4_FRAME;
+        // 每个分片独立的 codec 实例，并发分片之间不共享压缩上下文
+        auto codec = arrow::util::Codec::Create(type);
+        if (!codec.ok()) {
+            if (error) *error = codec.status().ToString();
             return -1;
         }
+        options.codec = std::shared_ptr<arrow::util::Codec>(std::move(*codec));
     }
 
-    auto close_status = writer->Close();
-    if (!close_status.ok()) {
-        if (error) *error = close_status.ToString();
+    std::string chunk;
+    auto stream = std::make_shared<ChunkOutputStream>(&chunk);
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+    size_t next = 0;
+    std::string encode_error;
+
+    // 每次回调序列化一个 batch（首次附带 Schema，最后一次写 EOS），请求体内存占用与单个 batch 相当
+    auto provider = [&](size_t, httplib::DataSink& sink) -> bool {
+        arrow::Status status;
+        if (!writer) {
+            auto result = arrow::ipc::MakeStreamWriter(stream, batches[0]->schema(), options);
+            if (!result.ok()) {
+                encode_error = result.status().ToString();
+                return false;
+            }
+            writer = *result;
+        }
+        bool last = next == batches.size();
+        status = last ? writer->Close() : writer->WriteRecordBatch(*batches[next++]);
+        if (!status.ok()) {
+            encode_error = status.ToString();
+            return false;
+        }
+        if (!chunk.empty() && !sink.write(chunk.data(), chunk.size())) return false;
+        chunk.clear();
+        if (last) sink.done();
+        return true;
+    };
+
+    auto res = client->Post(path, clients_->headers(), provider, "application/octet-stream");
+    if (!res) {
+        if (error) {
+            *error = encode_error.empty() ? "Connection failed: " + httplib::to_string(res.error()) : encode_error;
+        }
         return -1;
     }
+    if (res->status != 200 && error) *error = res->body;
+    return res->status;
+}
 
-    auto buffer_result = buffer_output->Finish();
-    if (!buffer_result.ok()) {
-        if (error) *error = buffer_result.status().ToString();
-        return -1;
+int ClickHouseSession::WriteArrowBatches(const char* table,
+                                         const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
+                                         std::string* error) {
+    // 空 batches 提前返回，不发 HTTP 请求
+    // （ClickHouse 收到只有 Schema 的 IPC Stream 行为未定义）
+    if (batches.empty()) return 0;
+
+    std::string query = "INSERT INTO " + QuoteIdentifier(table) + " FORMAT ArrowStream";
+    std::string path = "/?database=" + clients_->database() + "&query=" + httplib::detail::encode_url(query);
+
+    int64_t total_rows = 0;
+    for (const auto& batch : batches) total_rows += batch->num_rows();
+    int64_t wanted = (total_rows + insert_config_.part_rows - 1) / insert_config_.part_rows;
+    int parts = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(wanted, insert_config_.max_parallel_parts)));
+
+    // 单分片：走会话粘滞连接
+    if (parts == 1) {
+        std::lock_guard<std::mutex> lock(client_mutex_);
+        if (!client_) client_ = clients_->Acquire();
+        int status = InsertPart(client_, path, batches, error);
+        if (status < 0) {
+            clients_->Discard(client_);
+            client_ = nullptr;
+        }
+        return status == 200 ? 0 : -1;
     }
 
-    auto buf = *buffer_result;
-    *body = std::string(reinterpret_cast<const char*>(buf->data()), buf->size());
+    // 多分片：每个分片一个线程、一条独立的池化连接，并发 INSERT
+    auto split = SplitParts(batches, total_rows, parts);
+    parts = static_cast<int>(split.size());
+    std::vector<std::string> errors(parts);
+    std::vector<int> statuses(parts, 0);
+    std::vector<std::thread> workers;
+    workers.reserve(parts);
+    for (int i = 0; i < parts; ++i) {
+        workers.emplace_back([&, i]() {
+            httplib::Client* client = clients_->Acquire();
+            statuses[i] = InsertPart(client, path, split[i], &errors[i]);
+            if (statuses[i] < 0) clients_->Discard(client);
+            else clients_->Return(client);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    for (int i = 0; i < parts; ++i) {
+        if (statuses[i] != 200) {
+            if (error) *error = "part " + std::to_string(i + 1) + "/" + std::to_string(parts) + ": " + errors[i];
+            return -1;
+        }
+    }
     return 0;
 }
 
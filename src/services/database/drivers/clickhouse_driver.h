@@ -1,43 +1,64 @@
 #ifndef _FLOWSQL_SERVICES_DATABASE_DRIVERS_CLICKHOUSE_DRIVER_H_
 #define _FLOWSQL_SERVICES_DATABASE_DRIVERS_CLICKHOUSE_DRIVER_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "../connection_pool.h"
 #include "../db_session.h"
 #include "../idb_driver.h"
 #include "../capability_interfaces.h"
 
+namespace httplib {
+class Client;
+}
+
 namespace flowsql {
 namespace database {
 
+class ClickHouseClientPool;
+
+// 批量写入参数（Connect 参数 insert_compression / insert_parallel_parts / insert_part_rows）
+struct ClickHouseInsertConfig {
+    std::string compression = "lz4";  // Arrow IPC body 压缩：none / lz4 / zstd
+    int max_parallel_parts = 4;       // 单次写入最多拆分成的并发 INSERT 数
+    int64_t part_rows = 1 << 20;      // 每个分片的最少行数，总行数不足时不拆分
+};
+
 // ClickHouseDriver — ClickHouse 数据库驱动
 // 基于 HTTP 接口（8123 端口），使用 cpp-httplib，零新依赖
-// HTTP 无状态，不需要连接池，每次 CreateSession() 创建新 Session
-class __attribute__((visibility("default"))) ClickHouseDriver : public IDbDriver {
+// 驱动持有 keep-alive httplib::Client 连接池（ConnectionPoolConfig 决定池大小），
+// 每次 CreateSession() 创建新 Session，Session 共享连接池，避免每条语句重新建立 TCP 连接
+class __attribute__((visibility("default"))) ClickHouseDriver : public IDbDriver, public IPooledDriver {
 public:
     ClickHouseDriver() = default;
     ~ClickHouseDriver() override = default;
 
     // IDbDriver 实现
     int Connect(const std::unordered_map<std::string, std::string>& params) override;
-    int Disconnect() override { connected_ = false; return 0; }
+    int Disconnect() override;
     bool IsConnected() override { return connected_; }
     const char* DriverName() override { return "clickhouse"; }
     const char* LastError() override { return last_error_.c_str(); }
     bool Ping() override;
 
-    // 创建 Session（每次返回新实例，HTTP 无状态）
+    // IPooledDriver 实现
+    int WarmupPool(std::string* error) override;
+    bool GetPoolMetrics(ConnectionPoolMetrics* metrics) override;
+
+    // 创建 Session（每次返回新实例，共享驱动的 HTTP 连接池）
     std::shared_ptr<IDbSession> CreateSession();
 
 private:
-    std::string host_;
-    int port_ = 8123;
-    std::string user_;
-    std::string password_;
-    std::string database_;
+    // 连接池由 Session 共同持有：Disconnect 后仍在使用的 Session 不会悬空
+    std::shared_ptr<ClickHouseClientPool> clients_;
+    ClickHouseInsertConfig insert_config_;
+    bool warmup_on_open_ = false;
     bool connected_ = false;
     std::string last_error_;
 };
@@ -45,24 +66,32 @@ private:
 // ClickHouseSession — ClickHouse 会话实现
 // 直接继承 IDbSession，覆盖 Arrow 方法
 // 同时继承 IArrowReadable + IArrowWritable，供 DatabaseChannel::CreateArrowReader/Writer 的 dynamic_cast 检查
+// 继承 IBatchReadable 提供流式读取器（响应体边接收边解码），供 DatabaseChannel::CreateReader 使用
 // 不继承 RelationDbSessionBase（ClickHouse 是列式数据库，不走行式路径）
 class ClickHouseSession : public IDbSession,
                           public IArrowReadable,
-                          public IArrowWritable {
+                          public IArrowWritable,
+                          public IBatchReadable {
 public:
-    ClickHouseSession(const std::string& host, int port,
-                      const std::string& user, const std::string& password,
-                      const std::string& database);
-    ~ClickHouseSession() override = default;
+    // 响应体分块回调，返回 false 中止请求
+    using ChunkReceiver = std::function<bool(const char* data, size_t len)>;
+
+    ClickHouseSession(std::shared_ptr<ClickHouseClientPool> clients, const ClickHouseInsertConfig& insert_config);
+    ~ClickHouseSession() override;
 
     // ==================== 列式接口（核心实现）====================
 
-    // 执行 Arrow 查询：构造 "{sql} FORMAT ArrowStream"，POST，解析响应体
+    // 执行 Arrow 查询：构造 "{sql} FORMAT ArrowStream"，POST，响应体分块送入 StreamDecoder 增量解码
     int ExecuteQueryArrow(const char* sql,
                           std::vector<std::shared_ptr<arrow::RecordBatch>>* batches,
                           std::string* error) override;
 
-    // 写入 Arrow batches：序列化为 Arrow IPC Stream，POST INSERT
+    // 流式读取：后台线程接收响应体并增量解码，每个 RecordBatch 解码完成即可由 Next/NextBatch 取出
+    int CreateReader(const char* query, IBatchReader** reader) override;
+
+    // 写入 Arrow batches：按行数拆分为至多 max_parallel_parts 个分片并发 INSERT，
+    // 每个分片以 chunked 请求体逐 batch 流式序列化（可选 LZ4/ZSTD IPC 压缩），不在内存中拼出完整请求体
+    // 分片之间不是原子的：某个分片失败时其余分片可能已经写入
     int WriteArrowBatches(const char* table,
                           const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
                           std::string* error) override;
@@ -91,20 +120,21 @@ public:
     }
 
 private:
-    // 解析 Arrow IPC Stream 响应体
-    int ParseArrowStream(const std::string& body,
-                         std::vector<std::shared_ptr<arrow::RecordBatch>>* batches,
-                         std::string* error);
-
-    // 序列化 batches 为 Arrow IPC Stream
-    int SerializeArrowStream(const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
-                             std::string* body, std::string* error);
-
-    std::string host_;
-    int port_;
-    std::string user_;
-    std::string password_;
-    std::string database_;
+    // 以 chunked 请求体流式 INSERT 一个分片，返回 HTTP 状态码，传输失败返回 -1（error 为错误描述）
+    int InsertPart(httplib::Client* client, const std::string& path,
+                   const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches, std::string* error);
+
+    // 发送 POST 请求：复用本 Session 上次使用的 keep-alive 连接，没有时从连接池获取
+    // receiver 非空时 200 响应体逐块交给 receiver，否则累积到 response（错误响应总是写入 response）
+    // 返回 HTTP 状态码，传输失败或被中止返回 -1（该连接被丢弃）
+    int Post(const std::string& path, std::string body, const char* content_type,
+             std::string* response, const ChunkReceiver& receiver = nullptr);
+
+    std::shared_ptr<ClickHouseClientPool> clients_;
+    ClickHouseInsertConfig insert_config_;
+    // 会话粘滞的连接：连续的小语句走同一条已建立的连接，不反复进出连接池；Session 析构时归还
+    std::mutex client_mutex_;
+    httplib::Client* client_ = nullptr;
 };
 
 }  // namespace database
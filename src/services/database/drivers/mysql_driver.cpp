@@ -7,12 +7,18 @@
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
 
+#include <mysql/errmsg.h>
+
 #include <algorithm>
 #include <cerrno>
+#include <charconv>
 #include <climits>
 #include <cstdio>
 #include <common/log.h>
+#include <cstdlib>
 #include <cstring>
+#include <type_traits>
+#include <unordered_map>
 
 namespace flowsql {
 namespace database {
@@ -222,9 +228,9 @@ IResultSet* MysqlSession::CreateResultSet(MYSQL_RES* result,
 }
 
 // 使用简单 API 执行查询（覆盖基类的 prepared statement 路径）
-// 设计说明：MySQL 的简单 API（mysql_query）对于动态 SQL 已足够，
+// 设计说明：MySQL 的简单 API（mysql_query）对于一次性的动态 SQL 已足够，
 // 且避免了 prepared statement 的额外往返开销。
-// 写入路径（InsertBatch）通过 ExecuteSql 同样走简单 API，保持一致。
+// 批量写入（MysqlBatchWriter）的 INSERT 语句会被反复执行，因此单独走预编译语句 + 二进制协议。
 int MysqlSession::ExecuteQuery(const char* sql, IResultSet** result, std::string* error) {
     if (mysql_query(conn_, sql) != 0) {
         if (error) *error = mysql_error(conn_);
@@ -277,17 +283,163 @@ std::shared_ptr<arrow::Schema> MysqlSession::InferSchema(IResultSet* result, std
 }
 
 
+// ==================== MysqlBatchReader 实现 ====================
+
+// MysqlBatchReader — MySQL 流式批量读取器
+// 基于 mysql_use_result：服务端逐行下发，客户端只缓存当前行，内存占用与结果集大小无关；
+// 直接 mysql_fetch_row + mysql_fetch_lengths 解析文本协议值追加到类型化 Builder，不经过 IResultSet 虚函数
+// 批次构建与 IPC 编码由 RelationBatchReaderBase 提供，这里只实现逐行 / 逐单元格的取值钩子
+//
+// 取消：Cancel 置位后读取线程在下一行处结束；同时通过独立连接发送 KILL QUERY，
+// 让阻塞在网络读上的 mysql_fetch_row 立即返回，且释放结果集时无需把剩余行读完
+class MysqlBatchReader : public RelationBatchReaderBase<MysqlBatchReader> {
+public:
+    MysqlBatchReader(std::shared_ptr<IDbSession> session, IResultSet* result, MYSQL_RES* res,
+                     MYSQL* conn, MysqlDriver* driver, std::shared_ptr<arrow::Schema> schema)
+        : RelationBatchReaderBase(std::move(session), result, std::move(schema)),
+          res_(res), conn_(conn), driver_(driver), thread_id_(mysql_thread_id(conn)) {}
+
+    void Cancel() override {
+        if (cancelled_.exchange(true) || done_) return;
+        // 仅在结果集未读完时中止服务端查询；连接由本读取器持有的 Session 独占，不会误杀其他查询
+        std::string error;
+        if (driver_ && driver_->KillQuery(thread_id_, &error) != 0) {
+            LOG_WARN("MysqlBatchReader: KILL QUERY %lu failed: %s", thread_id_, error.c_str());
+        }
+    }
+
+private:
+    friend class RelationBatchReaderBase<MysqlBatchReader>;
+
+    int StepRow() {
+        row_ = mysql_fetch_row(res_);
+        if (!row_) {
+            // use_result 模式下 NULL 既可能是读完，也可能是网络错误或 KILL QUERY
+            if (mysql_errno(conn_) != 0) {
+                if (!CheckCancelled()) last_error_ = "mysql_fetch_row failed: " + std::string(mysql_error(conn_));
+                return -1;
+            }
+            return 0;
+        }
+        lengths_ = mysql_fetch_lengths(res_);
+        return 1;
+    }
+
+    bool CellIsNull(int col) { return row_[col] == nullptr; }
+
+    // 整数用 std::from_chars 按长度解析，无需 errno 和 NUL 终止；解析失败或越界记为 NULL（与 MysqlResultSet 一致）
+    template <typename CType>
+    bool FetchInteger(int col, CType* v) {
+        auto r = std::from_chars(row_[col], row_[col] + lengths_[col], *v);
+        return r.ec == std::errc();
+    }
+
+    bool FetchInt32(int col, int32_t* v) { return FetchInteger(col, v); }
+    bool FetchInt64(int col, int64_t* v) { return FetchInteger(col, v); }
+
+    // 文本协议的值以 NUL 结尾，可直接 strtod
+    bool FetchDouble(int col, double* v) {
+        char* end = nullptr;
+        *v = std::strtod(row_[col], &end);
+        return end != row_[col];
+    }
+
+    bool FetchString(int col, const uint8_t** data, int64_t* len) {
+        *data = reinterpret_cast<const uint8_t*>(row_[col]);
+        *len = static_cast<int64_t>(lengths_[col]);
+        return true;
+    }
+    bool FetchBinary(int col, const uint8_t** data, int64_t* len) { return FetchString(col, data, len); }
+
+    MYSQL_RES* res_;  // 由基类持有的 MysqlResultSet 负责释放
+    MYSQL* conn_;
+    MysqlDriver* driver_;
+    unsigned long thread_id_;
+    MYSQL_ROW row_ = nullptr;
+    unsigned long* lengths_ = nullptr;
+};
+
 IBatchReader* MysqlSession::CreateBatchReader(IResultSet* result,
                                                std::shared_ptr<arrow::Schema> schema) {
-    return new RelationBatchReader(shared_from_this(), result, schema);
+    MYSQL_RES* res = static_cast<MysqlResultSet*>(result)->GetResult();
+    return new MysqlBatchReader(shared_from_this(), result, res, conn_,
+                                static_cast<MysqlDriver*>(this->driver_), schema);
+}
+
+// 批量读取默认走 mysql_use_result 流式拉取（driver 参数 streaming_read=false 时回退到基类的 mysql_store_result）
+// 流式模式下结果集读完或释放之前该连接不能执行其他语句；读取器持有本 Session，连接不会提前归还连接池
+int MysqlSession::CreateReader(const char* query, IBatchReader** reader) {
+    auto* mysql_driver = static_cast<MysqlDriver*>(this->driver_);
+    if (!mysql_driver || !mysql_driver->StreamingRead()) {
+        return RelationDbSessionBase<MysqlTraits>::CreateReader(query, reader);
+    }
+
+    if (mysql_query(conn_, query) != 0) {
+        LOG_ERROR("MysqlSession::CreateReader: %s", mysql_error(conn_));
+        return -1;
+    }
+    MYSQL_RES* res = mysql_use_result(conn_);
+    if (!res) {
+        LOG_ERROR("MysqlSession::CreateReader: mysql_use_result failed: %s", mysql_error(conn_));
+        return -1;
+    }
+    std::unique_ptr<IResultSet> result(
+        new MysqlResultSet(res, [](MYSQL_RES* r) { mysql_free_result(r); }));
+
+    std::string error;
+    auto schema = InferSchema(result.get(), &error);
+    if (!schema) return -1;
+
+    *reader = CreateBatchReader(result.release(), schema);
+    return (*reader) ? 0 : -1;
 }
 
 // ==================== MysqlBatchWriter 实现 ====================
 
+// MYSQL_BIND::is_null 的指向类型（MySQL 8 为 bool，MariaDB / 5.7 为 my_bool）
+// 包一层结构体，避免 std::vector<bool> 特化导致无法取元素地址
+struct MysqlNullFlag {
+    std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type value;
+};
+
+// LOAD DATA LOCAL INFILE 的内存数据源，通过 mysql_set_local_infile_handler 回调读取
+struct InfileSource {
+    const std::string* data = nullptr;
+    size_t pos = 0;
+};
+
+static int InfileInit(void** ptr, const char* /*filename*/, void* userdata) {
+    auto* src = static_cast<InfileSource*>(userdata);
+    src->pos = 0;
+    *ptr = src;
+    return 0;
+}
+
+static int InfileRead(void* ptr, char* buf, unsigned int buf_len) {
+    auto* src = static_cast<InfileSource*>(ptr);
+    size_t n = std::min<size_t>(buf_len, src->data->size() - src->pos);
+    memcpy(buf, src->data->data() + src->pos, n);
+    src->pos += n;
+    return static_cast<int>(n);
+}
+
+static void InfileEnd(void* /*ptr*/) {}
+
+static int InfileError(void* /*ptr*/, char* error_msg, unsigned int error_msg_len) {
+    snprintf(error_msg, error_msg_len, "in-memory infile read failed");
+    return CR_UNKNOWN_ERROR;
+}
+
 class MysqlBatchWriter : public RelationBatchWriterBase {
 public:
-    MysqlBatchWriter(std::shared_ptr<IDbSession> session, const char* table)
-        : RelationBatchWriterBase(std::move(session), table) {}
+    MysqlBatchWriter(std::shared_ptr<IDbSession> session, MYSQL* conn, const char* table,
+                     int64_t local_infile_min_rows, const std::string& charset)
+        : RelationBatchWriterBase(std::move(session), table), conn_(conn),
+          local_infile_min_rows_(local_infile_min_rows), charset_(charset) {}
+
+    ~MysqlBatchWriter() override {
+        for (auto& kv : stmts_) mysql_stmt_close(kv.second.stmt);
+    }
 
 protected:
     // MySQL 用反引号包裹标识符，内部反引号用 `` 转义
@@ -322,46 +474,344 @@ protected:
         return 0;
     }
 
-    /* MySQL 分块多值 INSERT（每次最多 1000 行，性能优化）
-       字符串转义：' → \'，\ → \\
+    /* 默认走服务端预编译语句 + 二进制协议：
+         多值 INSERT 按行数缓存预编译语句，MYSQL_BIND 直接指向 Arrow 列缓冲区，无需格式化/转义
+         每条语句的参数数不超过 65535，发送数据量不超过 max_allowed_packet 的 3/4
+       批次行数 >= local_infile_min_rows（> 0 时启用）走 LOAD DATA LOCAL INFILE，
+       数据在内存中编码为 TSV，通过 infile 回调流式发送，适合超大批量导入
     */
     int InsertBatch(std::shared_ptr<arrow::RecordBatch> batch) override {
         if (batch->num_rows() == 0) return 0;
+        if (BindColumns(*batch) != 0) return -1;
+        if (local_infile_min_rows_ > 0 && batch->num_rows() >= local_infile_min_rows_) {
+            return LoadDataInfile(*batch);
+        }
+        return InsertPrepared(*batch);
+    }
+
+private:
+    static constexpr int64_t kMaxPlaceholders = 65535;
+    static constexpr int64_t kDefaultMaxPacket = 4 * 1024 * 1024;
+    static constexpr size_t kMaxCachedStatements = 4;
+    static constexpr int64_t kStringBindOverhead = 9;  // 二进制协议中变长值的长度前缀上限
+
+    // 列绑定信息：定长列直接指向 Arrow value buffer，布尔列展开为 int8
+    struct ColumnBinding {
+        enum_field_types type = MYSQL_TYPE_NULL;
+        int width = 0;                      // 定长列字节宽度，变长列为 0
+        const uint8_t* values = nullptr;    // 定长列首行地址（已计入 array offset）
+        const arrow::BinaryArray* binary = nullptr;
+        const arrow::Array* array = nullptr;
+        std::vector<int8_t> bools;
+    };
 
-        auto quote_string = [](const std::string& s) -> std::string {
-            std::string r = "'";
-            for (char c : s) {
-                if (c == '\'') r += "\\'";
-                else if (c == '\\') r += "\\\\";
-                else r += c;
+    int BindColumns(const arrow::RecordBatch& batch) {
+        columns_.clear();
+        columns_.resize(batch.num_columns());
+        fixed_row_bytes_ = 0;
+        has_var_columns_ = false;
+        for (int c = 0; c < batch.num_columns(); ++c) {
+            const auto& array = batch.column(c);
+            auto& col = columns_[c];
+            col.array = array.get();
+            switch (array->type_id()) {
+                case arrow::Type::INT32:
+                    col.type = MYSQL_TYPE_LONG; col.width = 4;
+                    col.values = reinterpret_cast<const uint8_t*>(
+                        static_cast<const arrow::Int32Array&>(*array).raw_values());
+                    break;
+                case arrow::Type::INT64:
+                    col.type = MYSQL_TYPE_LONGLONG; col.width = 8;
+                    col.values = reinterpret_cast<const uint8_t*>(
+                        static_cast<const arrow::Int64Array&>(*array).raw_values());
+                    break;
+                case arrow::Type::FLOAT:
+                    col.type = MYSQL_TYPE_FLOAT; col.width = 4;
+                    col.values = reinterpret_cast<const uint8_t*>(
+                        static_cast<const arrow::FloatArray&>(*array).raw_values());
+                    break;
+                case arrow::Type::DOUBLE:
+                    col.type = MYSQL_TYPE_DOUBLE; col.width = 8;
+                    col.values = reinterpret_cast<const uint8_t*>(
+                        static_cast<const arrow::DoubleArray&>(*array).raw_values());
+                    break;
+                case arrow::Type::BOOL: {
+                    const auto& bools = static_cast<const arrow::BooleanArray&>(*array);
+                    col.type = MYSQL_TYPE_TINY; col.width = 1;
+                    col.bools.resize(bools.length());
+                    for (int64_t i = 0; i < bools.length(); ++i) col.bools[i] = bools.Value(i) ? 1 : 0;
+                    col.values = reinterpret_cast<const uint8_t*>(col.bools.data());
+                    break;
+                }
+                case arrow::Type::STRING:
+                case arrow::Type::BINARY:
+                    // StringArray 派生自 BinaryArray，两者布局一致
+                    col.type = array->type_id() == arrow::Type::STRING ? MYSQL_TYPE_STRING : MYSQL_TYPE_BLOB;
+                    col.binary = static_cast<const arrow::BinaryArray*>(array.get());
+                    has_var_columns_ = true;
+                    break;
+                default:
+                    last_error_ = "unsupported column type for MySQL insert: " + array->type()->ToString();
+                    return -1;
             }
-            r += "'";
-            return r;
-        };
-
-        const int64_t chunk_size = 1000;
-        std::string prefix = "INSERT INTO " + QuoteIdentifier(table_) + " VALUES ";
-
-        for (int64_t start = 0; start < batch->num_rows(); start += chunk_size) {
-            int64_t end = std::min(start + chunk_size, batch->num_rows());
-            std::string sql = prefix;
-            for (int64_t row = start; row < end; ++row) {
-                if (row > start) sql += ", ";
-                sql += BuildRowValues(batch, row, quote_string);
+            fixed_row_bytes_ += col.width;
+        }
+        return 0;
+    }
+
+    int64_t RowBytes(int64_t row) const {
+        int64_t bytes = fixed_row_bytes_;
+        if (!has_var_columns_) return bytes;
+        for (const auto& col : columns_) {
+            if (col.binary && !col.binary->IsNull(row)) {
+                bytes += col.binary->value_length(row) + kStringBindOverhead;
             }
-            std::string error;
-            if (session_->ExecuteSql(sql.c_str(), &error) < 0) {
-                last_error_ = "INSERT failed: " + error;
-                return -1;
+        }
+        return bytes;
+    }
+
+    int64_t MaxAllowedPacket() {
+        if (max_packet_ > 0) return max_packet_;
+        max_packet_ = kDefaultMaxPacket;
+        if (mysql_query(conn_, "SELECT @@max_allowed_packet") == 0) {
+            MYSQL_RES* res = mysql_store_result(conn_);
+            if (res) {
+                MYSQL_ROW row = mysql_fetch_row(res);
+                if (row && row[0]) {
+                    long long v = std::strtoll(row[0], nullptr, 10);
+                    if (v > 0) max_packet_ = v;
+                }
+                mysql_free_result(res);
+            }
+        }
+        return max_packet_;
+    }
+
+    // 每批只算一次块行数：按本批最宽的行估算，任意连续 chunk_rows 行都不超过发送预算，
+    // 整块共用一条预编译语句，只有尾块另需一条；块行数向下取 2 的幂，跨批次也能命中缓存
+    int64_t ChunkRows(const arrow::RecordBatch& batch, int64_t* total_bytes) {
+        const int64_t max_rows = std::max<int64_t>(1, kMaxPlaceholders / std::max<int64_t>(1, batch.num_columns()));
+        const int64_t budget = MaxAllowedPacket() / 4 * 3;
+        int64_t widest = fixed_row_bytes_;
+        *total_bytes = fixed_row_bytes_ * batch.num_rows();
+        if (has_var_columns_) {
+            *total_bytes = 0;
+            for (int64_t row = 0; row < batch.num_rows(); ++row) {
+                int64_t row_bytes = RowBytes(row);
+                widest = std::max(widest, row_bytes);
+                *total_bytes += row_bytes;
+            }
+        }
+        int64_t rows = std::min(max_rows, std::max<int64_t>(1, budget / std::max<int64_t>(1, widest)));
+        if (rows == max_rows) return rows;
+        int64_t pow2 = 1;
+        while (pow2 * 2 <= rows) pow2 *= 2;
+        return pow2;
+    }
+
+    int InsertPrepared(const arrow::RecordBatch& batch) {
+        const int64_t num_rows = batch.num_rows();
+        int64_t total_bytes = 0;
+        const int64_t chunk_rows = ChunkRows(batch, &total_bytes);
+
+        for (int64_t start = 0; start < num_rows; start += chunk_rows) {
+            const int64_t rows = std::min(chunk_rows, num_rows - start);
+            if (ExecuteChunk(start, rows) != 0) return -1;
+            rows_written_ += rows;
+        }
+        bytes_written_ += total_bytes;
+        return 0;
+    }
+
+    // 取 rows 行的多值 INSERT 预编译语句，按行数缓存（整块与尾块各占一条）
+    // 缓存满时只淘汰最久未用的一条，整块语句一直在用，不会被尾块挤掉
+    MYSQL_STMT* GetStatement(int64_t rows) {
+        ++stmt_clock_;
+        auto it = stmts_.find(rows);
+        if (it != stmts_.end()) {
+            it->second.last_use = stmt_clock_;
+            return it->second.stmt;
+        }
+
+        if (stmts_.size() >= kMaxCachedStatements) {
+            auto oldest = std::min_element(stmts_.begin(), stmts_.end(), [](const auto& a, const auto& b) {
+                return a.second.last_use < b.second.last_use;
+            });
+            mysql_stmt_close(oldest->second.stmt);
+            stmts_.erase(oldest);
+        }
+
+        std::string row_marks = "(";
+        for (size_t c = 0; c < columns_.size(); ++c) row_marks += (c == 0) ? "?" : ",?";
+        row_marks += ")";
+        std::string sql = "INSERT INTO " + QuoteIdentifier(table_) + " VALUES ";
+        sql.reserve(sql.size() + static_cast<size_t>(rows) * (row_marks.size() + 1));
+        for (int64_t r = 0; r < rows; ++r) {
+            if (r > 0) sql += ',';
+            sql += row_marks;
+        }
+
+        MYSQL_STMT* stmt = mysql_stmt_init(conn_);
+        if (!stmt) {
+            last_error_ = "mysql_stmt_init failed";
+            return nullptr;
+        }
+        if (mysql_stmt_prepare(stmt, sql.c_str(), sql.size()) != 0) {
+            last_error_ = "INSERT prepare failed: " + std::string(mysql_stmt_error(stmt));
+            mysql_stmt_close(stmt);
+            return nullptr;
+        }
+        stmts_[rows] = CachedStatement{stmt, stmt_clock_};
+        return stmt;
+    }
+
+    int ExecuteChunk(int64_t start, int64_t rows) {
+        MYSQL_STMT* stmt = GetStatement(rows);
+        if (!stmt) return -1;
+
+        const size_t num_cols = columns_.size();
+        const size_t num_params = static_cast<size_t>(rows) * num_cols;
+        binds_.assign(num_params, MYSQL_BIND());
+        lengths_.assign(num_params, 0);
+        nulls_.assign(num_params, MysqlNullFlag{});
+
+        for (int64_t r = 0; r < rows; ++r) {
+            const int64_t row = start + r;
+            for (size_t c = 0; c < num_cols; ++c) {
+                const auto& col = columns_[c];
+                const size_t idx = static_cast<size_t>(r) * num_cols + c;
+                MYSQL_BIND& b = binds_[idx];
+                b.buffer_type = col.type;
+                b.is_null = &nulls_[idx].value;
+                if (col.array->IsNull(row)) {
+                    nulls_[idx].value = 1;
+                    continue;
+                }
+                if (col.binary) {
+                    auto view = col.binary->GetView(row);
+                    b.buffer = const_cast<char*>(view.data());
+                    b.buffer_length = static_cast<unsigned long>(view.size());
+                    lengths_[idx] = static_cast<unsigned long>(view.size());
+                    b.length = &lengths_[idx];
+                } else {
+                    b.buffer = const_cast<uint8_t*>(col.values + row * col.width);
+                }
+            }
+        }
+
+        if (mysql_stmt_bind_param(stmt, binds_.data()) != 0) {
+            last_error_ = "INSERT bind failed: " + std::string(mysql_stmt_error(stmt));
+            return -1;
+        }
+        if (mysql_stmt_execute(stmt) != 0) {
+            last_error_ = "INSERT failed: " + std::string(mysql_stmt_error(stmt));
+            return -1;
+        }
+        return 0;
+    }
+
+    // LOAD DATA 使用默认转义规则：\ 转义 \、TAB、换行、回车和 NUL，NULL 写作 \N
+    static void AppendEscaped(std::string* out, const char* s, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            char ch = s[i];
+            switch (ch) {
+                case '\\': out->append("\\\\"); break;
+                case '\t': out->append("\\t"); break;
+                case '\n': out->append("\\n"); break;
+                case '\r': out->append("\\r"); break;
+                case '\0': out->append("\\0"); break;
+                default: out->push_back(ch); break;
+            }
+        }
+    }
+
+    int LoadDataInfile(const arrow::RecordBatch& batch) {
+        std::string data;
+        data.reserve(static_cast<size_t>(batch.num_rows() * (fixed_row_bytes_ * 3 + 16)));
+        char num[32];
+        for (int64_t row = 0; row < batch.num_rows(); ++row) {
+            for (size_t c = 0; c < columns_.size(); ++c) {
+                if (c > 0) data.push_back('\t');
+                const auto& col = columns_[c];
+                if (col.array->IsNull(row)) {
+                    data.append("\\N");
+                    continue;
+                }
+                int n = 0;
+                switch (col.type) {
+                    case MYSQL_TYPE_LONG:
+                        n = snprintf(num, sizeof(num), "%d",
+                                     reinterpret_cast<const int32_t*>(col.values)[row]);
+                        break;
+                    case MYSQL_TYPE_LONGLONG:
+                        n = snprintf(num, sizeof(num), "%lld", static_cast<long long>(
+                                     reinterpret_cast<const int64_t*>(col.values)[row]));
+                        break;
+                    case MYSQL_TYPE_FLOAT:
+                        n = snprintf(num, sizeof(num), "%.9g",
+                                     reinterpret_cast<const float*>(col.values)[row]);
+                        break;
+                    case MYSQL_TYPE_DOUBLE:
+                        n = snprintf(num, sizeof(num), "%.17g",
+                                     reinterpret_cast<const double*>(col.values)[row]);
+                        break;
+                    case MYSQL_TYPE_TINY:
+                        num[0] = col.bools[row] ? '1' : '0';
+                        n = 1;
+                        break;
+                    default: {
+                        auto view = col.binary->GetView(row);
+                        AppendEscaped(&data, view.data(), view.size());
+                        break;
+                    }
+                }
+                if (n > 0) data.append(num, static_cast<size_t>(n));
             }
-            rows_written_ += (end - start);
+            data.push_back('\n');
         }
+
+        std::string sql = "LOAD DATA LOCAL INFILE 'flowsql_batch' INTO TABLE " + QuoteIdentifier(table_) +
+                          " CHARACTER SET " + charset_ +
+                          " FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n'";
+        InfileSource source;
+        source.data = &data;
+        mysql_set_local_infile_handler(conn_, InfileInit, InfileRead, InfileEnd, InfileError, &source);
+        int rc = mysql_query(conn_, sql.c_str());
+        mysql_set_local_infile_default(conn_);
+        if (rc != 0) {
+            last_error_ = "LOAD DATA LOCAL INFILE failed: " + std::string(mysql_error(conn_));
+            return -1;
+        }
+        rows_written_ += batch.num_rows();
+        bytes_written_ += static_cast<int64_t>(data.size());
         return 0;
     }
+
+    MYSQL* conn_;
+    int64_t local_infile_min_rows_;
+    std::string charset_;
+    int64_t max_packet_ = 0;
+
+    std::vector<ColumnBinding> columns_;
+    int64_t fixed_row_bytes_ = 0;
+    bool has_var_columns_ = false;
+
+    struct CachedStatement {
+        MYSQL_STMT* stmt = nullptr;
+        uint64_t last_use = 0;
+    };
+    std::unordered_map<int64_t, CachedStatement> stmts_;  // 行数 → 预编译语句
+    uint64_t stmt_clock_ = 0;
+    std::vector<MYSQL_BIND> binds_;
+    std::vector<unsigned long> lengths_;
+    std::vector<MysqlNullFlag> nulls_;
 };
 
 IBatchWriter* MysqlSession::CreateBatchWriter(const char* table) {
-    return new MysqlBatchWriter(shared_from_this(), table);
+    auto* mysql_driver = static_cast<MysqlDriver*>(this->driver_);
+    int64_t local_infile_min_rows = mysql_driver ? mysql_driver->LocalInfileMinRows() : 0;
+    std::string charset = mysql_driver ? mysql_driver->Charset() : "utf8mb4";
+    return new MysqlBatchWriter(shared_from_this(), conn_, table, local_infile_min_rows, charset);
 }
 
 
@@ -375,6 +825,8 @@ int MysqlDriver::Connect(const std::unordered_map<std::string, std::string>& par
     config.min_connections = 0;
     config.idle_timeout = std::chrono::seconds(300);
     config.health_check_interval = std::chrono::seconds(60);
+    // 池满时等待其他查询归还连接，而不是立即失败
+    config.acquire_timeout = std::chrono::milliseconds(5000);
 
     auto it = params.find("host");
     host_ = (it != params.end()) ? it->second : "localhost";
@@ -397,22 +849,17 @@ int MysqlDriver::Connect(const std::unordered_map<std::string, std::string>& par
     it = params.find("timeout");
     if (it != params.end()) timeout_ = std::stoi(it->second);
 
-    auto factory = [this](std::string* error) -> MYSQL* {
-        MYSQL* conn = mysql_init(nullptr);
-        if (!conn) {
-            *error = "mysql_init failed";
-            return nullptr;
-        }
-        mysql_options(conn, MYSQL_OPT_CONNECT_TIMEOUT, &timeout_);
-        mysql_options(conn, MYSQL_SET_CHARSET_NAME, charset_.c_str());
-        if (!mysql_real_connect(conn, host_.c_str(), user_.c_str(), password_.c_str(),
-                                database_.c_str(), port_, nullptr, 0)) {
-            *error = mysql_error(conn);
-            mysql_close(conn);
-            return nullptr;
-        }
-        return conn;
-    };
+    it = params.find("local_infile_min_rows");
+    if (it != params.end()) local_infile_min_rows_ = std::stoll(it->second);
+
+    it = params.find("streaming_read");
+    if (it != params.end()) streaming_read_ = (it->second != "false");
+
+    // 连接池参数：max_connections / min_idle / idle_timeout / acquire_timeout_ms / warmup_on_open
+    ApplyPoolParams(params, &config);
+    warmup_on_open_ = config.warmup_on_open;
+
+    auto factory = [this](std::string* error) -> MYSQL* { return OpenConnection(error); };
 
     auto closer = [](MYSQL* conn) { if (conn) mysql_close(conn); };
     auto pinger = [](MYSQL* conn) -> bool { return conn && mysql_ping(conn) == 0; };
@@ -433,12 +880,65 @@ int MysqlDriver::Connect(const std::unordered_map<std::string, std::string>& par
     return 0;
 }
 
+MYSQL* MysqlDriver::OpenConnection(std::string* error) {
+    MYSQL* conn = mysql_init(nullptr);
+    if (!conn) {
+        *error = "mysql_init failed";
+        return nullptr;
+    }
+    mysql_options(conn, MYSQL_OPT_CONNECT_TIMEOUT, &timeout_);
+    mysql_options(conn, MYSQL_SET_CHARSET_NAME, charset_.c_str());
+    if (local_infile_min_rows_ > 0) {
+        unsigned int local_infile = 1;
+        mysql_options(conn, MYSQL_OPT_LOCAL_INFILE, &local_infile);
+    }
+    if (!mysql_real_connect(conn, host_.c_str(), user_.c_str(), password_.c_str(),
+                            database_.c_str(), port_, nullptr, 0)) {
+        *error = mysql_error(conn);
+        mysql_close(conn);
+        return nullptr;
+    }
+    return conn;
+}
+
+// KILL QUERY 必须从另一条连接发出（目标连接正阻塞在结果集读取上）
+// 使用临时连接而非连接池：连接池可能已满，且不应让取消操作等待
+int MysqlDriver::KillQuery(unsigned long thread_id, std::string* error) {
+    MYSQL* conn = OpenConnection(error);
+    if (!conn) return -1;
+    std::string sql = "KILL QUERY " + std::to_string(thread_id);
+    int rc = 0;
+    if (mysql_query(conn, sql.c_str()) != 0) {
+        if (error) *error = mysql_error(conn);
+        rc = -1;
+    }
+    mysql_close(conn);
+    return rc;
+}
+
 int MysqlDriver::Disconnect() {
     pool_.reset();
     LOG_INFO("MysqlDriver: disconnected");
     return 0;
 }
 
+int MysqlDriver::WarmupPool(std::string* error) {
+    if (!pool_ || !warmup_on_open_) return 0;
+    std::string err;
+    int created = pool_->Warmup(&err);
+    if (created == 0 && !err.empty()) {
+        if (error) *error = err;
+        return -1;
+    }
+    return created;
+}
+
+bool MysqlDriver::GetPoolMetrics(ConnectionPoolMetrics* metrics) {
+    if (!pool_) return false;
+    *metrics = pool_->GetMetrics();
+    return true;
+}
+
 bool MysqlDriver::Ping() {
     return pool_ != nullptr;
 }
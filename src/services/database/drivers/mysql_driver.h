@@ -28,7 +28,7 @@ class MysqlSession;
 
 // MysqlDriver — MySQL 数据库驱动
 // 基于 libmysqlclient，支持预编译语句和事务
-class __attribute__((visibility("default"))) MysqlDriver : public IDbDriver {
+class __attribute__((visibility("default"))) MysqlDriver : public IDbDriver, public IPooledDriver {
  public:
     MysqlDriver() = default;
     ~MysqlDriver() override;
@@ -41,13 +41,31 @@ class __attribute__((visibility("default"))) MysqlDriver : public IDbDriver {
     const char* LastError() override { return last_error_.c_str(); }
     bool Ping() override;
 
+    // IPooledDriver 实现
+    int WarmupPool(std::string* error) override;
+    bool GetPoolMetrics(ConnectionPoolMetrics* metrics) override;
+
     // 连接池相关
     std::shared_ptr<IDbSession> CreateSession();
     void ReturnToPool(MYSQL* conn);
 
+    // 批量写入参数
+    int64_t LocalInfileMinRows() const { return local_infile_min_rows_; }
+    const std::string& Charset() const { return charset_; }
+
+    // 批量读取是否使用 mysql_use_result 流式拉取
+    bool StreamingRead() const { return streaming_read_; }
+
+    // 通过独立连接中止指定连接上正在执行的查询（KILL QUERY）
+    int KillQuery(unsigned long thread_id, std::string* error);
+
  private:
+    MYSQL* OpenConnection(std::string* error);
+
     // 连接池
     std::unique_ptr<ConnectionPool<MYSQL*>> pool_;
+    // 通道 Open 时是否预热连接池（参数 warmup_on_open，配合 min_idle / min_connections）
+    bool warmup_on_open_ = false;
 
     // 连接参数
     std::string host_;
@@ -57,6 +75,10 @@ class __attribute__((visibility("default"))) MysqlDriver : public IDbDriver {
     std::string database_;
     std::string charset_ = "utf8mb4";
     int timeout_ = 10;
+    // 单批行数达到该值时改用 LOAD DATA LOCAL INFILE（0 表示禁用，需服务端 local_infile=ON）
+    int64_t local_infile_min_rows_ = 0;
+    // 默认流式读取，大结果集不在客户端整体缓存（参数 streaming_read=false 时使用 mysql_store_result）
+    bool streaming_read_ = true;
 
     std::string last_error_;
 };
@@ -102,6 +124,9 @@ public:
     int ExecuteQuery(const char* sql, IResultSet** result, std::string* error) override;
     int ExecuteSql(const char* sql, std::string* error) override;
 
+    // 覆盖基类 CreateReader，使用 mysql_use_result 流式读取
+    int CreateReader(const char* query, IBatchReader** reader) override;
+
 protected:
     // 钩子方法实现
     MYSQL_STMT* PrepareStatement(MYSQL* conn, const char* sql, std::string* error) override;
@@ -195,17 +195,114 @@ IResultSet* SqliteSession::CreateResultSet(sqlite3_stmt* stmt,
     return new SqliteResultSet(stmt, free_func);
 }
 
+// ==================== SqliteBatchReader 实现 ====================
+
+// SqliteBatchReader — SQLite 原生批量读取器
+// 直接 sqlite3_step 并用 sqlite3_column_* 取值追加到类型化 Builder，
+// 不经过 IResultSet 的虚函数（每个单元格省去一次虚调用和重复的列数/类型检查）
+// GetSchema / Next（IPC 编码）、Builder 复用与自适应批大小由 RelationBatchReaderBase 提供
+class SqliteBatchReader : public RelationBatchReaderBase<SqliteBatchReader> {
+public:
+    SqliteBatchReader(std::shared_ptr<IDbSession> session, IResultSet* result,
+                      sqlite3_stmt* stmt, std::shared_ptr<arrow::Schema> schema)
+        : RelationBatchReaderBase(std::move(session), result, std::move(schema)), stmt_(stmt) {}
+
+private:
+    friend class RelationBatchReaderBase<SqliteBatchReader>;
+
+    int StepRow() {
+        int rc = sqlite3_step(stmt_);
+        if (rc == SQLITE_ROW) return 1;
+        if (rc == SQLITE_DONE) return 0;
+        last_error_ = "sqlite3_step failed: " + std::string(sqlite3_errmsg(sqlite3_db_handle(stmt_)));
+        return -1;
+    }
+
+    bool CellIsNull(int col) { return sqlite3_column_type(stmt_, col) == SQLITE_NULL; }
+
+    bool FetchInt32(int col, int32_t* v) { *v = sqlite3_column_int(stmt_, col); return true; }
+    bool FetchInt64(int col, int64_t* v) { *v = sqlite3_column_int64(stmt_, col); return true; }
+    bool FetchDouble(int col, double* v) { *v = sqlite3_column_double(stmt_, col); return true; }
+
+    // 先取指针再取长度（sqlite3_column_bytes 须在 text/blob 之后调用，避免类型转换使长度失效）
+    bool FetchString(int col, const uint8_t** data, int64_t* len) {
+        *data = sqlite3_column_text(stmt_, col);
+        *len = sqlite3_column_bytes(stmt_, col);
+        return true;
+    }
+
+    bool FetchBinary(int col, const uint8_t** data, int64_t* len) {
+        *data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt_, col));
+        *len = sqlite3_column_bytes(stmt_, col);
+        return true;
+    }
+
+    sqlite3_stmt* stmt_;  // 由基类持有的 SqliteResultSet 负责 finalize
+};
+
 IBatchReader* SqliteSession::CreateBatchReader(IResultSet* result,
                                                 std::shared_ptr<arrow::Schema> schema) {
-    return new RelationBatchReader(shared_from_this(), result, schema);
+    sqlite3_stmt* stmt = static_cast<SqliteResultSet*>(result)->GetStmt();
+    return new SqliteBatchReader(shared_from_this(), result, stmt, schema);
+}
+
+int SqliteSession::ExecuteQueryArrow(const char* sql,
+                                     std::vector<std::shared_ptr<arrow::RecordBatch>>* batches,
+                                     std::string* error) {
+    IBatchReader* reader = nullptr;
+    if (CreateReader(sql, &reader) != 0 || !reader) {
+        if (error) *error = "query failed: " + GetDriverError(conn_);
+        return -1;
+    }
+    auto* batch_source = dynamic_cast<IRecordBatchReader*>(reader);
+    int rc = 0;
+    while (true) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        rc = batch_source->NextBatch(&batch);
+        if (rc != 0) break;
+        batches->push_back(std::move(batch));
+    }
+    if (rc < 0 && error) *error = reader->GetLastError();
+    reader->Close();
+    reader->Release();
+    return rc < 0 ? -1 : 0;
 }
 
 // ==================== SqliteBatchWriter 实现 ====================
 
+// 批量导入期间临时生效的 PRAGMA（SqliteDriver 参数 ingest_pragmas=true 时启用）
+struct SqliteIngestPragmas {
+    bool enabled = false;
+    int cache_size_kb = 64 * 1024;  // PRAGMA cache_size 取负值时单位为 KiB
+};
+
 class SqliteBatchWriter : public RelationBatchWriterBase {
 public:
-    SqliteBatchWriter(std::shared_ptr<IDbSession> session, const char* table)
-        : RelationBatchWriterBase(std::move(session), table) {}
+    SqliteBatchWriter(std::shared_ptr<IDbSession> session, sqlite3* db, const char* table,
+                      const SqliteIngestPragmas& pragmas)
+        : RelationBatchWriterBase(std::move(session), table), db_(db), pragmas_(pragmas) {}
+
+    ~SqliteBatchWriter() override {
+        if (insert_stmt_) sqlite3_finalize(insert_stmt_);
+        // 先回滚未提交事务再恢复 PRAGMA（基类析构时已无事务可回滚）
+        if (transaction_started_ && !committed_) {
+            std::string error;
+            session_->RollbackTransaction(&error);
+            transaction_started_ = false;
+        }
+        RestorePragmas();
+    }
+
+    // 导入 PRAGMA 须在 BEGIN 之前切换：事务内修改 synchronous 不会生效
+    int WriteBatch(const std::shared_ptr<arrow::RecordBatch>& batch) override {
+        if (!transaction_started_ && ApplyPragmas() != 0) return -1;
+        return RelationBatchWriterBase::WriteBatch(batch);
+    }
+
+    void Close(BatchWriteStats* stats) override {
+        RelationBatchWriterBase::Close(stats);
+        RestorePragmas();
+    }
 
 protected:
     // SQLite 用双引号包裹标识符，内部双引号用 "" 转义
@@ -229,6 +326,8 @@ protected:
                 ddl += "BIGINT";
             else if (type_id == arrow::Type::FLOAT || type_id == arrow::Type::DOUBLE)
                 ddl += "REAL";
+            else if (type_id == arrow::Type::BOOL)
+                ddl += "BOOLEAN";
             else if (type_id == arrow::Type::BINARY)
                 ddl += "BLOB";
             else
@@ -240,74 +339,178 @@ protected:
             last_error_ = "CREATE TABLE failed: " + error;
             return -1;
         }
-        return 0;
+        return PrepareInsert(schema->num_fields());
     }
 
+    /* 预编译一次 INSERT，逐行 bind + step + reset
+       值直接从 Arrow 列绑定：整数 sqlite3_bind_int64，浮点 sqlite3_bind_double，
+       字符串/二进制以 SQLITE_STATIC 绑定 Arrow 缓冲区（step 期间 batch 保持存活），无需转义或十六进制编码
+    */
     int InsertBatch(std::shared_ptr<arrow::RecordBatch> batch) override {
         if (batch->num_rows() == 0) return 0;
+        if (!insert_stmt_) {
+            last_error_ = "INSERT statement not prepared";
+            return -1;
+        }
+        if (batch->num_columns() != sqlite3_bind_parameter_count(insert_stmt_)) {
+            last_error_ = "column count mismatch with INSERT statement";
+            return -1;
+        }
 
-        // SQLite 逐行 INSERT（不支持多值 INSERT 的旧版本兼容）
-        // 字符串转义：' → ''（SQL 标准），BINARY 用 X'...' 十六进制字面量
-        auto quote_string = [](const std::string& s) -> std::string {
-            std::string r = "'";
-            for (char c : s) {
-                if (c == '\'') r += "''";
-                else r += c;
+        // 按列选定绑定函数，行循环内不再按类型分派
+        std::vector<BindFn> binders(batch->num_columns());
+        for (int c = 0; c < batch->num_columns(); ++c) {
+            binders[c] = SelectBinder(batch->column(c)->type_id());
+            if (!binders[c]) {
+                last_error_ = "unsupported column type for SQLite insert: " +
+                              batch->column(c)->type()->ToString();
+                return -1;
             }
-            r += "'";
-            return r;
-        };
+        }
 
-        std::string prefix = "INSERT INTO " + QuoteIdentifier(table_) + " VALUES ";
+        const int num_cols = batch->num_columns();
         for (int64_t row = 0; row < batch->num_rows(); ++row) {
-            // BINARY 列需要特殊处理（X'...' 格式），不能走通用 BuildRowValues
-            std::string values = "(";
-            for (int col = 0; col < batch->num_columns(); ++col) {
-                if (col > 0) values += ", ";
-                auto array = batch->column(col);
-                if (array->IsNull(row)) {
-                    values += "NULL";
-                } else if (array->type()->id() == arrow::Type::BINARY) {
-                    auto blob = std::static_pointer_cast<arrow::BinaryArray>(array)->GetView(row);
-                    values += "X'";
-                    for (size_t i = 0; i < blob.size(); ++i) {
-                        char hex[3];
-                        snprintf(hex, sizeof(hex), "%02X",
-                                 static_cast<unsigned char>(blob.data()[i]));
-                        values += hex;
-                    }
-                    values += "'";
-                } else if (array->type()->id() == arrow::Type::INT32) {
-                    values += std::to_string(
-                        std::static_pointer_cast<arrow::Int32Array>(array)->Value(row));
-                } else if (array->type()->id() == arrow::Type::INT64) {
-                    values += std::to_string(
-                        std::static_pointer_cast<arrow::Int64Array>(array)->Value(row));
-                } else if (array->type()->id() == arrow::Type::FLOAT) {
-                    values += std::to_string(
-                        std::static_pointer_cast<arrow::FloatArray>(array)->Value(row));
-                } else if (array->type()->id() == arrow::Type::DOUBLE) {
-                    values += std::to_string(
-                        std::static_pointer_cast<arrow::DoubleArray>(array)->Value(row));
-                } else {
-                    values += quote_string(
-                        std::static_pointer_cast<arrow::StringArray>(array)->GetString(row));
+            for (int c = 0; c < num_cols; ++c) {
+                const arrow::Array& array = *batch->column(c);
+                int rc = array.IsNull(row) ? sqlite3_bind_null(insert_stmt_, c + 1)
+                                           : binders[c](insert_stmt_, c + 1, array, row);
+                if (rc != SQLITE_OK) {
+                    last_error_ = "INSERT bind failed: " + std::string(sqlite3_errmsg(db_));
+                    sqlite3_reset(insert_stmt_);
+                    return -1;
                 }
             }
-            values += ")";
-            std::string error;
-            if (session_->ExecuteSql((prefix + values).c_str(), &error) < 0) {
-                last_error_ = "INSERT failed: " + error;
+            int rc = sqlite3_step(insert_stmt_);
+            sqlite3_reset(insert_stmt_);
+            if (rc != SQLITE_DONE) {
+                last_error_ = "INSERT failed: " + std::string(sqlite3_errmsg(db_));
                 return -1;
             }
-            ++rows_written_;
         }
+        // 解除对本批 Arrow 缓冲区的引用
+        sqlite3_clear_bindings(insert_stmt_);
+        rows_written_ += batch->num_rows();
         return 0;
     }
+
+private:
+    using BindFn = int (*)(sqlite3_stmt* stmt, int index, const arrow::Array& array, int64_t row);
+
+    static int BindInt32(sqlite3_stmt* stmt, int index, const arrow::Array& array, int64_t row) {
+        return sqlite3_bind_int64(stmt, index, static_cast<const arrow::Int32Array&>(array).Value(row));
+    }
+    static int BindInt64(sqlite3_stmt* stmt, int index, const arrow::Array& array, int64_t row) {
+        return sqlite3_bind_int64(stmt, index, static_cast<const arrow::Int64Array&>(array).Value(row));
+    }
+    static int BindFloat(sqlite3_stmt* stmt, int index, const arrow::Array& array, int64_t row) {
+        return sqlite3_bind_double(stmt, index, static_cast<const arrow::FloatArray&>(array).Value(row));
+    }
+    static int BindDouble(sqlite3_stmt* stmt, int index, const arrow::Array& array, int64_t row) {
+        return sqlite3_bind_double(stmt, index, static_cast<const arrow::DoubleArray&>(array).Value(row));
+    }
+    static int BindBool(sqlite3_stmt* stmt, int index, const arrow::Array& array, int64_t row) {
+        return sqlite3_bind_int(stmt, index, static_cast<const arrow::BooleanArray&>(array).Value(row) ? 1 : 0);
+    }
+    static int BindText(sqlite3_stmt* stmt, int index, const arrow::Array& array, int64_t row) {
+        auto view = static_cast<const arrow::StringArray&>(array).GetView(row);
+        return sqlite3_bind_text(stmt, index, view.data(), static_cast<int>(view.size()), SQLITE_STATIC);
+    }
+    static int BindBlob(sqlite3_stmt* stmt, int index, const arrow::Array& array, int64_t row) {
+        auto view = static_cast<const arrow::BinaryArray&>(array).GetView(row);
+        return sqlite3_bind_blob(stmt, index, view.data(), static_cast<int>(view.size()), SQLITE_STATIC);
+    }
+
+    static BindFn SelectBinder(arrow::Type::type type_id) {
+        switch (type_id) {
+            case arrow::Type::INT32:  return &BindInt32;
+            case arrow::Type::INT64:  return &BindInt64;
+            case arrow::Type::FLOAT:  return &BindFloat;
+            case arrow::Type::DOUBLE: return &BindDouble;
+            case arrow::Type::BOOL:   return &BindBool;
+            case arrow::Type::STRING: return &BindText;
+            case arrow::Type::BINARY: return &BindBlob;
+            default:                  return nullptr;
+        }
+    }
+
+    int PrepareInsert(int num_cols) {
+        std::string sql = "INSERT INTO " + QuoteIdentifier(table_) + " VALUES (";
+        for (int i = 0; i < num_cols; ++i) sql += (i == 0) ? "?" : ", ?";
+        sql += ")";
+        if (sqlite3_prepare_v3(db_, sql.c_str(), static_cast<int>(sql.size()),
+                               SQLITE_PREPARE_PERSISTENT, &insert_stmt_, nullptr) != SQLITE_OK) {
+            last_error_ = "INSERT prepare failed: " + std::string(sqlite3_errmsg(db_));
+            insert_stmt_ = nullptr;
+            return -1;
+        }
+        return 0;
+    }
+
+    // 读取整数型 PRAGMA 当前值
+    bool QueryPragma(const char* name, int64_t* value) {
+        std::string sql = std::string("PRAGMA ") + name;
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return false;
+        bool ok = sqlite3_step(stmt) == SQLITE_ROW;
+        if (ok) *value = sqlite3_column_int64(stmt, 0);
+        sqlite3_finalize(stmt);
+        return ok;
+    }
+
+    int ExecPragma(const std::string& pragma) {
+        char* errmsg = nullptr;
+        if (sqlite3_exec(db_, pragma.c_str(), nullptr, nullptr, &errmsg) != SQLITE_OK) {
+            last_error_ = pragma + " failed: " + (errmsg ? errmsg : sqlite3_errmsg(db_));
+            sqlite3_free(errmsg);
+            return -1;
+        }
+        return 0;
+    }
+
+    // synchronous=OFF + 加大 page cache；journal_mode=WAL 已在建立连接时设置
+    // 任一 PRAGMA 失败则恢复已改动的设置并返回 -1，不带着半套设置继续导入
+    int ApplyPragmas() {
+        if (!pragmas_.enabled || pragmas_applied_) return 0;
+        if (!QueryPragma("synchronous", &saved_synchronous_) ||
+            !QueryPragma("cache_size", &saved_cache_size_)) {
+            last_error_ = "PRAGMA query failed: " + std::string(sqlite3_errmsg(db_));
+            return -1;
+        }
+        if (ExecPragma("PRAGMA synchronous=OFF") != 0) return -1;
+        if (ExecPragma("PRAGMA cache_size=" + std::to_string(-static_cast<int64_t>(pragmas_.cache_size_kb))) != 0) {
+            std::string error = last_error_;
+            ExecPragma("PRAGMA synchronous=" + std::to_string(saved_synchronous_));
+            last_error_ = error;
+            return -1;
+        }
+        pragmas_applied_ = true;
+        return 0;
+    }
+
+    // 写入结束后恢复连接原有设置，连接归还连接池后不影响其他会话
+    void RestorePragmas() {
+        if (!pragmas_applied_) return;
+        ExecPragma("PRAGMA synchronous=" + std::to_string(saved_synchronous_));
+        ExecPragma("PRAGMA cache_size=" + std::to_string(saved_cache_size_));
+        pragmas_applied_ = false;
+    }
+
+    sqlite3* db_;
+    SqliteIngestPragmas pragmas_;
+    sqlite3_stmt* insert_stmt_ = nullptr;
+    bool pragmas_applied_ = false;
+    int64_t saved_synchronous_ = 0;
+    int64_t saved_cache_size_ = 0;
 };
 
 IBatchWriter* SqliteSession::CreateBatchWriter(const char* table) {
-    return new SqliteBatchWriter(shared_from_this(), table);
+    SqliteIngestPragmas pragmas;
+    auto* sqlite_driver = static_cast<SqliteDriver*>(this->driver_);
+    if (sqlite_driver) {
+        pragmas.enabled = sqlite_driver->IngestPragmas();
+        pragmas.cache_size_kb = sqlite_driver->IngestCacheKb();
+    }
+    return new SqliteBatchWriter(shared_from_this(), conn_, table, pragmas);
 }
 
 
@@ -359,6 +562,8 @@ int SqliteDriver::Connect(const std::unordered_map<std::string, std::string>& pa
     config.min_connections = 0;
     config.idle_timeout = std::chrono::seconds(300);
     config.health_check_interval = std::chrono::seconds(60);
+    // 池满时等待其他查询归还连接，而不是立即失败
+    config.acquire_timeout = std::chrono::milliseconds(5000);
 
     auto it = params.find("path");
     db_path_ = (it != params.end()) ? it->second : ":memory:";
@@ -366,6 +571,16 @@ int SqliteDriver::Connect(const std::unordered_map<std::string, std::string>& pa
     bool readonly = (params.find("readonly") != params.end() &&
                      params.at("readonly") == "true");
 
+    it = params.find("ingest_pragmas");
+    ingest_pragmas_ = (it != params.end() && it->second == "true");
+
+    it = params.find("ingest_cache_mb");
+    if (it != params.end()) ingest_cache_kb_ = std::stoi(it->second) * 1024;
+
+    // 连接池参数：max_connections / min_idle / idle_timeout / acquire_timeout_ms / warmup_on_open
+    ApplyPoolParams(params, &config);
+    warmup_on_open_ = config.warmup_on_open;
+
     auto factory = [this, readonly](std::string* error) -> sqlite3* {
         sqlite3* db = nullptr;
         int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX;
@@ -404,6 +619,23 @@ int SqliteDriver::Disconnect() {
     return 0;
 }
 
+int SqliteDriver::WarmupPool(std::string* error) {
+    if (!pool_ || !warmup_on_open_) return 0;
+    std::string err;
+    int created = pool_->Warmup(&err);
+    if (created == 0 && !err.empty()) {
+        if (error) *error = err;
+        return -1;
+    }
+    return created;
+}
+
+bool SqliteDriver::GetPoolMetrics(ConnectionPoolMetrics* metrics) {
+    if (!pool_) return false;
+    *metrics = pool_->GetMetrics();
+    return true;
+}
+
 bool SqliteDriver::Ping() {
     return pool_ != nullptr;
 }
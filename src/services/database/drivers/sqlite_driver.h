@@ -7,6 +7,7 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 #include "../connection_pool.h"
 #include "../db_session.h"
@@ -29,7 +30,7 @@ class SqliteResultSet;
 
 // SqliteDriver — SQLite 数据库驱动
 // 使用 FULLMUTEX 模式保证多线程安全，WAL 模式提升并发读写性能
-class __attribute__((visibility("default"))) SqliteDriver : public IDbDriver {
+class __attribute__((visibility("default"))) SqliteDriver : public IDbDriver, public IPooledDriver {
  public:
     SqliteDriver() = default;
     ~SqliteDriver() override;
@@ -42,16 +43,29 @@ class __attribute__((visibility("default"))) SqliteDriver : public IDbDriver {
     const char* LastError() override { return last_error_.c_str(); }
     bool Ping() override;
 
+    // IPooledDriver 实现
+    int WarmupPool(std::string* error) override;
+    bool GetPoolMetrics(ConnectionPoolMetrics* metrics) override;
+
     // 连接池相关
     std::shared_ptr<IDbSession> CreateSession();
     void ReturnToPool(sqlite3* db);
 
+    // 批量写入参数
+    bool IngestPragmas() const { return ingest_pragmas_; }
+    int IngestCacheKb() const { return ingest_cache_kb_; }
+
  private:
     // 连接池
     std::unique_ptr<ConnectionPool<sqlite3*>> pool_;
+    // 通道 Open 时是否预热连接池（参数 warmup_on_open，配合 min_idle / min_connections）
+    bool warmup_on_open_ = false;
 
     std::string db_path_;
     bool readonly_ = false;
+    // 批量写入期间临时设置 synchronous=OFF 和 cache_size（参数 ingest_pragmas / ingest_cache_mb）
+    bool ingest_pragmas_ = false;
+    int ingest_cache_kb_ = 64 * 1024;
     std::string last_error_;
 };
 
@@ -86,11 +100,19 @@ private:
 };
 
 // SQLite Session 实现
-class SqliteSession : public RelationDbSessionBase<SqliteTraits> {
+// 同时实现 IArrowReadable：原生读取器直接从 sqlite3_column_* 构建 RecordBatch，
+// DatabaseChannel::CreateArrowReader 的 dynamic_cast 检查即可命中
+class SqliteSession : public RelationDbSessionBase<SqliteTraits>,
+                      public IArrowReadable {
 public:
     SqliteSession(SqliteDriver* driver, sqlite3* db);
     ~SqliteSession() override;
 
+    // IArrowReadable 实现（同时覆盖 IDbSession::ExecuteQueryArrow）
+    int ExecuteQueryArrow(const char* sql,
+                          std::vector<std::shared_ptr<arrow::RecordBatch>>* batches,
+                          std::string* error) override;
+
 protected:
     // 钩子方法实现
     sqlite3_stmt* PrepareStatement(sqlite3* db, const char* sql, std::string* error) override;
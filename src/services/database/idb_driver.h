@@ -6,6 +6,8 @@
 #include <string>
 #include <unordered_map>
 
+#include "connection_pool.h"
+
 namespace flowsql {
 namespace database {
 
@@ -28,6 +30,19 @@ interface IDbDriver {
     virtual bool Ping() = 0;
 };
 
+// IPooledDriver — 连接池能力（驱动级可选接口，dynamic_cast 检测）
+// DatabaseChannel::Open 用于预热，DatabasePlugin::Stats 用于导出连接池指标
+interface IPooledDriver {
+    virtual ~IPooledDriver() = default;
+
+    // 按 warmup_on_open 配置并行预建连接；未开启时直接返回 0
+    // 返回新建的连接数，全部失败返回 -1（error 为最后一个错误）
+    virtual int WarmupPool(std::string* error) = 0;
+
+    // 连接池指标快照，未连接时返回 false
+    virtual bool GetPoolMetrics(ConnectionPoolMetrics* metrics) = 0;
+};
+
 }  // namespace database
 }  // namespace flowsql
 
@@ -9,6 +9,8 @@
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,19 +18,37 @@
 namespace flowsql {
 namespace database {
 
-// RelationBatchReader — 行式数据库通用批量读取器
-// 将 IResultSet（行式游标）适配为 IBatchReader（Arrow IPC 流）
-// MySQL 和 SQLite 共用此实现，无需各自重复
-class RelationBatchReader : public IBatchReader {
+// RelationBatchReaderBase — 行式数据库批量读取器的公共骨架（CRTP）
+// 将行式游标适配为 IBatchReader（Arrow IPC 流）；同进程调用方可通过 IRecordBatchReader::NextBatch
+// 直接取 RecordBatch，跳过 IPC 编解码
+//
+// 列 Builder 与类型化追加函数按 Schema 只构建一次，跨批次复用（Finish 后 Builder 自动重置）
+// 批大小按字节预算自适应：首批 initial_batch_rows 行，之后按上一批的平均行宽换算，
+// 宽字符串行和窄整数行都能得到约 target_batch_bytes 大小的批次
+//
+// 子类只提供逐行 / 逐单元格的取值钩子，基类在编译期直接调用（无虚函数分派）：
+//   - int StepRow()：前进到下一行，1 有行，0 读完，-1 出错（子类设置 last_error_）
+//   - bool CellIsNull(int col)
+//   - bool FetchInt32 / FetchInt64 / FetchDouble(int col, T* v)
+//   - bool FetchString / FetchBinary(int col, const uint8_t** data, int64_t* len)
+//   Fetch* 返回 false 表示值无法解析，按 NULL 追加
+template <typename Derived>
+class RelationBatchReaderBase : public IBatchReader, public IRecordBatchReader {
 public:
-    RelationBatchReader(std::shared_ptr<IDbSession> session,
-                        IResultSet* result,
-                        std::shared_ptr<arrow::Schema> schema,
-                        int batch_size = 1024)
-        : session_(std::move(session)), result_(result),
-          schema_(std::move(schema)), batch_size_(batch_size) {}
-
-    ~RelationBatchReader() override {
+    static constexpr int64_t kDefaultTargetBatchBytes = 8 * 1024 * 1024;
+    static constexpr int kMinBatchRows = 64;
+    static constexpr int kMaxBatchRows = 1 << 20;
+
+    RelationBatchReaderBase(std::shared_ptr<IDbSession> session,
+                            IResultSet* result,
+                            std::shared_ptr<arrow::Schema> schema,
+                            int initial_batch_rows = 1024,
+                            int64_t target_batch_bytes = kDefaultTargetBatchBytes)
+        : schema_(std::move(schema)), batch_rows_(initial_batch_rows),
+          target_batch_bytes_(target_batch_bytes),
+          session_(std::move(session)), result_(result) {}
+
+    ~RelationBatchReaderBase() override {
         delete result_;
     }
 
@@ -49,116 +69,237 @@ public:
         return 0;
     }
 
+    // 跨进程路径：每批编码为独立的 IPC stream（含 Schema），接收方可逐个 buffer 独立解码
     int Next(const uint8_t** data, size_t* size) override {
-        if (done_) { *data = nullptr; *size = 0; return 1; }
+        *data = nullptr;
+        *size = 0;
+        std::shared_ptr<arrow::RecordBatch> batch;
+        int rc = NextBatch(&batch);
+        if (rc != 0) return rc;
 
-        // 为每列创建 Builder
-        std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders;
-        for (const auto& field : schema_->fields()) {
-            std::unique_ptr<arrow::ArrayBuilder> b;
-            if (!arrow::MakeBuilder(arrow::default_memory_pool(), field->type(), &b).ok())
+        auto out = arrow::io::BufferOutputStream::Create().ValueOrDie();
+        auto writer = arrow::ipc::MakeStreamWriter(out, schema_).ValueOrDie();
+        if (!writer->WriteRecordBatch(*batch).ok()) return -1;
+        if (!writer->Close().ok()) return -1;
+        auto buf = out->Finish();
+        if (!buf.ok()) return -1;
+        batch_buffer_ = *buf;
+        *data = batch_buffer_->data();
+        *size = batch_buffer_->size();
+        return 0;
+    }
+
+    // 进程内路径：直接交出构建好的 RecordBatch
+    int NextBatch(std::shared_ptr<arrow::RecordBatch>* batch) override {
+        if (done_) return 1;
+        if (CheckCancelled()) return -1;
+        if (columns_.empty() && InitColumns() != 0) return -1;
+
+        for (auto& c : columns_) {
+            if (!c.builder->Reserve(batch_rows_).ok()) {
+                last_error_ = "ArrayBuilder::Reserve failed";
                 return -1;
-            builders.push_back(std::move(b));
+            }
+            if (c.data_bytes > 0) {
+                // 变长列按上一批的数据量预留 value buffer
+                (void)static_cast<arrow::BinaryBuilder*>(c.builder.get())->ReserveData(c.data_bytes);
+            }
+            c.data_bytes = 0;
         }
 
+        Derived* self = static_cast<Derived*>(this);
+        const int num_cols = static_cast<int>(columns_.size());
         int row_count = 0;
-        for (int i = 0; i < batch_size_; ++i) {
-            if (!result_->Next()) { done_ = true; break; }
-
-            for (int col = 0; col < schema_->num_fields(); ++col) {
-                auto* b = builders[col].get();
-                if (result_->IsNull(col)) { (void)b->AppendNull(); continue; }
-
-                switch (b->type()->id()) {
-                    case arrow::Type::INT32: {
-                        int v; if (result_->GetInt(col, &v) == 0)
-                            (void)static_cast<arrow::Int32Builder*>(b)->Append(v);
-                        else (void)b->AppendNull();
-                        break;
-                    }
-                    case arrow::Type::INT64: {
-                        int64_t v; if (result_->GetInt64(col, &v) == 0)
-                            (void)static_cast<arrow::Int64Builder*>(b)->Append(v);
-                        else (void)b->AppendNull();
-                        break;
-                    }
-                    case arrow::Type::FLOAT: {
-                        double v; if (result_->GetDouble(col, &v) == 0)
-                            (void)static_cast<arrow::FloatBuilder*>(b)->Append(static_cast<float>(v));
-                        else (void)b->AppendNull();
-                        break;
-                    }
-                    case arrow::Type::DOUBLE: {
-                        double v; if (result_->GetDouble(col, &v) == 0)
-                            (void)static_cast<arrow::DoubleBuilder*>(b)->Append(v);
-                        else (void)b->AppendNull();
-                        break;
-                    }
-                    case arrow::Type::BINARY: {
-                        const char* s; size_t len;
-                        if (result_->GetString(col, &s, &len) == 0)
-                            (void)static_cast<arrow::BinaryBuilder*>(b)->Append(
-                                reinterpret_cast<const uint8_t*>(s), len);
-                        else (void)b->AppendNull();
-                        break;
-                    }
-                    default: {  // STRING / UTF8 及其他文本类型
-                        const char* s; size_t len;
-                        if (result_->GetString(col, &s, &len) == 0)
-                            (void)static_cast<arrow::StringBuilder*>(b)->Append(s, len);
-                        else (void)b->AppendNull();
-                        break;
-                    }
-                }
+        int64_t batch_bytes = 0;
+        while (row_count < batch_rows_ && batch_bytes < target_batch_bytes_) {
+            if (CheckCancelled()) return -1;
+            int rc = self->StepRow();
+            if (rc < 0) { done_ = true; return -1; }
+            if (rc == 0) { done_ = true; break; }
+
+            for (int col = 0; col < num_cols; ++col) {
+                auto& c = columns_[col];
+                if (self->CellIsNull(col)) { (void)c.builder->AppendNull(); continue; }
+                int64_t n = c.append(self, col, c.builder.get());
+                if (c.fixed_width == 0) c.data_bytes += n;
+                batch_bytes += n;
             }
             ++row_count;
         }
 
-        if (row_count == 0) { *data = nullptr; *size = 0; return 1; }
+        if (row_count == 0) return 1;
 
         std::vector<std::shared_ptr<arrow::Array>> arrays;
-        for (auto& b : builders) {
+        arrays.reserve(num_cols);
+        for (auto& c : columns_) {
             std::shared_ptr<arrow::Array> arr;
-            if (!b->Finish(&arr).ok()) return -1;
-            arrays.push_back(arr);
+            if (!c.builder->Finish(&arr).ok()) return -1;
+            arrays.push_back(std::move(arr));
         }
 
-        auto batch = arrow::RecordBatch::Make(schema_, row_count, arrays);
-        auto out = arrow::io::BufferOutputStream::Create().ValueOrDie();
-        auto writer = arrow::ipc::MakeStreamWriter(out, schema_).ValueOrDie();
-        if (!writer->WriteRecordBatch(*batch).ok()) return -1;
-        if (!writer->Close().ok()) return -1;
-        auto buf = out->Finish();
-        if (!buf.ok()) return -1;
-        batch_buffer_ = *buf;
-        *data = batch_buffer_->data();
-        *size = batch_buffer_->size();
+        AdjustBatchRows(row_count, batch_bytes);
+        *batch = arrow::RecordBatch::Make(schema_, row_count, arrays);
         return 0;
     }
 
+    // 可从其他线程调用：读取线程在下一行处检查标志并以错误结束
     void Cancel() override { cancelled_ = true; }
     void Close() override {}
     const char* GetLastError() override { return last_error_.c_str(); }
     void Release() override { delete this; }
 
-private:
-    std::shared_ptr<IDbSession> session_;
-    IResultSet* result_;
+protected:
+    bool CheckCancelled() {
+        if (!cancelled_) return false;
+        last_error_ = "read cancelled";
+        return true;
+    }
+
+    // 按本批平均行宽调整下一批行数
+    void AdjustBatchRows(int row_count, int64_t batch_bytes) {
+        int64_t row_bytes = std::max<int64_t>(1, batch_bytes / row_count);
+        batch_rows_ = static_cast<int>(std::min<int64_t>(
+            kMaxBatchRows, std::max<int64_t>(kMinBatchRows, target_batch_bytes_ / row_bytes)));
+    }
+
     std::shared_ptr<arrow::Schema> schema_;
+    std::string last_error_;
+    int batch_rows_ = 1024;
+    int64_t target_batch_bytes_ = kDefaultTargetBatchBytes;
+    std::atomic<bool> done_{false};
+    std::atomic<bool> cancelled_{false};
+    std::shared_ptr<IDbSession> session_;
+    IResultSet* result_;  // 子类直接读底层句柄时，仍由该结果集负责释放
+
+private:
+    // 追加当前行第 col 列（非 NULL）到 Builder，返回追加的字节数
+    using AppendFn = int64_t (*)(Derived* self, int col, arrow::ArrayBuilder* builder);
+
+    struct Column {
+        std::unique_ptr<arrow::ArrayBuilder> builder;
+        AppendFn append = nullptr;
+        int fixed_width = 0;     // 定长列字节宽度，变长列为 0
+        int64_t data_bytes = 0;  // 变长列上一批的数据量，用于预留 value buffer
+    };
+
+    static int64_t AppendInt32(Derived* self, int col, arrow::ArrayBuilder* builder) {
+        int32_t v;
+        if (!self->FetchInt32(col, &v)) { (void)builder->AppendNull(); return 0; }
+        (void)static_cast<arrow::Int32Builder*>(builder)->Append(v);
+        return sizeof(int32_t);
+    }
+
+    static int64_t AppendInt64(Derived* self, int col, arrow::ArrayBuilder* builder) {
+        int64_t v;
+        if (!self->FetchInt64(col, &v)) { (void)builder->AppendNull(); return 0; }
+        (void)static_cast<arrow::Int64Builder*>(builder)->Append(v);
+        return sizeof(int64_t);
+    }
+
+    template <typename BuilderType, typename CType>
+    static int64_t AppendFloating(Derived* self, int col, arrow::ArrayBuilder* builder) {
+        double v;
+        if (!self->FetchDouble(col, &v)) { (void)builder->AppendNull(); return 0; }
+        (void)static_cast<BuilderType*>(builder)->Append(static_cast<CType>(v));
+        return sizeof(CType);
+    }
+
+    static int64_t AppendBoolean(Derived* self, int col, arrow::ArrayBuilder* builder) {
+        int64_t v;
+        if (!self->FetchInt64(col, &v)) { (void)builder->AppendNull(); return 0; }
+        (void)static_cast<arrow::BooleanBuilder*>(builder)->Append(v != 0);
+        return 1;
+    }
+
+    // STRING / BINARY 共用：StringBuilder 派生自 BinaryBuilder
+    template <bool kBinary>
+    static int64_t AppendBytes(Derived* self, int col, arrow::ArrayBuilder* builder) {
+        const uint8_t* data;
+        int64_t len;
+        bool ok = kBinary ? self->FetchBinary(col, &data, &len) : self->FetchString(col, &data, &len);
+        if (!ok) { (void)builder->AppendNull(); return 0; }
+        (void)static_cast<arrow::BinaryBuilder*>(builder)->Append(data, static_cast<int32_t>(len));
+        return len;
+    }
+
+    // 按 Schema 一次性创建 Builder 并选定追加函数，NextBatch 中不再按类型分派
+    int InitColumns() {
+        for (const auto& field : schema_->fields()) {
+            Column c;
+            if (!arrow::MakeBuilder(arrow::default_memory_pool(), field->type(), &c.builder).ok()) {
+                last_error_ = "MakeBuilder failed for column " + field->name();
+                columns_.clear();
+                return -1;
+            }
+            switch (field->type()->id()) {
+                case arrow::Type::INT32:
+                    c.append = &AppendInt32; c.fixed_width = 4; break;
+                case arrow::Type::INT64:
+                    c.append = &AppendInt64; c.fixed_width = 8; break;
+                case arrow::Type::FLOAT:
+                    c.append = &AppendFloating<arrow::FloatBuilder, float>; c.fixed_width = 4; break;
+                case arrow::Type::DOUBLE:
+                    c.append = &AppendFloating<arrow::DoubleBuilder, double>; c.fixed_width = 8; break;
+                case arrow::Type::BOOL:
+                    c.append = &AppendBoolean; c.fixed_width = 1; break;
+                case arrow::Type::STRING:
+                    c.append = &AppendBytes<false>; break;
+                case arrow::Type::BINARY:
+                    c.append = &AppendBytes<true>; break;
+                default:
+                    last_error_ = "unsupported column type: " + field->type()->ToString();
+                    columns_.clear();
+                    return -1;
+            }
+            columns_.push_back(std::move(c));
+        }
+        return 0;
+    }
+
     std::shared_ptr<arrow::Buffer> schema_buffer_;
     std::shared_ptr<arrow::Buffer> batch_buffer_;
-    std::string last_error_;
-    int batch_size_ = 1024;
-    bool done_ = false;
-    bool cancelled_ = false;
+    std::vector<Column> columns_;
+};
+
+// RelationBatchReader — 基于 IResultSet 的通用批量读取器
+// 没有原生读取器的行式驱动直接使用；取值经 IResultSet 虚函数
+class RelationBatchReader : public RelationBatchReaderBase<RelationBatchReader> {
+public:
+    using RelationBatchReaderBase::RelationBatchReaderBase;
+
+private:
+    friend class RelationBatchReaderBase<RelationBatchReader>;
+
+    int StepRow() { return result_->Next() ? 1 : 0; }
+    bool CellIsNull(int col) { return result_->IsNull(col); }
+
+    bool FetchInt32(int col, int32_t* v) {
+        int n;
+        if (result_->GetInt(col, &n) != 0) return false;
+        *v = n;
+        return true;
+    }
+    bool FetchInt64(int col, int64_t* v) { return result_->GetInt64(col, v) == 0; }
+    bool FetchDouble(int col, double* v) { return result_->GetDouble(col, v) == 0; }
+
+    bool FetchString(int col, const uint8_t** data, int64_t* len) {
+        const char* s;
+        size_t n;
+        if (result_->GetString(col, &s, &n) != 0) return false;
+        *data = reinterpret_cast<const uint8_t*>(s);
+        *len = static_cast<int64_t>(n);
+        return true;
+    }
+    bool FetchBinary(int col, const uint8_t** data, int64_t* len) { return FetchString(col, data, len); }
 };
 
 // RelationBatchWriterBase — 行式数据库通用批量写入器基类
 // 提取 Write/Flush/Close/事务管理等公共逻辑，子类只需实现三个钩子：
 //   - QuoteIdentifier：标识符引用风格（MySQL 用反引号，SQLite 用双引号）
 //   - CreateTable：建表 DDL（类型映射因数据库而异）
-//   - InsertBatch：插入策略（MySQL 分块多值 INSERT，SQLite 逐行 INSERT）
-class RelationBatchWriterBase : public IBatchWriter {
+//   - InsertBatch：插入策略（MySQL 预编译多值 INSERT，SQLite 预编译单行 INSERT 循环）
+// 同进程调用方可通过 IRecordBatchWriter::WriteBatch 直接写入 RecordBatch，跳过 IPC 解码
+class RelationBatchWriterBase : public IBatchWriter, public IRecordBatchWriter {
 public:
     RelationBatchWriterBase(std::shared_ptr<IDbSession> session, const char* table)
         : session_(std::move(session)), table_(table) {}
@@ -180,6 +321,10 @@ public:
         std::shared_ptr<arrow::RecordBatch> batch;
         if (!reader->ReadNext(&batch).ok() || !batch) return -1;
 
+        return WriteBatch(batch);
+    }
+
+    int WriteBatch(const std::shared_ptr<arrow::RecordBatch>& batch) override {
         if (!transaction_started_) {
             std::string error;
             if (session_->BeginTransaction(&error) != 0) {
@@ -224,39 +369,6 @@ protected:
     // 插入一批数据（子类实现各自的插入策略）
     virtual int InsertBatch(std::shared_ptr<arrow::RecordBatch> batch) = 0;
 
-    // 构造单行值列表字符串，供子类的 InsertBatch 使用
-    // 子类传入自己的 QuoteString 函数（因转义规则不同）
-    static std::string BuildRowValues(
-        const std::shared_ptr<arrow::RecordBatch>& batch,
-        int64_t row,
-        const std::function<std::string(const std::string&)>& quote_string) {
-        std::string values = "(";
-        for (int col = 0; col < batch->num_columns(); ++col) {
-            if (col > 0) values += ", ";
-            auto array = batch->column(col);
-            if (array->IsNull(row)) {
-                values += "NULL";
-            } else if (array->type()->id() == arrow::Type::INT32) {
-                values += std::to_string(
-                    std::static_pointer_cast<arrow::Int32Array>(array)->Value(row));
-            } else if (array->type()->id() == arrow::Type::INT64) {
-                values += std::to_string(
-                    std::static_pointer_cast<arrow::Int64Array>(array)->Value(row));
-            } else if (array->type()->id() == arrow::Type::FLOAT) {
-                values += std::to_string(
-                    std::static_pointer_cast<arrow::FloatArray>(array)->Value(row));
-            } else if (array->type()->id() == arrow::Type::DOUBLE) {
-                values += std::to_string(
-                    std::static_pointer_cast<arrow::DoubleArray>(array)->Value(row));
-            } else {
-                auto str_array = std::static_pointer_cast<arrow::StringArray>(array);
-                values += quote_string(str_array->GetString(row));
-            }
-        }
-        values += ")";
-        return values;
-    }
-
 protected:
     std::shared_ptr<IDbSession> session_;
     std::string table_;
@@ -22,6 +22,9 @@ int LoadConfig(const std::string& path, GatewayConfig* config) {
         if (gw["port"]) config->port = gw["port"].as<int>();
         if (gw["heartbeat_interval_s"]) config->heartbeat_interval_s = gw["heartbeat_interval_s"].as<int>();
         if (gw["heartbeat_timeout_count"]) config->heartbeat_timeout_count = gw["heartbeat_timeout_count"].as<int>();
+        if (gw["upstream_max_idle"]) config->upstream_max_idle = gw["upstream_max_idle"].as<int>();
+        if (gw["upstream_read_timeout_s"]) config->upstream_read_timeout_s = gw["upstream_read_timeout_s"].as<int>();
+        if (gw["forward_workers"]) config->forward_workers = gw["forward_workers"].as<int>();
     }
 
     // services 段
@@ -34,6 +37,8 @@ int LoadConfig(const std::string& path, GatewayConfig* config) {
             if (node["host"]) svc.host = node["host"].as<std::string>();
             if (node["port"]) svc.port = node["port"].as<int>();
             if (node["option"]) svc.option = node["option"].as<std::string>();
+            if (node["instances"]) svc.instances = node["instances"].as<int>();
+            if (node["cpu_affinity"]) svc.cpu_affinity = node["cpu_affinity"].as<bool>();
             if (node["plugins"]) {
                 for (const auto& p : node["plugins"]) {
                     if (p.IsScalar()) {
@@ -35,6 +35,8 @@ struct ServiceConfig {
     std::string host = "127.0.0.1";
     int port = 0;
     std::string option;          // 传给插件的 Option 参数
+    int instances = 1;           // 实例数，端口从 port 起依次递增
+    bool cpu_affinity = false;   // 为 true 时第 i 个实例绑定到第 i 个可用 CPU
 };
 
 // Gateway 全局配置
@@ -43,6 +45,9 @@ struct GatewayConfig {
     int port = 18800;
     int heartbeat_interval_s = 5;
     int heartbeat_timeout_count = 3;
+    int upstream_max_idle = 16;        // 每个上游地址缓存的 keep-alive 连接数
+    int upstream_read_timeout_s = 30;  // 转发请求的上游读超时
+    int forward_workers = 0;           // 转发线程数，0 表示与 HTTP 服务线程数相同
     std::vector<ServiceConfig> services;
 };
 
@@ -4,14 +4,28 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <mutex>
+#include <strings.h>
 #include <thread>
 
 namespace flowsql {
 namespace gateway {
 
+// steady_clock 毫秒，与 Upstream::ejected_until_ms 同一时钟
+static int64_t NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+
 int GatewayPlugin::Option(const char* arg) {
     if (!arg || strlen(arg) == 0) {
         printf("GatewayPlugin: no config file specified\n");
@@ -24,6 +38,10 @@ int GatewayPlugin::Option(const char* arg) {
 }
 
 int GatewayPlugin::Load(IQuerier* /* querier */) {
+    UpstreamPoolConfig pool_config;
+    pool_config.max_idle_per_upstream = static_cast<size_t>(std::max(0, config_.upstream_max_idle));
+    pool_config.read_timeout_s = config_.upstream_read_timeout_s;
+    upstream_pool_ = std::make_shared<UpstreamPool>(pool_config);
     printf("GatewayPlugin::Load: gateway=%s:%d, %zu services\n", config_.host.c_str(), config_.port,
            config_.services.size());
     return 0;
@@ -37,6 +55,17 @@ int GatewayPlugin::Start() {
     running_ = true;
     std::string gateway_addr = config_.host + ":" + std::to_string(config_.port);
 
+    // 转发线程先于 HTTP 服务就绪
+    {
+        std::lock_guard<std::mutex> lock(forward_mutex_);
+        forward_stopping_ = false;
+    }
+    int forward_workers = config_.forward_workers > 0 ? config_.forward_workers
+                                                      : static_cast<int>(CPPHTTPLIB_THREAD_POOL_COUNT);
+    for (int i = 0; i < forward_workers; ++i) {
+        forward_threads_.emplace_back(&GatewayPlugin::ForwardThread, this);
+    }
+
     // 1. 启动 HTTP 服务线程
     http_thread_ = std::thread(&GatewayPlugin::HttpThread, this);
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
@@ -57,11 +86,20 @@ int GatewayPlugin::Stop() {
     // 停止子服务
     service_manager_.StopAll();
 
-    // 停止 HTTP 服务
+    // 停止 HTTP 服务；listen 返回时处理线程均已退出，不再提交新的转发任务
     server_.stop();
+    if (http_thread_.joinable()) http_thread_.join();
+
+    // 排空转发队列并等待在途的上游请求结束（上游读超时兜底），之后插件才能安全卸载
+    {
+        std::lock_guard<std::mutex> lock(forward_mutex_);
+        forward_stopping_ = true;
+    }
+    forward_cv_.notify_all();
+    for (auto& thread : forward_threads_) thread.join();
+    forward_threads_.clear();
 
     if (heartbeat_thread_.joinable()) heartbeat_thread_.join();
-    if (http_thread_.joinable()) http_thread_.join();
 
     printf("GatewayPlugin::Stop: done\n");
     return 0;
@@ -83,17 +121,22 @@ void GatewayPlugin::HttpThread() {
     });
 
     // 通配符路由 — 转发到子服务
-    auto forward = [this](const httplib::Request& req, httplib::Response& res) {
-        HandleForward(req, res);
-    };
-    server_.Get(R"(/.*)", forward);
-    server_.Post(R"(/.*)", forward);
-    server_.Put(R"(/.*)", forward);
-    server_.Delete(R"(/.*)", forward);
+    // 带请求体的方法用 ContentReader 形式注册，请求体不在网关缓冲；
+    // httplib 优先匹配 ContentReader 路由，因此排除 /gateway/ 管理接口
+    server_.Get(R"(/.*)", [this](const httplib::Request& req, httplib::Response& res) {
+        HandleForward(req, res, nullptr);
+    });
+    auto forward = [this](const httplib::Request& req, httplib::Response& res,
+                          const httplib::ContentReader& reader) { HandleForward(req, res, &reader); };
+    static const char* kForwardPattern = R"(/(?!gateway/).*)";
+    server_.Post(kForwardPattern, forward);
+    server_.Put(kForwardPattern, forward);
+    server_.Patch(kForwardPattern, forward);
+    server_.Delete(kForwardPattern, forward);
     server_.Options(R"(/.*)", [](const httplib::Request&, httplib::Response& res) {
         res.set_header("Access-Control-Allow-Origin", "*");
-        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type");
+        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, PATCH, DELETE, OPTIONS");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, Accept, X-Upstream");
         res.status = 204;
     });
 
@@ -101,6 +144,28 @@ void GatewayPlugin::HttpThread() {
     server_.listen(config_.host, config_.port);
 }
 
+void GatewayPlugin::ForwardThread() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(forward_mutex_);
+            forward_cv_.wait(lock, [this] { return forward_stopping_ || !forward_tasks_.empty(); });
+            if (forward_tasks_.empty()) return;
+            task = std::move(forward_tasks_.front());
+            forward_tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void GatewayPlugin::SubmitForward(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(forward_mutex_);
+        forward_tasks_.push_back(std::move(task));
+    }
+    forward_cv_.notify_one();
+}
+
 void GatewayPlugin::HeartbeatThread() {
     std::string gateway_addr = config_.host + ":" + std::to_string(config_.port);
     int timeout_s = config_.heartbeat_interval_s * config_.heartbeat_timeout_count;
@@ -112,6 +177,14 @@ void GatewayPlugin::HeartbeatThread() {
         }
         if (!running_) break;
         service_manager_.CheckAndRestart(timeout_s, gateway_addr);
+
+        // 心跳驱动的实例权重：按时到达为满权重，每错过一个周期减半，把流量提前从卡住的实例移走
+        int64_t interval_ms = config_.heartbeat_interval_s * 1000LL;
+        for (const auto& [name, age_ms] : service_manager_.HeartbeatAges()) {
+            int missed = interval_ms > 0 ? static_cast<int>(age_ms / interval_ms) : 0;
+            int weight = age_ms * 2 <= interval_ms * 3 ? Upstream::kMaxWeight : Upstream::kMaxWeight >> std::min(missed, 7);
+            route_table_.SetServiceWeight(name, weight);
+        }
     }
 }
 
@@ -130,11 +203,22 @@ void GatewayPlugin::HandleRegister(const httplib::Request& req, httplib::Respons
     std::string address = doc["address"].GetString();
     std::string service = doc.HasMember("service") ? doc["service"].GetString() : "";
 
-    if (route_table_.Register(prefix, address, service) != 0) {
+    std::string owner;
+    if (route_table_.Register(prefix, address, service, &owner) != 0) {
+        // 冲突的是地址而非前缀：同一前缀允许多个实例，但一个地址只能属于一个服务
+        rapidjson::StringBuffer buf;
+        rapidjson::Writer<rapidjson::StringBuffer> w(buf);
+        w.StartObject();
+        w.Key("error"); w.String("address already registered by another service");
+        w.Key("address"); w.String(address.c_str());
+        w.Key("service"); w.String(owner.c_str());
+        w.EndObject();
         res.status = 409;
-        res.set_content(R"({"error":"prefix already registered"})", "application/json");
+        res.set_content(buf.GetString(), "application/json");
         return;
     }
+    // 服务（重新）注册时丢弃到该地址的空闲连接，旧进程的 keep-alive socket 已失效
+    if (upstream_pool_) upstream_pool_->Clear(address);
     res.set_content(R"({"status":"ok"})", "application/json");
 }
 
@@ -146,7 +230,9 @@ void GatewayPlugin::HandleUnregister(const httplib::Request& req, httplib::Respo
         res.set_content(R"({"error":"invalid request"})", "application/json");
         return;
     }
-    route_table_.Unregister(doc["prefix"].GetString());
+    // 带 address 时只注销该实例
+    std::string address = doc.HasMember("address") && doc["address"].IsString() ? doc["address"].GetString() : "";
+    route_table_.Unregister(doc["prefix"].GetString(), address);
     res.set_content(R"({"status":"ok"})", "application/json");
 }
 
@@ -155,11 +241,25 @@ void GatewayPlugin::HandleRoutes(const httplib::Request&, httplib::Response& res
     rapidjson::StringBuffer buf;
     rapidjson::Writer<rapidjson::StringBuffer> w(buf);
     w.StartArray();
+    int64_t now = NowMs();
     for (const auto& r : routes) {
         w.StartObject();
         w.Key("prefix"); w.String(r.prefix.c_str());
-        w.Key("address"); w.String(r.address.c_str());
-        w.Key("service"); w.String(r.service.c_str());
+        // address / service 取第一个实例，兼容只认单实例的服务发现方
+        w.Key("address"); w.String(r.upstreams.empty() ? "" : r.upstreams[0]->address.c_str());
+        w.Key("service"); w.String(r.upstreams.empty() ? "" : r.upstreams[0]->service.c_str());
+        w.Key("upstreams");
+        w.StartArray();
+        for (const auto& u : r.upstreams) {
+            w.StartObject();
+            w.Key("address"); w.String(u->address.c_str());
+            w.Key("service"); w.String(u->service.c_str());
+            w.Key("outstanding"); w.Int(u->outstanding.load());
+            w.Key("weight"); w.Int(u->weight.load());
+            w.Key("ejected"); w.Bool(u->ejected_until_ms > now);
+            w.EndObject();
+        }
+        w.EndArray();
         w.EndObject();
     }
     w.EndArray();
@@ -180,60 +280,326 @@ void GatewayPlugin::HandleHeartbeat(const httplib::Request& req, httplib::Respon
 
 // --- 路由转发 ---
 
-void GatewayPlugin::HandleForward(const httplib::Request& req, httplib::Response& res) {
-    const RouteEntry* route = route_table_.Match(req.path);
+namespace {
+
+// 逐跳头部只对单条连接有意义，不透传；REMOTE_ADDR 等是 httplib 填入的伪头部
+bool IsHopByHopHeader(const std::string& key) {
+    static const char* const kHeaders[] = {
+        "Connection", "Keep-Alive", "Proxy-Connection", "Transfer-Encoding", "TE", "Trailer", "Upgrade",
+        "Content-Length", "Host", "REMOTE_ADDR", "REMOTE_PORT", "LOCAL_ADDR", "LOCAL_PORT"};
+    for (const char* name : kHeaders) {
+        if (strcasecmp(key.c_str(), name) == 0) return true;
+    }
+    return false;
+}
+
+// 上游响应在转发线程与下游写出之间的交接状态
+// 转发线程边收边把响应体放入有界队列（超过 kMaxQueuedBytes 时暂停读取上游，形成背压），
+// 下游的 content provider 逐块取出写给客户端，整个响应体不在网关内拼接
+struct UpstreamStream {
+    static constexpr size_t kMaxQueuedBytes = 4 << 20;
+    static constexpr size_t kCoalesceBytes = 64 << 10;  // 小块合并，减少下游写次数
+    static constexpr size_t kInlineBytes = 64 << 10;    // 在此之前结束的响应直接整体回写
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool headers_ready = false;
+    bool finished = false;  // 上游请求结束（成功或失败）
+    bool failed = false;
+    bool aborted = false;   // 下游已断开或响应已写完，转发线程停止接收
+    int status = 0;
+    httplib::Headers headers;
+    std::deque<std::string> chunks;
+    size_t queued_bytes = 0;
+
+    // 取下一块：1 取到，0 上游已正常结束，-1 上游中途失败
+    int Pull(std::string* chunk) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return !chunks.empty() || finished; });
+        if (chunks.empty()) return failed ? -1 : 0;
+        *chunk = std::move(chunks.front());
+        chunks.pop_front();
+        queued_bytes -= chunk->size();
+        cv.notify_all();
+        return 1;
+    }
+
+    void Abort() {
+        std::lock_guard<std::mutex> lock(mutex);
+        aborted = true;
+        chunks.clear();
+        queued_bytes = 0;
+        cv.notify_all();
+    }
+};
+
+// 连接失败、读超时（下游主动断开除外）以及网关类错误码计为上游失败，用于被动摘除
+bool IsUpstreamFailure(bool headers_ready, bool failed, bool aborted, int status) {
+    if (!headers_ready) return true;
+    if (failed && !aborted) return true;
+    return status == 502 || status == 503 || status == 504;
+}
+
+// 在转发线程上执行上游请求：请求体由 upstream_req 的 content provider 直接从下游连接读取，
+// 响应头交给等待中的处理线程，响应体写入 stream 队列；结束时更新上游的在途计数与健康状态
+void RunUpstream(std::shared_ptr<UpstreamPool> pool, std::shared_ptr<Upstream> upstream,
+                 std::shared_ptr<UpstreamStream> stream, httplib::Request upstream_req) {
+    upstream_req.response_handler = [stream](const httplib::Response& r) {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->status = r.status;
+        stream->headers = r.headers;
+        stream->headers_ready = true;
+        stream->cv.notify_all();
+        return true;
+    };
+    upstream_req.content_receiver = [stream](const char* data, size_t len, uint64_t, uint64_t) {
+        std::unique_lock<std::mutex> lock(stream->mutex);
+        stream->cv.wait(lock, [&] { return stream->aborted || stream->queued_bytes < UpstreamStream::kMaxQueuedBytes; });
+        if (stream->aborted) return false;
+        if (!stream->chunks.empty() && stream->chunks.back().size() < UpstreamStream::kCoalesceBytes) {
+            stream->chunks.back().append(data, len);
+        } else {
+            stream->chunks.emplace_back(data, len);
+        }
+        stream->queued_bytes += len;
+        stream->cv.notify_all();
+        return true;
+    };
+
+    auto client = pool->Acquire(upstream->address);
+    bool ok = client && static_cast<bool>(client->send(upstream_req));
+    bool upstream_failed;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->finished = true;
+        stream->failed = !ok;
+        upstream_failed = IsUpstreamFailure(stream->headers_ready, stream->failed, stream->aborted, stream->status);
+        stream->cv.notify_all();
+    }
+    --upstream->outstanding;
+    if (upstream_failed) {
+        upstream->OnFailure(NowMs());
+    } else {
+        upstream->OnSuccess();
+    }
+    // 失败的连接可能停在半个响应上，不再复用
+    pool->Release(upstream->address, std::move(client), ok);
+}
+
+// 广播：依次发给路由的每个实例，用于各实例需要保持一致的控制面操作（如数据库通道增删）
+// 请求体很小，读入内存后复用；全部成功时返回最后一个响应，否则返回第一个失败的响应
+void BroadcastRequest(UpstreamPool& pool, const RouteEntry& route, const httplib::Request& base,
+                      const std::string& body, httplib::Response& res) {
+    int status = 502;
+    std::string content;
+    std::string content_type = "application/json";
+    bool failed = false;
+    for (auto& upstream : route.upstreams) {
+        httplib::Request req = base;
+        req.body = body;
+        int s = 502;
+        std::string c = R"({"error":"upstream unreachable","service":")" + upstream->service + R"("})";
+        std::string t = "application/json";
+        auto client = pool.Acquire(upstream->address);
+        bool ok = false;
+        if (client) {
+            auto result = client->send(req);
+            ok = static_cast<bool>(result);
+            if (ok) {
+                s = result->status;
+                c = std::move(result->body);
+                t = result->get_header_value("Content-Type");
+            }
+        }
+        pool.Release(upstream->address, std::move(client), ok);
+        if (IsUpstreamFailure(ok, !ok, false, s)) {
+            upstream->OnFailure(NowMs());
+        } else {
+            upstream->OnSuccess();
+        }
+
+        if (failed) continue;
+        status = s;
+        content = std::move(c);
+        content_type = std::move(t);
+        failed = s >= 400;
+    }
+    res.status = status;
+    res.set_header("X-Upstream", "*");
+    res.set_content(std::move(content), content_type.empty() ? "application/octet-stream" : content_type);
+}
+
+}  // namespace
+
+void GatewayPlugin::HandleForward(const httplib::Request& req, httplib::Response& res,
+                                  const httplib::ContentReader* reader) {
+    // 请求体：只能通过 reader 读一次；未转发出去时需读空，否则残留数据会破坏下游的 keep-alive 连接
+    bool chunked = req.get_header_value("Transfer-Encoding") == "chunked";
+    size_t content_length = 0;
+    if (req.has_header("Content-Length")) {
+        content_length = static_cast<size_t>(std::strtoull(req.get_header_value("Content-Length").c_str(), nullptr, 10));
+    }
+    bool has_body = reader && (chunked || content_length > 0);
+    auto consumed = std::make_shared<bool>(false);
+    auto discard_body = [&] {
+        if (!has_body) return;
+        if (*consumed) {
+            res.set_header("Connection", "close");  // 请求体已读了一部分，连接状态不确定
+        } else {
+            (*reader)([](const char*, size_t) { return true; });
+        }
+    };
+
+    auto route = route_table_.Match(req.path);
     if (!route) {
+        discard_body();
         res.status = 404;
         res.set_content(R"({"error":"no route matched","path":")" + req.path + R"("})", "application/json");
         return;
     }
 
-    // 剥离前缀，构造目标路径
-    std::string target_path = RouteTable::StripPrefix(req.path, route->prefix);
-
-    // 解析目标地址
-    std::string addr = route->address;
-    std::string host;
-    int port;
-    size_t colon = addr.find(':');
-    if (colon != std::string::npos) {
-        host = addr.substr(0, colon);
-        port = std::stoi(addr.substr(colon + 1));
-    } else {
-        host = addr;
-        port = 80;
+    // 剥离前缀，构造目标路径；保留查询参数（如结果分页的 offset / limit）
+    httplib::Request upstream_req;
+    upstream_req.method = req.method;
+    upstream_req.path = httplib::append_query_params(RouteTable::StripPrefix(req.path, route->prefix), req.params);
+    // 透传端到端头部（含 Accept / Content-Type），结果格式由上游按内容协商决定，网关不解析请求体和响应体
+    for (const auto& [key, val] : req.headers) {
+        if (!IsHopByHopHeader(key) && strcasecmp(key.c_str(), "X-Upstream") != 0) {
+            upstream_req.headers.emplace(key, val);
+        }
     }
 
-    // 转发请求
-    httplib::Client client(host, port);
-    client.set_connection_timeout(5);
-    client.set_read_timeout(30);
+    // X-Upstream 请求头：实例地址表示会话亲和（如查询某实例上的异步作业），"*" 表示广播到所有实例
+    std::string pinned = req.get_header_value("X-Upstream");
+    if (pinned == "*") {
+        std::string body;
+        if (has_body) (*reader)([&body](const char* data, size_t len) {
+            body.append(data, len);
+            return true;
+        });
+        BroadcastRequest(*upstream_pool_, *route, upstream_req, body, res);
+        return;
+    }
 
-    std::string content_type = req.get_header_value("Content-Type");
-    httplib::Result result(nullptr, httplib::Error::Unknown);
+    // provider 被调用时直接从下游连接读取请求体并写给上游，不落到 req.body
+    if (has_body) {
+        upstream_req.content_provider_ = [reader, consumed, chunked](size_t, size_t, httplib::DataSink& sink) {
+            // 下游请求体只能读一次；长度与声明不符时 httplib 会再次调用，此时按失败处理
+            if (*consumed) return false;
+            *consumed = true;
+            bool ok = (*reader)([&sink](const char* data, size_t len) { return sink.write(data, len); });
+            if (ok && chunked) sink.done();
+            return ok;
+        };
+        upstream_req.is_chunked_content_provider_ = chunked;
+        if (chunked) {
+            upstream_req.set_header("Transfer-Encoding", "chunked");
+        } else {
+            upstream_req.content_length_ = content_length;
+        }
+    }
 
-    if (req.method == "GET") {
-        result = client.Get(target_path);
-    } else if (req.method == "POST") {
-        result = client.Post(target_path, req.body, content_type);
-    } else if (req.method == "DELETE") {
-        result = client.Delete(target_path);
-    } else if (req.method == "PUT") {
-        result = client.Put(target_path, req.body, content_type);
+    // 选择实例并发起请求；连接阶段失败且请求体尚未读取时换一个实例重试一次
+    auto upstream = RouteTable::Select(*route, pinned);
+    if (!upstream) {
+        discard_body();
+        res.status = 502;
+        res.set_content(R"({"error":"no upstream available","path":")" + req.path + R"("})", "application/json");
+        return;
+    }
+    std::shared_ptr<UpstreamStream> stream;
+    for (int attempt = 0;; ++attempt) {
+        stream = std::make_shared<UpstreamStream>();
+        ++upstream->outstanding;
+        SubmitForward([pool = upstream_pool_, upstream, stream, upstream_req]() {
+            RunUpstream(pool, upstream, stream, upstream_req);
+        });
+
+        // 请求体在上游返回响应头之前已全部发送，此后 reader 不再被访问，处理线程可以安全返回
+        // 小响应等到结束后整体回写（带 Content-Length），大响应累积到 kInlineBytes 后转为流式
+        std::unique_lock<std::mutex> lock(stream->mutex);
+        stream->cv.wait(lock, [&] {
+            return stream->finished || (stream->headers_ready && stream->queued_bytes >= UpstreamStream::kInlineBytes);
+        });
+        if (stream->headers_ready || attempt > 0 || *consumed || route->upstreams.size() < 2) break;
+        auto next = RouteTable::Select(*route, "", upstream.get());
+        if (!next || next == upstream) break;
+        printf("GatewayPlugin: upstream %s unreachable, retrying on %s\n", upstream->address.c_str(),
+               next->address.c_str());
+        upstream = std::move(next);
     }
 
-    if (!result) {
+    std::unique_lock<std::mutex> lock(stream->mutex);
+    if (!stream->headers_ready || (stream->finished && stream->failed)) {
+        lock.unlock();
+        stream->Abort();
+        discard_body();
         res.status = 502;
-        res.set_content(R"({"error":"upstream unreachable","service":")" + route->service + R"("})",
+        res.set_content(R"({"error":"upstream unreachable","service":")" + upstream->service + R"("})",
                         "application/json");
         return;
     }
 
-    // 回写响应
-    res.status = result->status;
-    res.body = result->body;
-    for (const auto& [key, val] : result->headers) {
-        res.set_header(key, val);
+    res.status = stream->status;
+    // 告知调用方实际处理的实例，后续请求可带回 X-Upstream 保持亲和
+    res.set_header("X-Upstream", upstream->address);
+    std::string content_type;
+    int64_t upstream_length = -1;
+    for (const auto& [key, val] : stream->headers) {
+        if (strcasecmp(key.c_str(), "Content-Type") == 0) {
+            content_type = val;
+        } else if (strcasecmp(key.c_str(), "Content-Length") == 0) {
+            upstream_length = std::strtoll(val.c_str(), nullptr, 10);
+        } else if (!IsHopByHopHeader(key) && strcasecmp(key.c_str(), "X-Upstream") != 0) {
+            res.set_header(key, val);
+        }
+    }
+
+    if (stream->finished) {
+        // 已完整接收：通常只有一块，直接移交，不再拼接
+        std::string body;
+        if (stream->chunks.size() == 1) {
+            body = std::move(stream->chunks.front());
+        } else {
+            body.reserve(stream->queued_bytes);
+            for (auto& chunk : stream->chunks) body += chunk;
+        }
+        stream->chunks.clear();
+        stream->queued_bytes = 0;
+        lock.unlock();
+        if (!body.empty() || !content_type.empty()) {
+            res.set_content(std::move(body), content_type.empty() ? "application/octet-stream" : content_type);
+        }
+        return;
+    }
+    lock.unlock();
+    if (content_type.empty()) content_type = "application/octet-stream";
+
+    // 流式回写：上游带 Content-Length 时保持定长分帧，否则改为分块编码
+    auto releaser = [stream](bool) { stream->Abort(); };
+    if (upstream_length >= 0) {
+        res.set_content_provider(
+            static_cast<size_t>(upstream_length), content_type,
+            [stream](size_t, size_t, httplib::DataSink& sink) {
+                std::string chunk;
+                if (stream->Pull(&chunk) != 1) return false;  // 上游提前结束，长度不足
+                return sink.write(chunk.data(), chunk.size());
+            },
+            releaser);
+    } else {
+        res.set_chunked_content_provider(
+            content_type,
+            [stream](size_t, httplib::DataSink& sink) {
+                std::string chunk;
+                int rc = stream->Pull(&chunk);
+                if (rc < 0) return false;
+                if (rc == 0) {
+                    sink.done();
+                    return true;
+                }
+                return sink.write(chunk.data(), chunk.size());
+            },
+            releaser);
     }
 }
 
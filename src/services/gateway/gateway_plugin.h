@@ -2,9 +2,14 @@
 #define _FLOWSQL_GATEWAY_GATEWAY_PLUGIN_H_
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <httplib.h>
 
@@ -13,6 +18,7 @@
 #include "config.h"
 #include "route_table.h"
 #include "service_manager.h"
+#include "upstream_pool.h"
 
 namespace flowsql {
 namespace gateway {
@@ -37,8 +43,12 @@ class GatewayPlugin : public IPlugin {
     // 心跳检测线程
     void HeartbeatThread();
 
-    // 路由转发
-    void HandleForward(const httplib::Request& req, httplib::Response& res);
+    // 转发线程：执行上游请求，与处理线程通过 UpstreamStream 交接响应
+    void ForwardThread();
+    void SubmitForward(std::function<void()> task);
+
+    // 路由转发：reader 非空时请求体不经缓冲，边读边写给上游；响应体同样分块流式回写
+    void HandleForward(const httplib::Request& req, httplib::Response& res, const httplib::ContentReader* reader);
 
     // Gateway API 处理
     void HandleRegister(const httplib::Request& req, httplib::Response& res);
@@ -49,10 +59,19 @@ class GatewayPlugin : public IPlugin {
     GatewayConfig config_;
     RouteTable route_table_;
     ServiceManager service_manager_;
+    // 转发线程可能在单个请求结束后仍持有连接池，故用 shared_ptr
+    std::shared_ptr<UpstreamPool> upstream_pool_;
     httplib::Server server_;
 
     std::thread http_thread_;
     std::thread heartbeat_thread_;
+
+    // 固定数量的转发线程；每个处理线程同一时刻最多占用一个，数量不少于 HTTP 服务线程数即不会互相等待
+    std::mutex forward_mutex_;
+    std::condition_variable forward_cv_;
+    std::deque<std::function<void()>> forward_tasks_;
+    std::vector<std::thread> forward_threads_;
+    bool forward_stopping_ = false;
     std::atomic<bool> running_{false};
 };
 
@@ -1,64 +1,228 @@
 #include "route_table.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
-#include <mutex>
+#include <random>
 
 namespace flowsql {
 namespace gateway {
 
-int RouteTable::Register(const std::string& prefix, const std::string& address, const std::string& service) {
-    std::unique_lock lock(mutex_);
-    if (routes_.count(prefix)) {
-        printf("RouteTable: prefix already exists: %s\n", prefix.c_str());
-        return -1;
+// 依次取出 path 中的非空段："/web//api/" → "web", "api"
+static bool NextSegment(std::string_view path, size_t* pos, std::string_view* segment) {
+    while (*pos < path.size() && path[*pos] == '/') ++*pos;
+    if (*pos >= path.size()) return false;
+    size_t end = path.find('/', *pos);
+    if (end == std::string_view::npos) end = path.size();
+    *segment = path.substr(*pos, end - *pos);
+    *pos = end;
+    return true;
+}
+
+static int64_t NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void Upstream::OnFailure(int64_t now_ms) {
+    if (++failures >= kEjectAfterFailures) {
+        // 摘除后计数清零：到期恢复的实例再连续失败 kEjectAfterFailures 次才会被再次摘除
+        failures = 0;
+        ejected_until_ms = now_ms + kEjectMs;
+        printf("RouteTable: ejected upstream %s (%s) for %llds\n", address.c_str(), service.c_str(),
+               (long long)(kEjectMs / 1000));
+    }
+}
+
+RouteTable::RouteTable() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    Publish();
+}
+
+int RouteTable::Register(const std::string& prefix, const std::string& address, const std::string& service,
+                         std::string* owner) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto& entry = routes_[prefix];
+    entry.prefix = prefix;
+    for (auto& upstream : entry.upstreams) {
+        if (upstream->address != address) continue;
+        if (upstream->service != service) {
+            printf("RouteTable: %s already registered by %s\n", address.c_str(), upstream->service.c_str());
+            if (owner) *owner = upstream->service;
+            return -1;
+        }
+        // 重启后重新注册：清除失败计数与摘除状态
+        upstream->failures = 0;
+        upstream->ejected_until_ms = 0;
+        return 0;
     }
-    routes_[prefix] = {prefix, address, service};
-    printf("RouteTable: registered %s -> %s (%s)\n", prefix.c_str(), address.c_str(), service.c_str());
+
+    auto upstream = std::make_shared<Upstream>();
+    upstream->address = address;
+    upstream->service = service;
+    entry.upstreams.push_back(std::move(upstream));
+    Publish();
+    printf("RouteTable: registered %s -> %s (%s), %zu instance(s)\n", prefix.c_str(), address.c_str(),
+           service.c_str(), entry.upstreams.size());
     return 0;
 }
 
-void RouteTable::Unregister(const std::string& prefix) {
-    std::unique_lock lock(mutex_);
-    routes_.erase(prefix);
+void RouteTable::Unregister(const std::string& prefix, const std::string& address) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto it = routes_.find(prefix);
+    if (it == routes_.end()) return;
+    if (!address.empty()) {
+        auto& upstreams = it->second.upstreams;
+        upstreams.erase(std::remove_if(upstreams.begin(), upstreams.end(),
+                                       [&](const std::shared_ptr<Upstream>& u) { return u->address == address; }),
+                        upstreams.end());
+        if (!upstreams.empty()) {
+            Publish();
+            return;
+        }
+    }
+    routes_.erase(it);
+    Publish();
 }
 
 void RouteTable::UnregisterByService(const std::string& service) {
-    std::unique_lock lock(mutex_);
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    bool changed = false;
     for (auto it = routes_.begin(); it != routes_.end();) {
-        if (it->second.service == service) {
+        auto& upstreams = it->second.upstreams;
+        size_t before = upstreams.size();
+        upstreams.erase(std::remove_if(upstreams.begin(), upstreams.end(),
+                                       [&](const std::shared_ptr<Upstream>& u) { return u->service == service; }),
+                        upstreams.end());
+        if (upstreams.size() != before) {
             printf("RouteTable: unregistered %s (%s)\n", it->first.c_str(), service.c_str());
-            it = routes_.erase(it);
-        } else {
-            ++it;
+            changed = true;
+        }
+        it = upstreams.empty() ? routes_.erase(it) : std::next(it);
+    }
+    if (changed) Publish();
+}
+
+void RouteTable::SetServiceWeight(const std::string& service, int weight) {
+    weight = std::clamp(weight, 0, Upstream::kMaxWeight);
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    for (auto& [prefix, entry] : routes_) {
+        for (auto& upstream : entry.upstreams) {
+            if (upstream->service == service) upstream->weight = weight;
+        }
+    }
+}
+
+void RouteTable::Publish() {
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->routes.reserve(routes_.size());
+    snapshot->nodes.emplace_back();
+
+    for (auto& [prefix, entry] : routes_) {
+        uint32_t node = 0;
+        size_t pos = 0;
+        std::string_view segment;
+        while (NextSegment(prefix, &pos, &segment)) {
+            uint32_t next = 0;
+            for (auto& [seg, child] : snapshot->nodes[node].children) {
+                if (seg == segment) {
+                    next = child;
+                    break;
+                }
+            }
+            if (next == 0) {
+                // emplace_back 可能使 nodes 重新分配，先记下新下标再挂到父节点
+                next = static_cast<uint32_t>(snapshot->nodes.size());
+                snapshot->nodes.emplace_back();
+                snapshot->nodes[node].children.emplace_back(std::string(segment), next);
+            }
+            node = next;
         }
+        // "/" 与 "" 都落在根节点上，等价于默认路由
+        snapshot->nodes[node].route = static_cast<int32_t>(snapshot->routes.size());
+        snapshot->routes.push_back(entry);
     }
+
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::move(snapshot)));
 }
 
-const RouteEntry* RouteTable::Match(const std::string& uri) {
-    std::shared_lock lock(mutex_);
-    // 提取前 2 级路径作为 key
-    std::string key = ExtractPrefix(uri);
-    auto it = routes_.find(key);
-    if (it != routes_.end()) return &it->second;
-
-    // 回退到前 1 级路径
-    size_t second_slash = key.find('/', 1);
-    if (second_slash != std::string::npos) {
-        std::string key1 = key.substr(0, second_slash);
-        it = routes_.find(key1);
-        if (it != routes_.end()) return &it->second;
+std::shared_ptr<const RouteEntry> RouteTable::Match(std::string_view uri) const {
+    auto snapshot = std::atomic_load(&snapshot_);
+
+    // 沿前缀树逐段下降，记录途经的最后一个路由（最长前缀）
+    const auto& nodes = snapshot->nodes;
+    int32_t matched = nodes[0].route;
+    uint32_t node = 0;
+    size_t pos = 0;
+    std::string_view segment;
+    while (NextSegment(uri, &pos, &segment)) {
+        uint32_t next = 0;
+        for (auto& [seg, child] : nodes[node].children) {
+            if (seg == segment) {
+                next = child;
+                break;
+            }
+        }
+        if (next == 0) break;
+        node = next;
+        if (nodes[node].route >= 0) matched = nodes[node].route;
     }
-    return nullptr;
+    if (matched < 0) return nullptr;
+    // 别名构造：与快照共享引用计数，不额外分配
+    return std::shared_ptr<const RouteEntry>(snapshot, &snapshot->routes[matched]);
+}
+
+std::vector<RouteEntry> RouteTable::GetAll() const {
+    return std::atomic_load(&snapshot_)->routes;
 }
 
-std::vector<RouteEntry> RouteTable::GetAll() {
-    std::shared_lock lock(mutex_);
-    std::vector<RouteEntry> result;
-    result.reserve(routes_.size());
-    for (auto& [_, entry] : routes_) {
-        result.push_back(entry);
+std::shared_ptr<Upstream> RouteTable::Select(const RouteEntry& route, std::string_view pinned,
+                                             const Upstream* exclude) {
+    const auto& upstreams = route.upstreams;
+    if (!pinned.empty()) {
+        for (auto& upstream : upstreams) {
+            if (upstream->address == pinned) return upstream;
+        }
     }
-    return result;
+    if (upstreams.size() == 1) return upstreams[0];
+
+    // 候选实例：可用且不是 exclude；没有时放宽为除 exclude 外的全部，再没有就取全部
+    int64_t now = NowMs();
+    auto eligible = [&](const Upstream& u, int level) {
+        if (level < 2 && &u == exclude) return false;
+        return level > 0 || u.Available(now);
+    };
+    int level = 0;
+    size_t count = 0;
+    for (; level < 3; ++level) {
+        count = 0;
+        for (auto& upstream : upstreams) count += eligible(*upstream, level) ? 1 : 0;
+        if (count > 0) break;
+    }
+    if (count == 0) return nullptr;
+
+    // 第 k 个候选
+    auto nth = [&](size_t k) -> const std::shared_ptr<Upstream>& {
+        for (auto& upstream : upstreams) {
+            if (eligible(*upstream, level) && k-- == 0) return upstream;
+        }
+        return upstreams[0];
+    };
+    if (count == 1) return nth(0);
+
+    // P2C：随机取两个不同候选，选 在途请求数 / 权重 较小的一个
+    thread_local std::minstd_rand rng(std::random_device{}());
+    size_t i = rng() % count;
+    size_t j = rng() % (count - 1);
+    if (j >= i) ++j;
+    const auto& a = nth(i);
+    const auto& b = nth(j);
+    auto load = [](const Upstream& u) {
+        return static_cast<int64_t>(u.outstanding + 1) * Upstream::kMaxWeight / std::max(1, u.weight.load());
+    };
+    return load(*a) <= load(*b) ? a : b;
 }
 
 std::string RouteTable::StripPrefix(const std::string& uri, const std::string& prefix) {
@@ -70,18 +234,5 @@ std::string RouteTable::StripPrefix(const std::string& uri, const std::string& p
     return uri;
 }
 
-std::string RouteTable::ExtractPrefix(const std::string& uri) {
-    // 从 URI 提取前 2 级路径："/web/api/health" → "/web/api"
-    if (uri.empty() || uri[0] != '/') return uri;
-
-    size_t first = uri.find('/', 1);
-    if (first == std::string::npos) return uri;  // 只有 1 级
-
-    size_t second = uri.find('/', first + 1);
-    if (second == std::string::npos) return uri;  // 只有 2 级
-
-    return uri.substr(0, second);  // 前 2 级
-}
-
 }  // namespace gateway
 }  // namespace flowsql
@@ -1,47 +1,98 @@
 #ifndef _FLOWSQL_GATEWAY_ROUTE_TABLE_H_
 #define _FLOWSQL_GATEWAY_ROUTE_TABLE_H_
 
-#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 namespace flowsql {
 namespace gateway {
 
+// 路由的一个上游实例
+// 负载与健康状态跨快照共享（快照重建时沿用同一个对象），转发路径上无锁读写
+struct Upstream {
+    static constexpr int kMaxWeight = 100;
+    static constexpr int kEjectAfterFailures = 3;   // 连续失败次数达到后被动摘除
+    static constexpr int64_t kEjectMs = 10000;      // 摘除时长，到期后重新参与选择
+
+    std::string address;  // 目标地址，如 "127.0.0.1:18803"
+    std::string service;  // 实例名，如 "scheduler" / "scheduler#1"
+
+    std::atomic<int> outstanding{0};            // 在途请求数
+    std::atomic<int> weight{kMaxWeight};        // 0..kMaxWeight，由心跳新鲜度决定，0 表示心跳已丢失
+    std::atomic<int> failures{0};               // 连续失败次数
+    std::atomic<int64_t> ejected_until_ms{0};   // steady_clock 毫秒
+
+    bool Available(int64_t now_ms) const { return weight > 0 && ejected_until_ms <= now_ms; }
+    void OnSuccess() { failures = 0; }
+    // 连接失败、超时或 502/503/504 时调用
+    void OnFailure(int64_t now_ms);
+};
+
 struct RouteEntry {
-    std::string prefix;   // 路由前缀，如 "/web/api"
-    std::string address;  // 目标地址，如 "127.0.0.1:18802"
-    std::string service;  // 所属服务名，如 "web"
+    std::string prefix;                               // 路由前缀，如 "/web/api"
+    std::vector<std::shared_ptr<Upstream>> upstreams;  // 至少一个
 };
 
-// 路由表 — 前 2 级 URI 精确匹配，线程安全
+// 路由表 — 按 URI 段的前缀树做最长前缀匹配，每个前缀可挂多个上游实例，线程安全
+// 读路径无锁：Match 原子地取当前不可变快照，遍历时不分配内存；
+// 注册 / 注销在写锁内复制路由集合、重建前缀树后原子替换快照（RCU），不阻塞正在进行的匹配
 class RouteTable {
  public:
-    // 注册路由（前缀不能重复）
-    int Register(const std::string& prefix, const std::string& address, const std::string& service);
+    RouteTable();
+
+    // 注册路由：同一前缀可由多个实例注册，同一地址重复注册视为幂等（服务重启后重新注册）
+    // 地址已被其他服务名占用时返回 -1，owner 非空时填入占用该地址的服务名
+    int Register(const std::string& prefix, const std::string& address, const std::string& service,
+                 std::string* owner = nullptr);
 
-    // 注销指定前缀
-    void Unregister(const std::string& prefix);
+    // 注销指定前缀；address 非空时只移除该实例，最后一个实例移除后前缀一并删除
+    void Unregister(const std::string& prefix, const std::string& address = "");
 
-    // 注销某服务的所有路由
+    // 注销某服务（实例名）的所有路由
     void UnregisterByService(const std::string& service);
 
-    // 匹配路由：从 URI 提取前 2 级路径精确查找
-    const RouteEntry* Match(const std::string& uri);
+    // 按实例名设置权重（心跳检测线程调用）
+    void SetServiceWeight(const std::string& service, int weight);
+
+    // 匹配路由：按 '/' 分段取最长的已注册前缀，未命中返回 nullptr
+    // 返回值与所属快照共享所有权，路由随后被注销也可以安全使用
+    std::shared_ptr<const RouteEntry> Match(std::string_view uri) const;
+
+    // 选择上游：pinned 命中该路由的某个实例时直接返回它（会话亲和，不看健康状态）；
+    // 否则在可用实例中按 P2C 选择（随机取两个，比较 在途请求数 / 权重），
+    // 全部不可用时退化为在所有实例中选择；exclude 用于重试时跳过刚失败的实例
+    static std::shared_ptr<Upstream> Select(const RouteEntry& route, std::string_view pinned,
+                                            const Upstream* exclude = nullptr);
 
     // 查询所有路由
-    std::vector<RouteEntry> GetAll();
+    std::vector<RouteEntry> GetAll() const;
 
     // 从 URI 中剥离匹配的前缀
     static std::string StripPrefix(const std::string& uri, const std::string& prefix);
 
-    // 从 URI 提取前 2 级路径作为匹配 key
-    static std::string ExtractPrefix(const std::string& uri);
-
  private:
-    mutable std::shared_mutex mutex_;
-    std::unordered_map<std::string, RouteEntry> routes_;  // key = prefix
+    // 不可变路由快照：routes 与按段展开的前缀树，发布后只读
+    struct Snapshot {
+        struct Node {
+            std::vector<std::pair<std::string, uint32_t>> children;  // (段, 子节点下标)，通常很少，线性查找
+            int32_t route = -1;                                     // 以此节点结尾的路由下标
+        };
+        std::vector<RouteEntry> routes;
+        std::vector<Node> nodes;  // nodes[0] 为根
+    };
+
+    // 由 routes_ 重建快照并原子发布，调用方持有 write_mutex_
+    void Publish();
+
+    std::mutex write_mutex_;
+    std::unordered_map<std::string, RouteEntry> routes_;  // key = prefix，仅写路径访问，Upstream 对象与快照共享
+    std::shared_ptr<const Snapshot> snapshot_;             // 通过 std::atomic_load / atomic_store 访问
 };
 
 }  // namespace gateway
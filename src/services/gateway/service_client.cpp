@@ -49,7 +49,7 @@ int ServiceClient::RegisterRoutes(const std::vector<std::string>& prefixes, cons
     return 0;
 }
 
-int ServiceClient::UnregisterRoute(const std::string& prefix) {
+int ServiceClient::UnregisterRoute(const std::string& prefix, const std::string& local_address) {
     httplib::Client client(gateway_host_, gateway_port_);
     client.set_connection_timeout(3);
     client.set_read_timeout(3);
@@ -58,6 +58,9 @@ int ServiceClient::UnregisterRoute(const std::string& prefix) {
     rapidjson::Writer<rapidjson::StringBuffer> w(buf);
     w.StartObject();
     w.Key("prefix"); w.String(prefix.c_str());
+    if (!local_address.empty()) {
+        w.Key("address"); w.String(local_address.c_str());
+    }
     w.EndObject();
 
     auto res = client.Post("/gateway/unregister", buf.GetString(), "application/json");
@@ -18,14 +18,17 @@ class ServiceClient {
     // 设置 Gateway 地址
     void SetGateway(const std::string& host, int port);
 
+    // 设置服务（实例）名，注册路由时一并上报，供 Gateway 按实例注销路由和调整权重
+    void SetServiceName(const std::string& name) { service_name_ = name; }
+
     // 注册单个路由前缀
     int RegisterRoute(const std::string& prefix, const std::string& local_address);
 
     // 批量注册路由
     int RegisterRoutes(const std::vector<std::string>& prefixes, const std::string& local_address);
 
-    // 注销路由
-    int UnregisterRoute(const std::string& prefix);
+    // 注销路由；local_address 非空时只注销本实例，其他实例继续服务该前缀
+    int UnregisterRoute(const std::string& prefix, const std::string& local_address = "");
 
     // 启动心跳线程
     void StartHeartbeat(const std::string& service_name, int interval_s);
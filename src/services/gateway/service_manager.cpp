@@ -1,10 +1,13 @@
 #include "service_manager.h"
 
+#include <sched.h>
 #include <signal.h>
 #include <spawn.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <cstdio>
 #include <cstring>
@@ -22,6 +25,27 @@ static int64_t NowMs() {
         .count();
 }
 
+// 把进程绑定到本进程可用 CPU 中的第 index 个（超出时取模）
+// posix_spawn 返回时子进程已 exec，尚未创建其他线程，之后的线程继承该亲和性
+static void PinToCpu(pid_t pid, int index, const std::string& name) {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) return;
+    int target = index % CPU_COUNT(&allowed);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed) || target-- > 0) continue;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(pid, sizeof(set), &set) != 0) {
+            printf("ServiceManager: pin %s to cpu %d failed: %s\n", name.c_str(), cpu, strerror(errno));
+        } else {
+            printf("ServiceManager: pinned %s to cpu %d\n", name.c_str(), cpu);
+        }
+        return;
+    }
+}
+
 ServiceManager::~ServiceManager() {
     StopAll();
 }
@@ -31,16 +55,23 @@ int ServiceManager::StartAll(const GatewayConfig& config, const std::string& gat
     config_ = config;
 
     for (const auto& svc : config.services) {
-        ServiceInfo info;
-        info.config = svc;
-        info.address = svc.host + ":" + std::to_string(svc.port);
-        info.last_heartbeat_ms = NowMs();
+        // 多实例：端口依次递增，实例名 "name#i"，都注册到同一路由前缀，由 Gateway 负载均衡
+        // Python Worker 多实例即 Worker 池：每个进程一个 GIL，由 Bridge 按在途调用数分派
+        for (int i = 0; i < std::max(1, svc.instances); ++i) {
+            ServiceInfo info;
+            info.name = i == 0 ? svc.name : svc.name + "#" + std::to_string(i);
+            info.index = i;
+            info.config = svc;
+            info.config.port = svc.port + i;
+            info.address = svc.host + ":" + std::to_string(info.config.port);
+            info.last_heartbeat_ms = NowMs();
 
-        if (SpawnService(info, gateway_addr) != 0) {
-            printf("ServiceManager: failed to start service: %s\n", svc.name.c_str());
-            continue;
+            if (SpawnService(info, gateway_addr) != 0) {
+                printf("ServiceManager: failed to start service: %s\n", info.name.c_str());
+                continue;
+            }
+            services_[info.name] = std::move(info);
         }
-        services_[svc.name] = std::move(info);
     }
     return 0;
 }
@@ -111,6 +142,17 @@ void ServiceManager::CheckAndRestart(int timeout_s, const std::string& gateway_a
     }
 }
 
+std::vector<std::pair<std::string, int64_t>> ServiceManager::HeartbeatAges() {
+    std::lock_guard lock(mutex_);
+    int64_t now = NowMs();
+    std::vector<std::pair<std::string, int64_t>> ages;
+    ages.reserve(services_.size());
+    for (auto& [name, info] : services_) {
+        if (info.pid > 0) ages.emplace_back(name, now - info.last_heartbeat_ms);
+    }
+    return ages;
+}
+
 const ServiceInfo* ServiceManager::GetService(const std::string& name) {
     std::lock_guard lock(mutex_);
     auto it = services_.find(name);
@@ -149,6 +191,11 @@ int ServiceManager::SpawnService(ServiceInfo& info, const std::string& gateway_a
             arg_strings.push_back("--port");
             arg_strings.push_back(std::to_string(svc.port));
         }
+        // 多实例时以实例名注册路由、上报心跳
+        if (info.name != svc.name) {
+            arg_strings.push_back("--instance");
+            arg_strings.push_back(info.name);
+        }
     } else {
         // C++ 服务：使用同一个可执行文件，不同角色
         arg_strings.push_back(exe_path);
@@ -158,6 +205,10 @@ int ServiceManager::SpawnService(ServiceInfo& info, const std::string& gateway_a
         arg_strings.push_back(gateway_addr);
         arg_strings.push_back("--port");
         arg_strings.push_back(std::to_string(svc.port));
+        if (info.name != svc.name) {
+            arg_strings.push_back("--instance");
+            arg_strings.push_back(info.name);
+        }
         // 插件列表
         if (!svc.plugins.empty()) {
             arg_strings.push_back("--plugins");
@@ -228,13 +279,15 @@ int ServiceManager::SpawnService(ServiceInfo& info, const std::string& gateway_a
                            const_cast<char* const*>(argv.data()),
                            const_cast<char* const*>(envp.data()));
     if (ret != 0) {
-        printf("ServiceManager: posix_spawnp failed for %s: %s\n", svc.name.c_str(), strerror(ret));
+        printf("ServiceManager: posix_spawnp failed for %s: %s\n", info.name.c_str(), strerror(ret));
         return -1;
     }
 
+    if (svc.cpu_affinity) PinToCpu(child_pid, info.index, info.name);
+
     info.pid = child_pid;
     info.alive = true;
-    printf("ServiceManager: started %s (pid=%d, port=%d)\n", svc.name.c_str(), child_pid, svc.port);
+    printf("ServiceManager: started %s (pid=%d, port=%d)\n", info.name.c_str(), child_pid, svc.port);
     return 0;
 }
 
@@ -13,7 +13,9 @@ namespace gateway {
 
 // 子服务运行时信息
 struct ServiceInfo {
-    ServiceConfig config;
+    std::string name;             // 实例名：单实例时即服务名，多实例为 "scheduler#1" 等
+    int index = 0;                // 实例序号，从 0 开始
+    ServiceConfig config;         // 多实例时 port 已按实例序号偏移
     pid_t pid = -1;
     std::string address;          // "host:port"
     int64_t last_heartbeat_ms = 0;
@@ -44,6 +46,9 @@ class ServiceManager {
     // 检查超时并重启（由心跳检测线程调用）
     void CheckAndRestart(int timeout_s, const std::string& gateway_addr);
 
+    // 各运行中实例距上次心跳的毫秒数（实例名 → 毫秒）
+    std::vector<std::pair<std::string, int64_t>> HeartbeatAges();
+
     // 获取服务信息
     const ServiceInfo* GetService(const std::string& name);
 
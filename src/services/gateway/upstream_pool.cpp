@@ -0,0 +1,70 @@
+#include "upstream_pool.h"
+
+#include <cstdlib>
+
+namespace flowsql {
+namespace gateway {
+
+int UpstreamPool::ParseAddress(const std::string& address, std::string* host, int* port) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        *host = address;
+        *port = 80;
+    } else {
+        *host = address.substr(0, colon);
+        char* end = nullptr;
+        long p = std::strtol(address.c_str() + colon + 1, &end, 10);
+        if (end == address.c_str() + colon + 1 || *end != '\0' || p <= 0 || p > 65535) return -1;
+        *port = static_cast<int>(p);
+    }
+    return host->empty() ? -1 : 0;
+}
+
+std::unique_ptr<httplib::Client> UpstreamPool::Acquire(const std::string& address) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.find(address);
+        if (it != idle_.end() && !it->second.empty()) {
+            auto client = std::move(it->second.back());
+            it->second.pop_back();
+            ++in_use_;
+            return client;
+        }
+    }
+
+    std::string host;
+    int port = 0;
+    if (ParseAddress(address, &host, &port) != 0) return nullptr;
+    auto client = std::make_unique<httplib::Client>(host, port);
+    client->set_keep_alive(true);
+    client->set_connection_timeout(config_.connect_timeout_s);
+    client->set_read_timeout(config_.read_timeout_s);
+    // 响应体原样透传给下游，不在网关解压
+    client->set_decompress(false);
+    ++in_use_;
+    return client;
+}
+
+void UpstreamPool::Release(const std::string& address, std::unique_ptr<httplib::Client> client, bool reusable) {
+    if (!client) return;
+    --in_use_;
+    if (!reusable) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& stack = idle_[address];
+    if (stack.size() < config_.max_idle_per_upstream) stack.push_back(std::move(client));
+}
+
+void UpstreamPool::Clear(const std::string& address) {
+    std::vector<std::unique_ptr<httplib::Client>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.find(address);
+        if (it == idle_.end()) return;
+        dropped.swap(it->second);
+        idle_.erase(it);
+    }
+    // 在锁外析构，关闭 socket 不阻塞其他请求
+}
+
+}  // namespace gateway
+}  // namespace flowsql
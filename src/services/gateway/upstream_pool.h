@@ -0,0 +1,59 @@
+#ifndef _FLOWSQL_GATEWAY_UPSTREAM_POOL_H_
+#define _FLOWSQL_GATEWAY_UPSTREAM_POOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <httplib.h>
+
+namespace flowsql {
+namespace gateway {
+
+// 上游连接池配置
+struct UpstreamPoolConfig {
+    size_t max_idle_per_upstream = 16;  // 每个上游地址最多缓存的空闲连接数，超出的直接关闭
+    int connect_timeout_s = 5;
+    int read_timeout_s = 30;
+};
+
+// UpstreamPool — 按上游地址（host:port）缓存 keep-alive 的 httplib::Client
+// httplib::Client 不能并发发送请求，因此每个转发请求独占一个 Client，用完归还到空闲栈；
+// 栈顶是最近使用的连接，socket 仍然有效的概率最高
+class UpstreamPool {
+ public:
+    explicit UpstreamPool(const UpstreamPoolConfig& config = {}) : config_(config) {}
+
+    UpstreamPool(const UpstreamPool&) = delete;
+    UpstreamPool& operator=(const UpstreamPool&) = delete;
+
+    // 取一个到 address 的连接，没有空闲连接时新建；地址非法返回 nullptr
+    std::unique_ptr<httplib::Client> Acquire(const std::string& address);
+
+    // 归还连接；请求失败的连接应传 reusable=false 直接关闭
+    void Release(const std::string& address, std::unique_ptr<httplib::Client> client, bool reusable = true);
+
+    // 借出未归还的连接数（Stop 时据此等待在途转发结束）
+    int InUse() const { return in_use_; }
+
+    // 关闭某个上游的全部空闲连接（服务重新注册时调用，旧进程的 keep-alive 连接已失效）
+    void Clear(const std::string& address);
+
+    // 解析 "host:port"，缺省端口为 80
+    static int ParseAddress(const std::string& address, std::string* host, int* port);
+
+ private:
+    UpstreamPoolConfig config_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<httplib::Client>>> idle_;
+    std::atomic<int> in_use_{0};
+};
+
+}  // namespace gateway
+}  // namespace flowsql
+
+#endif  // _FLOWSQL_GATEWAY_UPSTREAM_POOL_H_
@@ -0,0 +1,210 @@
+#include "job_queue.h"
+
+#include <arrow/util/byte_size.h>
+
+#include <algorithm>
+#include <chrono>
+#include <common/log.h>
+
+#include "framework/core/dataframe.h"
+
+namespace flowsql {
+namespace scheduler {
+
+static int64_t NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+const char* JobStateName(JobState state) {
+    switch (state) {
+        case JobState::QUEUED: return "queued";
+        case JobState::RUNNING: return "running";
+        case JobState::COMPLETED: return "completed";
+        case JobState::FAILED: return "failed";
+        case JobState::CANCELLED: return "cancelled";
+    }
+    return "unknown";
+}
+
+// --- Job ---
+Job::View Job::Snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    View v;
+    v.id = id;
+    v.state = state_;
+    // 运行中取实时进度，结束后取最终行数
+    v.rows = (state_ == JobState::RUNNING) ? progress.rows.load() : rows_;
+    v.error = error_;
+    v.created_ms = created_ms_;
+    v.started_ms = started_ms_;
+    v.finished_ms = finished_ms_;
+    return v;
+}
+
+bool Job::Result(int64_t* rows, std::shared_ptr<const DataFrame>* result) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != JobState::COMPLETED) return false;
+    if (rows) *rows = rows_;
+    if (result) *result = result_;
+    return true;
+}
+
+// --- JobQueue ---
+int JobQueue::Start(const JobQueueOptions& options, Runner runner) {
+    if (!runner || !workers_.empty()) return -1;
+    options_ = options;
+    runner_ = std::move(runner);
+    int n = options_.workers;
+    if (n <= 0) n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+    for (int i = 0; i < n; ++i) workers_.emplace_back(&JobQueue::WorkerLoop, this);
+    LOG_INFO("JobQueue::Start: %d workers, max_pending=%zu", n, options_.max_pending);
+    return 0;
+}
+
+void JobQueue::Stop() {
+    std::deque<std::shared_ptr<Job>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (workers_.empty()) return;
+        stopping_ = true;
+        dropped.swap(pending_);
+        for (auto& [id, job] : jobs_) job->cancel = true;
+    }
+    cv_.notify_all();
+    for (auto& job : dropped) Finish(job, JobState::CANCELLED);
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+}
+
+std::shared_ptr<Job> JobQueue::Submit(const std::string& sql, std::string* error) {
+    auto job = std::make_shared<Job>();
+    job->sql = sql;
+    job->created_ms_ = NowMs();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (workers_.empty() || stopping_) {
+            if (error) *error = "job queue is not running";
+            return nullptr;
+        }
+        if (pending_.size() >= options_.max_pending) {
+            if (error) *error = "job queue is full (" + std::to_string(options_.max_pending) + " pending)";
+            return nullptr;
+        }
+        job->id = next_id_++;
+        jobs_[job->id] = job;
+        pending_.push_back(job);
+    }
+    cv_.notify_one();
+    return job;
+}
+
+std::shared_ptr<Job> JobQueue::Get(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    return it == jobs_.end() ? nullptr : it->second;
+}
+
+int JobQueue::Cancel(uint64_t id) {
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(id);
+        if (it == jobs_.end()) return -1;
+        job = it->second;
+
+        auto pos = std::find(pending_.begin(), pending_.end(), job);
+        if (pos == pending_.end()) {
+            std::lock_guard<std::mutex> job_lock(job->mutex_);
+            if (job->state_ != JobState::RUNNING) return 1;
+            job->cancel = true;
+            return 0;
+        }
+        pending_.erase(pos);
+    }
+    job->cancel = true;
+    Finish(job, JobState::CANCELLED);
+    return 0;
+}
+
+size_t JobQueue::Pending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+void JobQueue::WorkerLoop() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            if (stopping_) return;
+            job = pending_.front();
+            pending_.pop_front();
+            std::lock_guard<std::mutex> job_lock(job->mutex_);
+            job->state_ = JobState::RUNNING;
+            job->started_ms_ = NowMs();
+        }
+
+        int64_t rows = 0;
+        std::shared_ptr<const DataFrame> result;
+        std::string error;
+        int rc = -1;
+        try {
+            rc = runner_(job.get(), &rows, &result, &error);
+        } catch (const std::exception& e) {
+            error = std::string("internal error: ") + e.what();
+        } catch (...) {
+            error = "internal error: unknown exception";
+        }
+
+        JobState state = JobState::COMPLETED;
+        if (job->cancel) {
+            state = JobState::CANCELLED;
+        } else if (rc != 0) {
+            state = JobState::FAILED;
+            if (error.empty()) error = "execution failed";
+        }
+        {
+            std::lock_guard<std::mutex> job_lock(job->mutex_);
+            job->rows_ = rows;
+            if (state == JobState::COMPLETED) job->result_ = std::move(result);
+            job->error_ = (state == JobState::CANCELLED) ? "cancelled" : error;
+        }
+        Finish(job, state);
+    }
+}
+
+void JobQueue::Finish(const std::shared_ptr<Job>& job, JobState state) {
+    int64_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> job_lock(job->mutex_);
+        job->state_ = state;
+        job->finished_ms_ = NowMs();
+        if (state == JobState::CANCELLED && job->error_.empty()) job->error_ = "cancelled";
+        if (job->result_) {
+            auto batch = job->result_->ToArrow();
+            if (batch) bytes = arrow::util::TotalBufferSize(*batch);
+        }
+    }
+
+    // 只保留最近 max_retained 个、合计不超过 max_result_bytes 的已结束作业
+    // 淘汰只是从表中移除，调用方已持有的 shared_ptr（如正在流式输出的结果）不受影响
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_.emplace_back(job->id, bytes);
+    retained_bytes_ += bytes;
+    while (finished_.size() > options_.max_retained ||
+           (finished_.size() > 1 && retained_bytes_ > options_.max_result_bytes)) {
+        jobs_.erase(finished_.front().first);
+        retained_bytes_ -= finished_.front().second;
+        finished_.pop_front();
+    }
+}
+
+}  // namespace scheduler
+}  // namespace flowsql
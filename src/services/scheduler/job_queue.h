@@ -0,0 +1,120 @@
+#ifndef _FLOWSQL_SCHEDULER_JOB_QUEUE_H_
+#define _FLOWSQL_SCHEDULER_JOB_QUEUE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/core/channel_adapter.h"
+
+namespace flowsql {
+
+class DataFrame;
+
+namespace scheduler {
+
+enum class JobState { QUEUED, RUNNING, COMPLETED, FAILED, CANCELLED };
+
+const char* JobStateName(JobState state);
+
+// 异步执行的 SQL 作业
+// cancel / progress 由执行线程无锁读写，其余字段受 mutex 保护，读取请用 Snapshot
+struct Job {
+    uint64_t id = 0;
+    std::string sql;
+
+    std::atomic<bool> cancel{false};
+    TransferProgress progress;
+
+    struct View {
+        uint64_t id = 0;
+        JobState state = JobState::QUEUED;
+        int64_t rows = 0;
+        std::string error;
+        int64_t created_ms = 0;   // Unix 毫秒时间戳
+        int64_t started_ms = 0;
+        int64_t finished_ms = 0;
+    };
+
+    View Snapshot() const;
+    // 仅 COMPLETED 状态有结果，其他状态返回 false
+    // 结果以 DataFrame 形式保留（结果游标），由调用方按页或按块序列化；写入数据库的作业 result 为空
+    bool Result(int64_t* rows, std::shared_ptr<const DataFrame>* result) const;
+
+ private:
+    friend class JobQueue;
+    mutable std::mutex mutex_;
+    JobState state_ = JobState::QUEUED;
+    int64_t rows_ = 0;
+    std::shared_ptr<const DataFrame> result_;
+    std::string error_;
+    int64_t created_ms_ = 0;
+    int64_t started_ms_ = 0;
+    int64_t finished_ms_ = 0;
+};
+
+struct JobQueueOptions {
+    int workers = 0;             // 0 表示按 CPU 核数
+    size_t max_pending = 64;     // 排队上限，超出后 Submit 直接拒绝
+    size_t max_retained = 256;   // 已结束作业的保留个数，超出后淘汰最早结束的
+    int64_t max_result_bytes = 1LL << 30;  // 保留结果的内存上限，超出后同样淘汰最早结束的（最新一个始终保留）
+};
+
+// JobQueue — 有界作业队列 + 固定大小工作线程池
+// runner 在工作线程上执行作业，成功返回 0 并填充 rows / result，失败返回 -1 并填充 error
+// runner 应在合适的边界检查 job->cancel，作业被取消后其返回值被忽略，状态记为 CANCELLED
+class JobQueue {
+ public:
+    using Runner = std::function<int(Job* job, int64_t* rows, std::shared_ptr<const DataFrame>* result,
+                                     std::string* error)>;
+
+    JobQueue() = default;
+    ~JobQueue() { Stop(); }
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    int Start(const JobQueueOptions& options, Runner runner);
+    // 取消所有排队中的作业，通知运行中的作业取消，并等待工作线程退出
+    void Stop();
+
+    // 队列已满或未启动时返回 nullptr 并填充 error
+    std::shared_ptr<Job> Submit(const std::string& sql, std::string* error = nullptr);
+    std::shared_ptr<Job> Get(uint64_t id);
+
+    // 排队中的作业立即出队并记为 CANCELLED；运行中的作业置取消标志，由 runner 协作退出
+    // 返回：0 已取消或已请求取消，1 作业已结束，-1 作业不存在
+    int Cancel(uint64_t id);
+
+    size_t Pending();
+    int Workers() const { return static_cast<int>(workers_.size()); }
+
+ private:
+    void WorkerLoop();
+    void Finish(const std::shared_ptr<Job>& job, JobState state);
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<Job>> pending_;
+    std::unordered_map<uint64_t, std::shared_ptr<Job>> jobs_;
+    std::deque<std::pair<uint64_t, int64_t>> finished_;  // (id, 结果字节数)，按结束顺序，用于淘汰
+    int64_t retained_bytes_ = 0;
+    std::vector<std::thread> workers_;
+    JobQueueOptions options_;
+    Runner runner_;
+    uint64_t next_id_ = 1;
+    bool stopping_ = false;
+};
+
+}  // namespace scheduler
+}  // namespace flowsql
+
+#endif  // _FLOWSQL_SCHEDULER_JOB_QUEUE_H_
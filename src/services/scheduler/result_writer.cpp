@@ -0,0 +1,208 @@
+#include "result_writer.h"
+
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
+
+#include <algorithm>
+#include <cctype>
+
+#include "framework/core/dataframe.h"
+
+namespace flowsql {
+namespace scheduler {
+
+static constexpr int64_t kStreamChunkRows = 8192;
+
+bool ParseResultFormat(const std::string& name, ResultFormat* format) {
+    if (name.empty() || name == "json") *format = ResultFormat::JSON;
+    else if (name == "ndjson") *format = ResultFormat::NDJSON;
+    else if (name == "arrow") *format = ResultFormat::ARROW;
+    else if (name == "feather") *format = ResultFormat::FEATHER;
+    else return false;
+    return true;
+}
+
+ResultFormat NegotiateResultFormat(const std::string& accept) {
+    size_t pos = 0;
+    while (pos < accept.size()) {
+        size_t end = accept.find(',', pos);
+        if (end == std::string::npos) end = accept.size();
+        std::string item = accept.substr(pos, end - pos);
+        pos = end + 1;
+
+        // 拆出媒体类型与参数，q=0 表示明确不接受
+        size_t semi = item.find(';');
+        std::string params = semi == std::string::npos ? "" : item.substr(semi);
+        std::string type = item.substr(0, semi);
+        type.erase(0, type.find_first_not_of(" \t"));
+        type.erase(type.find_last_not_of(" \t") + 1);
+        std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+        params.erase(std::remove(params.begin(), params.end(), ' '), params.end());
+        bool rejected = false;
+        size_t q = params.find(";q=");
+        if (q != std::string::npos) {
+            std::string qv = params.substr(q + 3, params.find(';', q + 1) - (q + 3));
+            rejected = !qv.empty() && qv.find_first_not_of("0.") == std::string::npos;
+        }
+        if (rejected) continue;
+
+        if (type == "application/json") return ResultFormat::JSON;
+        if (type == "application/x-ndjson") return ResultFormat::NDJSON;
+        if (type == "application/vnd.apache.arrow.stream") return ResultFormat::ARROW;
+        if (type == "application/vnd.apache.arrow.file") return ResultFormat::FEATHER;
+    }
+    return ResultFormat::JSON;
+}
+
+const char* ResultFormatName(ResultFormat format) {
+    switch (format) {
+        case ResultFormat::JSON: return "json";
+        case ResultFormat::NDJSON: return "ndjson";
+        case ResultFormat::ARROW: return "arrow";
+        case ResultFormat::FEATHER: return "feather";
+    }
+    return "json";
+}
+
+const char* ResultContentType(ResultFormat format) {
+    switch (format) {
+        case ResultFormat::JSON: return "application/json";
+        case ResultFormat::NDJSON: return "application/x-ndjson";
+        case ResultFormat::ARROW: return "application/vnd.apache.arrow.stream";
+        case ResultFormat::FEATHER: return "application/vnd.apache.arrow.file";
+    }
+    return "application/json";
+}
+
+bool ParseJsonLayout(const std::string& name, JsonLayout* layout) {
+    if (name.empty() || name == "rows") *layout = JsonLayout::ROWS;
+    else if (name == "columns") *layout = JsonLayout::COLUMNS;
+    else return false;
+    return true;
+}
+
+std::string MakeResultPage(int64_t rows, const DataFrame* result, int64_t offset, int64_t limit,
+                           JsonLayout layout) {
+    // 直接拼接分页 JSON，避免再经 rapidjson RawValue 复制一次
+    std::string data = result ? result->ToJson(offset, limit, layout) : "[]";
+    std::string body;
+    body.reserve(data.size() + 96);
+    body += R"({"status":"completed","rows":)";
+    body += std::to_string(rows);
+    body += R"(,"offset":)";
+    body += std::to_string(std::max<int64_t>(offset, 0));
+    if (limit >= 0) {
+        body += R"(,"limit":)";
+        body += std::to_string(limit);
+    }
+    body += R"(,"data":)";
+    body += data;
+    body += "}";
+    return body;
+}
+
+namespace {
+
+// 将 IPC 输出追加到当前块缓冲区，每次回调结束后整块写给 DataSink
+class ChunkOutputStream : public arrow::io::OutputStream {
+public:
+    explicit ChunkOutputStream(std::string* chunk) : chunk_(chunk) {}
+
+    arrow::Status Close() override {
+        closed_ = true;
+        return arrow::Status::OK();
+    }
+    bool closed() const override { return closed_; }
+    arrow::Result<int64_t> Tell() const override { return position_; }
+    arrow::Status Write(const void* data, int64_t nbytes) override {
+        chunk_->append(static_cast<const char*>(data), static_cast<size_t>(nbytes));
+        position_ += nbytes;
+        return arrow::Status::OK();
+    }
+
+private:
+    std::string* chunk_;
+    int64_t position_ = 0;
+    bool closed_ = false;
+};
+
+// 跨回调保持的流式输出状态
+struct StreamState {
+    std::shared_ptr<const DataFrame> result;
+    std::shared_ptr<arrow::RecordBatch> batch;
+    int64_t next = 0;  // 下一块起始行
+    int64_t end = 0;
+    bool header_sent = false;
+
+    std::string chunk;
+    std::shared_ptr<ChunkOutputStream> stream;
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+};
+
+}  // namespace
+
+void SetStreamingResult(httplib::Response& res, std::shared_ptr<const DataFrame> result,
+                        ResultFormat format, int64_t offset, int64_t limit) {
+    auto state = std::make_shared<StreamState>();
+    state->result = std::move(result);
+    state->batch = state->result ? state->result->ToArrow() : nullptr;
+    int64_t rows = state->batch ? state->batch->num_rows() : 0;
+    state->next = std::min(std::max<int64_t>(offset, 0), rows);
+    state->end = (limit < 0) ? rows : std::min(rows, state->next + limit);
+
+    if (format == ResultFormat::NDJSON) {
+        res.set_chunked_content_provider(
+            "application/x-ndjson", [state](size_t, httplib::DataSink& sink) {
+                if (!state->header_sent) {
+                    // 表头复用 ToJson 的 columns / types，data 为空数组
+                    std::string header = state->result ? state->result->ToJson(0, 0)
+                                                       : R"({"columns":[],"types":[],"data":[]})";
+                    header += '\n';
+                    state->header_sent = true;
+                    return sink.write(header.data(), header.size());
+                }
+                if (state->next >= state->end) {
+                    sink.done();
+                    return true;
+                }
+                int64_t n = std::min(kStreamChunkRows, state->end - state->next);
+                std::string lines = state->result->ToNdjson(state->next, n);
+                state->next += n;
+                return sink.write(lines.data(), lines.size());
+            });
+        return;
+    }
+
+    // Arrow IPC：schema 随首块输出，每块一个零拷贝切片的 RecordBatch，最后写 EOS
+    // Feather（IPC file）的块格式相同，只是首部多 magic、末尾多 footer（各块偏移），写入器按 Tell 记录偏移
+    bool feather = format == ResultFormat::FEATHER;
+    res.set_chunked_content_provider(
+        ResultContentType(format), [state, feather](size_t, httplib::DataSink& sink) {
+            if (!state->batch) {
+                sink.done();
+                return true;
+            }
+            state->chunk.clear();
+            if (!state->writer) {
+                state->stream = std::make_shared<ChunkOutputStream>(&state->chunk);
+                auto writer = feather ? arrow::ipc::MakeFileWriter(state->stream, state->batch->schema())
+                                      : arrow::ipc::MakeStreamWriter(state->stream, state->batch->schema());
+                if (!writer.ok()) return false;
+                state->writer = *writer;
+            }
+            if (state->next >= state->end) {
+                if (!state->writer->Close().ok()) return false;
+                if (!state->chunk.empty() && !sink.write(state->chunk.data(), state->chunk.size())) return false;
+                sink.done();
+                return true;
+            }
+            int64_t n = std::min(kStreamChunkRows, state->end - state->next);
+            if (!state->writer->WriteRecordBatch(*state->batch->Slice(state->next, n)).ok()) return false;
+            state->next += n;
+            return sink.write(state->chunk.data(), state->chunk.size());
+        });
+}
+
+}  // namespace scheduler
+}  // namespace flowsql
@@ -0,0 +1,51 @@
+#ifndef _FLOWSQL_SCHEDULER_RESULT_WRITER_H_
+#define _FLOWSQL_SCHEDULER_RESULT_WRITER_H_
+
+#include <httplib.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "framework/core/json_writer.h"
+
+namespace flowsql {
+
+class DataFrame;
+
+namespace scheduler {
+
+// 查询结果输出格式
+//   json   — 单个 JSON 对象，支持 offset / limit 分页
+//   ndjson — 分块流式输出：首行为表头 {"columns","types","data":[]}，之后每行一个 JSON 数组
+//   arrow  — 分块流式输出 Arrow IPC stream（application/vnd.apache.arrow.stream）
+//   feather — 分块流式输出 Arrow IPC file / Feather V2（application/vnd.apache.arrow.file），带 footer 可随机访问
+enum class ResultFormat { JSON, NDJSON, ARROW, FEATHER };
+
+// 空串按 json 处理，未知格式返回 false
+bool ParseResultFormat(const std::string& name, ResultFormat* format);
+
+// 按 Accept 头协商输出格式：依次取第一个可识别的媒体类型（忽略 q=0），
+// 没有可识别类型（含空串、*/*）时按 json 处理；显式的 format 参数优先于 Accept
+ResultFormat NegotiateResultFormat(const std::string& accept);
+
+const char* ResultFormatName(ResultFormat format);
+const char* ResultContentType(ResultFormat format);
+
+// JSON 分页：{"status":"completed","rows":总行数,"offset":o,"limit":l,"data":{columns,types,data}}
+// result 为空（写入数据库的语句）时 data 为 []；limit < 0 表示到末尾；layout 见 DataFrame::ToJson
+std::string MakeResultPage(int64_t rows, const DataFrame* result, int64_t offset, int64_t limit,
+                           JsonLayout layout = JsonLayout::ROWS);
+
+// "rows"（默认）/ "columns"，未知布局返回 false
+bool ParseJsonLayout(const std::string& name, JsonLayout* layout);
+
+// 设置分块响应：每次只序列化一块（kStreamChunkRows 行），内存占用与结果总行数无关
+// result 由响应持有，作业被淘汰后仍可输出完
+void SetStreamingResult(httplib::Response& res, std::shared_ptr<const DataFrame> result,
+                        ResultFormat format, int64_t offset, int64_t limit);
+
+}  // namespace scheduler
+}  // namespace flowsql
+
+#endif  // _FLOWSQL_SCHEDULER_RESULT_WRITER_H_
@@ -4,6 +4,8 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <charconv>
+#include <chrono>
 #include <cstdio>
 #include <common/log.h>
 #include <cstdlib>
@@ -20,6 +22,7 @@
 #include "framework/interfaces/idatabase_factory.h"
 #include "framework/interfaces/idataframe_channel.h"
 #include "framework/interfaces/ioperator.h"
+#include "result_writer.h"
 
 namespace flowsql {
 namespace scheduler {
@@ -56,6 +59,14 @@ int SchedulerPlugin::Option(const char* arg) {
 
         if (key == "host") host_ = val;
         else if (key == "port") port_ = std::stoi(val);
+        else if (key == "transfer_window_mb") transfer_options_.window_bytes = std::stoll(val) * 1024 * 1024;
+        else if (key == "transfer_window_batches") transfer_options_.window_batches = std::stoi(val);
+        else if (key == "transfer_pipelined") transfer_options_.pipelined = (val == "true" || val == "1");
+        else if (key == "transfer_queue_depth") transfer_options_.queue_depth = std::stoi(val);
+        else if (key == "exec_workers") job_options_.workers = std::stoi(val);
+        else if (key == "exec_queue_depth") job_options_.max_pending = std::stoul(val);
+        else if (key == "exec_retained") job_options_.max_retained = std::stoul(val);
+        else if (key == "exec_max_result_mb") job_options_.max_result_bytes = std::stoll(val) * 1024 * 1024;
 
         pos = (end < opts.size()) ? end + 1 : opts.size();
     }
@@ -106,6 +117,12 @@ int SchedulerPlugin::Start() {
 
     RegisterRoutes();
 
+    jobs_.Start(job_options_, [this](Job* job, int64_t* rows, std::shared_ptr<const DataFrame>* result,
+                                     std::string* error) {
+        int status = 0;
+        return RunStatement(job->sql, job, rows, result, error, &status);
+    });
+
     server_thread_ = std::thread([this]() {
         LOG_INFO("SchedulerPlugin: listening on %s:%d", host_.c_str(), port_);
         if (!server_.listen(host_, port_)) {
@@ -119,6 +136,8 @@ int SchedulerPlugin::Start() {
 int SchedulerPlugin::Stop() {
     server_.stop();
     if (server_thread_.joinable()) server_thread_.join();
+    // 作业线程仍可能引用通道，先于通道表清理退出
+    jobs_.Stop();
     channels_.clear();
     LOG_INFO("SchedulerPlugin::Stop: done");
     return 0;
@@ -137,6 +156,17 @@ void SchedulerPlugin::RegisterRoutes() {
         HandleExecute(req, res);
     });
 
+    // 异步作业：POST /execute {"async":true} 提交后按 job_id 轮询
+    server_.Get(R"(/jobs/(\d+))", [this](const httplib::Request& req, httplib::Response& res) {
+        HandleGetJob(req, res);
+    });
+    server_.Get(R"(/jobs/(\d+)/result)", [this](const httplib::Request& req, httplib::Response& res) {
+        HandleGetJobResult(req, res);
+    });
+    server_.Post(R"(/jobs/(\d+)/cancel)", [this](const httplib::Request& req, httplib::Response& res) {
+        HandleCancelJob(req, res);
+    });
+
     server_.Get("/channels", [this](const httplib::Request& req, httplib::Response& res) {
         HandleGetChannels(req, res);
     });
@@ -153,6 +183,9 @@ void SchedulerPlugin::RegisterRoutes() {
     server_.Get("/db-channels", [this](const httplib::Request& req, httplib::Response& res) {
         HandleListDbChannels(req, res);
     });
+    server_.Get("/db-channels/stats", [this](const httplib::Request& req, httplib::Response& res) {
+        HandleDbChannelStats(req, res);
+    });
     server_.Post("/db-channels/add", [this](const httplib::Request& req, httplib::Response& res) {
         HandleAddDbChannel(req, res);
     });
@@ -279,12 +312,27 @@ static std::string BuildQuery(const std::string& source_name, const SqlStatement
 }
 
 // --- 辅助：对 DataFrame 通道应用 WHERE 过滤 ---
+// 复用 SqlParser 解析出的表达式树，编译为列式过滤程序后在 Arrow 缓冲区上求值
 static std::shared_ptr<DataFrameChannel> ApplyDataFrameFilter(
-    IDataFrameChannel* src, const std::string& where_clause, uint64_t seq) {
+    IDataFrameChannel* src, const SqlStatement& stmt, uint64_t seq, std::string* error) {
+    std::shared_ptr<WhereExpr> expr = stmt.where_expr;
+    if (!expr) {
+        std::string parse_error;
+        expr = SqlParser::ParseWhere(stmt.where_clause, &parse_error);
+        if (!expr) {
+            if (error) *error = "unsupported WHERE clause on dataframe channel: " + parse_error;
+            return nullptr;
+        }
+    }
+
     DataFrame data;
     if (src->Read(&data) != 0 || data.RowCount() == 0) return nullptr;
 
-    if (data.Filter(where_clause.c_str()) != 0) return nullptr;
+    std::string filter_error;
+    if (data.Filter(*expr, &filter_error) != 0) {
+        if (error) *error = "filter failed: " + filter_error;
+        return nullptr;
+    }
 
     auto filtered = std::make_shared<DataFrameChannel>("_filter", std::to_string(seq));
     filtered->Open();
@@ -296,8 +344,8 @@ static std::shared_ptr<DataFrameChannel> ApplyDataFrameFilter(
 int SchedulerPlugin::ExecuteTransfer(IChannel* source, IChannel* sink,
                                       const std::string& source_type,
                                       const std::string& sink_type,
-                                      const SqlStatement& stmt, int64_t* rows_affected,
-                                      std::string* error) {
+                                      const SqlStatement& stmt, const TransferOptions& options,
+                                      int64_t* rows_affected, std::string* error) {
     if (source_type == ChannelType::kDataFrame && sink_type == ChannelType::kDataFrame) {
         auto* src = dynamic_cast<IDataFrameChannel*>(source);
         auto* dst = dynamic_cast<IDataFrameChannel*>(sink);
@@ -305,7 +353,7 @@ int SchedulerPlugin::ExecuteTransfer(IChannel* source, IChannel* sink,
 
         // DataFrame + WHERE → 先过滤再复制
         if (!stmt.where_clause.empty()) {
-            auto filtered = ApplyDataFrameFilter(src, stmt.where_clause, ++tmp_channel_seq_);
+            auto filtered = ApplyDataFrameFilter(src, stmt, ++tmp_channel_seq_, error);
             if (!filtered) return -1;
             return ChannelAdapter::CopyDataFrame(filtered.get(), dst);
         }
@@ -320,7 +368,7 @@ int SchedulerPlugin::ExecuteTransfer(IChannel* source, IChannel* sink,
 
         // DataFrame + WHERE → 先过滤再写入
         if (!stmt.where_clause.empty()) {
-            auto filtered = ApplyDataFrameFilter(src, stmt.where_clause, ++tmp_channel_seq_);
+            auto filtered = ApplyDataFrameFilter(src, stmt, ++tmp_channel_seq_, error);
             if (!filtered) return -1;
             int64_t rows = ChannelAdapter::WriteFromDataFrame(filtered.get(), dst, table.c_str(), error);
             if (rows_affected) *rows_affected = rows;
@@ -344,15 +392,11 @@ int SchedulerPlugin::ExecuteTransfer(IChannel* source, IChannel* sink,
         auto* dst = dynamic_cast<IDatabaseChannel*>(sink);
         if (!src || !dst) return -1;
 
-        auto tmp = std::make_shared<DataFrameChannel>("_adapter", std::to_string(++tmp_channel_seq_));
-        tmp->Open();
-
+        // 流式搬运：读一批写一批，内存占用与总行数无关
         std::string query = BuildQuery(stmt.source, stmt);
-        int rc = ChannelAdapter::ReadToDataFrame(src, query.c_str(), tmp.get(), error);
-        if (rc != 0) return rc;
-
         std::string table = ExtractTableName(stmt.dest);
-        int64_t rows = ChannelAdapter::WriteFromDataFrame(tmp.get(), dst, table.c_str(), error);
+        int64_t rows = ChannelAdapter::TransferDatabase(src, query.c_str(), dst, table.c_str(),
+                                                        options, error);
         if (rows_affected) *rows_affected = rows;
         return (rows < 0) ? -1 : 0;
     }
@@ -366,12 +410,34 @@ int SchedulerPlugin::ExecuteWithOperator(IChannel* source, IChannel* sink,
                                           IOperator* op,
                                           const std::string& source_type,
                                           const std::string& sink_type,
-                                          const SqlStatement& stmt, int64_t* rows_affected,
-                                          std::string* error) {
+                                          const SqlStatement& stmt, const TransferOptions& options,
+                                          int64_t* rows_affected, std::string* error) {
     IChannel* actual_source = source;
     IChannel* actual_sink = sink;
     std::shared_ptr<DataFrameChannel> tmp_in, tmp_out;
 
+    // 支持逐批处理的算子：读端每取一批交给算子、算子每产出一批直接写入目标，不经中间 DataFrame
+    if (auto* batch_op = dynamic_cast<IBatchOperator*>(op)) {
+        std::string query;
+        if (source_type == ChannelType::kDatabase) {
+            query = BuildQuery(stmt.source, stmt);
+        } else if (source_type == ChannelType::kDataFrame && !stmt.where_clause.empty()) {
+            auto* df_src = dynamic_cast<IDataFrameChannel*>(source);
+            if (!df_src) return -1;
+            tmp_in = ApplyDataFrameFilter(df_src, stmt, ++tmp_channel_seq_, error);
+            if (!tmp_in) return -1;
+            actual_source = tmp_in.get();
+        }
+        std::string table;
+        if (sink_type == ChannelType::kDatabase) table = ExtractTableName(stmt.dest);
+
+        int64_t rows = ChannelAdapter::TransferThroughOperator(actual_source, query.c_str(), batch_op, sink,
+                                                               table.c_str(), options, error);
+        if (rows < 0) return -1;
+        if (sink_type == ChannelType::kDatabase && rows_affected) *rows_affected = rows;
+        return 0;
+    }
+
     if (source_type == ChannelType::kDatabase) {
         auto* db_src = dynamic_cast<IDatabaseChannel*>(source);
         if (!db_src) return -1;
@@ -389,7 +455,7 @@ int SchedulerPlugin::ExecuteWithOperator(IChannel* source, IChannel* sink,
         auto* df_src = dynamic_cast<IDataFrameChannel*>(source);
         if (!df_src) return -1;
 
-        tmp_in = ApplyDataFrameFilter(df_src, stmt.where_clause, ++tmp_channel_seq_);
+        tmp_in = ApplyDataFrameFilter(df_src, stmt, ++tmp_channel_seq_, error);
         if (!tmp_in) return -1;
         actual_source = tmp_in.get();
     }
@@ -428,40 +494,23 @@ int SchedulerPlugin::ExecuteWithOperator(IChannel* source, IChannel* sink,
     return 0;
 }
 
-// --- HandleExecute ---
-void SchedulerPlugin::HandleExecute(const httplib::Request& req, httplib::Response& res) {
-    SetCorsHeaders(res);
-
-    rapidjson::Document doc;
-    doc.Parse(req.body.c_str());
-    if (doc.HasParseError() || !doc.HasMember("sql") || !doc["sql"].IsString()) {
-        res.status = 400;
-        res.set_content(MakeErrorJson("invalid request, expected {\"sql\":\"...\"}"), "application/json");
-        return;
-    }
-    std::string sql_text = doc["sql"].GetString();
-
-    // 限制 SQL 长度，防止超大请求导致 DoS
-    static constexpr size_t kMaxSqlLength = 64 * 1024;  // 64KB
-    if (sql_text.size() > kMaxSqlLength) {
-        res.status = 400;
-        res.set_content(MakeErrorJson("SQL too long (max 64KB)"), "application/json");
-        return;
-    }
+// --- RunStatement ---
+int SchedulerPlugin::RunStatement(const std::string& sql_text, Job* job, int64_t* rows,
+                                  std::shared_ptr<const DataFrame>* result, std::string* error,
+                                  int* status) {
+    *status = 400;
 
     SqlParser parser;
     auto stmt = parser.Parse(sql_text);
     if (!stmt.error.empty()) {
-        res.status = 400;
-        res.set_content(MakeErrorJson(stmt.error), "application/json");
-        return;
+        *error = stmt.error;
+        return -1;
     }
 
     IChannel* source = FindChannel(stmt.source);
     if (!source) {
-        res.status = 400;
-        res.set_content(MakeErrorJson("source channel not found: " + stmt.source), "application/json");
-        return;
+        *error = "source channel not found: " + stmt.source;
+        return -1;
     }
 
     IOperator* op = nullptr;
@@ -469,83 +518,199 @@ void SchedulerPlugin::HandleExecute(const httplib::Request& req, httplib::Respon
     if (stmt.HasOperator()) {
         op_holder = FindOperator(stmt.op_catelog, stmt.op_name);
         if (!op_holder) {
-            res.status = 400;
-            res.set_content(MakeErrorJson("operator not found: " + stmt.op_catelog + "." + stmt.op_name),
-                            "application/json");
-            return;
+            *error = "operator not found: " + stmt.op_catelog + "." + stmt.op_name;
+            return -1;
         }
         op = op_holder.get();
     }
 
-    try {
-        if (op) {
-            for (auto& [k, v] : stmt.with_params) {
-                op->Configure(k.c_str(), v.c_str());
-            }
+    *status = 500;
+    if (op) {
+        for (auto& [k, v] : stmt.with_params) {
+            op->Configure(k.c_str(), v.c_str());
         }
+    }
 
-        std::shared_ptr<DataFrameChannel> temp_sink;
-        IChannel* sink = nullptr;
+    std::shared_ptr<DataFrameChannel> temp_sink;
+    IChannel* sink = nullptr;
 
-        if (!stmt.dest.empty()) {
-            sink = FindChannel(stmt.dest);
-            if (!sink) {
-                // 临时通道仅由局部 shared_ptr 持有，不注册到 channels_ 避免累积
-                temp_sink = std::make_shared<DataFrameChannel>("result", stmt.dest);
-                temp_sink->Open();
-                sink = temp_sink.get();
-            }
-        } else {
-            temp_sink = std::make_shared<DataFrameChannel>("_temp", "sink");
+    if (!stmt.dest.empty()) {
+        sink = FindChannel(stmt.dest);
+        if (!sink) {
+            // 临时通道仅由局部 shared_ptr 持有，不注册到 channels_ 避免累积
+            temp_sink = std::make_shared<DataFrameChannel>("result", stmt.dest);
             temp_sink->Open();
             sink = temp_sink.get();
         }
+    } else {
+        temp_sink = std::make_shared<DataFrameChannel>("_temp", "sink");
+        temp_sink->Open();
+        sink = temp_sink.get();
+    }
 
-        std::string source_type(source->Type());
-        std::string sink_type(sink->Type());
+    std::string source_type(source->Type());
+    std::string sink_type(sink->Type());
 
-        int rc = 0;
-        int64_t affected_rows = 0;
-        std::string exec_error;
+    // 异步作业：取消标志与进度接入流式搬运，每批之间检查
+    TransferOptions options = transfer_options_;
+    if (job) {
+        options.cancel = &job->cancel;
+        options.progress = &job->progress;
+    }
 
-        if (!op) {
-            rc = ExecuteTransfer(source, sink, source_type, sink_type, stmt, &affected_rows, &exec_error);
-        } else {
-            rc = ExecuteWithOperator(source, sink, op, source_type, sink_type, stmt, &affected_rows, &exec_error);
-        }
+    int rc = 0;
+    int64_t affected_rows = 0;
+    std::string exec_error;
 
-        if (rc != 0) {
-            std::string err = exec_error;
-            if (err.empty() && op) err = op->LastError();
-            if (err.empty()) err = "execution failed";
-            res.status = 500;
-            res.set_content(MakeErrorJson(err), "application/json");
+    if (!op) {
+        rc = ExecuteTransfer(source, sink, source_type, sink_type, stmt, options, &affected_rows, &exec_error);
+    } else {
+        rc = ExecuteWithOperator(source, sink, op, source_type, sink_type, stmt, options, &affected_rows,
+                                 &exec_error);
+    }
+
+    if (rc != 0) {
+        *error = exec_error;
+        if (error->empty() && op) *error = op->LastError();
+        if (error->empty()) *error = "execution failed";
+        return -1;
+    }
+    if (job && job->cancel) {
+        *error = "cancelled";
+        return -1;
+    }
+
+    // 结果保留为 DataFrame，由调用方按页或分块序列化，不在此处整体转成 JSON
+    auto* df_sink = dynamic_cast<IDataFrameChannel*>(sink);
+    auto frame = std::make_shared<DataFrame>();
+    result->reset();
+    *rows = 0;
+    if (df_sink && df_sink->Read(frame.get()) == 0 && frame->RowCount() > 0) {
+        frame->ToArrow();  // 提前完成构建，此后结果只读，可被多个请求并发序列化
+        *rows = frame->RowCount();
+        *result = std::move(frame);
+    } else if (sink_type == ChannelType::kDatabase) {
+        // 写入数据库时，使用 ExecuteTransfer 返回的行数
+        *rows = affected_rows;
+    }
+    *status = 200;
+    return 0;
+}
+
+// 输出查询结果：json 分页，ndjson / arrow / feather 分块流式输出（无结果集时退化为 json）
+static void SetResultContent(httplib::Response& res, int64_t rows, std::shared_ptr<const DataFrame> result,
+                             ResultFormat format, int64_t offset, int64_t limit, JsonLayout layout) {
+    // 格式可由 Accept 协商，提示中间缓存按 Accept 区分
+    res.set_header("Vary", "Accept");
+    if (format != ResultFormat::JSON && result) {
+        SetStreamingResult(res, std::move(result), format, offset, limit);
+        return;
+    }
+    res.set_content(MakeResultPage(rows, result.get(), offset, limit, layout), "application/json");
+}
+
+static int64_t QueryParamInt(const httplib::Request& req, const char* key, int64_t default_value) {
+    if (!req.has_param(key)) return default_value;
+    try {
+        return std::stoll(req.get_param_value(key));
+    } catch (const std::exception&) {
+        return default_value;
+    }
+}
+
+// 路径中的作业 id：路由正则只保证是数字，超出 uint64 范围时同样按非法 id 回 400
+static bool ParseJobId(const httplib::Request& req, httplib::Response& res, uint64_t* id) {
+    std::string text = req.matches[1].str();
+    auto r = std::from_chars(text.data(), text.data() + text.size(), *id);
+    if (r.ec == std::errc() && r.ptr == text.data() + text.size()) return true;
+    res.status = 400;
+    res.set_content(MakeErrorJson("invalid job id: " + text), "application/json");
+    return false;
+}
+
+// --- HandleExecute ---
+// {"sql":"..."} 同步执行并返回结果；{"sql":"...","async":true} 入队后立即返回 job_id
+// 同步执行可选 "offset" / "limit" 分页，"layout":"columns" 列式 JSON，"format":"ndjson"|"arrow"|"feather" 分块流式输出
+// 未指定 "format" 时按 Accept 头协商（如 application/vnd.apache.arrow.stream 直接返回 Arrow IPC 二进制）
+void SchedulerPlugin::HandleExecute(const httplib::Request& req, httplib::Response& res) {
+    SetCorsHeaders(res);
+
+    rapidjson::Document doc;
+    doc.Parse(req.body.c_str());
+    if (doc.HasParseError() || !doc.HasMember("sql") || !doc["sql"].IsString()) {
+        res.status = 400;
+        res.set_content(MakeErrorJson("invalid request, expected {\"sql\":\"...\"}"), "application/json");
+        return;
+    }
+    std::string sql_text = doc["sql"].GetString();
+    bool async = doc.HasMember("async") && doc["async"].IsBool() && doc["async"].GetBool();
+    int64_t offset = doc.HasMember("offset") && doc["offset"].IsInt64() ? doc["offset"].GetInt64() : 0;
+    int64_t limit = doc.HasMember("limit") && doc["limit"].IsInt64() ? doc["limit"].GetInt64() : -1;
+    ResultFormat format = NegotiateResultFormat(req.get_header_value("Accept"));
+    if (doc.HasMember("format") &&
+        (!doc["format"].IsString() || !ParseResultFormat(doc["format"].GetString(), &format))) {
+        res.status = 400;
+        res.set_content(MakeErrorJson("invalid format, expected json / ndjson / arrow / feather"), "application/json");
+        return;
+    }
+    JsonLayout layout = JsonLayout::ROWS;
+    if (doc.HasMember("layout") &&
+        (!doc["layout"].IsString() || !ParseJsonLayout(doc["layout"].GetString(), &layout))) {
+        res.status = 400;
+        res.set_content(MakeErrorJson("invalid layout, expected rows / columns"), "application/json");
+        return;
+    }
+
+    // 限制 SQL 长度，防止超大请求导致 DoS
+    static constexpr size_t kMaxSqlLength = 64 * 1024;  // 64KB
+    if (sql_text.size() > kMaxSqlLength) {
+        res.status = 400;
+        res.set_content(MakeErrorJson("SQL too long (max 64KB)"), "application/json");
+        return;
+    }
+
+    if (async) {
+        // 语法错误在入队前直接返回，通道和算子查找在工作线程上进行
+        SqlParser parser;
+        auto stmt = parser.Parse(sql_text);
+        if (!stmt.error.empty()) {
+            res.status = 400;
+            res.set_content(MakeErrorJson(stmt.error), "application/json");
             return;
         }
 
-        auto* df_sink = dynamic_cast<IDataFrameChannel*>(sink);
-        DataFrame result;
-        std::string result_json = "[]";
-        int64_t row_count = 0;
-        if (df_sink && df_sink->Read(&result) == 0 && result.RowCount() > 0) {
-            result_json = result.ToJson();
-            row_count = result.RowCount();
-        } else if (sink_type == ChannelType::kDatabase) {
-            // 写入数据库时，使用 ExecuteTransfer 返回的行数
-            row_count = affected_rows;
+        std::string submit_error;
+        auto job = jobs_.Submit(sql_text, &submit_error);
+        if (!job) {
+            res.status = 503;
+            res.set_content(MakeErrorJson(submit_error), "application/json");
+            return;
         }
 
         rapidjson::StringBuffer buf;
         rapidjson::Writer<rapidjson::StringBuffer> w(buf);
         w.StartObject();
+        w.Key("job_id");
+        w.Uint64(job->id);
         w.Key("status");
-        w.String("completed");
-        w.Key("rows");
-        w.Int64(row_count);
-        w.Key("data");
-        w.RawValue(result_json.c_str(), result_json.size(), rapidjson::kArrayType);
+        w.String(JobStateName(job->Snapshot().state));
         w.EndObject();
+        res.status = 202;
         res.set_content(buf.GetString(), "application/json");
+        return;
+    }
+
+    try {
+        int64_t rows = 0;
+        std::shared_ptr<const DataFrame> result;
+        std::string error;
+        int status = 500;
+        if (RunStatement(sql_text, nullptr, &rows, &result, &error, &status) != 0) {
+            res.status = status;
+            res.set_content(MakeErrorJson(error), "application/json");
+            return;
+        }
+        SetResultContent(res, rows, std::move(result), format, offset, limit, layout);
 
     } catch (const std::exception& e) {
         std::string err = std::string("internal error: ") + e.what();
@@ -559,6 +724,114 @@ void SchedulerPlugin::HandleExecute(const httplib::Request& req, httplib::Respon
     }
 }
 
+// --- 异步作业端点 ---
+void SchedulerPlugin::HandleGetJob(const httplib::Request& req, httplib::Response& res) {
+    SetCorsHeaders(res);
+    uint64_t id = 0;
+    if (!ParseJobId(req, res, &id)) return;
+    auto job = jobs_.Get(id);
+    if (!job) {
+        res.status = 404;
+        res.set_content(MakeErrorJson("job not found"), "application/json");
+        return;
+    }
+
+    auto v = job->Snapshot();
+    int64_t end_ms = v.finished_ms;
+    if (!end_ms && v.started_ms) {
+        end_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count();
+    }
+
+    rapidjson::StringBuffer buf;
+    rapidjson::Writer<rapidjson::StringBuffer> w(buf);
+    w.StartObject();
+    w.Key("job_id"); w.Uint64(v.id);
+    w.Key("status"); w.String(JobStateName(v.state));
+    w.Key("rows"); w.Int64(v.rows);
+    w.Key("batches"); w.Int64(job->progress.batches.load());
+    w.Key("bytes"); w.Int64(job->progress.bytes.load());
+    w.Key("created_at"); w.Int64(v.created_ms);
+    w.Key("started_at"); w.Int64(v.started_ms);
+    w.Key("finished_at"); w.Int64(v.finished_ms);
+    w.Key("elapsed_ms"); w.Int64(v.started_ms ? end_ms - v.started_ms : 0);
+    if (!v.error.empty()) {
+        w.Key("error"); w.String(v.error.c_str());
+    }
+    w.EndObject();
+    res.set_content(buf.GetString(), "application/json");
+}
+
+void SchedulerPlugin::HandleGetJobResult(const httplib::Request& req, httplib::Response& res) {
+    SetCorsHeaders(res);
+    uint64_t id = 0;
+    if (!ParseJobId(req, res, &id)) return;
+    auto job = jobs_.Get(id);
+    if (!job) {
+        res.status = 404;
+        res.set_content(MakeErrorJson("job not found"), "application/json");
+        return;
+    }
+
+    // 结果游标：?offset=&limit= 分页，?layout=columns 列式 JSON，?format=ndjson|arrow|feather 分块流式输出
+    // 未带 ?format 时按 Accept 头协商
+    ResultFormat format = NegotiateResultFormat(req.get_header_value("Accept"));
+    if (req.has_param("format") && !ParseResultFormat(req.get_param_value("format"), &format)) {
+        res.status = 400;
+        res.set_content(MakeErrorJson("invalid format, expected json / ndjson / arrow / feather"), "application/json");
+        return;
+    }
+    JsonLayout layout = JsonLayout::ROWS;
+    if (!ParseJsonLayout(req.get_param_value("layout"), &layout)) {
+        res.status = 400;
+        res.set_content(MakeErrorJson("invalid layout, expected rows / columns"), "application/json");
+        return;
+    }
+    int64_t rows = 0;
+    std::shared_ptr<const DataFrame> result;
+    if (job->Result(&rows, &result)) {
+        SetResultContent(res, rows, std::move(result), format, QueryParamInt(req, "offset", 0),
+                         QueryParamInt(req, "limit", -1), layout);
+        return;
+    }
+
+    // 未完成或失败：409 并带上当前状态，调用方据此决定继续轮询还是放弃
+    auto v = job->Snapshot();
+    rapidjson::StringBuffer buf;
+    rapidjson::Writer<rapidjson::StringBuffer> w(buf);
+    w.StartObject();
+    w.Key("status"); w.String(JobStateName(v.state));
+    w.Key("error"); w.String(v.error.empty() ? "job not finished" : v.error.c_str());
+    w.EndObject();
+    res.status = 409;
+    res.set_content(buf.GetString(), "application/json");
+}
+
+void SchedulerPlugin::HandleCancelJob(const httplib::Request& req, httplib::Response& res) {
+    SetCorsHeaders(res);
+    uint64_t id = 0;
+    if (!ParseJobId(req, res, &id)) return;
+    int rc = jobs_.Cancel(id);
+    if (rc < 0) {
+        res.status = 404;
+        res.set_content(MakeErrorJson("job not found"), "application/json");
+        return;
+    }
+
+    auto job = jobs_.Get(id);
+    JobState state = job ? job->Snapshot().state : JobState::CANCELLED;
+    rapidjson::StringBuffer buf;
+    rapidjson::Writer<rapidjson::StringBuffer> w(buf);
+    w.StartObject();
+    w.Key("job_id"); w.Uint64(id);
+    // 运行中的作业在下一批边界退出，此处仍可能是 running
+    w.Key("status"); w.String(JobStateName(state));
+    w.EndObject();
+    if (rc == 1) res.status = 409;  // 作业已结束，无法取消
+    res.set_content(buf.GetString(), "application/json");
+}
+
 // --- HandleGetChannels ---
 void SchedulerPlugin::HandleGetChannels(const httplib::Request&, httplib::Response& res) {
     SetCorsHeaders(res);
@@ -703,6 +976,31 @@ void SchedulerPlugin::HandleListDbChannels(const httplib::Request&, httplib::Res
     res.body = body;
 }
 
+// GET /db-channels/stats — 已连接数据库通道的连接池实时指标
+// 每项：{"type","name","pool":{total,idle,in_use,max,waiters,acquires,acquire_timeouts,
+//        wait_ms_histogram,connects,connect_failures,connect_avg_ms,connect_max_ms,
+//        health_checks,health_check_failures,idle_evictions}}
+void SchedulerPlugin::HandleDbChannelStats(const httplib::Request&, httplib::Response& res) {
+    SetCorsHeaders(res);
+    auto* factory = GetDbFactory(querier_);
+    if (!factory) {
+        res.status = 503;
+        res.body = R"({"error":"DatabasePlugin not available"})";
+        return;
+    }
+
+    std::string body = "[";
+    bool first = true;
+    factory->Stats([&](const char*, const char*, const char* stats_json) {
+        if (!first) body += ",";
+        body += stats_json ? stats_json : "{}";
+        first = false;
+    });
+    body += "]";
+    res.status = 200;
+    res.body = body;
+}
+
 // POST /db-channels/add — 新增数据库通道
 // Body: {"config":"type=mysql;name=mydb;host=...;..."}
 void SchedulerPlugin::HandleAddDbChannel(const httplib::Request& req, httplib::Response& res) {
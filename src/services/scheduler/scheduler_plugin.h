@@ -11,10 +11,13 @@
 
 #include <common/iplugin.h>
 
+#include "framework/core/channel_adapter.h"
 #include "framework/interfaces/ibridge.h"
+#include "job_queue.h"
 
 namespace flowsql {
 
+class DataFrame;
 class IChannel;
 class IOperator;
 struct SqlStatement;
@@ -41,12 +44,16 @@ class SchedulerPlugin : public IPlugin {
 
     // HTTP 端点处理
     void HandleExecute(const httplib::Request& req, httplib::Response& res);
+    void HandleGetJob(const httplib::Request& req, httplib::Response& res);
+    void HandleGetJobResult(const httplib::Request& req, httplib::Response& res);
+    void HandleCancelJob(const httplib::Request& req, httplib::Response& res);
     void HandleGetChannels(const httplib::Request& req, httplib::Response& res);
     void HandleGetOperators(const httplib::Request& req, httplib::Response& res);
     void HandleRefreshOperators(httplib::Response& res);
 
     // 数据库通道动态管理端点（Epic 6）
     void HandleListDbChannels(const httplib::Request& req, httplib::Response& res);
+    void HandleDbChannelStats(const httplib::Request& req, httplib::Response& res);
     void HandleAddDbChannel(const httplib::Request& req, httplib::Response& res);
     void HandleRemoveDbChannel(const httplib::Request& req, httplib::Response& res);
     void HandleUpdateDbChannel(const httplib::Request& req, httplib::Response& res);
@@ -58,18 +65,25 @@ class SchedulerPlugin : public IPlugin {
     // 算子查找（先查 C++ 静态算子，再查 IBridge Python 算子）
     std::shared_ptr<IOperator> FindOperator(const std::string& catelog, const std::string& name);
 
+    // 执行一条 SQL，同步 /execute 与异步作业共用
+    // job 非空时接入取消标志与搬运进度；失败时 status 为对应的 HTTP 状态码（400 请求错误 / 500 执行失败）
+    // 成功时 result 为结果 DataFrame（写入数据库时为空），rows 为结果行数或写入行数
+    int RunStatement(const std::string& sql_text, Job* job, int64_t* rows,
+                     std::shared_ptr<const DataFrame>* result, std::string* error, int* status);
+
     // 执行路径：无算子的纯数据搬运
     // rows_affected: 可选的输出参数，返回受影响的行数（写入/读取的行数）
     int ExecuteTransfer(IChannel* source, IChannel* sink,
                         const std::string& source_type, const std::string& sink_type,
-                        const SqlStatement& stmt, int64_t* rows_affected = nullptr,
-                        std::string* error = nullptr);
+                        const SqlStatement& stmt, const TransferOptions& options,
+                        int64_t* rows_affected = nullptr, std::string* error = nullptr);
 
     // 执行路径：有算子，自动适配通道类型
+    // 算子实现 IBatchOperator 时逐批流式执行（取消 / 进度经 options 接入），否则经中间 DataFrame 整体执行
     int ExecuteWithOperator(IChannel* source, IChannel* sink, IOperator* op,
                             const std::string& source_type, const std::string& sink_type,
-                            const SqlStatement& stmt, int64_t* rows_affected = nullptr,
-                            std::string* error = nullptr);
+                            const SqlStatement& stmt, const TransferOptions& options,
+                            int64_t* rows_affected = nullptr, std::string* error = nullptr);
 
     IQuerier* querier_ = nullptr;  // Load 时传入，用于查询算子等插件接口
     httplib::Server server_;
@@ -81,6 +95,15 @@ class SchedulerPlugin : public IPlugin {
     std::string host_ = "127.0.0.1";
     int port_ = 18803;
 
+    // Database → Database 流式搬运参数
+    // Option: transfer_window_mb / transfer_window_batches / transfer_pipelined / transfer_queue_depth
+    TransferOptions transfer_options_;
+
+    // 异步执行：有界作业队列 + 工作线程池
+    // Option: exec_workers（默认 CPU 核数）/ exec_queue_depth / exec_retained / exec_max_result_mb
+    JobQueueOptions job_options_;
+    JobQueue jobs_;
+
     // 用于生成唯一临时通道名，避免并发请求冲突
     std::atomic<uint64_t> tmp_channel_seq_{0};
 };
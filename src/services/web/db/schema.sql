@@ -26,11 +26,15 @@ CREATE TABLE IF NOT EXISTS operators (
     UNIQUE(catelog, name)
 );
 
--- 任务记录表
+-- 任务记录表（status: queued / running / completed / failed / cancelled，job_id 为 Scheduler 异步作业 ID，
+-- upstream 为执行该作业的 Scheduler 实例地址，多实例时用于把后续请求固定转发到同一实例）
 CREATE TABLE IF NOT EXISTS tasks (
     id INTEGER PRIMARY KEY AUTOINCREMENT,
     sql_text TEXT NOT NULL,
     status TEXT NOT NULL DEFAULT 'pending',
+    job_id INTEGER NOT NULL DEFAULT 0,
+    upstream TEXT DEFAULT '',
+    row_count INTEGER NOT NULL DEFAULT 0,
     result_json TEXT DEFAULT '',
     error_msg TEXT DEFAULT '',
     created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
@@ -6,6 +6,9 @@
 
 #include <cstdio>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
 #include <unistd.h>
 #include <sys/stat.h>
@@ -42,6 +45,9 @@ CREATE TABLE IF NOT EXISTS tasks (
     id INTEGER PRIMARY KEY AUTOINCREMENT,
     sql_text TEXT NOT NULL,
     status TEXT NOT NULL DEFAULT 'pending',
+    job_id INTEGER NOT NULL DEFAULT 0,
+    upstream TEXT DEFAULT '',
+    row_count INTEGER NOT NULL DEFAULT 0,
     result_json TEXT DEFAULT '',
     error_msg TEXT DEFAULT '',
     created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
@@ -62,11 +68,11 @@ void WebServer::SetSchedulerAddress(const std::string& host, int port) {
 }
 
 void WebServer::NotifyWorkerReload() {
-    // 通过 Gateway 转发 reload 请求到 Python Worker
+    // 通过 Gateway 转发 reload 请求到 Python Worker，Worker 池中每个实例都要重新扫描算子目录
     httplib::Client client(worker_host_, worker_port_);
     client.set_connection_timeout(2);
     client.set_read_timeout(5);
-    auto result = client.Post("/pyworker/reload", "", "application/json");
+    auto result = client.Post("/pyworker/reload", httplib::Headers{{"X-Upstream", "*"}}, "", "application/json");
     if (result && result->status == 200) {
         printf("WebServer: Worker reload OK\n");
     } else {
@@ -78,7 +84,9 @@ void WebServer::NotifySchedulerRefresh() {
     httplib::Client client(scheduler_host_, scheduler_port_);
     client.set_connection_timeout(2);
     client.set_read_timeout(5);
-    auto result = client.Post("/scheduler/refresh-operators", "", "application/json");
+    // 多实例部署时由 Gateway 广播给每个 Scheduler 实例
+    auto result = client.Post("/scheduler/refresh-operators", httplib::Headers{{"X-Upstream", "*"}}, "",
+                              "application/json");
     if (result && result->status == 200) {
         printf("WebServer: Scheduler refresh OK\n");
     } else {
@@ -98,7 +106,28 @@ int WebServer::Init(const std::string& db_path) {
         return -1;
     }
 
+    // 旧库迁移：tasks 表补充异步作业列
+    bool has_job_id = false;
+    bool has_upstream = false;
+    for (auto& row : db_.Query("PRAGMA table_info(tasks)")) {
+        for (auto& [k, v] : row) {
+            if (k == "name" && v == "job_id") has_job_id = true;
+            if (k == "name" && v == "upstream") has_upstream = true;
+        }
+    }
+    if (!has_job_id &&
+        (db_.Execute("ALTER TABLE tasks ADD COLUMN job_id INTEGER NOT NULL DEFAULT 0") != 0 ||
+         db_.Execute("ALTER TABLE tasks ADD COLUMN row_count INTEGER NOT NULL DEFAULT 0") != 0)) {
+        printf("WebServer::Init: failed to migrate tasks table\n");
+        return -1;
+    }
+    if (!has_upstream && db_.Execute("ALTER TABLE tasks ADD COLUMN upstream TEXT DEFAULT ''") != 0) {
+        printf("WebServer::Init: failed to migrate tasks table\n");
+        return -1;
+    }
+
     RegisterRoutes();
+    if (!refresh_thread_.joinable()) refresh_thread_ = std::thread(&WebServer::RefreshLoop, this);
 
     printf("WebServer::Init: OK (db=%s)\n", db_path.c_str());
     return 0;
@@ -115,6 +144,12 @@ int WebServer::Start(const std::string& host, int port) {
 
 void WebServer::Stop() {
     server_.stop();
+    {
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+        refresh_stop_ = true;
+    }
+    refresh_cv_.notify_all();
+    if (refresh_thread_.joinable()) refresh_thread_.join();
 }
 
 void WebServer::RegisterRoutes() {
@@ -159,15 +194,30 @@ void WebServer::RegisterRoutes() {
     server_.Post("/api/tasks", [this](const httplib::Request& req, httplib::Response& res) {
         HandleCreateTask(req, res);
     });
+    server_.Get(R"(/api/tasks/(\d+))",
+        [this](const httplib::Request& req, httplib::Response& res) {
+            HandleGetTask(req, res);
+        });
     server_.Get(R"(/api/tasks/(\d+)/result)",
         [this](const httplib::Request& req, httplib::Response& res) {
             HandleGetTaskResult(req, res);
         });
+    server_.Get(R"(/api/tasks/(\d+)/stream)",
+        [this](const httplib::Request& req, httplib::Response& res) {
+            HandleStreamTaskResult(req, res);
+        });
+    server_.Post(R"(/api/tasks/(\d+)/cancel)",
+        [this](const httplib::Request& req, httplib::Response& res) {
+            HandleCancelTask(req, res);
+        });
 
     // 数据库通道动态管理（Epic 6）
     server_.Get("/api/db-channels", [this](const httplib::Request& req, httplib::Response& res) {
         HandleListDbChannels(req, res);
     });
+    server_.Get("/api/db-channels/stats", [this](const httplib::Request& req, httplib::Response& res) {
+        HandleDbChannelStats(req, res);
+    });
     server_.Post("/api/db-channels/add", [this](const httplib::Request& req, httplib::Response& res) {
         HandleAddDbChannel(req, res);
     });
@@ -390,10 +440,214 @@ void WebServer::HandleDeactivateOperator(const httplib::Request& req, httplib::R
     res.set_content(buf.GetString(), "application/json");
 }
 
+// 辅助：转发请求到 Scheduler（/execute、/jobs/*、/db-channels/*）
+static httplib::Result ForwardToScheduler(const std::string& host, int port,
+                                           const std::string& path,
+                                           const std::string& method,
+                                           const std::string& body = "",
+                                           const httplib::Params& params = {},
+                                           const httplib::Headers& headers = {}) {
+    httplib::Client client(host, port);
+    client.set_connection_timeout(3);
+    client.set_read_timeout(10);
+    if (method == "GET") {
+        return client.Get(path, params, headers);
+    }
+    return client.Post(path, headers, body, "application/json");
+}
+
+// Scheduler 多实例时作业只存在于提交它的实例上：创建任务时记下 Gateway 返回的 X-Upstream，
+// 后续状态 / 取消 / 结果请求带上同一个值，由 Gateway 固定转发到该实例
+static httplib::Headers PinUpstream(const std::string& upstream) {
+    if (upstream.empty()) return {};
+    return {{"X-Upstream", upstream}};
+}
+
+// 控制面变更（数据库通道增删改）需要所有 Scheduler 实例生效，由 Gateway 广播
+static const httplib::Headers kBroadcastUpstream = {{"X-Upstream", "*"}};
+
+static std::string FindColumn(const Row& row, const char* name) {
+    for (auto& [k, v] : row) {
+        if (k == name) return v;
+    }
+    return "";
+}
+
+static bool IsTaskFinished(const std::string& status) {
+    return status == "completed" || status == "failed" || status == "cancelled";
+}
+
+// 结果流格式 → 媒体类型，不支持的格式返回 nullptr
+static const char* StreamContentType(const std::string& format) {
+    if (format == "ndjson") return "application/x-ndjson";
+    if (format == "arrow") return "application/vnd.apache.arrow.stream";
+    if (format == "feather") return "application/vnd.apache.arrow.file";
+    return nullptr;
+}
+
+// 客户端要求的结果流格式：?format= 优先，其次按 Accept 头识别 Arrow / NDJSON 媒体类型，都没有时返回空串
+static std::string RequestedStreamFormat(const httplib::Request& req) {
+    if (req.has_param("format")) return req.get_param_value("format");
+    std::string accept = req.get_header_value("Accept");
+    if (accept.find("application/vnd.apache.arrow.stream") != std::string::npos) return "arrow";
+    if (accept.find("application/vnd.apache.arrow.file") != std::string::npos) return "feather";
+    if (accept.find("application/x-ndjson") != std::string::npos) return "ndjson";
+    return "";
+}
+
+// Scheduler 结果流在接收线程与下游 content provider 之间的交接状态
+// 200 响应体经有界队列转交（满时暂停接收，形成背压）；错误响应体很小，不受队列上限约束
+struct RelayState {
+    static constexpr size_t kMaxQueuedBytes = 4 << 20;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool headers_ready = false;
+    bool finished = false;
+    bool failed = false;
+    bool aborted = false;  // 下游已断开或响应已写完，接收线程停止接收
+    int status = 0;
+    std::string content_type;
+    std::deque<std::string> chunks;
+    size_t queued_bytes = 0;
+    std::thread receiver;
+
+    // 取下一块：1 取到，0 上游已正常结束，-1 上游中途失败
+    int Pull(std::string* chunk) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return !chunks.empty() || finished; });
+        if (chunks.empty()) return failed ? -1 : 0;
+        *chunk = std::move(chunks.front());
+        chunks.pop_front();
+        queued_bytes -= chunk->size();
+        cv.notify_all();
+        return 1;
+    }
+
+    void Abort() {
+        std::lock_guard<std::mutex> lock(mutex);
+        aborted = true;
+        chunks.clear();
+        queued_bytes = 0;
+        cv.notify_all();
+    }
+};
+
+// 把 Scheduler 的结果流按块原样转发给客户端：Arrow IPC 二进制不解码，本端也不缓存整个结果
+// 先等到 Scheduler 的响应头再决定状态码：非 200（作业被淘汰、参数非法等）连同响应体原样返回，200 才转为分块流式回写
+static void RelaySchedulerStream(httplib::Response& res, const std::string& host, int port,
+                                 const std::string& path, const char* content_type,
+                                 const httplib::Headers& headers = {}) {
+    res.set_header("Vary", "Accept");
+    auto state = std::make_shared<RelayState>();
+    state->receiver = std::thread([state, host, port, path, headers] {
+        httplib::Client client(host, port);
+        client.set_connection_timeout(3);
+        client.set_read_timeout(60);
+        auto result = client.Get(
+            path, headers,
+            [&](const httplib::Response& r) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->status = r.status;
+                state->content_type = r.get_header_value("Content-Type");
+                state->headers_ready = true;
+                state->cv.notify_all();
+                return true;
+            },
+            [&](const char* data, size_t len) {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->cv.wait(lock, [&] {
+                    return state->aborted || state->status != 200 || state->queued_bytes < RelayState::kMaxQueuedBytes;
+                });
+                if (state->aborted) return false;
+                state->chunks.emplace_back(data, len);
+                state->queued_bytes += len;
+                state->cv.notify_all();
+                return true;
+            });
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->finished = true;
+        state->failed = !result;
+        state->cv.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&] { return state->headers_ready || state->finished; });
+    if (!state->headers_ready || state->status != 200) {
+        state->cv.wait(lock, [&] { return state->finished; });
+        lock.unlock();
+        state->receiver.join();
+        if (!state->headers_ready) {
+            res.status = 502;
+            res.set_content(R"({"error":"failed to reach scheduler"})", "application/json");
+            return;
+        }
+        std::string body;
+        for (auto& chunk : state->chunks) body += chunk;
+        res.status = state->status;
+        res.set_content(std::move(body), state->content_type.empty() ? "application/json" : state->content_type);
+        return;
+    }
+    lock.unlock();
+
+    // 响应结束或下游断开时停止接收并回收接收线程
+    res.set_chunked_content_provider(
+        content_type,
+        [state](size_t, httplib::DataSink& sink) {
+            std::string chunk;
+            int rc = state->Pull(&chunk);
+            if (rc < 0) return false;
+            if (rc == 0) {
+                sink.done();
+                return true;
+            }
+            return sink.write(chunk.data(), chunk.size());
+        },
+        [state](bool) {
+            state->Abort();
+            if (state->receiver.joinable()) state->receiver.join();
+        });
+}
+
 // --- Tasks ---
+// 任务异步执行：创建时提交到 Scheduler 作业队列并记录 job_id，
+// 未结束任务的作业状态由后台刷新线程拉取并落库；单个任务的详情 / 取消 / 结果接口仍在请求内即时刷新
+static constexpr int kTaskRefreshIntervalMs = 1000;
+
+void WebServer::RefreshLoop() {
+    std::unique_lock<std::mutex> lock(refresh_mutex_);
+    while (!refresh_stop_) {
+        refresh_cv_.wait_for(lock, std::chrono::milliseconds(kTaskRefreshIntervalMs),
+                             [this] { return refresh_stop_ || refresh_wake_; });
+        if (refresh_stop_) break;
+        refresh_wake_ = false;
+        lock.unlock();
+        auto active = db_.Query("SELECT id FROM tasks WHERE status IN ('queued', 'running')");
+        for (auto& row : active) {
+            RefreshTask(FindColumn(row, "id"));
+            std::lock_guard<std::mutex> stop_lock(refresh_mutex_);
+            if (refresh_stop_) break;
+        }
+        lock.lock();
+    }
+}
+
+void WebServer::WakeRefresher() {
+    {
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+        refresh_wake_ = true;
+    }
+    refresh_cv_.notify_one();
+}
+
+// 列表只读本地 tasks 表，未结束任务的状态最多滞后一个刷新周期；请求同时唤醒刷新线程尽快拉取
 void WebServer::HandleGetTasks(const httplib::Request&, httplib::Response& res) {
     SetCorsHeaders(res);
-    auto rows = db_.Query("SELECT id, sql_text, status, error_msg, created_at, finished_at FROM tasks ORDER BY id DESC");
+    WakeRefresher();
+
+    auto rows = db_.Query(
+        "SELECT id, sql_text, status, job_id, row_count, error_msg, created_at, finished_at "
+        "FROM tasks ORDER BY id DESC");
     res.set_content(RowsToJson(rows), "application/json");
 }
 
@@ -411,28 +665,25 @@ void WebServer::HandleCreateTask(const httplib::Request& req, httplib::Response&
     std::string sql_text = doc["sql"].GetString();
 
     // 创建任务记录
-    int64_t task_id = db_.InsertParams("INSERT INTO tasks (sql_text, status) VALUES (?1, 'running')", {sql_text});
+    int64_t task_id = db_.InsertParams("INSERT INTO tasks (sql_text, status) VALUES (?1, 'queued')", {sql_text});
     if (task_id < 0) {
         res.status = 500;
         res.set_content(R"({"error":"failed to create task"})", "application/json");
         return;
     }
 
-    // 转发到 Scheduler 执行
-    httplib::Client client(scheduler_host_, scheduler_port_);
-    client.set_connection_timeout(5);
-    client.set_read_timeout(30);
-
-    // 构造转发请求体
+    // 提交到 Scheduler 作业队列，立即返回，不等待执行完成
     rapidjson::StringBuffer fwd_buf;
     rapidjson::Writer<rapidjson::StringBuffer> fwd_w(fwd_buf);
     fwd_w.StartObject();
     fwd_w.Key("sql");
     fwd_w.String(sql_text.c_str());
+    fwd_w.Key("async");
+    fwd_w.Bool(true);
     fwd_w.EndObject();
 
-    auto result = client.Post("/scheduler/execute", fwd_buf.GetString(), "application/json");
-
+    auto result = ForwardToScheduler(scheduler_host_, scheduler_port_, "/scheduler/execute", "POST",
+                                     fwd_buf.GetString());
     if (!result) {
         // 网络错误
         std::string err = "scheduler unreachable";
@@ -444,12 +695,12 @@ void WebServer::HandleCreateTask(const httplib::Request& req, httplib::Response&
         return;
     }
 
-    // 解析 Scheduler 响应
     rapidjson::Document sched_doc;
     sched_doc.Parse(result->body.c_str());
-
-    if (result->status != 200) {
-        // Scheduler 返回错误
+    bool accepted = result->status == 202 && !sched_doc.HasParseError() &&
+                    sched_doc.HasMember("job_id") && sched_doc["job_id"].IsUint64();
+    if (!accepted) {
+        // SQL 语法错误（400）或作业队列已满（503）
         std::string err = "scheduler error";
         if (!sched_doc.HasParseError() && sched_doc.HasMember("error") && sched_doc["error"].IsString()) {
             err = sched_doc["error"].GetString();
@@ -457,50 +708,155 @@ void WebServer::HandleCreateTask(const httplib::Request& req, httplib::Response&
         db_.ExecuteParams(
             "UPDATE tasks SET status='failed', error_msg=?1, finished_at=CURRENT_TIMESTAMP WHERE id=?2",
             {err, std::to_string(task_id)});
-        res.status = result->status;
+        res.status = result->status == 202 ? 502 : result->status;
         res.set_content(MakeErrorJson(err, task_id), "application/json");
         return;
     }
 
-    // Scheduler 执行成功，提取结果
-    std::string result_json = "[]";
-    int row_count = 0;
-    if (!sched_doc.HasParseError()) {
-        if (sched_doc.HasMember("data")) {
-            // 将 data 字段序列化为 JSON 字符串存入数据库
-            rapidjson::StringBuffer data_buf;
-            rapidjson::Writer<rapidjson::StringBuffer> data_w(data_buf);
-            sched_doc["data"].Accept(data_w);
-            result_json = data_buf.GetString();
-        }
-        if (sched_doc.HasMember("rows") && sched_doc["rows"].IsInt()) {
-            row_count = sched_doc["rows"].GetInt();
-        }
+    uint64_t job_id = sched_doc["job_id"].GetUint64();
+    std::string status = "queued";
+    if (sched_doc.HasMember("status") && sched_doc["status"].IsString()) {
+        status = sched_doc["status"].GetString();
     }
+    db_.ExecuteParams("UPDATE tasks SET job_id=?1, status=?2, upstream=?3 WHERE id=?4",
+                      {std::to_string(job_id), status, result->get_header_value("X-Upstream"),
+                       std::to_string(task_id)});
 
-    // 更新任务状态
-    db_.ExecuteParams(
-        "UPDATE tasks SET status='completed', result_json=?1, finished_at=CURRENT_TIMESTAMP WHERE id=?2",
-        {result_json, std::to_string(task_id)});
-
-    // 返回结果
     rapidjson::StringBuffer buf;
     rapidjson::Writer<rapidjson::StringBuffer> w(buf);
     w.StartObject();
     w.Key("task_id");
     w.Int64(task_id);
+    w.Key("job_id");
+    w.Uint64(job_id);
     w.Key("status");
-    w.String("completed");
-    w.Key("rows");
-    w.Int(row_count);
+    w.String(status.c_str());
+    w.EndObject();
+    res.status = 202;
+    res.set_content(buf.GetString(), "application/json");
+}
+
+// 从 Scheduler 拉取未结束任务的作业状态并写回 tasks 表
+// 返回 Scheduler 的作业状态 JSON（含 batches / bytes / elapsed_ms 等实时进度），任务已结束或拉取失败返回空串
+std::string WebServer::RefreshTask(const std::string& task_id) {
+    auto rows = db_.QueryParams("SELECT status, job_id, upstream FROM tasks WHERE id=?1", {task_id});
+    if (rows.empty()) return "";
+    std::string status = FindColumn(rows[0], "status");
+    std::string job_id = FindColumn(rows[0], "job_id");
+    if (IsTaskFinished(status) || job_id.empty() || job_id == "0") return "";
+
+    auto result = ForwardToScheduler(scheduler_host_, scheduler_port_, "/scheduler/jobs/" + job_id, "GET", "", {},
+                                     PinUpstream(FindColumn(rows[0], "upstream")));
+    if (!result) return "";  // Scheduler 暂不可达，保留原状态下次再试
+    if (result->status == 404) {
+        // Scheduler 重启或作业已被淘汰，结果无法再取回
+        db_.ExecuteParams(
+            "UPDATE tasks SET status='failed', error_msg=?1, finished_at=CURRENT_TIMESTAMP WHERE id=?2",
+            {"job " + job_id + " no longer exists on scheduler", task_id});
+        return "";
+    }
+
+    rapidjson::Document job;
+    job.Parse(result->body.c_str());
+    if (result->status != 200 || job.HasParseError() || !job.HasMember("status") || !job["status"].IsString()) {
+        return "";
+    }
+    std::string job_status = job["status"].GetString();
+    std::string row_count = job.HasMember("rows") && job["rows"].IsInt64()
+                                ? std::to_string(job["rows"].GetInt64()) : "0";
+
+    if (job_status == "completed") {
+        // 结果保留在 Scheduler 的结果游标中，按需分页拉取，不再整体落库
+        db_.ExecuteParams(
+            "UPDATE tasks SET status='completed', row_count=?1, finished_at=CURRENT_TIMESTAMP WHERE id=?2",
+            {row_count, task_id});
+    } else if (job_status == "failed" || job_status == "cancelled") {
+        std::string err = job.HasMember("error") && job["error"].IsString() ? job["error"].GetString() : "";
+        db_.ExecuteParams(
+            "UPDATE tasks SET status=?1, row_count=?2, error_msg=?3, finished_at=CURRENT_TIMESTAMP WHERE id=?4",
+            {job_status, row_count, err, task_id});
+    } else {
+        db_.ExecuteParams("UPDATE tasks SET status=?1, row_count=?2 WHERE id=?3", {job_status, row_count, task_id});
+    }
+    return result->body;
+}
+
+void WebServer::HandleGetTask(const httplib::Request& req, httplib::Response& res) {
+    SetCorsHeaders(res);
+    std::string task_id = req.matches[1];
+    std::string progress = RefreshTask(task_id);
+    auto rows = db_.QueryParams(
+        "SELECT id, sql_text, status, job_id, row_count, error_msg, created_at, finished_at "
+        "FROM tasks WHERE id=?1", {task_id});
+    if (rows.empty()) {
+        res.status = 404;
+        res.set_content(R"({"error":"task not found"})", "application/json");
+        return;
+    }
+
+    rapidjson::StringBuffer buf;
+    rapidjson::Writer<rapidjson::StringBuffer> w(buf);
+    w.StartObject();
+    for (auto& [k, v] : rows[0]) {
+        w.Key(k.c_str());
+        w.String(v.c_str());
+    }
+    // 运行中的任务附带 Scheduler 的实时进度
+    if (!progress.empty()) {
+        w.Key("progress");
+        w.RawValue(progress.c_str(), progress.size(), rapidjson::kObjectType);
+    }
     w.EndObject();
     res.set_content(buf.GetString(), "application/json");
 }
 
+void WebServer::HandleCancelTask(const httplib::Request& req, httplib::Response& res) {
+    SetCorsHeaders(res);
+    std::string task_id = req.matches[1];
+    auto rows = db_.QueryParams("SELECT status, job_id, upstream FROM tasks WHERE id=?1", {task_id});
+    if (rows.empty()) {
+        res.status = 404;
+        res.set_content(R"({"error":"task not found"})", "application/json");
+        return;
+    }
+    std::string status = FindColumn(rows[0], "status");
+    std::string job_id = FindColumn(rows[0], "job_id");
+    if (IsTaskFinished(status) || job_id.empty() || job_id == "0") {
+        res.status = 409;
+        res.set_content(MakeErrorJson("task already " + status), "application/json");
+        return;
+    }
+
+    auto result = ForwardToScheduler(scheduler_host_, scheduler_port_,
+                                     "/scheduler/jobs/" + job_id + "/cancel", "POST", "", {},
+                                     PinUpstream(FindColumn(rows[0], "upstream")));
+    if (!result) {
+        res.status = 502;
+        res.set_content(R"({"error":"failed to reach scheduler"})", "application/json");
+        return;
+    }
+
+    // 排队中的作业立即取消；运行中的作业在下一批边界退出，此时状态可能仍为 running
+    RefreshTask(task_id);
+    auto updated = db_.QueryParams("SELECT status FROM tasks WHERE id=?1", {task_id});
+    rapidjson::StringBuffer buf;
+    rapidjson::Writer<rapidjson::StringBuffer> w(buf);
+    w.StartObject();
+    w.Key("task_id"); w.Int64(std::stoll(task_id));
+    w.Key("status"); w.String(updated.empty() ? status.c_str() : FindColumn(updated[0], "status").c_str());
+    w.EndObject();
+    res.set_content(buf.GetString(), "application/json");
+}
+
+// 任务结果分页：?offset=&limit=（默认每页 kDefaultPageRows 行）&layout=rows|columns，从 Scheduler 结果游标按页拉取
+// Accept: application/vnd.apache.arrow.stream（或 ?format=arrow）时改为透传 Arrow IPC 流
 void WebServer::HandleGetTaskResult(const httplib::Request& req, httplib::Response& res) {
+    static constexpr const char* kDefaultPageRows = "1000";
     SetCorsHeaders(res);
     std::string task_id = req.matches[1];
-    auto rows = db_.QueryParams("SELECT status, result_json, error_msg FROM tasks WHERE id=?1", {task_id});
+    RefreshTask(task_id);
+    auto rows = db_.QueryParams(
+        "SELECT status, job_id, upstream, row_count, result_json, error_msg FROM tasks WHERE id=?1", {task_id});
     if (rows.empty()) {
         res.status = 404;
         res.set_content(R"({"error":"task not found"})", "application/json");
@@ -508,23 +864,64 @@ void WebServer::HandleGetTaskResult(const httplib::Request& req, httplib::Respon
     }
 
     auto& row = rows[0];
-    std::string status, result_json, error_msg;
-    for (auto& [k, v] : row) {
-        if (k == "status") status = v;
-        else if (k == "result_json") result_json = v;
-        else if (k == "error_msg") error_msg = v;
+    std::string status = FindColumn(row, "status");
+    std::string job_id = FindColumn(row, "job_id");
+    std::string row_count = FindColumn(row, "row_count");
+    std::string result_json = FindColumn(row, "result_json");
+    httplib::Headers pin = PinUpstream(FindColumn(row, "upstream"));
+
+    if (status == "failed" || status == "cancelled") {
+        res.set_content(MakeErrorJson(FindColumn(row, "error_msg")), "application/json");
+        return;
     }
 
-    if (status == "failed") {
-        res.set_content(MakeErrorJson(error_msg), "application/json");
+    if (status == "completed" && result_json.empty() && !job_id.empty() && job_id != "0") {
+        // 二进制 / NDJSON 结果直接透传 Scheduler 的输出，offset / limit 仍然生效
+        std::string format = RequestedStreamFormat(req);
+        if (!format.empty() && format != "json") {
+            const char* content_type = StreamContentType(format);
+            if (!content_type) {
+                res.status = 400;
+                res.set_content(R"({"error":"invalid format, expected json / ndjson / arrow / feather"})",
+                                "application/json");
+                return;
+            }
+            httplib::Params params = req.params;
+            params.erase("format");
+            params.emplace("format", format);
+            RelaySchedulerStream(res, scheduler_host_, scheduler_port_,
+                                 httplib::append_query_params("/scheduler/jobs/" + job_id + "/result", params),
+                                 content_type, pin);
+            return;
+        }
+
+        httplib::Params params;
+        params.emplace("offset", req.has_param("offset") ? req.get_param_value("offset") : "0");
+        params.emplace("limit", req.has_param("limit") ? req.get_param_value("limit") : kDefaultPageRows);
+        if (req.has_param("layout")) params.emplace("layout", req.get_param_value("layout"));
+        auto result = ForwardToScheduler(scheduler_host_, scheduler_port_,
+                                         "/scheduler/jobs/" + job_id + "/result", "GET", "", params, pin);
+        if (!result) {
+            res.status = 502;
+            res.set_content(R"({"error":"failed to reach scheduler"})", "application/json");
+            return;
+        }
+        if (result->status == 404) {
+            res.status = 410;
+            res.set_content(MakeErrorJson("result expired on scheduler"), "application/json");
+            return;
+        }
+        res.status = result->status;
+        res.set_content(result->body, "application/json");
         return;
     }
 
-    // 直接返回存储的 result_json
+    // 旧任务直接返回落库的 result_json；未结束的任务 data 为空，调用方按 status 继续轮询
     rapidjson::StringBuffer buf;
     rapidjson::Writer<rapidjson::StringBuffer> w(buf);
     w.StartObject();
     w.Key("status"); w.String(status.c_str());
+    w.Key("rows"); w.Int64(row_count.empty() ? 0 : std::stoll(row_count));
     w.Key("data"); w.RawValue(result_json.empty() ? "[]" : result_json.c_str(),
                                result_json.empty() ? 2 : result_json.size(),
                                rapidjson::kArrayType);
@@ -532,22 +929,44 @@ void WebServer::HandleGetTaskResult(const httplib::Request& req, httplib::Respon
     res.set_content(buf.GetString(), "application/json");
 }
 
-// ==================== 数据库通道动态管理（Epic 6）====================
+// 任务结果流式下载：?format=ndjson（默认）|arrow|feather 或 Accept 头，边从 Scheduler 接收边分块转发
+void WebServer::HandleStreamTaskResult(const httplib::Request& req, httplib::Response& res) {
+    SetCorsHeaders(res);
+    std::string task_id = req.matches[1];
+    RefreshTask(task_id);
+    auto rows = db_.QueryParams("SELECT status, job_id, upstream FROM tasks WHERE id=?1", {task_id});
+    if (rows.empty()) {
+        res.status = 404;
+        res.set_content(R"({"error":"task not found"})", "application/json");
+        return;
+    }
+    std::string status = FindColumn(rows[0], "status");
+    std::string job_id = FindColumn(rows[0], "job_id");
+    if (status != "completed" || job_id.empty() || job_id == "0") {
+        res.status = 409;
+        res.set_content(MakeErrorJson("task is " + status), "application/json");
+        return;
+    }
 
-// 辅助：转发请求到 Scheduler 的 /db-channels/* 端点
-static httplib::Result ForwardToScheduler(const std::string& host, int port,
-                                           const std::string& path,
-                                           const std::string& method,
-                                           const std::string& body = "") {
-    httplib::Client client(host, port);
-    client.set_connection_timeout(3);
-    client.set_read_timeout(10);
-    if (method == "GET") {
-        return client.Get(path);
+    std::string format = RequestedStreamFormat(req);
+    if (format.empty()) format = "ndjson";
+    const char* content_type = StreamContentType(format);
+    if (!content_type) {
+        res.status = 400;
+        res.set_content(R"({"error":"invalid format, expected ndjson / arrow / feather"})", "application/json");
+        return;
     }
-    return client.Post(path, body, "application/json");
+
+    httplib::Params params = req.params;
+    params.erase("format");
+    params.emplace("format", format);
+    RelaySchedulerStream(res, scheduler_host_, scheduler_port_,
+                         httplib::append_query_params("/scheduler/jobs/" + job_id + "/result", params),
+                         content_type, PinUpstream(FindColumn(rows[0], "upstream")));
 }
 
+// ==================== 数据库通道动态管理（Epic 6）====================
+
 void WebServer::HandleListDbChannels(const httplib::Request&, httplib::Response& res) {
     SetCorsHeaders(res);
     auto result = ForwardToScheduler(scheduler_host_, scheduler_port_,
@@ -560,10 +979,23 @@ void WebServer::HandleListDbChannels(const httplib::Request&, httplib::Response&
     }
 }
 
+void WebServer::HandleDbChannelStats(const httplib::Request&, httplib::Response& res) {
+    SetCorsHeaders(res);
+    auto result = ForwardToScheduler(scheduler_host_, scheduler_port_,
+                                     "/scheduler/db-channels/stats", "GET");
+    if (result && result->status == 200) {
+        res.set_content(result->body, "application/json");
+    } else {
+        res.status = 502;
+        res.body = R"({"error":"failed to reach scheduler"})";
+    }
+}
+
 void WebServer::HandleAddDbChannel(const httplib::Request& req, httplib::Response& res) {
     SetCorsHeaders(res);
     auto result = ForwardToScheduler(scheduler_host_, scheduler_port_,
-                                     "/scheduler/db-channels/add", "POST", req.body);
+                                     "/scheduler/db-channels/add", "POST", req.body, {},
+                                     kBroadcastUpstream);
     if (result) {
         res.status = result->status;
         res.body = result->body;
@@ -576,7 +1008,8 @@ void WebServer::HandleAddDbChannel(const httplib::Request& req, httplib::Respons
 void WebServer::HandleRemoveDbChannel(const httplib::Request& req, httplib::Response& res) {
     SetCorsHeaders(res);
     auto result = ForwardToScheduler(scheduler_host_, scheduler_port_,
-                                     "/scheduler/db-channels/remove", "POST", req.body);
+                                     "/scheduler/db-channels/remove", "POST", req.body, {},
+                                     kBroadcastUpstream);
     if (result) {
         res.status = result->status;
         res.body = result->body;
@@ -589,7 +1022,8 @@ void WebServer::HandleRemoveDbChannel(const httplib::Request& req, httplib::Resp
 void WebServer::HandleUpdateDbChannel(const httplib::Request& req, httplib::Response& res) {
     SetCorsHeaders(res);
     auto result = ForwardToScheduler(scheduler_host_, scheduler_port_,
-                                     "/scheduler/db-channels/update", "POST", req.body);
+                                     "/scheduler/db-channels/update", "POST", req.body, {},
+                                     kBroadcastUpstream);
     if (result) {
         res.status = result->status;
         res.body = result->body;
@@ -3,8 +3,11 @@
 
 #include <httplib.h>
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "db/database.h"
 
@@ -15,7 +18,7 @@ namespace web {
 class WebServer {
  public:
     WebServer();
-    ~WebServer() = default;
+    ~WebServer() { Stop(); }
 
     // 初始化：打开数据库、注册路由
     int Init(const std::string& db_path);
@@ -47,10 +50,21 @@ class WebServer {
     void HandleDeactivateOperator(const httplib::Request& req, httplib::Response& res);
     void HandleGetTasks(const httplib::Request& req, httplib::Response& res);
     void HandleCreateTask(const httplib::Request& req, httplib::Response& res);
+    void HandleGetTask(const httplib::Request& req, httplib::Response& res);
     void HandleGetTaskResult(const httplib::Request& req, httplib::Response& res);
+    void HandleStreamTaskResult(const httplib::Request& req, httplib::Response& res);
+    void HandleCancelTask(const httplib::Request& req, httplib::Response& res);
+
+    // 从 Scheduler 拉取未结束任务的作业状态并写回 tasks 表
+    std::string RefreshTask(const std::string& task_id);
+
+    // 后台刷新线程：周期性（或被任务列表请求唤醒时）刷新全部未结束任务，列表接口只读本地表
+    void RefreshLoop();
+    void WakeRefresher();
 
     // 数据库通道动态管理（Epic 6）
     void HandleListDbChannels(const httplib::Request& req, httplib::Response& res);
+    void HandleDbChannelStats(const httplib::Request& req, httplib::Response& res);
     void HandleAddDbChannel(const httplib::Request& req, httplib::Response& res);
     void HandleRemoveDbChannel(const httplib::Request& req, httplib::Response& res);
     void HandleUpdateDbChannel(const httplib::Request& req, httplib::Response& res);
@@ -67,6 +81,12 @@ class WebServer {
     int worker_port_ = 18900;
     std::string scheduler_host_ = "127.0.0.1";
     int scheduler_port_ = 18800;  // 默认指向 Gateway
+
+    std::thread refresh_thread_;
+    std::mutex refresh_mutex_;
+    std::condition_variable refresh_cv_;
+    bool refresh_stop_ = false;
+    bool refresh_wake_ = false;
 };
 
 }  // namespace web
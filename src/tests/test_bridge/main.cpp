@@ -1,12 +1,19 @@
+#include <atomic>
 #include <cstdio>
 #include <cstring>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <unistd.h>
+
 #include <arrow/api.h>
 
 #include "services/bridge/arrow_ipc_serializer.h"
+#include "services/bridge/python_operator_bridge.h"
+#include "services/bridge/shm_ring.h"
+#include "services/bridge/worker_pool.h"
 #include "framework/core/dataframe.h"
 
 using namespace flowsql;
@@ -217,6 +224,196 @@ int test_error_handling() {
     return 0;
 }
 
+// ============================================================
+// 测试 5: 共享内存环（回绕、满、跨映射可见）
+// ============================================================
+int test_shm_ring() {
+    printf("\n=== Test: Shared Memory Ring ===\n");
+
+    std::string path = "/tmp/flowsql_test_ring_" + std::to_string(getpid());
+    ShmRing producer;
+    if (producer.Create(path, 4096) != 0) {
+        printf("FAIL: Create returned -1\n");
+        return -1;
+    }
+    // 对端通过文件名映射，之后即可删除文件名
+    ShmRing consumer;
+    if (consumer.Open(path) != 0 || consumer.Capacity() != 4096) {
+        printf("FAIL: Open returned -1\n");
+        return -1;
+    }
+    producer.Unlink();
+
+    if (producer.Reserve(RingDirection::REQUEST, 4096) != nullptr) {
+        printf("FAIL: Reserve larger than capacity should return null\n");
+        return -1;
+    }
+
+    // 多轮写读，记录长度不整齐，迫使 payload 跨过数据区末尾时写 PAD 回绕
+    int total = 0;
+    for (int round = 0; round < 20; ++round) {
+        int written = 0;
+        while (true) {
+            std::string msg = "msg" + std::to_string(total + written) + std::string((total + written) * 37 % 900, 'x');
+            uint8_t* slot = producer.Reserve(RingDirection::REQUEST, msg.size());
+            if (!slot) break;
+            memcpy(slot, msg.data(), msg.size());
+            producer.Commit(RingDirection::REQUEST);
+            ++written;
+        }
+        if (written == 0) {
+            printf("FAIL: ring full with no pending records (round %d)\n", round);
+            return -1;
+        }
+        for (int i = 0; i < written; ++i) {
+            const uint8_t* data = nullptr;
+            size_t len = 0;
+            std::string expected = "msg" + std::to_string(total + i) + std::string((total + i) * 37 % 900, 'x');
+            if (consumer.Peek(RingDirection::REQUEST, &data, &len) != 0 ||
+                std::string(reinterpret_cast<const char*>(data), len) != expected) {
+                printf("FAIL: record %d mismatch\n", total + i);
+                return -1;
+            }
+            if (reinterpret_cast<uintptr_t>(data) % 8 != 0) {
+                printf("FAIL: payload not 8-byte aligned\n");
+                return -1;
+            }
+            consumer.Release(RingDirection::REQUEST);
+        }
+        total += written;
+    }
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+    if (consumer.Peek(RingDirection::REQUEST, &data, &len) != -1 ||
+        consumer.Peek(RingDirection::RESPONSE, &data, &len) != -1) {
+        printf("FAIL: ring should be empty\n");
+        return -1;
+    }
+
+    printf("PASS: Shared memory ring OK (%d records)\n", total);
+    return 0;
+}
+
+// ============================================================
+// 测试 6: Worker 池按在途调用数分派
+// ============================================================
+int test_worker_pool() {
+    printf("\n=== Test: Worker Pool ===\n");
+
+    WorkerPool pool;
+    if (pool.Acquire() != nullptr) {
+        printf("FAIL: empty pool should return null\n");
+        return -1;
+    }
+    std::vector<std::shared_ptr<PythonWorker>> workers;
+    for (int i = 0; i < 3; ++i) workers.push_back(std::make_shared<PythonWorker>("127.0.0.1", 18900 + i, nullptr));
+    pool.Reset(workers);
+
+    // 3 个并发调用应落到 3 个不同的 Worker
+    std::vector<std::shared_ptr<PythonWorker>> held;
+    for (int i = 0; i < 3; ++i) held.push_back(pool.Acquire());
+    for (auto& worker : workers) {
+        if (worker->inflight.load() != 1) {
+            printf("FAIL: worker %d has %d in-flight calls, expected 1\n", worker->port, worker->inflight.load());
+            return -1;
+        }
+    }
+    // 释放一个后，下一次调用应落到它上面
+    pool.Release(held[1], false);
+    auto next = pool.Acquire();
+    if (next != held[1]) {
+        printf("FAIL: expected least-loaded worker %d, got %d\n", held[1]->port, next->port);
+        return -1;
+    }
+    pool.Release(next, false);
+    for (int i = 0; i < 3; ++i) {
+        if (i != 1) pool.Release(held[i], false);
+    }
+
+    // 不可达的 Worker 暂停分派，exclude 的 Worker 不被选中
+    auto lost = pool.Acquire();
+    pool.Release(lost, true);
+    for (int i = 0; i < 10; ++i) {
+        auto worker = pool.Acquire(workers[0].get());
+        if (worker == lost || worker == workers[0]) {
+            printf("FAIL: picked unreachable or excluded worker %d\n", worker->port);
+            return -1;
+        }
+        pool.Release(worker, false);
+    }
+
+    // Reset 时传入 Find 返回的旧对象，成员保持同一实例
+    auto kept = pool.Find("127.0.0.1", 18901);
+    pool.Reset({kept});
+    if (pool.Size() != 1 || pool.Acquire() != kept) {
+        printf("FAIL: pool should keep the reused worker\n");
+        return -1;
+    }
+
+    printf("PASS: Worker pool OK\n");
+    return 0;
+}
+
+// ============================================================
+// 测试 7: 同一算子实例被并发调用，错误按调用隔离
+// ============================================================
+int test_concurrent_errors() {
+    printf("\n=== Test: Concurrent Operator Errors ===\n");
+
+    // 端口 1 无人监听：连接立即被拒绝，走文件 + HTTP 通道失败
+    auto pool = std::make_shared<WorkerPool>();
+    pool->Reset({std::make_shared<PythonWorker>("127.0.0.1", 1, nullptr)});
+    OperatorMeta meta;
+    meta.catelog = "test";
+    meta.name = "concurrent";
+    PythonOperatorBridge bridge(meta, pool);
+    PythonOperatorBridge other(meta, pool);
+
+    auto schema = arrow::schema({arrow::field("id", arrow::int32())});
+    arrow::Int32Builder builder;
+    (void)builder.AppendValues({1, 2, 3});
+    auto input = arrow::RecordBatch::Make(schema, 3, {*builder.Finish()});
+
+    // 两个线程各自以不同原因失败，各自只能看到自己的错误
+    const std::string read_error = "read operator input failed";
+    const std::string http_error = "HTTP POST to Python Worker failed (connection error)";
+    std::atomic<int> mismatches{0};
+    BatchSink emit = [](const std::shared_ptr<arrow::RecordBatch>&) { return 0; };
+    auto run = [&](bool fail_read, const std::string& expected) {
+        for (int i = 0; i < 200; ++i) {
+            bool sent = false;
+            BatchSource next = [&](std::shared_ptr<arrow::RecordBatch>* batch) {
+                if (fail_read) return -1;
+                if (sent) return 1;
+                sent = true;
+                *batch = input;
+                return 0;
+            };
+            if (bridge.WorkBatches(next, emit) == 0 || bridge.LastError() != expected ||
+                !other.LastError().empty()) {
+                mismatches++;
+            }
+        }
+    };
+    std::thread reader_thread(run, true, read_error);
+    std::thread http_thread(run, false, http_error);
+    reader_thread.join();
+    http_thread.join();
+
+    if (mismatches.load() != 0) {
+        printf("FAIL: %d calls saw another call's error\n", mismatches.load());
+        return -1;
+    }
+    // 本线程没有调用过，不应看到其他线程的错误
+    if (!bridge.LastError().empty()) {
+        printf("FAIL: main thread sees error: %s\n", bridge.LastError().c_str());
+        return -1;
+    }
+
+    printf("PASS: Concurrent operator errors OK\n");
+    return 0;
+}
+
 // ============================================================
 int main() {
     printf("========================================\n");
@@ -228,6 +425,9 @@ int main() {
     if (test_dataframe_ipc_roundtrip() != 0) failures++;
     if (test_empty_batch() != 0) failures++;
     if (test_error_handling() != 0) failures++;
+    if (test_shm_ring() != 0) failures++;
+    if (test_worker_pool() != 0) failures++;
+    if (test_concurrent_errors() != 0) failures++;
 
     printf("\n========================================\n");
     if (failures == 0) {
@@ -1007,6 +1007,197 @@ void test_injection_error_distinction() {
     printf("[PASS] T21: injection error distinction\n");
 }
 
+// ============================================================
+// T22: keep-alive 连接池 — 小语句突发、池满退化为临时连接、Disconnect 后存量 Session 仍可用
+// ============================================================
+void test_keep_alive_pool() {
+    printf("[TEST] ClickHouse: keep-alive client pool...\n");
+
+    auto params = GetClickHouseParams();
+    params["max_connections"] = "2";  // 故意小于并发线程数，验证池满时不报错
+    ClickHouseDriver driver;
+    assert(driver.Connect(params) == 0);
+
+    const int THREADS = 6;
+    const int QUERIES = 50;
+    std::atomic<int> fail_count{0};
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < THREADS; ++i) {
+        threads.emplace_back([&driver, &fail_count]() {
+            // 一半请求复用同一 Session（会话粘滞连接），一半每次新建 Session（走连接池）
+            auto sticky = driver.CreateSession();
+            for (int q = 0; q < QUERIES; ++q) {
+                auto session = (q % 2 == 0) ? sticky : driver.CreateSession();
+                std::string err;
+                if (!session || session->ExecuteSql("SELECT 1", &err) != 0) fail_count++;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start).count();
+    printf("  %d short statements in %lld ms\n", THREADS * QUERIES, static_cast<long long>(ms));
+    assert(fail_count == 0);
+
+    // Disconnect 后已创建的 Session 仍持有连接池，可继续使用
+    auto session = driver.CreateSession();
+    assert(session != nullptr);
+    driver.Disconnect();
+    std::string error;
+    assert(session->ExecuteSql("SELECT 1", &error) == 0);
+    assert(driver.CreateSession() == nullptr);
+
+    g_passed++;
+    printf("[PASS] T22: keep-alive client pool\n");
+}
+
+// ============================================================
+// T23: 流式读取 — CreateReader 边接收边解码，读完计数正确；中途 Cancel 立即返回
+// ============================================================
+void test_streaming_reader() {
+    printf("[TEST] ClickHouse: streaming ArrowStream reader...\n");
+
+    ClickHouseDriver driver;
+    assert(driver.Connect(GetClickHouseParams()) == 0);
+    auto session = driver.CreateSession();
+    auto* readable = dynamic_cast<IBatchReadable*>(session.get());
+    assert(readable != nullptr);
+
+    // 1. 完整读取：max_block_size 使服务端分多个 block 返回
+    const int64_t ROWS = 1000000;
+    std::string sql = "SELECT number AS id, toString(number) AS s FROM numbers(" + std::to_string(ROWS) +
+                      ") SETTINGS max_block_size = 65536";
+    IBatchReader* reader = nullptr;
+    assert(readable->CreateReader(sql.c_str(), &reader) == 0);
+    auto* fast = dynamic_cast<IRecordBatchReader*>(reader);
+    assert(fast != nullptr);
+
+    const uint8_t* schema_buf = nullptr;
+    size_t schema_len = 0;
+    assert(reader->GetSchema(&schema_buf, &schema_len) == 0 && schema_len > 0);
+
+    int64_t total_rows = 0;
+    int batch_count = 0;
+    std::shared_ptr<arrow::RecordBatch> batch;
+    int rc;
+    while ((rc = fast->NextBatch(&batch)) == 0) {
+        assert(batch->num_columns() == 2);
+        total_rows += batch->num_rows();
+        ++batch_count;
+    }
+    assert(rc == 1);
+    assert(total_rows == ROWS);
+    assert(batch_count > 1);
+    printf("  Streamed %lld rows in %d batches\n", static_cast<long long>(total_rows), batch_count);
+    reader->Close();
+    reader->Release();
+
+    // 2. 中途取消：读一个 batch 后 Cancel，后续 NextBatch 返回错误而不是读完全部响应
+    std::string big = "SELECT number FROM numbers(1000000000) SETTINGS max_block_size = 65536";
+    assert(readable->CreateReader(big.c_str(), &reader) == 0);
+    fast = dynamic_cast<IRecordBatchReader*>(reader);
+    assert(fast->NextBatch(&batch) == 0);
+    auto start = std::chrono::steady_clock::now();
+    reader->Cancel();
+    while ((rc = fast->NextBatch(&batch)) == 0) {}
+    assert(rc < 0);
+    assert(strcmp(reader->GetLastError(), "read cancelled") == 0);
+    reader->Close();
+    reader->Release();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start).count();
+    printf("  Cancelled mid-stream in %lld ms\n", static_cast<long long>(ms));
+
+    // 3. 未读完直接 Release：后台线程被中止并回收
+    assert(readable->CreateReader(big.c_str(), &reader) == 0);
+    reader->Release();
+
+    // 取消后的连接已丢弃，Session 仍可正常使用
+    std::string error;
+    assert(session->ExecuteSql("SELECT 1", &error) == 0);
+
+    g_passed++;
+    printf("[PASS] T23: streaming ArrowStream reader\n");
+}
+
+// ============================================================
+// T24: 分片并发 + 压缩写入 — 按 insert_part_rows 拆分并发 INSERT，sum 校验每行恰好写入一次
+// ============================================================
+void test_parallel_compressed_write() {
+    printf("[TEST] ClickHouse: parallel compressed write...\n");
+
+    // 非法压缩参数在 Connect 时报错
+    {
+        auto params = GetClickHouseParams();
+        params["insert_compression"] = "snappy";
+        ClickHouseDriver bad;
+        assert(bad.Connect(params) != 0);
+        assert(strstr(bad.LastError(), "insert_compression") != nullptr);
+    }
+
+    // 50000 行分 7 个 batch，insert_part_rows=10000 → 拆成 4 个分片（受 insert_parallel_parts 限制），
+    // 分片边界落在 batch 中间，验证 Slice 拆分不丢不重
+    const int N = 50000;
+    const int BATCHES = 7;
+    auto schema = arrow::schema({arrow::field("id", arrow::int64()), arrow::field("val", arrow::utf8())});
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    int64_t next_id = 0;
+    for (int b = 0; b < BATCHES; ++b) {
+        int64_t rows = (b + 1 == BATCHES) ? N - next_id : N / BATCHES;
+        arrow::Int64Builder  b_id;
+        arrow::StringBuilder b_val;
+        for (int64_t i = 0; i < rows; ++i, ++next_id) {
+            (void)b_id.Append(next_id);
+            (void)b_val.Append("row_" + std::to_string(next_id % 100));
+        }
+        std::shared_ptr<arrow::Array> a_id, a_val;
+        (void)b_id.Finish(&a_id);
+        (void)b_val.Finish(&a_val);
+        batches.push_back(arrow::RecordBatch::Make(schema, rows, {a_id, a_val}));
+    }
+
+    for (const char* compression : {"none", "lz4", "zstd"}) {
+        auto params = GetClickHouseParams();
+        params["insert_compression"] = compression;
+        params["insert_parallel_parts"] = "4";
+        params["insert_part_rows"] = "10000";
+        ClickHouseDriver driver;
+        assert(driver.Connect(params) == 0);
+        auto session = driver.CreateSession();
+
+        std::string table = UniqueTable("ch_test_parallel");
+        DropTableIfExists(session.get(), table);
+        std::string error;
+        assert(session->ExecuteSql(
+            ("CREATE TABLE " + table + " (id Int64, val String) ENGINE = MergeTree() ORDER BY id").c_str(),
+            &error) == 0);
+
+        auto start = std::chrono::steady_clock::now();
+        int rc = session->WriteArrowBatches(table.c_str(), batches, &error);
+        if (rc != 0) printf("  error: %s\n", error.c_str());
+        assert(rc == 0);
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - start).count();
+
+        std::vector<std::shared_ptr<arrow::RecordBatch>> result;
+        assert(session->ExecuteQueryArrow(
+            ("SELECT count(), uniqExact(id), sum(id) FROM " + table).c_str(), &result, &error) == 0);
+        auto count = std::static_pointer_cast<arrow::UInt64Array>(result[0]->column(0))->Value(0);
+        auto uniq = std::static_pointer_cast<arrow::UInt64Array>(result[0]->column(1))->Value(0);
+        auto sum = std::static_pointer_cast<arrow::Int64Array>(result[0]->column(2))->Value(0);
+        assert(count == static_cast<uint64_t>(N));
+        assert(uniq == static_cast<uint64_t>(N));
+        assert(sum == static_cast<int64_t>(N) * (N - 1) / 2);
+        printf("  compression=%s: %d rows in %lld ms\n", compression, N, static_cast<long long>(ms));
+
+        DropTableIfExists(session.get(), table);
+    }
+
+    g_passed++;
+    printf("[PASS] T24: parallel compressed write\n");
+}
+
 // ============================================================
 // main
 // ============================================================
@@ -1020,7 +1211,7 @@ int main() {
     if (!IsClickHouseAvailable()) {
         printf("\n[SKIP] ClickHouse not available, skipping T1/T4-T16\n");
         printf("  Set CH_HOST/CH_PORT/CH_USER/CH_PASSWORD/CH_DATABASE to enable\n");
-        g_skipped += 14;
+        g_skipped += 17;
     } else {
         test_connect_disconnect();
         test_ddl();
@@ -1041,6 +1232,9 @@ int main() {
         test_nullable_null_handling();
         test_multi_batch_write();
         test_injection_error_distinction();
+        test_keep_alive_pool();
+        test_streaming_reader();
+        test_parallel_compressed_write();
     }
 
     printf("\n=== Results: %d passed, %d skipped ===\n", g_passed, g_skipped);
@@ -130,7 +130,7 @@ void test_pool_idle_timeout() {
     config.health_check_interval = std::chrono::seconds(60);
 
     int create_count = 0;
-    int close_count = 0;
+    std::atomic<int> close_count{0};  // reaper 线程也会关闭连接
 
     auto factory = [&create_count](std::string* error) -> int {
         return ++create_count;
@@ -164,7 +164,7 @@ void test_pool_idle_timeout() {
 
     // 验证关闭计数
     assert(close_count >= 1);
-    printf("  Connections closed: %d\n", close_count);
+    printf("  Connections closed: %d\n", close_count.load());
 
     printf("[PASS] Connection pool: idle timeout\n");
 }
@@ -183,8 +183,8 @@ void test_pool_health_check() {
     config.health_check_interval = std::chrono::seconds(1);
 
     int create_count = 0;
-    int close_count = 0;
-    int ping_fail_count = 0;
+    std::atomic<int> close_count{0};  // reaper 线程也会关闭连接
+    std::atomic<int> ping_fail_count{0};
 
     auto factory = [&create_count](std::string* error) -> int {
         return ++create_count;
@@ -194,7 +194,7 @@ void test_pool_health_check() {
         close_count++;
     };
 
-    int check_count = 0;
+    std::atomic<int> check_count{0};
     auto pinger = [&ping_fail_count, &check_count](int conn) -> bool {
         // 模拟连接失效：第 1 次检查就失败
         check_count++;
@@ -209,13 +209,18 @@ void test_pool_health_check() {
     assert(pool.Acquire(&conn1, nullptr));
     pool.Return(conn1);
 
-    // 等待健康检查间隔：health_check_interval=1s，since_check >= 1s 即触发，等 1100ms
-    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    // 健康检查由后台 reaper 完成：since_check >= 1s 后的下一轮扫描（周期 250ms）触发，等 1600ms
+    std::this_thread::sleep_for(std::chrono::milliseconds(1600));
+
+    // Acquire 之前 reaper 已 Ping 失败并关闭旧连接
+    assert(ping_fail_count >= 1);
+    assert(close_count >= 1);
+    assert(pool.GetStats().total_connections == 0);
 
     // 再次获取，应创建新连接（健康检查失败）
     int conn2;
     assert(pool.Acquire(&conn2, nullptr));
-    printf("  Got connection %d (old was %d, ping_fail=%d)\n", conn2, conn1, ping_fail_count);
+    printf("  Got connection %d (old was %d, ping_fail=%d)\n", conn2, conn1, ping_fail_count.load());
 
     pool.Return(conn2);
 
@@ -409,6 +414,183 @@ void test_pool_concurrent_stats() {
     printf("[PASS] Connection pool: concurrent stats consistency\n");
 }
 
+// ============================================================
+// Test 8: 池满等待 — 其他线程归还后被唤醒；无人归还时按 acquire_timeout 超时失败
+// ============================================================
+void test_pool_acquire_wait() {
+    printf("[TEST] Connection pool: acquire wait with timeout...\n");
+
+    ConnectionPoolConfig config;
+    config.max_connections = 1;
+    config.min_connections = 0;
+    config.idle_timeout = std::chrono::seconds(300);
+    config.health_check_interval = std::chrono::seconds(60);
+    config.acquire_timeout = std::chrono::milliseconds(300);
+
+    int create_count = 0;
+    auto factory = [&create_count](std::string* error) -> int { return ++create_count; };
+    auto closer = [](int conn) {};
+    auto pinger = [](int conn) -> bool { return true; };
+
+    ConnectionPool<int> pool(config, factory, closer, pinger);
+
+    int conn1;
+    assert(pool.Acquire(&conn1, nullptr));
+
+    // ① 无人归还：等待约 acquire_timeout 后失败
+    auto start = std::chrono::steady_clock::now();
+    int conn2;
+    std::string error;
+    assert(!pool.Acquire(&conn2, &error));
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - start).count();
+    assert(waited >= 250);
+    assert(error.find("exhausted") != std::string::npos);
+    printf("  Timed out after %lld ms: %s\n", static_cast<long long>(waited), error.c_str());
+
+    // ② 另一线程 100ms 后归还：等待方被唤醒并拿到同一连接
+    std::thread returner([&pool, conn1]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        pool.Return(conn1);
+    });
+    start = std::chrono::steady_clock::now();
+    assert(pool.Acquire(&conn2, nullptr));
+    waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - start).count();
+    returner.join();
+    assert(conn2 == conn1);
+    assert(waited < 300);
+    printf("  Woken after %lld ms with connection %d\n", static_cast<long long>(waited), conn2);
+
+    // ③ Discard 释放名额同样唤醒等待方，并新建连接
+    std::thread discarder([&pool, conn2]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        pool.Discard(conn2);
+    });
+    int conn3;
+    assert(pool.Acquire(&conn3, nullptr));
+    discarder.join();
+    assert(conn3 != conn2);
+    pool.Return(conn3);
+    assert(create_count == 2);
+
+    printf("[PASS] Connection pool: acquire wait with timeout\n");
+}
+
+// ============================================================
+// Test 9: 后台回收 — 不调用 Acquire，超时空闲连接也会被 reaper 关闭
+// ============================================================
+void test_pool_background_reaper() {
+    printf("[TEST] Connection pool: background reaper...\n");
+
+    ConnectionPoolConfig config;
+    config.max_connections = 5;
+    config.min_connections = 3;
+    config.idle_timeout = std::chrono::seconds(1);
+    config.health_check_interval = std::chrono::seconds(60);
+
+    std::atomic<int> counter{0};
+    std::atomic<int> close_count{0};
+    auto factory = [&counter](std::string* error) -> int { return ++counter; };
+    auto closer = [&close_count](int conn) { close_count++; };
+    auto pinger = [](int conn) -> bool { return true; };
+
+    ConnectionPool<int> pool(config, factory, closer, pinger);
+    assert(pool.GetStats().available_connections == 3);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1600));
+
+    auto stats = pool.GetStats();
+    assert(stats.total_connections == 0);
+    assert(close_count == 3);
+    printf("  Reaped %d idle connections without Acquire\n", close_count.load());
+
+    printf("[PASS] Connection pool: background reaper\n");
+}
+
+// ============================================================
+// Test 10: 预热与 min_idle — Warmup 并行建连；空闲回收后 reaper 自动补齐；指标计数正确
+// ============================================================
+void test_pool_warmup_min_idle() {
+    printf("[TEST] Connection pool: warmup, min_idle and metrics...\n");
+
+    ConnectionPoolConfig config;
+    config.max_connections = 8;
+    config.min_connections = 0;
+    config.idle_timeout = std::chrono::seconds(1);
+    config.health_check_interval = std::chrono::seconds(60);
+    config.min_idle = 4;
+
+    std::atomic<int> counter{0};
+    auto factory = [&counter](std::string* error) -> int {
+        // 模拟 50ms 建连开销：并行预热总耗时应远小于 4 × 50ms
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return ++counter;
+    };
+    auto closer = [](int conn) {};
+    auto pinger = [](int conn) -> bool { return true; };
+
+    ConnectionPool<int> pool(config, factory, closer, pinger);
+
+    auto start = std::chrono::steady_clock::now();
+    std::string error;
+    assert(pool.Warmup(&error) == 4);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start).count();
+    assert(ms < 150);
+    assert(pool.GetStats().available_connections == 4);
+    // 已达到 min_idle，再次预热不新建
+    assert(pool.Warmup(&error) == 0);
+    printf("  Warmed up 4 connections in %lld ms\n", static_cast<long long>(ms));
+
+    // 取用预热连接无需等待，也不再建连
+    int conn;
+    assert(pool.Acquire(&conn, nullptr));
+    pool.Return(conn);
+    assert(counter == 4);
+
+    // 超过 idle_timeout 后旧连接被回收，reaper 补齐到 min_idle
+    std::this_thread::sleep_for(std::chrono::milliseconds(1800));
+    auto metrics = pool.GetMetrics();
+    assert(metrics.idle_evictions >= 4);
+    assert(metrics.idle_connections == 4);
+    assert(counter >= 8);
+    printf("  After idle eviction: idle=%d, evicted=%llu, connects=%llu\n",
+           metrics.idle_connections, static_cast<unsigned long long>(metrics.idle_evictions),
+           static_cast<unsigned long long>(metrics.connects));
+
+    assert(metrics.acquires == 1);
+    assert(metrics.wait_histogram[0] == 1);  // 直接取到空闲连接，落在 <1ms 桶
+    assert(metrics.connect_avg_ms >= 40);
+    assert(metrics.connect_max_ms >= metrics.connect_avg_ms);
+    assert(metrics.max_connections == 8);
+
+    printf("[PASS] Connection pool: warmup, min_idle and metrics\n");
+}
+
+// ============================================================
+// Test 11: ApplyPoolParams — 驱动参数覆盖默认值，min_idle 不超过 max_connections
+// ============================================================
+void test_pool_apply_params() {
+    printf("[TEST] Connection pool: ApplyPoolParams...\n");
+
+    ConnectionPoolConfig config;
+    ApplyPoolParams({{"max_connections", "4"}, {"min_idle", "9"}, {"warmup_on_open", "true"},
+                     {"acquire_timeout_ms", "250"}, {"idle_timeout", "30"}},
+                    &config);
+    assert(config.max_connections == 4);
+    assert(config.min_idle == 4);
+    assert(config.warmup_on_open);
+    assert(config.acquire_timeout == std::chrono::milliseconds(250));
+    assert(config.idle_timeout == std::chrono::seconds(30));
+
+    ConnectionPoolConfig defaults;
+    ApplyPoolParams({}, &defaults);
+    assert(defaults.max_connections == 10 && defaults.min_idle == 0 && !defaults.warmup_on_open);
+
+    printf("[PASS] Connection pool: ApplyPoolParams\n");
+}
+
 // ============================================================
 // main
 // ============================================================
@@ -422,6 +604,10 @@ int main() {
     test_pool_stats();
     test_pool_concurrency();
     test_pool_concurrent_stats();
+    test_pool_acquire_wait();
+    test_pool_background_reaper();
+    test_pool_warmup_min_idle();
+    test_pool_apply_params();
 
     printf("\n=== All connection pool tests passed ===\n");
     return 0;
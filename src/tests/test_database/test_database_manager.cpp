@@ -590,6 +590,51 @@ void test_password_restart_decrypt_clickhouse() {
     printf("[PASS] TQ-B4b: ClickHouse password channel restart decrypt\n");
 }
 
+// ============================================================
+// TQ-F4: warmup_on_open 预热连接池，Stats() 导出连接池指标
+// ============================================================
+void test_warmup_and_pool_stats() {
+    printf("[TEST] TQ-F4: warmup_on_open and pool Stats()...\n");
+
+    std::string yml = TmpYaml("tqf4");
+    RemoveFile(yml);
+
+    DatabasePlugin plugin;
+    plugin.Option(("config_file=" + yml).c_str());
+    plugin.Load(nullptr);
+    plugin.Start();
+
+    assert(plugin.AddChannel(
+        "type=sqlite;name=warmdb;path=:memory:;min_idle=3;warmup_on_open=true;max_connections=4") == 0);
+    assert(plugin.AddChannel("type=sqlite;name=colddb;path=:memory:") == 0);
+
+    // 未连接的通道不出现在 Stats 中
+    int count = 0;
+    plugin.Stats([&](const char*, const char*, const char*) { count++; });
+    assert(count == 0);
+
+    assert(plugin.Get("sqlite", "warmdb") != nullptr);
+    assert(plugin.Get("sqlite", "colddb") != nullptr);
+
+    std::string warm_json, cold_json;
+    plugin.Stats([&](const char* type, const char* name, const char* stats_json) {
+        assert(strcmp(type, "sqlite") == 0);
+        if (strcmp(name, "warmdb") == 0) warm_json = stats_json;
+        if (strcmp(name, "colddb") == 0) cold_json = stats_json;
+    });
+    printf("  warmdb: %s\n", warm_json.c_str());
+    // 预热后已有 3 条空闲连接，未预热的通道为 0
+    assert(warm_json.find("\"idle\":3") != std::string::npos);
+    assert(warm_json.find("\"connects\":3") != std::string::npos);
+    assert(warm_json.find("\"max\":4") != std::string::npos);
+    assert(warm_json.find("\"wait_ms_histogram\":{") != std::string::npos);
+    assert(cold_json.find("\"idle\":0") != std::string::npos);
+
+    RemoveFile(yml);
+    g_passed++;
+    printf("[PASS] TQ-F4: warmup_on_open and pool Stats()\n");
+}
+
 // ============================================================
 // main
 // ============================================================
@@ -925,7 +970,8 @@ int main() {
     test_restart_recovery_field_values();
     test_update_then_restart_recovery();
     test_add_channel_then_get();
+    test_warmup_and_pool_stats();
 
-    printf("\n=== Results: %d/20 passed ===\n", g_passed);
-    return (g_passed == 20) ? 0 : 1;
+    printf("\n=== Results: %d/21 passed ===\n", g_passed);
+    return (g_passed == 21) ? 0 : 1;
 }
@@ -687,6 +687,219 @@ void test_batch_large_write() {
     printf("[PASS] MySQL: large batch write\n");
 }
 
+// ============================================================
+// Test 11b: BatchWriter — 预编译语句绑定 NULL / 特殊字符 / 多种类型
+//           以及 LOAD DATA LOCAL INFILE 路径（服务端未开启 local_infile 时跳过）
+// ============================================================
+static std::shared_ptr<arrow::RecordBatch> MakeMixedBatch(int n) {
+    auto schema = arrow::schema({
+        arrow::field("id",   arrow::int32()),
+        arrow::field("big",  arrow::int64()),
+        arrow::field("f",    arrow::float32()),
+        arrow::field("name", arrow::utf8()),
+    });
+    arrow::Int32Builder  id_b;
+    arrow::Int64Builder  big_b;
+    arrow::FloatBuilder  f_b;
+    arrow::StringBuilder name_b;
+    for (int i = 0; i < n; ++i) {
+        id_b.Append(i);
+        if (i % 7 == 0) big_b.AppendNull(); else big_b.Append(int64_t(i) << 33);
+        f_b.Append(i * 0.5f);
+        if (i % 5 == 0) name_b.AppendNull();
+        else name_b.Append("it's a \\ \"quoted\"\ttab\nline " + std::to_string(i));
+    }
+    return arrow::RecordBatch::Make(schema, n, {
+        id_b.Finish().ValueOrDie(), big_b.Finish().ValueOrDie(),
+        f_b.Finish().ValueOrDie(), name_b.Finish().ValueOrDie(),
+    });
+}
+
+static void VerifyMixedTable(IDbSession* session, const char* table, int n) {
+    std::string error;
+    IResultSet* rs = nullptr;
+    std::string sql = std::string("SELECT COUNT(*), SUM(big IS NULL), SUM(name IS NULL) FROM ") + table;
+    assert(session->ExecuteQuery(sql.c_str(), &rs, &error) == 0 && rs->Next());
+    int64_t cnt, big_nulls, name_nulls;
+    rs->GetInt64(0, &cnt); rs->GetInt64(1, &big_nulls); rs->GetInt64(2, &name_nulls);
+    assert(cnt == n);
+    assert(big_nulls == (n + 6) / 7);
+    assert(name_nulls == (n + 4) / 5);
+    delete rs;
+
+    sql = std::string("SELECT big, name FROM ") + table + " WHERE id = 3";
+    assert(session->ExecuteQuery(sql.c_str(), &rs, &error) == 0 && rs->Next());
+    int64_t big; rs->GetInt64(0, &big);
+    assert(big == (int64_t(3) << 33));
+    const char* name; size_t len;
+    rs->GetString(1, &name, &len);
+    assert(std::string(name, len) == "it's a \\ \"quoted\"\ttab\nline 3");
+    delete rs;
+}
+
+void test_batch_writer_binary_protocol() {
+    printf("[TEST] MySQL: BatchWriter prepared INSERT (NULL / escapes / types)...\n");
+
+    MysqlDriver driver;
+    assert(driver.Connect(GetMysqlParams()) == 0);
+    auto session = driver.CreateSession();
+    DropTableIfExists(session.get(), "mysql_test_bind_write");
+
+    auto* writable = dynamic_cast<IBatchWritable*>(session.get());
+    const int N = 30000;  // 4 列 × 30000 行 > 65535 个参数，触发分块
+    auto buf = SerializeBatch(MakeMixedBatch(N));
+
+    IBatchWriter* writer = nullptr;
+    assert(writable->CreateWriter("mysql_test_bind_write", &writer) == 0 && writer != nullptr);
+    assert(writer->Write(buf->data(), static_cast<size_t>(buf->size())) == 0);
+    BatchWriteStats stats;
+    writer->Close(&stats);
+    assert(stats.rows_written == N);
+    writer->Release();
+
+    VerifyMixedTable(session.get(), "mysql_test_bind_write", N);
+
+    DropTableIfExists(session.get(), "mysql_test_bind_write");
+    driver.Disconnect();
+    g_passed++;
+    printf("[PASS] MySQL: BatchWriter prepared INSERT\n");
+}
+
+void test_batch_writer_local_infile() {
+    printf("[TEST] MySQL: BatchWriter LOAD DATA LOCAL INFILE...\n");
+
+    auto params = GetMysqlParams();
+    params["local_infile_min_rows"] = "100";
+    MysqlDriver driver;
+    assert(driver.Connect(params) == 0);
+    auto session = driver.CreateSession();
+    DropTableIfExists(session.get(), "mysql_test_infile_write");
+
+    auto* writable = dynamic_cast<IBatchWritable*>(session.get());
+    const int N = 1000;
+    auto buf = SerializeBatch(MakeMixedBatch(N));
+
+    IBatchWriter* writer = nullptr;
+    assert(writable->CreateWriter("mysql_test_infile_write", &writer) == 0 && writer != nullptr);
+    if (writer->Write(buf->data(), static_cast<size_t>(buf->size())) != 0) {
+        printf("[SKIP] LOAD DATA LOCAL INFILE unavailable: %s\n", writer->GetLastError());
+        writer->Release();
+        DropTableIfExists(session.get(), "mysql_test_infile_write");
+        driver.Disconnect();
+        g_skipped++;
+        return;
+    }
+    BatchWriteStats stats;
+    writer->Close(&stats);
+    assert(stats.rows_written == N);
+    writer->Release();
+
+    VerifyMixedTable(session.get(), "mysql_test_infile_write", N);
+
+    DropTableIfExists(session.get(), "mysql_test_infile_write");
+    driver.Disconnect();
+    g_passed++;
+    printf("[PASS] MySQL: BatchWriter LOAD DATA LOCAL INFILE\n");
+}
+
+// ============================================================
+// Test 11c: BatchReader — mysql_use_result 流式读取与取消
+// ============================================================
+static int64_t DrainReader(IBatchReader* reader) {
+    auto* batch_source = dynamic_cast<IRecordBatchReader*>(reader);
+    assert(batch_source != nullptr);
+    int64_t rows = 0;
+    std::shared_ptr<arrow::RecordBatch> batch;
+    int rc;
+    while ((rc = batch_source->NextBatch(&batch)) == 0) rows += batch->num_rows();
+    assert(rc == 1);
+    return rows;
+}
+
+void test_batch_reader_streaming() {
+    printf("[TEST] MySQL: BatchReader streaming (mysql_use_result) + Cancel...\n");
+
+    const int N = 200000;
+    MysqlDriver driver;
+    assert(driver.Connect(GetMysqlParams()) == 0);
+    assert(driver.StreamingRead());
+    {
+        auto session = driver.CreateSession();
+        DropTableIfExists(session.get(), "mysql_test_stream_read");
+        auto* writable = dynamic_cast<IBatchWritable*>(session.get());
+        IBatchWriter* writer = nullptr;
+        assert(writable->CreateWriter("mysql_test_stream_read", &writer) == 0);
+        assert(dynamic_cast<IRecordBatchWriter*>(writer)->WriteBatch(MakeMixedBatch(N)) == 0);
+        writer->Close(nullptr);
+        writer->Release();
+    }
+
+    // 完整流式读取：行数与 NULL 分布与写入一致
+    {
+        auto session = driver.CreateSession();
+        IBatchReader* reader = nullptr;
+        assert(dynamic_cast<IBatchReadable*>(session.get())->CreateReader(
+                   "SELECT * FROM mysql_test_stream_read", &reader) == 0);
+        assert(DrainReader(reader) == N);
+        reader->Close();
+        reader->Release();
+    }
+
+    // 读一批后取消：后续 NextBatch 返回错误，释放读取器不必读完剩余行
+    {
+        auto session = driver.CreateSession();
+        IBatchReader* reader = nullptr;
+        assert(dynamic_cast<IBatchReadable*>(session.get())->CreateReader(
+                   "SELECT * FROM mysql_test_stream_read", &reader) == 0);
+        auto* batch_source = dynamic_cast<IRecordBatchReader*>(reader);
+        std::shared_ptr<arrow::RecordBatch> batch;
+        assert(batch_source->NextBatch(&batch) == 0);
+        assert(batch->num_rows() < N);
+
+        reader->Cancel();
+        assert(batch_source->NextBatch(&batch) < 0);
+        assert(strstr(reader->GetLastError(), "cancelled") != nullptr);
+        reader->Close();
+        reader->Release();
+    }
+
+    // 取消后连接回到连接池仍可用
+    {
+        auto session = driver.CreateSession();
+        std::string error;
+        IResultSet* rs = nullptr;
+        assert(session->ExecuteQuery("SELECT COUNT(*) FROM mysql_test_stream_read", &rs, &error) == 0);
+        assert(rs->Next());
+        int64_t cnt; rs->GetInt64(0, &cnt);
+        assert(cnt == N);
+        delete rs;
+    }
+
+    // streaming_read=false 回退到 mysql_store_result，结果一致
+    {
+        auto params = GetMysqlParams();
+        params["streaming_read"] = "false";
+        MysqlDriver buffered;
+        assert(buffered.Connect(params) == 0 && !buffered.StreamingRead());
+        auto session = buffered.CreateSession();
+        IBatchReader* reader = nullptr;
+        assert(dynamic_cast<IBatchReadable*>(session.get())->CreateReader(
+                   "SELECT * FROM mysql_test_stream_read", &reader) == 0);
+        assert(DrainReader(reader) == N);
+        reader->Close();
+        reader->Release();
+        buffered.Disconnect();
+    }
+
+    {
+        auto session = driver.CreateSession();
+        DropTableIfExists(session.get(), "mysql_test_stream_read");
+    }
+    driver.Disconnect();
+    g_passed++;
+    printf("[PASS] MySQL: BatchReader streaming + Cancel\n");
+}
+
 // ============================================================
 // Test 12: 连接池复用
 // ============================================================
@@ -1179,6 +1392,9 @@ int main() {
     test_batch_writer();
     test_batch_writer_append();
     test_batch_large_write();
+    test_batch_writer_binary_protocol();
+    test_batch_writer_local_infile();
+    test_batch_reader_streaming();
     test_connection_pool_reuse();
     test_resultset_exhausted_state();
     test_error_nonexistent_table();
@@ -362,6 +362,144 @@ void test_batch_reader() {
     printf("[PASS] SQLite: BatchReader\n");
 }
 
+// ============================================================
+// Test 7b: BatchReader — 进程内 NextBatch + 按字节预算自适应批大小
+// ============================================================
+void test_batch_reader_adaptive() {
+    printf("[TEST] SQLite: BatchReader adaptive batch size...\n");
+
+    SqliteDriver driver;
+    std::unordered_map<std::string, std::string> params;
+    params["path"] = ":memory:";
+    assert(driver.Connect(params) == 0);
+
+    auto session = driver.CreateSession();
+    std::string error;
+    // wide：每行约 16KB 字符串；narrow：每行一个整数
+    assert(session->ExecuteSql("CREATE TABLE wide (id INTEGER, payload TEXT)", &error) == 0);
+    assert(session->ExecuteSql(
+        "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 2000) "
+        "INSERT INTO wide SELECT x, hex(zeroblob(8192)) FROM c", &error) == 0);
+    assert(session->ExecuteSql("CREATE TABLE narrow (id INTEGER)", &error) == 0);
+    assert(session->ExecuteSql(
+        "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 5000) "
+        "INSERT INTO narrow SELECT x FROM c", &error) == 0);
+
+    auto* readable = dynamic_cast<IBatchReadable*>(session.get());
+    assert(readable != nullptr);
+
+    auto read_all = [&](const char* sql, std::vector<int64_t>* batch_rows) {
+        IBatchReader* reader = nullptr;
+        assert(readable->CreateReader(sql, &reader) == 0 && reader != nullptr);
+        auto* batch_source = dynamic_cast<IRecordBatchReader*>(reader);
+        assert(batch_source != nullptr);
+        int64_t next_id = 1;
+        std::shared_ptr<arrow::RecordBatch> batch;
+        int rc;
+        while ((rc = batch_source->NextBatch(&batch)) == 0) {
+            // 复用的 Builder 每批都从头开始，数据连续不丢行
+            auto ids = std::static_pointer_cast<arrow::Int64Array>(batch->column(0));
+            assert(ids->Value(0) == next_id);
+            next_id += batch->num_rows();
+            batch_rows->push_back(batch->num_rows());
+        }
+        assert(rc == 1);
+        reader->Close();
+        reader->Release();
+        return next_id - 1;
+    };
+
+    std::vector<int64_t> wide_rows, narrow_rows;
+    assert(read_all("SELECT id, payload FROM wide ORDER BY id", &wide_rows) == 2000);
+    assert(read_all("SELECT id FROM narrow ORDER BY id", &narrow_rows) == 5000);
+
+    // 宽行：每批不超过约 8MB 字节预算（少于默认的 1024 行）
+    for (auto rows : wide_rows) assert(rows * 16384 <= 8 * 1024 * 1024 + 16384);
+    assert(wide_rows.size() >= 4);
+    // 窄行：首批 1024 行后批大小按行宽放大，剩余数据一批读完
+    assert(narrow_rows.size() == 2);
+    assert(narrow_rows[0] == 1024 && narrow_rows[1] == 5000 - 1024);
+    printf("  wide: %zu batches, narrow: %zu batches\n", wide_rows.size(), narrow_rows.size());
+
+    driver.Disconnect();
+    printf("[PASS] SQLite: BatchReader adaptive batch size\n");
+}
+
+// ============================================================
+// Test 7c: IArrowReadable — 原生读取器直接从 sqlite3_column_* 构建 RecordBatch
+// ============================================================
+void test_execute_query_arrow() {
+    printf("[TEST] SQLite: ExecuteQueryArrow native reader...\n");
+
+    SqliteDriver driver;
+    std::unordered_map<std::string, std::string> params;
+    params["path"] = ":memory:";
+    assert(driver.Connect(params) == 0);
+
+    auto session = driver.CreateSession();
+    std::string error;
+    session->ExecuteSql(
+        "CREATE TABLE native_t (id INTEGER, score REAL, ok BOOLEAN, name TEXT, raw BLOB)", &error);
+    session->ExecuteSql("BEGIN", &error);
+    for (int i = 0; i < 3000; ++i) {
+        std::string sql = "INSERT INTO native_t VALUES (" + std::to_string(i) + ", " +
+                          std::to_string(i) + ".5, " + std::to_string(i % 2) + ", ";
+        sql += (i % 10 == 0) ? "NULL, NULL)" : "'n" + std::to_string(i) + "', X'00FF')";
+        session->ExecuteSql(sql.c_str(), &error);
+    }
+    session->ExecuteSql("COMMIT", &error);
+
+    auto* arrow_readable = dynamic_cast<IArrowReadable*>(session.get());
+    assert(arrow_readable != nullptr);
+
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    assert(arrow_readable->ExecuteQueryArrow("SELECT * FROM native_t ORDER BY id", &batches, &error) == 0);
+    assert(!batches.empty());
+
+    auto schema = batches[0]->schema();
+    assert(schema->field(0)->type()->id() == arrow::Type::INT64);
+    assert(schema->field(1)->type()->id() == arrow::Type::DOUBLE);
+    assert(schema->field(2)->type()->id() == arrow::Type::BOOL);
+    assert(schema->field(3)->type()->id() == arrow::Type::STRING);
+    assert(schema->field(4)->type()->id() == arrow::Type::BINARY);
+
+    int64_t total = 0;
+    for (const auto& batch : batches) {
+        auto ids = std::static_pointer_cast<arrow::Int64Array>(batch->column(0));
+        auto scores = std::static_pointer_cast<arrow::DoubleArray>(batch->column(1));
+        auto oks = std::static_pointer_cast<arrow::BooleanArray>(batch->column(2));
+        auto names = std::static_pointer_cast<arrow::StringArray>(batch->column(3));
+        auto raws = std::static_pointer_cast<arrow::BinaryArray>(batch->column(4));
+        for (int64_t r = 0; r < batch->num_rows(); ++r) {
+            int64_t id = ids->Value(r);
+            assert(id == total + r);
+            assert(scores->Value(r) == id + 0.5);
+            assert(oks->Value(r) == (id % 2 == 1));
+            if (id % 10 == 0) {
+                assert(names->IsNull(r) && raws->IsNull(r));
+            } else {
+                assert(names->GetString(r) == "n" + std::to_string(id));
+                auto raw = raws->GetView(r);
+                assert(raw.size() == 2 && static_cast<uint8_t>(raw[0]) == 0x00 &&
+                       static_cast<uint8_t>(raw[1]) == 0xFF);
+            }
+        }
+        total += batch->num_rows();
+    }
+    assert(total == 3000);
+    size_t batch_count = batches.size();
+
+    // 错误 SQL 返回 -1 并带错误信息
+    batches.clear();
+    error.clear();
+    assert(arrow_readable->ExecuteQueryArrow("SELECT * FROM no_such_table", &batches, &error) == -1);
+    assert(!error.empty());
+
+    printf("  Read %lld rows in %zu batches\n", static_cast<long long>(total), batch_count);
+    driver.Disconnect();
+    printf("[PASS] SQLite: ExecuteQueryArrow\n");
+}
+
 // ============================================================
 // Test 8: BatchWriter — Arrow IPC 批量写入（自动建表）
 // ============================================================
@@ -487,6 +625,137 @@ void test_batch_writer_append() {
     printf("[PASS] SQLite: BatchWriter append\n");
 }
 
+// ============================================================
+// Test 9b: BatchWriter — 预编译 INSERT 批量写入（NULL/引号/BLOB 往返 + ingest PRAGMA 恢复）
+// ============================================================
+void test_batch_writer_bulk() {
+    printf("[TEST] SQLite: BatchWriter bulk insert via prepared statement...\n");
+
+    SqliteDriver driver;
+    std::unordered_map<std::string, std::string> params;
+    params["path"] = ":memory:";
+    params["ingest_pragmas"] = "true";
+    params["ingest_cache_mb"] = "16";
+    assert(driver.Connect(params) == 0);
+    assert(driver.IngestPragmas() && driver.IngestCacheKb() == 16 * 1024);
+
+    auto session = driver.CreateSession();
+    std::string error;
+
+    auto query_int64 = [&](const char* sql) -> int64_t {
+        IResultSet* rs = nullptr;
+        assert(session->ExecuteQuery(sql, &rs, &error) == 0 && rs != nullptr);
+        assert(rs->Next());
+        int64_t v = 0;
+        rs->GetInt64(0, &v);
+        delete rs;
+        return v;
+    };
+    int64_t sync_before = query_int64("PRAGMA synchronous");
+    int64_t cache_before = query_int64("PRAGMA cache_size");
+
+    auto schema = arrow::schema({
+        arrow::field("id", arrow::int32()),
+        arrow::field("big", arrow::int64()),
+        arrow::field("ratio", arrow::float64()),
+        arrow::field("flag", arrow::boolean()),
+        arrow::field("name", arrow::utf8()),
+        arrow::field("payload", arrow::binary()),
+    });
+
+    // 两批共 20000 行，每 7 行一个 NULL，字符串含单引号，BLOB 含 0x00
+    const int kBatchRows = 10000;
+    auto* writable = dynamic_cast<IBatchWritable*>(session.get());
+    IBatchWriter* writer = nullptr;
+    assert(writable->CreateWriter("bulk_t", &writer) == 0);
+    auto* record_writer = dynamic_cast<IRecordBatchWriter*>(writer);
+    assert(record_writer != nullptr);
+
+    for (int b = 0; b < 2; ++b) {
+        arrow::Int32Builder id_b;
+        arrow::Int64Builder big_b;
+        arrow::DoubleBuilder ratio_b;
+        arrow::BooleanBuilder flag_b;
+        arrow::StringBuilder name_b;
+        arrow::BinaryBuilder payload_b;
+        for (int i = 0; i < kBatchRows; ++i) {
+            int id = b * kBatchRows + i;
+            id_b.Append(id);
+            big_b.Append(static_cast<int64_t>(id) * 1000000007LL);
+            ratio_b.Append(id * 0.5);
+            flag_b.Append(id % 2 == 0);
+            if (id % 7 == 0) {
+                name_b.AppendNull();
+                payload_b.AppendNull();
+            } else {
+                name_b.Append("it's row " + std::to_string(id));
+                uint8_t bytes[3] = {0x00, static_cast<uint8_t>(id & 0xff), 0xff};
+                payload_b.Append(bytes, 3);
+            }
+        }
+        auto batch = arrow::RecordBatch::Make(schema, kBatchRows, {
+            id_b.Finish().ValueOrDie(), big_b.Finish().ValueOrDie(),
+            ratio_b.Finish().ValueOrDie(), flag_b.Finish().ValueOrDie(),
+            name_b.Finish().ValueOrDie(), payload_b.Finish().ValueOrDie(),
+        });
+        if (b == 0) {
+            auto buf = SerializeBatch(batch);
+            assert(writer->Write(buf->data(), static_cast<size_t>(buf->size())) == 0);
+            // 写入期间 PRAGMA 已切换
+            assert(query_int64("PRAGMA synchronous") == 0);
+            assert(query_int64("PRAGMA cache_size") == -16 * 1024);
+        } else {
+            assert(record_writer->WriteBatch(batch) == 0);
+        }
+    }
+
+    BatchWriteStats stats;
+    writer->Close(&stats);
+    assert(stats.rows_written == 2 * kBatchRows);
+    writer->Release();
+
+    // 提交后 PRAGMA 恢复原值
+    assert(query_int64("PRAGMA synchronous") == sync_before);
+    assert(query_int64("PRAGMA cache_size") == cache_before);
+
+    assert(query_int64("SELECT COUNT(*) FROM bulk_t") == 2 * kBatchRows);
+    assert(query_int64("SELECT COUNT(*) FROM bulk_t WHERE name IS NULL") == (2 * kBatchRows + 6) / 7);
+    assert(query_int64("SELECT big FROM bulk_t WHERE id = 19999") == 19999LL * 1000000007LL);
+    assert(query_int64("SELECT SUM(flag) FROM bulk_t") == kBatchRows);
+    assert(query_int64("SELECT COUNT(*) FROM bulk_t WHERE name = 'it''s row 12345'") == 1);
+    assert(query_int64("SELECT COUNT(*) FROM bulk_t WHERE payload = X'0039FF'") ==
+           query_int64("SELECT COUNT(*) FROM bulk_t WHERE id % 256 = 57 AND id % 7 != 0"));
+    assert(query_int64("SELECT length(payload) FROM bulk_t WHERE id = 1") == 3);
+
+    // 未 Close 即释放：事务回滚，PRAGMA 同样恢复
+    writer = nullptr;
+    assert(writable->CreateWriter("bulk_t", &writer) == 0);
+    {
+        arrow::Int32Builder id_b;
+        arrow::Int64Builder big_b;
+        arrow::DoubleBuilder ratio_b;
+        arrow::BooleanBuilder flag_b;
+        arrow::StringBuilder name_b;
+        arrow::BinaryBuilder payload_b;
+        id_b.Append(-1); big_b.Append(-1); ratio_b.Append(-1.0);
+        flag_b.Append(false); name_b.Append("discarded"); payload_b.AppendNull();
+        auto batch = arrow::RecordBatch::Make(schema, 1, {
+            id_b.Finish().ValueOrDie(), big_b.Finish().ValueOrDie(),
+            ratio_b.Finish().ValueOrDie(), flag_b.Finish().ValueOrDie(),
+            name_b.Finish().ValueOrDie(), payload_b.Finish().ValueOrDie(),
+        });
+        assert(dynamic_cast<IRecordBatchWriter*>(writer)->WriteBatch(batch) == 0);
+    }
+    writer->Release();
+    assert(query_int64("SELECT COUNT(*) FROM bulk_t") == 2 * kBatchRows);
+    assert(query_int64("PRAGMA synchronous") == sync_before);
+    printf("  Wrote %lld rows, pragmas restored (synchronous=%lld)\n",
+           stats.rows_written, sync_before);
+
+    driver.Disconnect();
+    printf("[PASS] SQLite: BatchWriter bulk insert\n");
+}
+
 // ============================================================
 // Test 10: 连接池复用
 // ============================================================
@@ -738,8 +1007,11 @@ int main() {
     test_transaction_commit();
     test_transaction_rollback();
     test_batch_reader();
+    test_batch_reader_adaptive();
+    test_execute_query_arrow();
     test_batch_writer();
     test_batch_writer_append();
+    test_batch_writer_bulk();
     test_connection_pool_reuse();
     test_resultset_exhausted_state();
     test_error_nonexistent_table();
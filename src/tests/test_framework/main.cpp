@@ -1,13 +1,19 @@
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cassert>
 #include <cstring>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <regex>
 
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
 #include <common/loader.hpp>
 #include <framework/core/channel_adapter.h>
+#include <framework/core/columnar_filter.h>
 #include <framework/core/dataframe.h>
 #include <framework/core/dataframe_channel.h>
 #include <framework/core/pipeline.h>
@@ -15,6 +21,8 @@
 #include <framework/interfaces/ichannel.h>
 #include <framework/interfaces/idataframe_channel.h>
 #include <framework/interfaces/ioperator.h>
+#include <services/scheduler/job_queue.h>
+#include <services/scheduler/result_writer.h>
 
 using namespace flowsql;
 
@@ -28,6 +36,10 @@ void test_sql_parser();
 void test_normalize_from_table_name();
 void test_channel_adapter_copy();
 void test_channel_type_constants();
+void test_dataframe_filter();
+void test_channel_adapter_transfer();
+void test_job_queue();
+void test_result_format();
 void test_pipeline(const std::string& plugin_dir);
 
 // ============================================================
@@ -119,6 +131,40 @@ void test_dataframe_json() {
     assert(std::get<uint32_t>(row[1]) == 8080);
     assert(std::get<bool>(row[2]) == true);
 
+    // 分页：offset 超出范围时裁剪，limit < 0 表示到末尾
+    DataFrame page;
+    assert(page.FromJson(df1.ToJson(1, 10)) && page.RowCount() == 1);
+    assert(std::get<std::string>(page.GetRow(0)[0]) == "10.0.0.2");
+    assert(page.FromJson(df1.ToJson(5, -1)) && page.RowCount() == 0);
+    assert(df1.ToJson(0, -1) == json);
+
+    // NDJSON：每行一个数组
+    assert(df1.ToNdjson(0, -1) == "[\"10.0.0.1\",8080,true]\n[\"10.0.0.2\",443,false]\n");
+    assert(df1.ToNdjson(1, 1) == "[\"10.0.0.2\",443,false]\n");
+    assert(df1.ToNdjson(2, 1).empty());
+
+    // 列式布局：{"col":[...]}，FromJson 可还原
+    std::string columnar = df1.ToJson(0, -1, JsonLayout::COLUMNS);
+    assert(columnar.find(R"("data":{"ip":["10.0.0.1","10.0.0.2"],"port":[8080,443],"active":[true,false]})") !=
+           std::string::npos);
+    DataFrame df3;
+    assert(df3.FromJson(columnar) && df3.RowCount() == 2);
+    assert(std::get<uint32_t>(df3.GetRow(1)[1]) == 443);
+
+    // 字符串转义、浮点最短往返表示、切片后的偏移
+    DataFrame df4;
+    df4.SetSchema({{"s", DataType::STRING, 0, ""}, {"d", DataType::DOUBLE, 0, ""}, {"f", DataType::FLOAT, 0, ""}});
+    df4.AppendRow({std::string("skip"), 0.0, 0.0f});
+    df4.AppendRow({std::string("a\"b\\c\n\x01"), 0.1, 0.1f});
+    df4.AppendRow({std::string("中文"), 1e300, -2.5f});
+    DataFrame sliced;
+    sliced.FromArrow(df4.ToArrow()->Slice(1, 2));
+    assert(sliced.ToNdjson(0, -1) == "[\"a\\\"b\\\\c\\n\\u0001\",0.1,0.1]\n[\"中文\",1e+300,-2.5]\n");
+    DataFrame df5;
+    assert(df5.FromJson(sliced.ToJson()) && df5.RowCount() == 2);
+    assert(std::get<std::string>(df5.GetRow(0)[0]) == "a\"b\\c\n\x01");
+    assert(std::get<double>(df5.GetRow(0)[1]) == 0.1 && std::get<float>(df5.GetRow(0)[2]) == 0.1f);
+
     printf("[PASS] DataFrame JSON serialization\n");
 }
 
@@ -360,6 +406,41 @@ void test_sql_parser() {
         assert(stmt.dest == "result");
     }
 
+    // WHERE 表达式树：优先级 NOT > AND > OR，同类连接词展平
+    {
+        auto stmt = parser.Parse("SELECT * FROM t WHERE a=1 OR b>2 AND NOT c LIKE 'x%' INTO r");
+        assert(stmt.error.empty());
+        assert(stmt.where_expr);
+        assert(stmt.where_expr->kind == WhereExprKind::OR);
+        assert(stmt.where_expr->children.size() == 2);
+        auto& rhs = stmt.where_expr->children[1];
+        assert(rhs->kind == WhereExprKind::AND);
+        assert(rhs->children[1]->kind == WhereExprKind::NOT);
+        assert(rhs->children[1]->children[0]->kind == WhereExprKind::LIKE);
+        assert(rhs->children[1]->children[0]->values[0] == "x%");
+    }
+    {
+        auto expr = SqlParser::ParseWhere("a IN (1, 2, 3) AND b NOT BETWEEN 1 AND 5 AND c IS NOT NULL AND (d<>'it''s')");
+        assert(expr && expr->kind == WhereExprKind::AND);
+        assert(expr->children.size() == 4);
+        assert(expr->children[0]->kind == WhereExprKind::IN && expr->children[0]->values.size() == 3);
+        assert(expr->children[1]->kind == WhereExprKind::BETWEEN && expr->children[1]->negated);
+        assert(expr->children[2]->kind == WhereExprKind::IS_NULL && expr->children[2]->negated);
+        assert(expr->children[3]->op == CompareOp::NE && expr->children[3]->values[0] == "it's");
+    }
+    {
+        // 数据库方言（GROUP BY 等）不生成表达式树，原文仍交给数据库
+        auto stmt = parser.Parse("SELECT a FROM source WHERE x>1 GROUP BY a");
+        assert(stmt.error.empty());
+        assert(!stmt.where_expr);
+
+        std::string error;
+        assert(!SqlParser::ParseWhere("a=1 AND", &error));
+        assert(!error.empty());
+        assert(!SqlParser::ParseWhere("(a=1", &error));
+        assert(!SqlParser::ParseWhere("a BETWEEN 1", &error));
+    }
+
     printf("[PASS] SQL parser (USING optional + columns)\n");
 }
 
@@ -520,6 +601,572 @@ void test_channel_adapter_copy() {
     printf("[PASS] ChannelAdapter CopyDataFrame\n");
 }
 
+// ============================================================
+// Test 12: DataFrame 列式过滤（类型化谓词 + 选择掩码 + gather）
+// ============================================================
+void test_dataframe_filter() {
+    printf("[TEST] DataFrame columnar filter...\n");
+
+    DataFrame df;
+    df.SetSchema({
+        {"id", DataType::INT32, 0, ""},
+        {"bytes", DataType::UINT64, 0, ""},
+        {"score", DataType::DOUBLE, 0, ""},
+        {"name", DataType::STRING, 0, ""},
+        {"active", DataType::BOOLEAN, 0, ""},
+    });
+    df.AppendRow({int32_t(1), uint64_t(100), double(95.5), std::string("alice"), true});
+    df.AppendRow({int32_t(2), uint64_t(200), double(87.3), std::string("bob"), false});
+    df.AppendRow({int32_t(3), uint64_t(300), double(92.1), std::string("carol"), true});
+    df.AppendRow({int32_t(4), uint64_t(400), double(60.0), std::string("dave"), false});
+    auto source = df.ToArrow();
+
+    // 各类型 + 各操作符
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("id>=2") == 0);
+        assert(out.RowCount() == 3);
+        assert(std::get<int32_t>(out.GetRow(0)[0]) == 2);
+        assert(std::get<std::string>(out.GetRow(2)[3]) == "dave");
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("bytes<300") == 0);
+        assert(out.RowCount() == 2);
+        assert(std::get<uint64_t>(out.GetRow(1)[1]) == 200);
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("bytes>-1") == 0);  // 无符号列与负数比较
+        assert(out.RowCount() == 4);
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("score > 90.0") == 0);
+        assert(out.RowCount() == 2);
+        assert(std::get<double>(out.GetRow(1)[2]) == 92.1);
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("name='bob'") == 0);
+        assert(out.RowCount() == 1);
+        assert(std::get<int32_t>(out.GetRow(0)[0]) == 2);
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("name!=bob") == 0);
+        assert(out.RowCount() == 3);
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("active=true") == 0);
+        assert(out.RowCount() == 2);
+        assert(std::get<bool>(out.GetRow(1)[4]) == true);
+        assert(std::get<std::string>(out.GetRow(1)[3]) == "carol");
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("id>100") == 0);
+        assert(out.RowCount() == 0);
+    }
+
+    // 复合条件：AND / OR / NOT / IN / BETWEEN / LIKE
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("id>=2 AND name LIKE 'c%'") == 0);
+        assert(out.RowCount() == 1);
+        assert(std::get<std::string>(out.GetRow(0)[3]) == "carol");
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("name IN ('bob', 'dave') OR active=true") == 0);
+        assert(out.RowCount() == 4);
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("NOT (id BETWEEN 2 AND 3)") == 0);
+        assert(out.RowCount() == 2);
+        assert(std::get<int32_t>(out.GetRow(0)[0]) == 1);
+        assert(std::get<int32_t>(out.GetRow(1)[0]) == 4);
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("(score < 90 OR bytes = 100) AND name NOT LIKE 'd_v%'") == 0);
+        assert(out.RowCount() == 2);  // alice, bob（dave 匹配 d_v% 被排除）
+        assert(std::get<std::string>(out.GetRow(1)[3]) == "bob");
+    }
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("id NOT IN (1, 4) AND score BETWEEN 80 AND 95") == 0);
+        assert(out.RowCount() == 2);
+    }
+
+    // 错误：列不存在 / 字面量与类型不匹配 / 无操作符
+    {
+        DataFrame out; out.FromArrow(source);
+        assert(out.Filter("missing=1") == -1);
+        assert(out.Filter("id>abc") == -1);
+        assert(out.Filter("id") == -1);
+        assert(out.RowCount() == 4);  // 失败时数据不变
+    }
+
+    // null 不命中任何比较
+    {
+        arrow::Int64Builder ib;
+        arrow::StringBuilder sb;
+        assert(ib.Append(10).ok() && ib.AppendNull().ok() && ib.Append(30).ok());
+        assert(sb.Append("x").ok() && sb.Append("y").ok() && sb.AppendNull().ok());
+        std::shared_ptr<arrow::Array> ia, sa;
+        assert(ib.Finish(&ia).ok() && sb.Finish(&sa).ok());
+        auto schema = arrow::schema({arrow::field("v", arrow::int64()), arrow::field("s", arrow::utf8())});
+        auto batch = arrow::RecordBatch::Make(schema, 3, {ia, sa});
+
+        std::string error;
+        auto pred = ColumnarFilter::Compile("v!=0", *schema, &error);
+        assert(pred);
+        auto out = ColumnarFilter::Apply(batch, *pred, &error);
+        assert(out && out->num_rows() == 2);
+        assert(out->column(1)->IsNull(1));  // 第 3 行的 s 为 null，gather 后保留 null
+
+        pred = ColumnarFilter::Compile("s>=a", *schema, &error);
+        assert(pred);
+        out = ColumnarFilter::Apply(batch, *pred, &error);
+        assert(out && out->num_rows() == 2);
+        assert(out->column(0)->IsNull(1));
+
+        // IS [NOT] NULL；NOT 下推后 null 仍不命中比较（三值逻辑）
+        pred = ColumnarFilter::Compile("s IS NULL OR v IS NULL", *schema, &error);
+        out = ColumnarFilter::Apply(batch, *pred, &error);
+        assert(out && out->num_rows() == 2);
+        pred = ColumnarFilter::Compile("NOT (v > 15)", *schema, &error);
+        out = ColumnarFilter::Apply(batch, *pred, &error);
+        assert(out && out->num_rows() == 1);
+        assert(std::static_pointer_cast<arrow::Int64Array>(out->column(0))->Value(0) == 10);
+        pred = ColumnarFilter::Compile("NOT (s IN ('x') OR v IS NOT NULL)", *schema, &error);
+        out = ColumnarFilter::Apply(batch, *pred, &error);
+        assert(out && out->num_rows() == 1);  // 等价于 s NOT IN ('x') AND v IS NULL
+        assert(out->column(0)->IsNull(0));
+
+        // LIKE 只支持字符串列
+        assert(!ColumnarFilter::Compile("v LIKE '1%'", *schema, &error));
+        assert(!error.empty());
+
+        // 切片（非零 offset）同样正确
+        auto sliced = batch->Slice(1, 2);
+        pred = ColumnarFilter::Compile("v=30", *schema, &error);
+        out = ColumnarFilter::Apply(sliced, *pred, &error);
+        assert(out && out->num_rows() == 1);
+        assert(std::static_pointer_cast<arrow::Int64Array>(out->column(0))->Value(0) == 30);
+    }
+
+    printf("[PASS] DataFrame columnar filter\n");
+}
+
+// ============================================================
+// Test 13: ChannelAdapter — Database → Database 流式搬运（串行 / 流水线）
+// ============================================================
+namespace {
+
+// 每次 Next 返回一个 IPC stream buffer，buffer 在下一次 Next 时被覆盖（模拟真实读端语义）
+class MockBatchReader : public IBatchReader {
+ public:
+    MockBatchReader(int batches, int rows_per_batch) : remaining_(batches), rows_(rows_per_batch) {}
+    int GetSchema(const uint8_t**, size_t*) override { return -1; }
+    int Next(const uint8_t** buf, size_t* len) override {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        int rc = MakeBatch(&batch);
+        if (rc != 0) return rc;
+        auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+        auto writer = arrow::ipc::MakeStreamWriter(sink, batch->schema()).ValueOrDie();
+        assert(writer->WriteRecordBatch(*batch).ok());
+        assert(writer->Close().ok());
+        current_ = sink->Finish().ValueOrDie();
+        *buf = current_->data();
+        *len = static_cast<size_t>(current_->size());
+        return 0;
+    }
+    void Cancel() override { cancelled_ = true; }
+    void Close() override {}
+    const char* GetLastError() override { return cancelled_ ? "cancelled" : ""; }
+    void Release() override { delete this; }
+
+ protected:
+    int MakeBatch(std::shared_ptr<arrow::RecordBatch>* batch) {
+        if (cancelled_) return -1;
+        if (remaining_-- <= 0) return 1;
+        arrow::Int64Builder b;
+        for (int i = 0; i < rows_; ++i) assert(b.Append(next_value_++).ok());
+        std::shared_ptr<arrow::Array> arr;
+        assert(b.Finish(&arr).ok());
+        auto schema = arrow::schema({arrow::field("v", arrow::int64())});
+        *batch = arrow::RecordBatch::Make(schema, rows_, {arr});
+        return 0;
+    }
+
+ private:
+    int remaining_;
+    int rows_;
+    int64_t next_value_ = 0;
+    std::atomic<bool> cancelled_{false};
+    std::shared_ptr<arrow::Buffer> current_;
+};
+
+// 同进程读端：通过 IRecordBatchReader 直接交出 RecordBatch
+class MockInProcBatchReader : public MockBatchReader, public IRecordBatchReader {
+ public:
+    using MockBatchReader::MockBatchReader;
+    int Next(const uint8_t**, size_t*) override { return -1; }  // 快速路径下不应走 IPC
+    int NextBatch(std::shared_ptr<arrow::RecordBatch>* batch) override { return MakeBatch(batch); }
+};
+
+struct MockSinkState {
+    int64_t rows = 0;
+    int64_t sum = 0;
+    int calls = 0;
+    int fail_after = -1;  // 第 N 次写入失败
+    bool committed = false;
+};
+
+static void AccumulateBatch(const arrow::RecordBatch& batch, MockSinkState* state) {
+    auto col = std::static_pointer_cast<arrow::Int64Array>(batch.column(0));
+    for (int64_t i = 0; i < col->length(); ++i) state->sum += col->Value(i);
+    state->rows += batch.num_rows();
+}
+
+class MockBatchWriter : public IBatchWriter {
+ public:
+    explicit MockBatchWriter(MockSinkState* state) : state_(state) {}
+    int Write(const uint8_t* buf, size_t len) override {
+        if (state_->fail_after >= 0 && state_->calls >= state_->fail_after) return -1;
+        state_->calls++;
+        auto input = std::make_shared<arrow::io::BufferReader>(arrow::Buffer::Wrap(buf, len));
+        auto reader = arrow::ipc::RecordBatchStreamReader::Open(input).ValueOrDie();
+        std::shared_ptr<arrow::RecordBatch> batch;
+        while (reader->ReadNext(&batch).ok() && batch) AccumulateBatch(*batch, state_);
+        return 0;
+    }
+    int Flush() override { return 0; }
+    void Close(BatchWriteStats* stats) override {
+        state_->committed = true;
+        if (stats) stats->rows_written = state_->rows;
+    }
+    const char* GetLastError() override { return ""; }
+    void Release() override { delete this; }
+
+ protected:
+    MockSinkState* state_;
+};
+
+class MockInProcBatchWriter : public MockBatchWriter, public IRecordBatchWriter {
+ public:
+    using MockBatchWriter::MockBatchWriter;
+    int Write(const uint8_t*, size_t) override { return -1; }  // 快速路径下不应走 IPC
+    int WriteBatch(const std::shared_ptr<arrow::RecordBatch>& batch) override {
+        if (state_->fail_after >= 0 && state_->calls >= state_->fail_after) return -1;
+        state_->calls++;
+        AccumulateBatch(*batch, state_);
+        return 0;
+    }
+};
+
+class MockArrowWriter : public IArrowWriter {
+ public:
+    explicit MockArrowWriter(MockSinkState* state) : state_(state) {}
+    int WriteBatches(const char*, const std::vector<std::shared_ptr<arrow::RecordBatch>>& batches,
+                     std::string* error) override {
+        if (state_->fail_after >= 0 && state_->calls >= state_->fail_after) {
+            if (error) *error = "mock write failure";
+            return -1;
+        }
+        state_->calls++;
+        for (const auto& b : batches) AccumulateBatch(*b, state_);
+        state_->committed = true;
+        return 0;
+    }
+    const char* GetLastError() override { return ""; }
+    void Release() override { delete this; }
+
+ private:
+    MockSinkState* state_;
+};
+
+class MockDatabaseChannel : public IDatabaseChannel {
+ public:
+    MockDatabaseChannel(bool columnar, MockSinkState* state, int batches = 0, int rows_per_batch = 0,
+                        bool in_process = false)
+        : columnar_(columnar), state_(state), batches_(batches), rows_per_batch_(rows_per_batch),
+          in_process_(in_process) {}
+    const char* Catelog() override { return "mock"; }
+    const char* Name() override { return "db"; }
+    const char* Type() override { return ChannelType::kDatabase; }
+    const char* Schema() override { return ""; }
+    int Open() override { return 0; }
+    int Close() override { return 0; }
+    bool IsOpened() const override { return true; }
+    int Flush() override { return 0; }
+
+    int CreateReader(const char*, IBatchReader** reader) override {
+        if (in_process_) *reader = new MockInProcBatchReader(batches_, rows_per_batch_);
+        else *reader = new MockBatchReader(batches_, rows_per_batch_);
+        return 0;
+    }
+    int CreateWriter(const char*, IBatchWriter** writer) override {
+        if (in_process_) *writer = new MockInProcBatchWriter(state_);
+        else *writer = new MockBatchWriter(state_);
+        return 0;
+    }
+    int CreateArrowReader(const char*, IArrowReader**) override { return -1; }
+    int CreateArrowWriter(const char*, IArrowWriter** writer) override {
+        if (!columnar_) return -1;
+        *writer = new MockArrowWriter(state_);
+        return 0;
+    }
+    int ExecuteQueryArrow(const char*, std::vector<std::shared_ptr<arrow::RecordBatch>>*,
+                          std::string*) override { return -1; }
+    int WriteArrowBatches(const char*, const std::vector<std::shared_ptr<arrow::RecordBatch>>&,
+                          std::string*) override { return -1; }
+    int ExecuteSql(const char*, std::string*) override { return -1; }
+    bool IsConnected() override { return true; }
+
+ private:
+    bool columnar_;
+    MockSinkState* state_;
+    int batches_;
+    int rows_per_batch_;
+    bool in_process_;
+};
+
+}  // namespace
+
+void test_channel_adapter_transfer() {
+    printf("[TEST] ChannelAdapter TransferDatabase...\n");
+
+    const int kBatches = 50;
+    const int kRows = 100;
+    const int64_t kTotal = kBatches * kRows;
+    const int64_t kSum = kTotal * (kTotal - 1) / 2;
+
+    // 读写端分别组合 IPC / 进程内快速路径（IRecordBatchReader / IRecordBatchWriter）
+    for (int mode = 0; mode < 8; ++mode) {
+        bool pipelined = mode & 1;
+        bool columnar = mode & 2;
+        bool in_process = mode & 4;
+        {
+            MockSinkState src_state, dst_state;
+            MockDatabaseChannel src(false, &src_state, kBatches, kRows, in_process);
+            MockDatabaseChannel dst(columnar, &dst_state, 0, 0, in_process);
+
+            TransferOptions options;
+            options.pipelined = pipelined;
+            options.queue_depth = 2;
+            options.window_batches = 8;
+            TransferStats stats;
+            std::string error;
+            int64_t rows = ChannelAdapter::TransferDatabase(&src, "SELECT v FROM t", &dst, "t",
+                                                            options, &error, &stats);
+            assert(rows == kTotal);
+            assert(dst_state.rows == kTotal && dst_state.sum == kSum);
+            assert(dst_state.committed);
+            assert(stats.batches == kBatches && stats.rows == kTotal);
+            // 列式写端按窗口合并提交：50 批 / 每窗口 8 批 = 7 次
+            assert(dst_state.calls == (columnar ? 7 : kBatches));
+        }
+    }
+
+    // Database → DataFrame 同样走快速路径
+    {
+        MockSinkState src_state;
+        MockDatabaseChannel src(false, &src_state, 3, kRows, true);
+        DataFrameChannel dst("test", "dst");
+        dst.Open();
+        std::string error;
+        assert(ChannelAdapter::ReadToDataFrame(&src, "SELECT v FROM t", &dst, &error) == 0);
+        DataFrame result;
+        dst.Read(&result);
+        assert(result.RowCount() == 3 * kRows);
+        dst.Close();
+    }
+
+    // 写端失败：返回 -1，行式写端不提交事务，流水线读线程正常退出
+    for (bool pipelined : {false, true}) {
+        MockSinkState src_state, dst_state;
+        dst_state.fail_after = 3;
+        MockDatabaseChannel src(false, &src_state, kBatches, kRows);
+        MockDatabaseChannel dst(false, &dst_state);
+
+        TransferOptions options;
+        options.pipelined = pipelined;
+        std::string error;
+        assert(ChannelAdapter::TransferDatabase(&src, "SELECT v FROM t", &dst, "t", options, &error) == -1);
+        assert(!dst_state.committed);
+    }
+
+    // 进度上报与协作式取消：取消后不提交写端
+    for (bool pipelined : {false, true}) {
+        MockSinkState src_state, dst_state;
+        MockDatabaseChannel src(false, &src_state, kBatches, kRows);
+        MockDatabaseChannel dst(true, &dst_state);
+
+        std::atomic<bool> cancel{false};
+        TransferProgress progress;
+        TransferOptions options;
+        options.pipelined = pipelined;
+        options.window_batches = 8;
+        options.cancel = &cancel;
+        options.progress = &progress;
+        assert(ChannelAdapter::TransferDatabase(&src, "SELECT v FROM t", &dst, "t", options) == kTotal);
+        assert(progress.batches == kBatches && progress.rows == kTotal && progress.bytes > 0);
+
+        MockSinkState src_state2, dst_state2;
+        MockDatabaseChannel src2(false, &src_state2, kBatches, kRows);
+        MockDatabaseChannel dst2(false, &dst_state2);
+        cancel = true;
+        std::string error;
+        assert(ChannelAdapter::TransferDatabase(&src2, "SELECT v FROM t", &dst2, "t", options, &error) == -1);
+        assert(error == "cancelled" && !dst_state2.committed);
+    }
+
+    printf("[PASS] ChannelAdapter TransferDatabase\n");
+}
+
+void test_job_queue() {
+    printf("[TEST] JobQueue...\n");
+    using namespace flowsql::scheduler;
+
+    JobQueue queue;
+    JobQueueOptions options;
+    options.workers = 2;
+    options.max_pending = 2;
+    options.max_retained = 3;
+
+    // 作业阻塞在 gate 上，直到放行或被取消
+    std::atomic<bool> gate{false};
+    queue.Start(options, [&](Job* job, int64_t* rows, std::shared_ptr<const DataFrame>* result,
+                             std::string* error) {
+        while (!gate && !job->cancel) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (job->sql == "fail") {
+            *error = "boom";
+            return -1;
+        }
+        auto df = std::make_shared<DataFrame>();
+        df->SetSchema({{"v", DataType::INT32, 0, ""}});
+        for (int32_t i = 0; i < 5; ++i) df->AppendRow({i});
+        df->ToArrow();
+        *rows = df->RowCount();
+        *result = std::move(df);
+        return 0;
+    });
+    assert(queue.Workers() == 2);
+
+    auto wait_state = [](const std::shared_ptr<Job>& job, JobState state) {
+        while (job->Snapshot().state != state) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    };
+
+    auto a = queue.Submit("a");
+    auto b = queue.Submit("b");
+    wait_state(a, JobState::RUNNING);
+    wait_state(b, JobState::RUNNING);
+
+    // 两个工作线程都忙，再排两个即到上限，第五个被拒绝
+    auto c = queue.Submit("fail");
+    auto d = queue.Submit("d");
+    assert(c && d && queue.Pending() == 2);
+    std::string error;
+    assert(!queue.Submit("e", &error) && !error.empty());
+
+    // 排队中的作业立即取消；运行中的作业协作退出
+    assert(queue.Cancel(d->id) == 0);
+    assert(d->Snapshot().state == JobState::CANCELLED);
+    assert(queue.Cancel(b->id) == 0);
+    wait_state(b, JobState::CANCELLED);
+    assert(queue.Cancel(12345) == -1);
+
+    gate = true;
+    wait_state(a, JobState::COMPLETED);
+    wait_state(c, JobState::FAILED);
+    int64_t rows = 0;
+    std::shared_ptr<const DataFrame> data;
+    assert(a->Result(&rows, &data) && rows == 5 && data->RowCount() == 5);
+    assert(!c->Result(&rows, &data) && c->Snapshot().error == "boom");
+    assert(queue.Cancel(a->id) == 1);
+
+    // 只保留最近 3 个已结束作业，最早结束的 d 已被淘汰
+    assert(!queue.Get(d->id) && queue.Get(a->id));
+
+    queue.Stop();
+    assert(!queue.Submit("late"));
+    printf("[PASS] JobQueue\n");
+}
+
+// 拉取分块响应的全部输出
+static std::string DrainChunkedResponse(httplib::Response& res) {
+    std::string body;
+    bool done = false;
+    httplib::DataSink sink;
+    sink.write = [&](const char* data, size_t len) {
+        body.append(data, len);
+        return true;
+    };
+    sink.is_writable = [] { return true; };
+    sink.done = [&] { done = true; };
+    for (size_t offset = 0; !done;) {
+        bool ok = res.content_provider_(offset, 0, sink);
+        assert(ok);
+        offset = body.size();
+    }
+    return body;
+}
+
+void test_result_format() {
+    printf("[TEST] Result format negotiation...\n");
+    using namespace flowsql::scheduler;
+
+    // Accept 协商：取第一个可识别的类型，q=0 视为拒绝，未识别时退化为 json
+    assert(NegotiateResultFormat("") == ResultFormat::JSON);
+    assert(NegotiateResultFormat("*/*") == ResultFormat::JSON);
+    assert(NegotiateResultFormat("application/vnd.apache.arrow.stream") == ResultFormat::ARROW);
+    assert(NegotiateResultFormat("text/html, Application/Vnd.Apache.Arrow.File;q=0.9") == ResultFormat::FEATHER);
+    assert(NegotiateResultFormat("application/vnd.apache.arrow.stream;q=0, application/x-ndjson") ==
+           ResultFormat::NDJSON);
+    assert(NegotiateResultFormat("application/json, application/vnd.apache.arrow.stream") == ResultFormat::JSON);
+    assert(std::string(ResultContentType(ResultFormat::ARROW)) == "application/vnd.apache.arrow.stream");
+
+    auto df = std::make_shared<DataFrame>();
+    df->SetSchema({{"id", DataType::INT64, 0, ""}, {"name", DataType::STRING, 0, ""}});
+    for (int64_t i = 0; i < 20000; ++i) df->AppendRow({i, std::string("n") + std::to_string(i)});
+    df->ToArrow();
+
+    // Arrow IPC stream：跨多个块（每块 8192 行），offset / limit 生效
+    {
+        httplib::Response res;
+        SetStreamingResult(res, df, ResultFormat::ARROW, 100, 10000);
+        std::string body = DrainChunkedResponse(res);
+        auto reader = arrow::ipc::RecordBatchStreamReader::Open(
+            std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString(body)));
+        assert(reader.ok());
+        auto table = (*reader)->ToTable();
+        assert(table.ok() && (*table)->num_rows() == 10000);
+        auto first = std::static_pointer_cast<arrow::Int64Array>((*table)->column(0)->chunk(0));
+        assert(first->Value(0) == 100);
+    }
+
+    // Feather（IPC file）：footer 中的块偏移可供随机读取
+    {
+        httplib::Response res;
+        SetStreamingResult(res, df, ResultFormat::FEATHER, 0, -1);
+        std::string body = DrainChunkedResponse(res);
+        auto reader = arrow::ipc::RecordBatchFileReader::Open(
+            std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString(body)));
+        assert(reader.ok());
+        assert((*reader)->num_record_batches() == 3);
+        auto last = (*reader)->ReadRecordBatch(2);
+        assert(last.ok() && (*last)->num_rows() == 20000 - 2 * 8192);
+        auto ids = std::static_pointer_cast<arrow::Int64Array>((*last)->column(0));
+        assert(ids->Value(0) == 2 * 8192);
+    }
+    printf("[PASS] Result format negotiation\n");
+}
+
 // ============================================================
 // main
 // ============================================================
@@ -536,6 +1183,10 @@ int main(int argc, char* argv[]) {
     test_build_query_integration();
     test_channel_adapter_copy();
     test_channel_type_constants();
+    test_dataframe_filter();
+    test_channel_adapter_transfer();
+    test_job_queue();
+    test_result_format();
 
     // Pipeline 测试需要插件 .so
     std::string plugin_dir = get_absolute_process_path();
@@ -29,6 +29,8 @@ else()
                 -DARROW_IPC=ON
                 -DARROW_WITH_UTF8PROC=OFF
                 -DARROW_WITH_RE2=OFF
+                -DARROW_WITH_LZ4=ON
+                -DARROW_WITH_ZSTD=ON
                 -DARROW_DEPENDENCY_SOURCE=BUNDLED
                 -DCMAKE_POSITION_INDEPENDENT_CODE=ON
                 -DCMAKE_INSTALL_PREFIX:PATH=${_arrow_install}